@@ -1,33 +0,0 @@
-#ifndef CUSTOM_CHARACTERS_H
-#define CUSTOM_CHARACTERS_H
-
-#include <Arduino.h>
-
-// ========== CUSTOM CHARACTERS ==========
-// WiFi connected icon
-extern byte wifiIcon[8];
-
-// AP mode icon
-extern byte apIcon[8];
-
-// Temperature icon
-extern byte tempIcon[8];
-
-// Humidity icon
-extern byte humidityIcon[8];
-
-// Motion icon
-extern byte motionIcon[8];
-
-// Loading animation frames (3 frames)
-extern byte loadingIcon1[8];
-extern byte loadingIcon2[8];
-extern byte loadingIcon3[8];
-
-// Fan icon
-extern byte fanIcon[8];
-
-// Light icon
-extern byte lightIcon[8];
-
-#endif // CUSTOM_CHARACTERS_H
\ No newline at end of file
@@ -1,273 +0,0 @@
-#ifndef HTML_CONTENT_H
-#define HTML_CONTENT_H
-
-#include <Arduino.h>
-
-// Captive portal HTML template
-const char portal_html[] PROGMEM = R"=====(
-<!DOCTYPE html>
-<html>
-<head>
-    <meta name="viewport" content="width=device-width, initial-scale=1.0">
-    <title>Smart Environment Hub - WiFi Setup</title>
-    <style>
-        body {
-            font-family: Arial, sans-serif;
-            margin: 0;
-            padding: 20px;
-            background-color: #f8f9fa;
-            color: #333;
-        }
-        .container {
-            max-width: 500px;
-            margin: 0 auto;
-            background: white;
-            padding: 20px;
-            border-radius: 10px;
-            box-shadow: 0 2px 10px rgba(0,0,0,0.1);
-        }
-        h1 {
-            color: #2c3e50;
-            text-align: center;
-            margin-bottom: 20px;
-            font-size: 24px;
-        }
-        .network-list {
-            margin-bottom: 20px;
-            max-height: 300px;
-            overflow-y: auto;
-            border: 1px solid #ddd;
-            border-radius: 5px;
-            padding: 10px;
-        }
-        .network-item {
-            padding: 10px;
-            border-bottom: 1px solid #eee;
-            cursor: pointer;
-            display: flex;
-            justify-content: space-between;
-            align-items: center;
-        }
-        .network-item:last-child {
-            border-bottom: none;
-        }
-        .network-item:hover {
-            background-color: #f5f5f5;
-        }
-        .ssid {
-            font-weight: bold;
-        }
-        .signal {
-            display: inline-block;
-            width: 20px;
-        }
-        input[type="password"] {
-            width: 100%;
-            padding: 10px;
-            margin: 10px 0;
-            border: 1px solid #ddd;
-            border-radius: 4px;
-            box-sizing: border-box;
-        }
-        .connect-btn {
-            background-color: #4CAF50;
-            color: white;
-            border: none;
-            padding: 10px 15px;
-            border-radius: 4px;
-            cursor: pointer;
-            width: 100%;
-            font-size: 16px;
-        }
-        .connect-btn:hover {
-            background-color: #45a049;
-        }
-        .scan-btn {
-            background-color: #2196F3;
-            color: white;
-            border: none;
-            padding: 10px 15px;
-            border-radius: 4px;
-            cursor: pointer;
-            width: 100%;
-            font-size: 16px;
-            margin-bottom: 10px;
-        }
-        .scan-btn:hover {
-            background-color: #0b7dda;
-        }
-        .status {
-            text-align: center;
-            margin-top: 10px;
-            color: #666;
-        }
-        .hidden {
-            display: none;
-        }
-        .loading {
-            text-align: center;
-            margin: 20px 0;
-        }
-        .spinner {
-            border: 4px solid rgba(0, 0, 0, 0.1);
-            width: 36px;
-            height: 36px;
-            border-radius: 50%;
-            border-left-color: #2196F3;
-            animation: spin 1s linear infinite;
-            display: inline-block;
-            vertical-align: middle;
-        }
-        @keyframes spin {
-            0% { transform: rotate(0deg); }
-            100% { transform: rotate(360deg); }
-        }
-    </style>
-</head>
-<body>
-    <div class="container">
-        <h1>Smart Environment Hub</h1>
-        <div id="wifi-setup">
-            <button class="scan-btn" onclick="scanNetworks()">Scan WiFi Networks</button>
-            
-            <div id="loading" class="loading hidden">
-                <div class="spinner"></div>
-                <p>Scanning for networks...</p>
-            </div>
-            
-            <div id="network-list" class="network-list hidden">
-                <!-- Networks will be populated here -->
-            </div>
-            
-            <div id="connect-form" class="hidden">
-                <input type="text" id="selected-ssid" readonly>
-                <input type="password" id="password" placeholder="Enter password">
-                <button class="connect-btn" onclick="connectToWifi()">Connect</button>
-            </div>
-            
-            <div id="status" class="status"></div>
-        </div>
-    </div>
-
-    <script>
-        // Network scanning function
-        function scanNetworks() {
-            document.getElementById('loading').classList.remove('hidden');
-            document.getElementById('network-list').classList.add('hidden');
-            document.getElementById('connect-form').classList.add('hidden');
-            document.getElementById('status').textContent = '';
-            
-            fetch('/scan')
-                .then(response => response.json())
-                .then(data => {
-                    document.getElementById('loading').classList.add('hidden');
-                    
-                    const networkList = document.getElementById('network-list');
-                    networkList.innerHTML = '';
-                    networkList.classList.remove('hidden');
-                    
-                    if (data.networks && data.networks.length > 0) {
-                        // Sort networks by signal strength
-                        data.networks.sort((a, b) => b.rssi - a.rssi);
-                        
-                        data.networks.forEach(network => {
-                            const item = document.createElement('div');
-                            item.className = 'network-item';
-                            
-                            // Calculate signal strength icon based on RSSI
-                            let signalIcon = '📶';
-                            if (network.rssi > -50) signalIcon = '📶'; // Excellent
-                            else if (network.rssi > -65) signalIcon = '📶'; // Good
-                            else if (network.rssi > -75) signalIcon = '📶'; // Fair
-                            else signalIcon = '📶'; // Poor
-                            
-                            item.innerHTML = `
-                                <span class="ssid">${network.ssid}</span>
-                                <span class="signal">${signalIcon}</span>
-                            `;
-                            
-                            item.onclick = function() {
-                                selectNetwork(network.ssid);
-                            };
-                            
-                            networkList.appendChild(item);
-                        });
-                    } else {
-                        networkList.innerHTML = '<div style="text-align: center; padding: 20px;">No networks found</div>';
-                    }
-                })
-                .catch(error => {
-                    document.getElementById('loading').classList.add('hidden');
-                    document.getElementById('status').textContent = 'Error scanning networks. Please try again.';
-                    console.error('Error:', error);
-                });
-        }
-        
-        // Select network function
-        function selectNetwork(ssid) {
-            const connectForm = document.getElementById('connect-form');
-            connectForm.classList.remove('hidden');
-            
-            const ssidInput = document.getElementById('selected-ssid');
-            ssidInput.value = ssid;
-            
-            document.getElementById('password').value = '';
-            document.getElementById('password').focus();
-        }
-        
-        // Connect to WiFi function
-        function connectToWifi() {
-            const ssid = document.getElementById('selected-ssid').value;
-            const password = document.getElementById('password').value;
-            
-            if (!ssid) {
-                document.getElementById('status').textContent = 'Please select a network first.';
-                return;
-            }
-            
-            document.getElementById('status').textContent = `Connecting to ${ssid}...`;
-            
-            // Send connection request
-            const formData = new FormData();
-            formData.append('ssid', ssid);
-            formData.append('password', password);
-            
-            fetch('/connect', {
-                method: 'POST',
-                body: formData
-            })
-            .then(response => response.json())
-            .then(data => {
-                if (data.success) {
-                    document.getElementById('status').textContent = `Successfully connected to ${ssid}! Device is now connecting to the network...`;
-                    
-                    // Show countdown for reconnection
-                    let countdown = 10;
-                    const countdownInterval = setInterval(() => {
-                        document.getElementById('status').textContent = `Connection successful! This page will no longer be available. Your device is now operating normally. (${countdown})`;
-                        countdown--;
-                        
-                        if (countdown < 0) {
-                            clearInterval(countdownInterval);
-                        }
-                    }, 1000);
-                } else {
-                    document.getElementById('status').textContent = `Failed to connect to ${ssid}. Please check your password and try again.`;
-                }
-            })
-            .catch(error => {
-                document.getElementById('status').textContent = 'Error connecting to the network. Please try again.';
-                console.error('Error:', error);
-            });
-        }
-        
-        // Initial scan when page loads
-        window.onload = function() {
-            setTimeout(scanNetworks, 500);
-        };
-    </script>
-</body>
-</html>
-)=====";
-
-#endif // HTML_CONTENT_H
\ No newline at end of file
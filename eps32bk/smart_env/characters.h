@@ -1,18 +0,0 @@
-/*
- * Custom character definitions for LCD display
- */
-
-#ifndef CHARACTERS_H
-#define CHARACTERS_H
-
-
-extern byte wifiIcon[8];
-extern byte apIcon[8];
-extern byte tempIcon[8];
-extern byte humidityIcon[8];
-extern byte motionIcon[8];
-extern byte loadingIcon1[8];
-extern byte loadingIcon2[8];
-extern byte loadingIcon3[8];
-
-#endif // CHARACTERS_H
@@ -12,114 +12,42 @@
  * - Status LED
  */
 
-// Include all the necessary header files
-#include "config.h"
-#include "characters.h"
-#include "display.h"
-#include "sensors.h"
-#include "wifi_manager.h"
-#include "api_client.h"
-
-
+#include <WiFi.h>
+#include <AsyncTCP.h>
+#include <DNSServer.h>
+#include <ESPAsyncWebServer.h>
+#include <HTTPClient.h>
+#include <DHT.h>
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+#include <ArduinoJson.h>
+#include <HubCore.h>
+
+struct HubConfig : HubDefaults {
+    // ========== PINS ==========
+    static constexpr uint8_t dhtPin = 15;        // DHT temperature/humidity sensor
+    static constexpr uint8_t pirPin = 18;        // Motion sensor
+    static constexpr uint8_t motionLedPin = 17;  // Status LED
+
+    // ========== CONFIGURATION ==========
+    static const char* apSsid() { return "Smart Environment"; }
+    static const char* apPassword() { return ""; }
+    static constexpr HubTransport transport = HubTransport::Http;
+    static const char* endpoint() { return "http://abc.xyz/data"; }
+
+    // ========== TIMING ==========
+    static constexpr uint32_t dataSendInterval = 5000;   // Longest gap between API updates
+    static constexpr uint32_t reportMinInterval = 5000;  // One POST per 5 seconds at most
+    static constexpr uint32_t lcdUpdateInterval = 1000;
+};
+
+HubApp<HubConfig> hub;
 
 void setup() {
-    Serial.begin(115200);
-    Serial.println();
-    Serial.println("==============================================================");
-    Serial.println("Smart Environment Hub - Starting up...");
-    Serial.println("==============================================================");
-    Serial.println("Version: 1.0");
-    Serial.printf("Build date: %s %s\n", __DATE__, __TIME__);
-    Serial.println("Debug mode: ENABLED");
-
-    // Initialize LCD
-    initDisplay();
-
-    // Welcome splash screen
-    displayWelcomeScreen();
-
-    // Initialize sensors
-    initSensors();
-
-    Serial.println("Blinking LED to indicate startup...");
-    // Blink LED to indicate startup
-    for(int i = 0; i < 3; i++) {
-        digitalWrite(LED, HIGH);
-        delay(100);
-        digitalWrite(LED, LOW);
-        delay(100);
-    }
-
-    // Try to connect to WiFi or start Captive Portal
-    setupWiFiConnection();
-    
-    Serial.println("Setup complete, entering main loop");
+    hub.begin();
 }
 
+// All work runs in the FreeRTOS tasks started by hub.begin()
 void loop() {
-    // Handle DNS server for Captive Portal
-    dnsServer.processNextRequest();
-
-    // Check motion sensor
-    if (checkMotion()) {
-        // Only update LCD immediately for motion events in normal operation
-        if (currentLcdState == NORMAL_OPERATION) {
-            float temp = readTemperature();
-            float hum = readHumidity();
-            displaySensorData(isWiFiConnected, motionDetected, isApiConnected, temp, hum);
-        }
-    }
-
-    // Update motion status and LED
-    updateMotionStatus();
-    
-    // If motion just ended, update LCD
-    static bool prevMotionState = false;
-    if (prevMotionState != motionDetected) {
-        prevMotionState = motionDetected;
-        if (!motionDetected && currentLcdState == NORMAL_OPERATION) {
-            float temp = readTemperature();
-            float hum = readHumidity();
-            displaySensorData(isWiFiConnected, motionDetected, isApiConnected, temp, hum);
-        }
-    }
-
-    // Regular LCD updates
-    if (millis() - lastLCDUpdate >= LCD_UPDATE_INTERVAL) {
-        Serial.println("Regular LCD update");
-        
-        if (currentLcdState == NORMAL_OPERATION) {
-            float temp = readTemperature();
-            float hum = readHumidity();
-            displaySensorData(isWiFiConnected, motionDetected, isApiConnected, temp, hum);
-        } else {
-            updateLCD(currentLcdState);
-        }
-        
-        lastLCDUpdate = millis();
-    }
-
-    // Loading animation updates (faster than LCD)
-    if (millis() - lastAnimationUpdate >= ANIMATION_INTERVAL &&
-        (currentLcdState == CONNECTING_WIFI || currentLcdState == STARTING)) {
-        displayLoadingAnimation();
-        lastAnimationUpdate = millis();
-    }
-
-    // Send data to server
-    if (isWiFiConnected && millis() - lastDataSend >= DATA_SEND_INTERVAL) {
-        Serial.println("Time to send data to server");
-        float temp = readTemperature();
-        float hum = readHumidity();
-        sendDataToServer(temp, hum, motionDetected);
-        lastDataSend = millis();
-    }
-
-    // Check WiFi connection
-    if (!checkWiFiStatus() && currentLcdState != AP_MODE) {
-        Serial.println("WiFi connection check failed, device is in captive portal mode");
-    }
-
-    // Small delay to prevent CPU hogging
-    delay(10);
+    vTaskDelete(NULL);
 }
@@ -0,0 +1,90 @@
+/*
+ * Local client command parser benchmark
+ *
+ * Times parseCommand() on typical messages in each encoding, and
+ * writeCommandAck() on the result, as dispatchCommand() runs them for
+ * every message from a port 81 client.
+ *
+ *   bench_command_protocol [--iterations N]
+ *
+ * Each parse starts with copying the message into the receive buffer,
+ * since JSON escapes are decoded in place. Times are host CPU time, for
+ * comparing runs with each other. Exits non-zero if a message does not
+ * parse.
+ */
+#include <Arduino.h>
+#include <chrono>
+#include "command_protocol.h"
+
+struct Message {
+  const char* name;
+  const uint8_t* data;
+  size_t length;
+  bool binary;
+};
+
+#define TEXT_MESSAGE(name, text) { name, (const uint8_t*)text, sizeof(text) - 1, false }
+
+static const uint8_t binaryLed1[] = { CMD_LED1, 42, 0, 128, 0 };
+static const uint8_t binaryConnect[] = { CMD_CONNECT, 7, 0, 4, 'h', 'o', 'm', 'e',
+                                         8, 'h', 'u', 'n', 't', 'e', 'r', '2', '2' };
+
+static const Message messages[] = {
+  TEXT_MESSAGE("json led1", "{\"op\":\"led1\",\"id\":42,\"value\":128}"),
+  TEXT_MESSAGE("json connect", "{\"op\":\"connect\",\"id\":7,\"ssid\":\"home\",\"password\":\"hunter22\"}"),
+  TEXT_MESSAGE("json connect esc", "{\"op\":\"connect\",\"ssid\":\"caf\\u00e9\",\"password\":\"a|b\\\"c\"}"),
+  TEXT_MESSAGE("legacy led1", "led1:128"),
+  TEXT_MESSAGE("legacy connect", "connect:home|hunter22"),
+  TEXT_MESSAGE("legacy scan", "scan"),
+  { "binary led1", binaryLed1, sizeof(binaryLed1), true },
+  { "binary connect", binaryConnect, sizeof(binaryConnect), true },
+};
+
+// Keeps the compiler from dropping the work
+static volatile uint32_t sink;
+
+int main(int argc, char** argv) {
+  uint32_t iterations = 2000000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--iterations") == 0 && i + 1 < argc) {
+      iterations = atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--iterations N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (iterations == 0) iterations = 1;
+
+  int failures = 0;
+  uint8_t buffer[128];
+  char ack[96];
+  printf("Command parsing, %u iterations each\n", iterations);
+  printf("%-18s %6s %10s %10s\n", "message", "bytes", "parse ns", "+ack ns");
+  for (const Message& message : messages) {
+    Command command;
+    memcpy(buffer, message.data, message.length);
+    if (parseCommand(buffer, message.length, message.binary, command) != CMD_OK) {
+      fprintf(stderr, "FAIL: %s does not parse\n", message.name);
+      failures++;
+      continue;
+    }
+
+    auto start = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+      memcpy(buffer, message.data, message.length);
+      sink = parseCommand(buffer, message.length, message.binary, command);
+    }
+    auto parsed = std::chrono::steady_clock::now();
+    for (uint32_t i = 0; i < iterations; i++) {
+      memcpy(buffer, message.data, message.length);
+      CommandStatus status = parseCommand(buffer, message.length, message.binary, command);
+      sink = writeCommandAck(ack, sizeof(ack), command, status);
+    }
+    auto acked = std::chrono::steady_clock::now();
+
+    double parseNs = std::chrono::duration<double, std::nano>(parsed - start).count() / iterations;
+    double ackNs = std::chrono::duration<double, std::nano>(acked - parsed).count() / iterations;
+    printf("%-18s %6zu %10.1f %10.1f\n", message.name, message.length, parseNs, ackNs);
+  }
+  return failures != 0;
+}
@@ -0,0 +1,137 @@
+/*
+ * Loop latency benchmark
+ *
+ * Boots the sketch on the simulated ESP32 and runs a busy hub for a
+ * while: local clients dragging the LED1 slider and toggling LEDs, the
+ * API server sending device_control, the temperature drifting and the
+ * PIR firing. Then prints the latency percentiles of every timed
+ * subsystem from the loop_stats histograms.
+ *
+ *   bench_loop [--minutes N] [--clients N] [--verbose]
+ *
+ * Latencies are host compute plus the modeled waits (I2C transfers, the
+ * DHT read, socket back-pressure), so compare runs with each other, not
+ * with the device. Exits non-zero if the hub never got online or a
+ * subsystem never ran.
+ */
+#include <DHT.h>
+#include <WebSocketsClient.h>
+#include <WebSocketsServer.h>
+#include <WiFi.h>
+#include <memory>
+#include <vector>
+#include "host_sim.h"
+#include "loop_stats.h"
+#include "sketch.h"
+
+#define STEP_MS 100
+
+// The subsystems the benchmark must see run
+static const LoopRegion requiredRegions[] = {
+  REGION_READ_SENSORS,
+  REGION_UPDATE_LCD,
+  REGION_BROADCAST_STATUS,
+  REGION_SEND_DATA,
+  REGION_WEBSOCKET_LOOP,
+};
+
+static void printSummary(uint32_t minutes) {
+  printf("\nLoop latency over %u simulated minutes (us)\n", minutes);
+  printf("%-24s %8s %8s %8s %8s %8s\n", "region", "count", "p50", "p90", "p99", "max");
+  for (int i = 0; i < REGION_COUNT; i++) {
+    LoopRegionSummary summary;
+    if (!loopStatsSummary((LoopRegion)i, summary)) continue;
+    printf("%-24s %8u %8u %8u %8u %8u\n", loopStatsRegionName((LoopRegion)i), summary.count,
+           summary.p50Us, summary.p90Us, summary.p99Us, summary.maxUs);
+  }
+}
+
+int main(int argc, char** argv) {
+  uint32_t minutes = 60;
+  uint32_t clientCount = 3;
+  bool verbose = false;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--minutes") == 0 && i + 1 < argc) {
+      minutes = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--clients") == 0 && i + 1 < argc) {
+      clientCount = atoi(argv[++i]);
+    } else if (strcmp(argv[i], "--verbose") == 0) {
+      verbose = true;
+    } else {
+      fprintf(stderr, "usage: %s [--minutes N] [--clients N] [--verbose]\n", argv[0]);
+      return 2;
+    }
+  }
+
+  hostSerialEcho(verbose);
+  // The driver remembers the home network, as after a first setup
+  hostWifiAddNetwork("home", "hunter22", -58);
+  hostWifiSetDriverConfig("home", "hunter22");
+  hostSimBoot(setup, loop);
+  hostSimRun(15000);
+
+  std::vector<std::unique_ptr<HostWsPeer>> clients;
+  for (uint32_t i = 0; i < clientCount; i++) {
+    clients.emplace_back(new HostWsPeer());
+    clients.back()->connect(hostLocalPort);
+  }
+
+  uint32_t steps = minutes * 60000 / STEP_MS;
+  uint32_t commandSeq = 0;
+  char text[96];
+  for (uint32_t step = 0; step < steps; step++) {
+    uint32_t t = step * STEP_MS;
+
+    // A slider drag every 10 s: ten set-points 100 ms apart
+    if (t % 10000 < 1000) {
+      HostWsPeer& client = *clients[(t / 10000) % clients.size()];
+      snprintf(text, sizeof(text), "{\"op\":\"led1\",\"id\":%u,\"value\":%u}", step & 0x7fff,
+               (t / 100) % 256);
+      client.sendText(text);
+    }
+    if (t % 7000 == 0) clients[step % clients.size()]->sendText(step % 2 ? "led2:1" : "led2:0");
+    if (t % 30000 == 0) clients[0]->sendText("profile");
+
+    // Server set-points every 20 s
+    if (t % 20000 == 5000 && hostApi.linked()) {
+      commandSeq++;
+      snprintf(text, sizeof(text),
+               "{\"action\":\"device_control\",\"seq\":%u,\"payload\":{\"led3\":%s}}", commandSeq,
+               commandSeq % 2 ? "true" : "false");
+      hostApi.inject(text);
+    }
+
+    // Room temperature drifting by 0.1 °C every 5 s, humidity slower
+    if (t % 5000 == 0) hostDht.temperature = 21.0f + 0.1f * ((t / 5000) % 40);
+    if (t % 60000 == 0) hostDht.humidity = 45.0f + (t / 60000) % 10;
+    // Someone walks by every 45 s
+    if (t % 45000 == 0) hostPinSet(hostPirPin, HIGH);
+    if (t % 45000 == 3000) hostPinSet(hostPirPin, LOW);
+
+    hostSimRun(STEP_MS);
+    for (auto& client : clients) {
+      client->receive();
+      client->clearMessages();
+      // Phones that were dropped come back
+      if (!client->connected()) client->connect(hostLocalPort);
+    }
+  }
+
+  printSummary(minutes);
+
+  int failures = 0;
+  if (!hostSketchWifiConnected() || !hostSketchApiConnected()) {
+    fprintf(stderr, "FAIL: the hub is not online (wifi %d, api %d)\n", hostSketchWifiConnected(),
+            hostSketchApiConnected());
+    failures++;
+  }
+  for (LoopRegion region : requiredRegions) {
+    LoopRegionSummary summary;
+    if (!loopStatsSummary(region, summary)) {
+      fprintf(stderr, "FAIL: %s never ran\n", loopStatsRegionName(region));
+      failures++;
+    }
+  }
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
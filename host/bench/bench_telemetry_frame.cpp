@@ -0,0 +1,149 @@
+/*
+ * updateenv serializer benchmark
+ *
+ * Builds the {"action":"updateenv","payload":{...}} frame over and over
+ * with writeUpdateEnvFrame() and, when the build found the real library
+ * (see host/CMakeLists.txt), with the JsonDocument and String code it
+ * replaced. Prints the frame throughput and the heap allocations per
+ * frame of each.
+ *
+ *   bench_telemetry_frame [--frames N]
+ *
+ * Allocations are every malloc(), calloc() and realloc() in the process,
+ * so they include the String growth the library path goes through. The
+ * String stub follows the Arduino-ESP32 storage policy, so the counts
+ * match the device; the throughput is host CPU time. Exits non-zero if
+ * the fixed-layout path allocated at all.
+ */
+#include <Arduino.h>
+#include <WebSockets.h>
+#include <chrono>
+#include "telemetry_frame.h"
+
+#if HOST_ARDUINOJSON
+#include <ArduinoJson.h>
+#endif
+
+extern "C" void* __libc_malloc(size_t size);
+extern "C" void* __libc_calloc(size_t count, size_t size);
+extern "C" void* __libc_realloc(void* pointer, size_t size);
+extern "C" void __libc_free(void* pointer);
+
+// Single-threaded: nothing here boots the simulation
+static uint64_t allocations = 0;
+
+extern "C" void* malloc(size_t size) {
+  allocations++;
+  return __libc_malloc(size);
+}
+
+extern "C" void* calloc(size_t count, size_t size) {
+  allocations++;
+  return __libc_calloc(count, size);
+}
+
+extern "C" void* realloc(void* pointer, size_t size) {
+  allocations++;
+  return __libc_realloc(pointer, size);
+}
+
+extern "C" void free(void* pointer) {
+  __libc_free(pointer);
+}
+
+static const char* DEVICE_ID = "esp32-smart-hub";
+
+// Outgoing frame as the sketch keeps it, header room first
+static uint8_t txFrame[WEBSOCKETS_MAX_HEADER_SIZE + TELEMETRY_FRAME_SIZE];
+static char* const txFramePayload = (char*)txFrame + WEBSOCKETS_MAX_HEADER_SIZE;
+
+// A room drifting by, so every frame differs a little
+static TelemetrySample sampleAt(uint32_t i) {
+  TelemetrySample sample;
+  sample.temperature = 20.0f + (i % 97) * 0.13f;
+  sample.humidity = 40.0f + (i % 31) * 0.5f;
+  sample.motion = (i / 50) % 2;
+  sample.led1 = i % 256;
+  sample.led2 = (i / 7) % 2;
+  sample.led3 = (i / 11) % 2;
+  return sample;
+}
+
+struct PathResult {
+  uint64_t bytes;
+  uint64_t allocations;
+  double seconds;
+};
+
+static size_t frameWriterPath(const TelemetrySample& sample) {
+  return writeUpdateEnvFrame(txFramePayload, TELEMETRY_FRAME_SIZE, sample, DEVICE_ID);
+}
+
+#if HOST_ARDUINOJSON
+// What sendDataToServer() did before the fixed-layout writer
+static size_t arduinoJsonPath(const TelemetrySample& sample) {
+  JsonDocument doc;
+  doc["action"] = "updateenv";
+  JsonObject payload = doc["payload"].to<JsonObject>();
+  payload["led1"] = sample.led1;
+  payload["led2"] = sample.led2;
+  payload["led3"] = sample.led3;
+  payload["motion"] = sample.motion;
+  payload["temp"] = sample.temperature;
+  payload["hum"] = sample.humidity;
+  payload["deviceId"] = DEVICE_ID;
+
+  String json;
+  serializeJson(doc, json);
+  return json.length();
+}
+#endif
+
+static PathResult run(size_t (*path)(const TelemetrySample&), uint32_t frames) {
+  PathResult result = { 0, 0, 0 };
+  uint64_t allocationsBefore = allocations;
+  auto start = std::chrono::steady_clock::now();
+  for (uint32_t i = 0; i < frames; i++) {
+    result.bytes += path(sampleAt(i));
+  }
+  auto end = std::chrono::steady_clock::now();
+  result.allocations = allocations - allocationsBefore;
+  result.seconds = std::chrono::duration<double>(end - start).count();
+  return result;
+}
+
+static void printResult(const char* name, const PathResult& result, uint32_t frames) {
+  printf("%-14s %10.1f %10.1f %12.0f %14.2f\n", name, (double)result.bytes / frames,
+         result.seconds * 1e9 / frames, result.bytes / result.seconds,
+         (double)result.allocations / frames);
+}
+
+int main(int argc, char** argv) {
+  uint32_t frames = 1000000;
+  for (int i = 1; i < argc; i++) {
+    if (strcmp(argv[i], "--frames") == 0 && i + 1 < argc) {
+      frames = atoi(argv[++i]);
+    } else {
+      fprintf(stderr, "usage: %s [--frames N]\n", argv[0]);
+      return 2;
+    }
+  }
+  if (frames == 0) frames = 1;
+
+  printf("updateenv frames, %u each\n", frames);
+  printf("%-14s %10s %10s %12s %14s\n", "path", "bytes", "ns/frame", "bytes/s", "allocs/frame");
+  PathResult fixed = run(frameWriterPath, frames);
+  printResult("FrameWriter", fixed, frames);
+#if HOST_ARDUINOJSON
+  printResult("ArduinoJson", run(arduinoJsonPath, frames), frames);
+#else
+  printf("ArduinoJson    not found; see host/CMakeLists.txt\n");
+#endif
+
+  if (fixed.allocations != 0) {
+    fprintf(stderr, "FAIL: the fixed-layout path allocated %llu times\n",
+            (unsigned long long)fixed.allocations);
+    return 1;
+  }
+  return 0;
+}
@@ -0,0 +1,75 @@
+/*
+ * Fuzz target for the local client command parser
+ *
+ * Feeds every input to parseCommand() as a text and as a binary message,
+ * each in a buffer of exactly its size so that the sanitizers catch any
+ * read past the end, and checks what a parse promises:
+ *
+ *   - a status from CommandStatus, and an op from CommandOp
+ *   - CMD_OK only with the fields commandSpecs asks for
+ *   - string fields inside the message
+ *   - an ack that fits the buffer dispatchCommand() gives it
+ *
+ * Built with libFuzzer under clang and with fuzz_main.cpp elsewhere; see
+ * host/CMakeLists.txt.
+ */
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include "command_protocol.h"
+
+// dispatchCommand() writes acks into a char[96]
+#define ACK_BUFFER_SIZE 96
+
+#define FUZZ_CHECK(cond)                                                           \
+  do {                                                                             \
+    if (!(cond)) {                                                                 \
+      fprintf(stderr, "%s:%d: %s does not hold\n", __FILE__, __LINE__, #cond); \
+      abort();                                                                     \
+    }                                                                              \
+  } while (0)
+
+static void checkField(const CommandField& field, const uint8_t* message, size_t size) {
+  if (field.data == nullptr) {
+    FUZZ_CHECK(field.length == 0);
+    return;
+  }
+  const uint8_t* data = (const uint8_t*)field.data;
+  FUZZ_CHECK(data >= message && data <= message + size);
+  FUZZ_CHECK(field.length <= (size_t)(message + size - data));
+}
+
+static void checkParse(const uint8_t* input, size_t size, bool binary) {
+  // Exactly sized, and parsed in place
+  uint8_t* message = (uint8_t*)malloc(size ? size : 1);
+  memcpy(message, input, size);
+
+  Command command;
+  CommandStatus status = parseCommand(message, size, binary, command);
+  FUZZ_CHECK(status <= CMD_REJECTED);
+  FUZZ_CHECK(command.op < CMD_COUNT);
+  FUZZ_CHECK(command.id >= 0);
+  if (binary) FUZZ_CHECK(command.id <= 0xFFFF);
+  checkField(command.ssid, message, size);
+  checkField(command.password, message, size);
+
+  if (status == CMD_OK) {
+    FUZZ_CHECK(command.op != CMD_NONE);
+    uint8_t needs = commandSpecs[command.op].needs;
+    if (needs & CMD_NEEDS_VALUE) FUZZ_CHECK(command.hasValue);
+    if (needs & CMD_NEEDS_SSID) FUZZ_CHECK(command.ssid.length > 0);
+  }
+
+  char ack[ACK_BUFFER_SIZE];
+  size_t length = writeCommandAck(ack, sizeof(ack), command, status);
+  FUZZ_CHECK(length > 0 && length < sizeof(ack));
+  FUZZ_CHECK(memcmp(ack, "{\"action\":\"ack\"", 15) == 0);
+
+  free(message);
+}
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size) {
+  checkParse(data, size, false);
+  checkParse(data, size, true);
+  return 0;
+}
@@ -0,0 +1,233 @@
+/*
+ * Fuzzing driver for compilers without libFuzzer
+ *
+ * Runs LLVMFuzzerTestOneInput() on every corpus file, then on inputs
+ * mutated from them with random byte edits and dictionary tokens. There
+ * is no coverage feedback, so it finds less than libFuzzer, but it takes
+ * the same arguments for the runs, seed, dictionary and corpus:
+ *
+ *   fuzz_command_protocol [-runs=N] [-seed=N] [-max_len=N] [-dict=FILE] [DIR|FILE ...]
+ *
+ * A failed check aborts and a sanitizer error ends the run; either way
+ * the input that did it is written to crash-input for replaying.
+ */
+#include <dirent.h>
+#include <signal.h>
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <algorithm>
+#include <chrono>
+#include <string>
+#include <vector>
+#ifdef __SANITIZE_ADDRESS__
+#include <sanitizer/common_interface_defs.h>
+#define HAVE_SANITIZER_CALLBACK 1
+#endif
+
+extern "C" int LLVMFuzzerTestOneInput(const uint8_t* data, size_t size);
+
+typedef std::vector<uint8_t> Input;
+
+static uint64_t rngState = 1;
+
+static uint64_t nextRandom() {
+  // xorshift64; repeatable for a given -seed
+  rngState ^= rngState << 13;
+  rngState ^= rngState >> 7;
+  rngState ^= rngState << 17;
+  return rngState;
+}
+
+static size_t randomBelow(size_t n) {
+  return n ? (size_t)(nextRandom() % n) : 0;
+}
+
+static bool readFile(const std::string& path, Input& out) {
+  FILE* f = fopen(path.c_str(), "rb");
+  if (!f) return false;
+  out.clear();
+  uint8_t buffer[4096];
+  size_t n;
+  while ((n = fread(buffer, 1, sizeof(buffer), f)) > 0) out.insert(out.end(), buffer, buffer + n);
+  fclose(f);
+  return true;
+}
+
+static void addCorpus(const std::string& path, std::vector<Input>& corpus) {
+  struct stat st;
+  if (stat(path.c_str(), &st) != 0) {
+    fprintf(stderr, "cannot read %s\n", path.c_str());
+    exit(2);
+  }
+  if (!S_ISDIR(st.st_mode)) {
+    Input input;
+    if (readFile(path, input)) corpus.push_back(input);
+    return;
+  }
+
+  DIR* dir = opendir(path.c_str());
+  std::vector<std::string> names;
+  while (struct dirent* entry = readdir(dir)) {
+    if (entry->d_name[0] != '.') names.push_back(entry->d_name);
+  }
+  closedir(dir);
+  // Directory order is not stable across file systems
+  std::sort(names.begin(), names.end());
+  for (const std::string& name : names) addCorpus(path + "/" + name, corpus);
+}
+
+static int hexValue(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+// libFuzzer dictionary: one optional name, then "token" with \\, \" and \xNN escapes
+static void loadDictionary(const char* path, std::vector<Input>& tokens) {
+  FILE* f = fopen(path, "r");
+  if (!f) {
+    fprintf(stderr, "cannot read %s\n", path);
+    exit(2);
+  }
+  char line[1024];
+  while (fgets(line, sizeof(line), f)) {
+    char* p = line;
+    while (*p == ' ' || *p == '\t') p++;
+    if (*p == '#' || *p == '\n' || *p == '\0') continue;
+    p = strchr(p, '"');
+    if (!p) continue;
+
+    Input token;
+    for (p++; *p && *p != '"'; p++) {
+      if (*p != '\\') {
+        token.push_back(*p);
+      } else if (p[1] == 'x' && hexValue(p[2]) >= 0 && hexValue(p[3]) >= 0) {
+        token.push_back(hexValue(p[2]) << 4 | hexValue(p[3]));
+        p += 3;
+      } else if (p[1]) {
+        token.push_back(*++p);
+      }
+    }
+    if (!token.empty()) tokens.push_back(token);
+  }
+  fclose(f);
+}
+
+static void mutate(Input& input, const std::vector<Input>& tokens, size_t maxLength) {
+  int edits = 1 + randomBelow(4);
+  for (int i = 0; i < edits; i++) {
+    size_t at = randomBelow(input.size() + 1);
+    switch (randomBelow(7)) {
+      case 0:  // Flip a bit
+        if (!input.empty()) input[randomBelow(input.size())] ^= 1 << randomBelow(8);
+        break;
+      case 1:  // Set a byte
+        if (!input.empty()) input[randomBelow(input.size())] = (uint8_t)nextRandom();
+        break;
+      case 2:  // Insert a byte
+        input.insert(input.begin() + at, (uint8_t)nextRandom());
+        break;
+      case 3:  // Erase a range
+        if (at < input.size()) {
+          size_t n = 1 + randomBelow(input.size() - at);
+          input.erase(input.begin() + at, input.begin() + at + n);
+        }
+        break;
+      case 4:  // Repeat a range
+        if (at < input.size()) {
+          size_t n = 1 + randomBelow(input.size() - at);
+          Input copy(input.begin() + at, input.begin() + at + n);
+          input.insert(input.begin() + randomBelow(input.size() + 1), copy.begin(), copy.end());
+        }
+        break;
+      case 5:  // Insert a token
+      case 6:  // Overwrite with a token
+        if (!tokens.empty()) {
+          const Input& token = tokens[randomBelow(tokens.size())];
+          if (randomBelow(2) && at + token.size() <= input.size()) {
+            std::copy(token.begin(), token.end(), input.begin() + at);
+          } else {
+            input.insert(input.begin() + at, token.begin(), token.end());
+          }
+        }
+        break;
+    }
+  }
+  if (input.size() > maxLength) input.resize(maxLength);
+}
+
+static Input current;
+
+static void writeCrashInput() {
+  FILE* f = fopen("crash-input", "wb");
+  if (!f) return;
+  fwrite(current.data(), 1, current.size(), f);
+  fclose(f);
+}
+
+static void onAbort(int sig) {
+  writeCrashInput();
+  signal(sig, SIG_DFL);
+  raise(sig);
+}
+
+static void runOne(const Input& input) {
+  current = input;
+  // Exactly sized, so reads past the end are caught
+  uint8_t* data = (uint8_t*)malloc(input.size() ? input.size() : 1);
+  memcpy(data, input.data(), input.size());
+  LLVMFuzzerTestOneInput(data, input.size());
+  free(data);
+}
+
+int main(int argc, char** argv) {
+  uint64_t runs = 1000000;
+  uint64_t seed = 1;
+  size_t maxLength = 512;
+  std::vector<Input> corpus;
+  std::vector<Input> tokens;
+
+  for (int i = 1; i < argc; i++) {
+    const char* arg = argv[i];
+    if (strncmp(arg, "-runs=", 6) == 0) {
+      runs = strtoull(arg + 6, nullptr, 10);
+    } else if (strncmp(arg, "-seed=", 6) == 0) {
+      seed = strtoull(arg + 6, nullptr, 10);
+    } else if (strncmp(arg, "-max_len=", 9) == 0) {
+      maxLength = strtoull(arg + 9, nullptr, 10);
+    } else if (strncmp(arg, "-dict=", 6) == 0) {
+      loadDictionary(arg + 6, tokens);
+    } else if (arg[0] == '-') {
+      fprintf(stderr, "usage: %s [-runs=N] [-seed=N] [-max_len=N] [-dict=FILE] [DIR|FILE ...]\n",
+              argv[0]);
+      return 2;
+    } else {
+      addCorpus(arg, corpus);
+    }
+  }
+  rngState = seed ? seed : 1;
+  if (corpus.empty()) corpus.push_back(Input());
+  signal(SIGABRT, onAbort);
+#if HAVE_SANITIZER_CALLBACK
+  __sanitizer_set_death_callback(writeCrashInput);
+#endif
+
+  auto start = std::chrono::steady_clock::now();
+  for (const Input& input : corpus) runOne(input);
+  Input input;
+  for (uint64_t run = 0; run < runs; run++) {
+    input = corpus[randomBelow(corpus.size())];
+    mutate(input, tokens, maxLength);
+    runOne(input);
+  }
+  double seconds =
+    std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+
+  printf("Done %llu runs over %zu corpus inputs and %zu tokens in %.1f s\n",
+         (unsigned long long)(runs + corpus.size()), corpus.size(), tokens.size(), seconds);
+  return 0;
+}
@@ -0,0 +1,576 @@
+/*
+ * Simulated clock and task scheduler implementation
+ */
+#include "host_sim.h"
+#include <algorithm>
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+#include <pthread.h>
+#include <sched.h>
+#include <unistd.h>
+
+#define FOREVER UINT64_MAX
+#define NS_PER_TICK 1000000ULL
+
+struct tskTaskControlBlock {
+  std::string name;
+  TaskFunction_t code;
+  void* param;
+  uint32_t stackDepth;
+  UBaseType_t priority;
+  BaseType_t core;
+  std::condition_variable cv;
+  bool blocked;      // Waiting in waitLocked()
+  bool suspended;
+  bool deleted;
+  bool notified;     // Woken by another task rather than by the clock
+  uint64_t wakeAt;   // Clock time the wait ends, FOREVER for none
+  uint64_t cpuBase;  // Thread CPU time when the task last started running
+  uint64_t seenNs;   // Latest clock time the task has seen
+};
+
+struct QueueDefinition {
+  UBaseType_t length;
+  UBaseType_t itemSize;
+  std::vector<uint8_t> storage;
+  UBaseType_t head;
+  UBaseType_t count;
+  std::vector<TaskHandle_t> receivers;  // Waiting for an item
+  std::vector<TaskHandle_t> senders;    // Waiting for space
+};
+
+// Everything below is guarded by simMutex, except the clock, which
+// tasks read without it
+static std::mutex simMutex;
+static std::condition_variable controllerCv;
+static std::vector<TaskHandle_t> tasks;
+static std::atomic<uint64_t> clockNs(0);
+static uint64_t horizonNs = 0;
+static int runningTasks = 0;
+static bool active = false;  // Tasks exist; the harness may no longer block
+static std::multimap<uint64_t, std::function<void()>> timers;
+static TaskHandle_t eventTask = nullptr;
+static void (*sketchSetup)() = nullptr;
+static void (*sketchLoop)() = nullptr;
+static std::atomic<void (*)()> clockHook(nullptr);
+
+static thread_local TaskHandle_t currentTask = nullptr;
+static thread_local int criticalNesting = 0;
+
+[[noreturn]] static void fatal(const char* what) {
+  fprintf(stderr, "host sim: %s\n", what);
+  fflush(stdout);
+  _exit(2);
+}
+
+static uint64_t threadCpuNs() {
+  timespec ts;
+  clock_gettime(CLOCK_THREAD_CPUTIME_ID, &ts);
+  return (uint64_t)ts.tv_sec * 1000000000ULL + ts.tv_nsec;
+}
+
+// The clock plus the CPU time the task has used since it last woke,
+// never going backwards for the task
+static uint64_t perceivedNs(TaskHandle_t self) {
+  uint64_t now = clockNs.load() + (threadCpuNs() - self->cpuBase);
+  if (now < self->seenNs) now = self->seenNs;
+  self->seenNs = now;
+  return now;
+}
+
+// ===== SCHEDULING =====
+static uint64_t nextWakeLocked() {
+  uint64_t next = FOREVER;
+  for (TaskHandle_t t : tasks) {
+    if (t->blocked && !t->suspended && t->wakeAt < next) next = t->wakeAt;
+  }
+  return next;
+}
+
+static void wakeLocked(TaskHandle_t task, bool notified) {
+  if (!task->blocked || task->suspended) return;
+  task->blocked = false;
+  task->notified = notified;
+  runningTasks++;
+  task->cv.notify_one();
+}
+
+// Wakes the tasks that are due; once every task waits, moves the clock
+// to the next wake-up within the horizon or hands over to the harness
+static void scheduleLocked() {
+  uint64_t now = clockNs.load();
+  for (TaskHandle_t t : tasks) {
+    if (t->blocked && t->wakeAt <= now) wakeLocked(t, false);
+  }
+  if (runningTasks > 0) return;
+
+  uint64_t next = nextWakeLocked();
+  if (next != FOREVER && next <= horizonNs) {
+    clockNs.store(next);
+    for (TaskHandle_t t : tasks) {
+      if (t->blocked && t->wakeAt <= next) wakeLocked(t, false);
+    }
+  } else {
+    controllerCv.notify_all();
+  }
+}
+
+// Blocks the calling task until wakeAt or an earlier wakeLocked().
+// Returns true if another task woke it.
+static bool waitLocked(std::unique_lock<std::mutex>& lock, TaskHandle_t self, uint64_t wakeAt) {
+  uint64_t seen = perceivedNs(self);
+  if (seen > clockNs.load()) clockNs.store(seen);
+
+  self->blocked = true;
+  self->notified = false;
+  self->wakeAt = wakeAt;
+  runningTasks--;
+  scheduleLocked();
+  self->cv.wait(lock, [self] { return !self->blocked; });
+
+  self->cpuBase = threadCpuNs();
+  if (self->seenNs < clockNs.load()) self->seenNs = clockNs.load();
+  return self->notified;
+}
+
+void hostSimCheckpoint() {
+  TaskHandle_t self = currentTask;
+  if (self == nullptr || !self->suspended || criticalNesting > 0) return;
+  std::unique_lock<std::mutex> lock(simMutex);
+  while (self->suspended) waitLocked(lock, self, FOREVER);
+}
+
+uint64_t hostNowNs() {
+  TaskHandle_t self = currentTask;
+  return self ? perceivedNs(self) : clockNs.load();
+}
+
+void hostSleepNs(uint64_t ns) {
+  TaskHandle_t self = currentTask;
+  if (self == nullptr) {
+    if (active) fatal("the harness cannot block while tasks run; use hostSimRun()");
+    clockNs += ns;
+    return;
+  }
+
+  std::unique_lock<std::mutex> lock(simMutex);
+  uint64_t until = perceivedNs(self) + ns;
+  do {
+    waitLocked(lock, self, until);
+  } while (clockNs.load() < until || self->suspended);
+}
+
+void hostClockAdvance(uint32_t ms) {
+  if (active) fatal("hostClockAdvance() with tasks running; use hostSimRun()");
+  clockNs += ms * NS_PER_TICK;
+}
+
+void hostClockHook(void (*hook)()) {
+  clockHook = hook;
+}
+
+// Called by millis() and micros()
+void hostClockRead() {
+  if (currentTask == nullptr) return;
+  void (*hook)() = clockHook.load();
+  if (hook) hook();
+  hostSimCheckpoint();
+}
+
+// ===== HARNESS =====
+void hostSimRun(uint32_t ms) {
+  if (currentTask) fatal("hostSimRun() called from a task");
+  std::unique_lock<std::mutex> lock(simMutex);
+  horizonNs = clockNs.load() + ms * NS_PER_TICK;
+  scheduleLocked();
+  controllerCv.wait(lock, [] { return runningTasks == 0 && nextWakeLocked() > horizonNs; });
+  if (clockNs.load() < horizonNs) clockNs.store(horizonNs);
+}
+
+static void eventTaskMain(void*) {
+  std::unique_lock<std::mutex> lock(simMutex);
+  for (;;) {
+    auto due = timers.begin();
+    if (due != timers.end() && due->first <= perceivedNs(currentTask)) {
+      std::function<void()> fn = std::move(due->second);
+      timers.erase(due);
+      lock.unlock();
+      fn();
+      lock.lock();
+      continue;
+    }
+    waitLocked(lock, currentTask, due == timers.end() ? FOREVER : due->first);
+  }
+}
+
+static void startEventTask() {
+  if (eventTask) return;
+  xTaskCreatePinnedToCore(eventTaskMain, "sys_evt", 4096, nullptr, 20, &eventTask, 0);
+}
+
+void hostSimAt(uint32_t ms, std::function<void()> fn) {
+  startEventTask();
+  uint64_t at = hostNowNs() + ms * NS_PER_TICK;
+  std::lock_guard<std::mutex> lock(simMutex);
+  timers.emplace(at, std::move(fn));
+  // Let it pick up an earlier deadline
+  wakeLocked(eventTask, true);
+}
+
+static void loopTaskMain(void*) {
+  if (sketchSetup) sketchSetup();
+  for (;;) {
+    if (sketchLoop) sketchLoop();
+    // The core calls loop() back to back; a loop() that never blocks
+    // would stop the simulated clock, so each call costs one tick
+    vTaskDelay(1);
+  }
+}
+
+void hostSimBoot(void (*setup)(), void (*loop)()) {
+  sketchSetup = setup;
+  sketchLoop = loop;
+  startEventTask();
+  xTaskCreatePinnedToCore(loopTaskMain, "loopTask", 8192, nullptr, 1, nullptr, 1);
+}
+
+TaskHandle_t hostTaskFind(const char* name) {
+  std::lock_guard<std::mutex> lock(simMutex);
+  for (TaskHandle_t t : tasks) {
+    if (!t->deleted && t->name == name) return t;
+  }
+  return nullptr;
+}
+
+void hostSimExit(int status) {
+  fflush(stdout);
+  fflush(stderr);
+  _exit(status);
+}
+
+// ===== TASKS =====
+static void* taskThread(void* arg) {
+  TaskHandle_t self = static_cast<TaskHandle_t>(arg);
+  currentTask = self;
+  self->cpuBase = threadCpuNs();
+  pthread_setname_np(pthread_self(), self->name.substr(0, 15).c_str());
+
+  self->code(self->param);
+  // Returning from a task function is an error on FreeRTOS
+  vTaskDelete(nullptr);
+  return nullptr;
+}
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core) {
+  TaskHandle_t task = new tskTaskControlBlock();
+  task->name = name ? name : "";
+  task->code = code;
+  task->param = param;
+  task->stackDepth = stackDepth;
+  task->priority = priority;
+  task->core = core;
+  task->blocked = false;
+  task->suspended = false;
+  task->deleted = false;
+  task->notified = false;
+  task->wakeAt = FOREVER;
+  task->cpuBase = 0;
+  task->seenNs = hostNowNs();
+
+  {
+    std::lock_guard<std::mutex> lock(simMutex);
+    tasks.push_back(task);
+    runningTasks++;
+    active = true;
+  }
+
+  pthread_attr_t attr;
+  pthread_attr_init(&attr);
+  pthread_attr_setdetachstate(&attr, PTHREAD_CREATE_DETACHED);
+  pthread_t thread;
+  if (pthread_create(&thread, &attr, taskThread, task) != 0) fatal("pthread_create failed");
+  pthread_attr_destroy(&attr);
+
+  if (created) *created = task;
+  return pdPASS;
+}
+
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* param, UBaseType_t priority, TaskHandle_t* created) {
+  return xTaskCreatePinnedToCore(code, name, stackDepth, param, priority, created, tskNO_AFFINITY);
+}
+
+void vTaskDelete(TaskHandle_t task) {
+  TaskHandle_t self = currentTask;
+  if (task == nullptr) task = self;
+  if (task == nullptr) fatal("vTaskDelete(NULL) outside a task");
+
+  std::unique_lock<std::mutex> lock(simMutex);
+  // Never woken again; a running task stops at its next checkpoint
+  task->deleted = true;
+  task->suspended = true;
+  if (task != self) return;
+
+  runningTasks--;
+  scheduleLocked();
+  // The thread stays parked until the process exits
+  std::condition_variable parked;
+  for (;;) parked.wait(lock);
+}
+
+void vTaskDelay(TickType_t ticks) {
+  if (ticks == 0) {
+    vTaskYield();
+    return;
+  }
+  hostSleepNs(ticks * NS_PER_TICK);
+}
+
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment) {
+  *previousWake += increment;
+  uint64_t target = *previousWake * NS_PER_TICK;
+  uint64_t now = hostNowNs();
+  if (target > now) {
+    hostSleepNs(target - now);
+  } else {
+    hostSimCheckpoint();
+  }
+}
+
+TickType_t xTaskGetTickCount(void) {
+  return (TickType_t)(hostNowNs() / NS_PER_TICK);
+}
+
+TickType_t xTaskGetTickCountFromISR(void) {
+  return xTaskGetTickCount();
+}
+
+void vTaskSuspend(TaskHandle_t task) {
+  if (task == nullptr) task = currentTask;
+  {
+    std::lock_guard<std::mutex> lock(simMutex);
+    task->suspended = true;
+  }
+  if (task == currentTask) hostSimCheckpoint();
+}
+
+void vTaskResume(TaskHandle_t task) {
+  std::lock_guard<std::mutex> lock(simMutex);
+  if (task->deleted || !task->suspended) return;
+  task->suspended = false;
+  // Let it check whatever it was waiting for again
+  wakeLocked(task, false);
+}
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void) {
+  return currentTask;
+}
+
+char* pcTaskGetName(TaskHandle_t task) {
+  if (task == nullptr) task = currentTask;
+  return task ? &task->name[0] : nullptr;
+}
+
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task) {
+  if (task == nullptr) task = currentTask;
+  return task ? task->priority : 0;
+}
+
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task) {
+  if (task == nullptr) task = currentTask;
+  return task ? task->stackDepth : 0;
+}
+
+void vTaskYield(void) {
+  hostSimCheckpoint();
+  sched_yield();
+}
+
+// ===== CRITICAL SECTIONS =====
+void vPortEnterCritical(portMUX_TYPE* mux) {
+  while (__atomic_exchange_n(&mux->locked, 1, __ATOMIC_ACQUIRE)) sched_yield();
+  criticalNesting++;
+}
+
+void vPortExitCritical(portMUX_TYPE* mux) {
+  criticalNesting--;
+  __atomic_store_n(&mux->locked, 0, __ATOMIC_RELEASE);
+}
+
+BaseType_t xPortGetCoreID(void) {
+  TaskHandle_t self = currentTask;
+  return self && self->core != tskNO_AFFINITY ? self->core : 0;
+}
+
+// ===== QUEUES =====
+// Highest priority waiter first, like the FreeRTOS event lists
+static void wakeWaiter(std::vector<TaskHandle_t>& waiters) {
+  TaskHandle_t best = nullptr;
+  for (TaskHandle_t t : waiters) {
+    if (t->blocked && !t->suspended && (best == nullptr || t->priority > best->priority)) best = t;
+  }
+  if (best) wakeLocked(best, true);
+}
+
+// Waits until ready() holds; false once ticks have run out
+template <typename Ready>
+static bool waitFor(std::unique_lock<std::mutex>& lock, std::vector<TaskHandle_t>& waiters,
+                    TickType_t ticks, Ready ready) {
+  if (ready()) return true;
+  if (ticks == 0) return false;
+
+  TaskHandle_t self = currentTask;
+  if (self == nullptr) {
+    // Single-threaded tests: nothing else can change the queue
+    if (active) fatal("the harness cannot block on a queue while tasks run");
+    if (ticks == portMAX_DELAY) fatal("waiting forever on a queue nothing can change");
+    clockNs += ticks * NS_PER_TICK;
+    return false;
+  }
+
+  uint64_t until = ticks == portMAX_DELAY ? FOREVER : perceivedNs(self) + ticks * NS_PER_TICK;
+  while (!ready()) {
+    if (clockNs.load() >= until) return false;
+    waiters.push_back(self);
+    waitLocked(lock, self, until);
+    waiters.erase(std::remove(waiters.begin(), waiters.end(), self), waiters.end());
+  }
+  return true;
+}
+
+QueueHandle_t xQueueCreate(UBaseType_t length, UBaseType_t itemSize) {
+  QueueHandle_t queue = new QueueDefinition();
+  queue->length = length;
+  queue->itemSize = itemSize;
+  queue->storage.resize((size_t)length * itemSize);
+  queue->head = 0;
+  queue->count = 0;
+  return queue;
+}
+
+void vQueueDelete(QueueHandle_t queue) {
+  delete queue;
+}
+
+static void putItem(QueueHandle_t queue, const void* item, bool front) {
+  UBaseType_t slot;
+  if (front) {
+    queue->head = (queue->head + queue->length - 1) % queue->length;
+    slot = queue->head;
+  } else {
+    slot = (queue->head + queue->count) % queue->length;
+  }
+  if (queue->itemSize && item) {
+    memcpy(&queue->storage[(size_t)slot * queue->itemSize], item, queue->itemSize);
+  }
+  queue->count++;
+  wakeWaiter(queue->receivers);
+}
+
+static BaseType_t queueSend(QueueHandle_t queue, const void* item, TickType_t ticks, bool front) {
+  hostSimCheckpoint();
+  std::unique_lock<std::mutex> lock(simMutex);
+  if (!waitFor(lock, queue->senders, ticks, [queue] { return queue->count < queue->length; })) {
+    return errQUEUE_FULL;
+  }
+  putItem(queue, item, front);
+  return pdTRUE;
+}
+
+static BaseType_t queueReceive(QueueHandle_t queue, void* buffer, TickType_t ticks, bool peek) {
+  hostSimCheckpoint();
+  std::unique_lock<std::mutex> lock(simMutex);
+  if (!waitFor(lock, queue->receivers, ticks, [queue] { return queue->count > 0; })) {
+    return errQUEUE_EMPTY;
+  }
+  if (queue->itemSize && buffer) {
+    memcpy(buffer, &queue->storage[(size_t)queue->head * queue->itemSize], queue->itemSize);
+  }
+  if (!peek) {
+    queue->head = (queue->head + 1) % queue->length;
+    queue->count--;
+    wakeWaiter(queue->senders);
+  }
+  return pdTRUE;
+}
+
+BaseType_t xQueueSend(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  return queueSend(queue, item, ticks, false);
+}
+
+BaseType_t xQueueSendToBack(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  return queueSend(queue, item, ticks, false);
+}
+
+BaseType_t xQueueSendToFront(QueueHandle_t queue, const void* item, TickType_t ticks) {
+  return queueSend(queue, item, ticks, true);
+}
+
+BaseType_t xQueueOverwrite(QueueHandle_t queue, const void* item) {
+  hostSimCheckpoint();
+  std::lock_guard<std::mutex> lock(simMutex);
+  if (queue->count == queue->length) {
+    queue->count--;
+  }
+  putItem(queue, item, false);
+  return pdPASS;
+}
+
+BaseType_t xQueueReceive(QueueHandle_t queue, void* buffer, TickType_t ticks) {
+  return queueReceive(queue, buffer, ticks, false);
+}
+
+BaseType_t xQueuePeek(QueueHandle_t queue, void* buffer, TickType_t ticks) {
+  return queueReceive(queue, buffer, ticks, true);
+}
+
+BaseType_t xQueueSendFromISR(QueueHandle_t queue, const void* item, BaseType_t* woken) {
+  if (woken) *woken = pdFALSE;
+  std::unique_lock<std::mutex> lock(simMutex);
+  if (queue->count == queue->length) return errQUEUE_FULL;
+  putItem(queue, item, false);
+  return pdTRUE;
+}
+
+BaseType_t xQueueReceiveFromISR(QueueHandle_t queue, void* buffer, BaseType_t* woken) {
+  if (woken) *woken = pdFALSE;
+  return queueReceive(queue, buffer, 0, false);
+}
+
+BaseType_t xQueueReset(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(simMutex);
+  queue->head = 0;
+  queue->count = 0;
+  wakeWaiter(queue->senders);
+  return pdPASS;
+}
+
+UBaseType_t uxQueueMessagesWaiting(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(simMutex);
+  return queue->count;
+}
+
+UBaseType_t uxQueueSpacesAvailable(QueueHandle_t queue) {
+  std::lock_guard<std::mutex> lock(simMutex);
+  return queue->length - queue->count;
+}
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void) {
+  return xSemaphoreCreateCounting(1, 1);
+}
+
+SemaphoreHandle_t xSemaphoreCreateBinary(void) {
+  return xSemaphoreCreateCounting(1, 0);
+}
+
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount) {
+  QueueHandle_t queue = xQueueCreate(maxCount, 0);
+  queue->count = initialCount;
+  return queue;
+}
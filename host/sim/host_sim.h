@@ -0,0 +1,70 @@
+/*
+ * Simulated clock and task scheduler for the host build
+ *
+ * The firmware's FreeRTOS tasks run as host threads against a simulated
+ * clock. The clock only moves when every task is blocked: it then jumps
+ * to the earliest wake-up, whether that is a vTaskDelay(), a queue
+ * timeout, a delay(), a modeled I2C or sensor transfer or an event
+ * scheduled with hostSimAt(). The CPU time a task spends between two
+ * blocking calls is added to the time it sees, and pushes the clock on
+ * when it blocks, so loop passes and timed regions measure the host's
+ * compute time plus every wait the firmware would sit through.
+ *
+ * Priorities and cores are recorded but not enforced; the host runs the
+ * tasks in parallel. Host compute is not ESP32 compute either, so
+ * absolute figures compare host runs with each other, not with the
+ * device. Waits are modeled after the device and dominate most paths.
+ *
+ * The harness thread (main()) is not a task: it starts the sketch with
+ * hostSimBoot(), then alternates between hostSimRun() and poking the
+ * simulated peripherals while every task is blocked. Without a booted
+ * sketch or tasks, unit tests get a plain fake clock that moves only
+ * through delay() and hostClockAdvance().
+ *
+ *   hostSimBoot(setup, loop);
+ *   hostSimRun(10000);            // the first 10 s after reset
+ *   hostPinSet(PIR_PIN, HIGH);    // motion
+ *   hostSimRun(1000);
+ *   hostSimExit(failures != 0);
+ */
+#ifndef HOST_SIM_H
+#define HOST_SIM_H
+
+#include <Arduino.h>
+#include <functional>
+
+// Starts setup() and then loop() on the "loopTask" task, like the core
+void hostSimBoot(void (*setup)(), void (*loop)());
+
+// Lets the tasks run until the clock has moved ms further. Returns with
+// every task blocked, so the harness can inspect and change state.
+void hostSimRun(uint32_t ms);
+
+// Runs fn on the system event task once ms have passed, as the WiFi
+// driver and peripheral interrupts do on the device
+void hostSimAt(uint32_t ms, std::function<void()> fn);
+
+// Clock time seen by the caller, in nanoseconds
+uint64_t hostNowNs();
+
+// Blocks the calling task for ns of simulated time; outside a booted
+// simulation it moves the clock instead
+void hostSleepNs(uint64_t ns);
+
+// Moves the clock of a single-threaded test
+void hostClockAdvance(uint32_t ms);
+
+// Called on every millis() and micros() from a task; tests use it to
+// stop a task at an exact point
+void hostClockHook(void (*hook)());
+
+// Returns at a task's clock reads and blocking calls while it is
+// suspended; called by the clock functions
+void hostSimCheckpoint();
+
+TaskHandle_t hostTaskFind(const char* name);
+
+// Ends the process without tearing down the task threads
+[[noreturn]] void hostSimExit(int status);
+
+#endif // HOST_SIM_H
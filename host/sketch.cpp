@@ -0,0 +1,65 @@
+/*
+ * The firmware sketch compiled for the host
+ */
+#include "../esp32/esp32.ino"
+#include "sketch.h"
+
+const uint8_t hostPirPin = HubConfig::pirPin;
+const uint8_t hostLed1Pin = actuators[0].pin;
+const uint16_t hostLocalPort = HubConfig::localPort;
+const uint32_t hostNetLoopBudget = HUB_NET_LOOP_BUDGET;
+const uint32_t hostActuatorQueueLength = HUB_ACTUATOR_QUEUE_LENGTH;
+
+bool hostSketchWifiConnected() {
+  return hub.wifiConnected();
+}
+
+bool hostSketchApiConnected() {
+  return hub.apiConnected();
+}
+
+QueueHandle_t hostSketchActuatorQueue() {
+  return hub.actuatorQueue();
+}
+
+QueueHandle_t hostSketchDisplayQueue() {
+  return hub.displayQueue();
+}
+
+uint32_t hostSketchDroppedCommands() {
+  return hub.droppedCommands();
+}
+
+int hostSketchLed1() {
+  return hub.actuator(0);
+}
+
+bool hostSketchLed2() {
+  return hub.actuator(1);
+}
+
+bool hostSketchLed3() {
+  return hub.actuator(2);
+}
+
+float hostSketchTemperature() {
+  return hub.temperature();
+}
+
+void hostSketchSetupLcd() {
+  hub.display().begin();
+}
+
+void hostSketchShowNormalScreen(float temperature, float humidity, bool motion, int led1,
+                                bool led2, bool led3) {
+  DisplayFrame frame;
+  frame.state = NORMAL_OPERATION;
+  frame.temperature = temperature;
+  frame.humidity = humidity;
+  frame.motion = motion;
+  frame.wifiConnected = true;
+  frame.actuators[0] = led1;
+  frame.actuators[1] = led2;
+  frame.actuators[2] = led3;
+  hub.display().draw(frame);
+}
@@ -0,0 +1,43 @@
+/*
+ * The firmware sketch (esp32/esp32.ino) compiled for the host
+ *
+ * sketch.cpp includes the sketch as a single translation unit, as the
+ * Arduino builder does, and exposes the pins and the state the host
+ * tests and benchmarks look at. Call these only between hostSimRun()
+ * calls, while every task is blocked. The firmware itself is HubApp
+ * (libraries/HubCore/src/hub_app.h) configured by the sketch.
+ */
+#ifndef HOST_SKETCH_H
+#define HOST_SKETCH_H
+
+#include <Arduino.h>
+
+void setup();
+void loop();
+
+extern const uint8_t hostPirPin;
+extern const uint8_t hostLed1Pin;
+extern const uint16_t hostLocalPort;   // Local WebSocket server
+extern const uint32_t hostNetLoopBudget;
+
+bool hostSketchWifiConnected();
+bool hostSketchApiConnected();
+
+// The task graph: LED commands to the io task, frames to the display task
+extern const uint32_t hostActuatorQueueLength;
+QueueHandle_t hostSketchActuatorQueue();
+QueueHandle_t hostSketchDisplayQueue();
+uint32_t hostSketchDroppedCommands();
+
+int hostSketchLed1();
+bool hostSketchLed2();
+bool hostSketchLed3();
+float hostSketchTemperature();
+
+// The LCD without the display task, for tests that do not boot the
+// sketch: HubDisplay::begin(), then draw() with the normal-operation screen
+void hostSketchSetupLcd();
+void hostSketchShowNormalScreen(float temperature, float humidity, bool motion, int led1,
+                                bool led2, bool led3);
+
+#endif // HOST_SKETCH_H
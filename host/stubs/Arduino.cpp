@@ -0,0 +1,339 @@
+/*
+ * Arduino-ESP32 core for the host build, implementation
+ */
+#include <Arduino.h>
+#include <atomic>
+#include <mutex>
+#include <malloc.h>
+#include <unistd.h>
+#include "host_sim.h"
+#include "driver/ledc.h"
+#include "esp_heap_caps.h"
+#include "rom/gpio.h"
+
+void hostClockRead();
+
+// ===== TIME =====
+unsigned long millis() {
+  hostClockRead();
+  return (unsigned long)(hostNowNs() / 1000000ULL);
+}
+
+unsigned long micros() {
+  hostClockRead();
+  return (unsigned long)(hostNowNs() / 1000ULL);
+}
+
+void delay(uint32_t ms) {
+  hostSleepNs((uint64_t)ms * 1000000ULL);
+}
+
+// Busy-waits on the device; the waiting is what matters here
+void delayMicroseconds(uint32_t us) {
+  hostSleepNs((uint64_t)us * 1000ULL);
+}
+
+void yield() {
+  vTaskYield();
+}
+
+void configTime(long gmtOffset, int daylightOffset, const char* server1, const char* server2,
+                const char* server3) {}
+
+// ===== SERIAL =====
+HardwareSerial Serial;
+static std::atomic<bool> serialEcho(true);
+static std::mutex serialMutex;
+
+size_t HardwareSerial::write(uint8_t c) {
+  return write(&c, 1);
+}
+
+size_t HardwareSerial::write(const uint8_t* buffer, size_t size) {
+  if (serialEcho) {
+    std::lock_guard<std::mutex> lock(serialMutex);
+    fwrite(buffer, 1, size, stdout);
+  }
+  return size;
+}
+
+void HardwareSerial::flush() {
+  fflush(stdout);
+}
+
+void hostSerialEcho(bool on) {
+  serialEcho = on;
+}
+
+// ===== GPIO =====
+#define PIN_COUNT 40
+
+struct PinState {
+  uint8_t mode;
+  int level;
+  void (*handler)(void*);
+  void* arg;
+  int edges;
+};
+
+static PinState pins[PIN_COUNT];
+static std::atomic<uint64_t> inputLevels(0);
+
+void pinMode(uint8_t pin, uint8_t mode) {
+  if (pin < PIN_COUNT) pins[pin].mode = mode;
+}
+
+void digitalWrite(uint8_t pin, uint8_t val) {
+  if (pin < PIN_COUNT) pins[pin].level = val ? HIGH : LOW;
+}
+
+int digitalRead(uint8_t pin) {
+  if (pin >= PIN_COUNT) return LOW;
+  return (int)((inputLevels.load() >> pin) & 1);
+}
+
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode) {
+  if (pin >= PIN_COUNT) return;
+  pins[pin].handler = handler;
+  pins[pin].arg = arg;
+  pins[pin].edges = mode;
+}
+
+void detachInterrupt(uint8_t pin) {
+  if (pin < PIN_COUNT) pins[pin].handler = nullptr;
+}
+
+void hostPinSet(uint8_t pin, int level) {
+  if (pin >= PIN_COUNT) return;
+  uint64_t bit = 1ULL << pin;
+  uint64_t before = inputLevels.load();
+  bool wasHigh = (before & bit) != 0;
+  if (wasHigh == (level != LOW)) return;
+  if (level != LOW) {
+    inputLevels |= bit;
+  } else {
+    inputLevels &= ~bit;
+  }
+
+  PinState& state = pins[pin];
+  bool rising = level != LOW;
+  if (state.handler && (state.edges == CHANGE || (state.edges == RISING) == rising)) {
+    state.handler(state.arg);
+  }
+}
+
+int hostPinGet(uint8_t pin) {
+  return pin < PIN_COUNT ? pins[pin].level : LOW;
+}
+
+uint32_t gpio_input_get(void) {
+  return (uint32_t)inputLevels.load();
+}
+
+uint32_t gpio_input_get_high(void) {
+  return (uint32_t)(inputLevels.load() >> 32);
+}
+
+// ===== LEDC =====
+#define LEDC_CHANNELS 16
+
+struct LedcChannel {
+  uint32_t duty;
+  uint32_t target;     // Duty a running fade ends at
+  uint32_t fadeMs;
+  uint32_t generation; // Bumped to cancel a fade in flight
+  ledc_cb_t callback;
+  void* arg;
+};
+
+static LedcChannel ledc[LEDC_CHANNELS];
+static std::mutex ledcMutex;
+static bool fadeInstalled = false;
+
+static LedcChannel& ledcAt(ledc_mode_t mode, ledc_channel_t channel) {
+  return ledc[(mode * 8 + channel) % LEDC_CHANNELS];
+}
+
+double ledcSetup(uint8_t channel, double freq, uint8_t resolutionBits) {
+  return freq;
+}
+
+void ledcAttachPin(uint8_t pin, uint8_t channel) {}
+
+void ledcWrite(uint8_t channel, uint32_t duty) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  ledc[channel % LEDC_CHANNELS].duty = duty;
+  ledc[channel % LEDC_CHANNELS].generation++;
+}
+
+uint32_t ledcRead(uint8_t channel) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  return ledc[channel % LEDC_CHANNELS].duty;
+}
+
+esp_err_t ledc_fade_func_install(int intrAllocFlags) {
+  if (fadeInstalled) return ESP_ERR_INVALID_STATE;
+  fadeInstalled = true;
+  return ESP_OK;
+}
+
+esp_err_t ledc_cb_register(ledc_mode_t mode, ledc_channel_t channel, ledc_cbs_t* cbs, void* arg) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  ledcAt(mode, channel).callback = cbs->fade_cb;
+  ledcAt(mode, channel).arg = arg;
+  return ESP_OK;
+}
+
+uint32_t ledc_get_duty(ledc_mode_t mode, ledc_channel_t channel) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  return ledcAt(mode, channel).duty;
+}
+
+esp_err_t ledc_set_duty(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  ledcAt(mode, channel).target = duty;
+  ledcAt(mode, channel).fadeMs = 0;
+  return ESP_OK;
+}
+
+esp_err_t ledc_update_duty(ledc_mode_t mode, ledc_channel_t channel) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  LedcChannel& ch = ledcAt(mode, channel);
+  ch.duty = ch.target;
+  ch.generation++;
+  return ESP_OK;
+}
+
+esp_err_t ledc_set_fade_with_time(ledc_mode_t mode, ledc_channel_t channel, uint32_t duty,
+                                  int maxFadeTimeMs) {
+  std::lock_guard<std::mutex> lock(ledcMutex);
+  ledcAt(mode, channel).target = duty;
+  ledcAt(mode, channel).fadeMs = maxFadeTimeMs;
+  return ESP_OK;
+}
+
+// The fade unit ends the ramp on its own and raises the end event
+esp_err_t ledc_fade_start(ledc_mode_t mode, ledc_channel_t channel, ledc_fade_mode_t fadeMode) {
+  uint32_t generation, fadeMs;
+  {
+    std::lock_guard<std::mutex> lock(ledcMutex);
+    LedcChannel& ch = ledcAt(mode, channel);
+    generation = ++ch.generation;
+    fadeMs = ch.fadeMs;
+  }
+  hostSimAt(fadeMs, [mode, channel, generation] {
+    ledc_cb_t callback;
+    void* arg;
+    {
+      std::lock_guard<std::mutex> lock(ledcMutex);
+      LedcChannel& ch = ledcAt(mode, channel);
+      if (ch.generation != generation) return;
+      ch.duty = ch.target;
+      callback = ch.callback;
+      arg = ch.arg;
+    }
+    if (callback) {
+      ledc_cb_param_t param = { LEDC_FADE_END_EVT, (uint32_t)mode * 8 + channel, 0, 0 };
+      callback(&param, arg);
+    }
+  });
+  return ESP_OK;
+}
+
+// ===== RANDOM =====
+static uint32_t randomState = 0x2545F491;
+
+extern "C" uint32_t esp_random(void) {
+  // xorshift32; repeatable runs matter more than quality here
+  static std::mutex randomMutex;
+  std::lock_guard<std::mutex> lock(randomMutex);
+  randomState ^= randomState << 13;
+  randomState ^= randomState >> 17;
+  randomState ^= randomState << 5;
+  return randomState;
+}
+
+long random(long max) {
+  if (max <= 0) return 0;
+  return (long)(esp_random() % (uint64_t)max);
+}
+
+long random(long min, long max) {
+  if (min >= max) return min;
+  return random(max - min) + min;
+}
+
+void randomSeed(unsigned long seed) {
+  if (seed != 0) randomState = (uint32_t)seed;
+}
+
+// ===== ESP =====
+EspClass ESP;
+
+uint32_t EspClass::getCycleCount() {
+  return (uint32_t)(hostNowNs() * getCpuFreqMHz() / 1000);
+}
+
+// The ESP32's internal heap as a fixed-size arena over the host heap
+#define HOST_HEAP_SIZE (320 * 1024)
+
+static size_t hostHeapUsed() {
+  struct mallinfo2 info = mallinfo2();
+  return info.uordblks;
+}
+
+uint32_t EspClass::getHeapSize() {
+  return HOST_HEAP_SIZE;
+}
+
+uint32_t EspClass::getFreeHeap() {
+  size_t used = hostHeapUsed();
+  return used < HOST_HEAP_SIZE ? HOST_HEAP_SIZE - used : 0;
+}
+
+uint32_t EspClass::getMinFreeHeap() {
+  return getFreeHeap();
+}
+
+uint32_t EspClass::getMaxAllocHeap() {
+  return getFreeHeap();
+}
+
+void EspClass::restart() {
+  Serial.println("ESP.restart()");
+  hostSimExit(3);
+}
+
+void heap_caps_get_info(multi_heap_info_t* info, uint32_t caps) {
+  memset(info, 0, sizeof(*info));
+  size_t used = hostHeapUsed();
+  info->total_allocated_bytes = used;
+  info->total_free_bytes = used < HOST_HEAP_SIZE ? HOST_HEAP_SIZE - used : 0;
+  info->largest_free_block = info->total_free_bytes;
+  info->minimum_free_bytes = info->total_free_bytes;
+  // glibc does not count blocks; allocation counts come from mem_stats
+  info->allocated_blocks = 0;
+}
+
+size_t heap_caps_get_free_size(uint32_t caps) {
+  return ESP.getFreeHeap();
+}
+
+// ===== STRINGS =====
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+extern "C" size_t strlcpy(char* dst, const char* src, size_t size) {
+  size_t length = strlen(src);
+  if (size) {
+    size_t n = length < size - 1 ? length : size - 1;
+    memcpy(dst, src, n);
+    dst[n] = '\0';
+  }
+  return length;
+}
+
+extern "C" size_t strlcat(char* dst, const char* src, size_t size) {
+  size_t used = strnlen(dst, size);
+  if (used == size) return size + strlen(src);
+  return used + strlcpy(dst + used, src, size - used);
+}
+#endif
@@ -0,0 +1,144 @@
+/*
+ * Arduino-ESP32 core for the host build
+ *
+ * The subset of the Arduino-ESP32 2.x core the firmware uses, on top of
+ * the simulated clock and tasks in host/sim. Types and macros follow the
+ * core's own headers; on the host, long is 64 bits wide.
+ */
+#ifndef ARDUINO_H
+#define ARDUINO_H
+
+#include <stdint.h>
+#include <stdbool.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+#include <stdio.h>
+#include <stdarg.h>
+#include <math.h>
+#include <time.h>
+
+#ifdef __cplusplus
+#include <algorithm>
+#include <cmath>
+#endif
+
+#include "esp_attr.h"
+#include "esp_err.h"
+#include "pgmspace.h"
+#include "freertos/FreeRTOS.h"
+#include "freertos/task.h"
+#include "freertos/queue.h"
+#include "freertos/semphr.h"
+
+#ifdef __cplusplus
+using std::isinf;
+using std::isnan;
+using std::max;
+using std::min;
+#endif
+
+// ===== CONSTANTS =====
+#define HIGH 0x1
+#define LOW 0x0
+
+#define INPUT 0x01
+#define OUTPUT 0x03
+#define PULLUP 0x04
+#define INPUT_PULLUP 0x05
+#define PULLDOWN 0x08
+#define INPUT_PULLDOWN 0x09
+
+#define RISING 0x01
+#define FALLING 0x02
+#define CHANGE 0x03
+
+#define PI 3.1415926535897932384626433832795
+#define DEC 10
+#define HEX 16
+#define OCT 8
+#define BIN 2
+
+#define constrain(amt, low, high) ((amt) < (low) ? (low) : ((amt) > (high) ? (high) : (amt)))
+#define digitalPinToInterrupt(p) (p)
+#define bit(b) (1UL << (b))
+#define bitRead(value, b) (((value) >> (b)) & 0x01)
+
+typedef bool boolean;
+typedef uint8_t byte;
+typedef unsigned int word;
+
+// newlib has strlcpy; glibc only from 2.38
+#if defined(__GLIBC__) && (__GLIBC__ < 2 || (__GLIBC__ == 2 && __GLIBC_MINOR__ < 38))
+#ifdef __cplusplus
+extern "C" {
+#endif
+size_t strlcpy(char* dst, const char* src, size_t size);
+size_t strlcat(char* dst, const char* src, size_t size);
+#ifdef __cplusplus
+}
+#endif
+#endif
+
+#ifdef __cplusplus
+
+#include "WString.h"
+#include "Print.h"
+#include "Stream.h"
+#include "IPAddress.h"
+#include "HardwareSerial.h"
+
+// ===== TIME =====
+// Simulated time, see host/sim/host_sim.h
+unsigned long millis();
+unsigned long micros();
+void delay(uint32_t ms);
+void delayMicroseconds(uint32_t us);
+void yield();
+// SNTP is not simulated; time() is the host's wall clock
+void configTime(long gmtOffset, int daylightOffset, const char* server1,
+                const char* server2 = nullptr, const char* server3 = nullptr);
+
+// ===== GPIO =====
+void pinMode(uint8_t pin, uint8_t mode);
+void digitalWrite(uint8_t pin, uint8_t val);
+int digitalRead(uint8_t pin);
+void attachInterruptArg(uint8_t pin, void (*handler)(void*), void* arg, int mode);
+void detachInterrupt(uint8_t pin);
+
+// ===== LEDC =====
+double ledcSetup(uint8_t channel, double freq, uint8_t resolutionBits);
+void ledcAttachPin(uint8_t pin, uint8_t channel);
+void ledcWrite(uint8_t channel, uint32_t duty);
+uint32_t ledcRead(uint8_t channel);
+
+// ===== RANDOM =====
+long random(long max);
+long random(long min, long max);
+void randomSeed(unsigned long seed);
+extern "C" uint32_t esp_random(void);
+
+// ===== ESP =====
+class EspClass {
+ public:
+  // Cycles of a 240 MHz core on the simulated clock
+  uint32_t getCycleCount();
+  uint32_t getCpuFreqMHz() { return 240; }
+  uint32_t getHeapSize();
+  uint32_t getFreeHeap();
+  uint32_t getMinFreeHeap();
+  uint32_t getMaxAllocHeap();
+  void restart();
+};
+extern EspClass ESP;
+
+// ===== HOST CONTROL =====
+// Sets an input pin as the sensor wired to it would; runs the pin's
+// interrupt handler on the calling thread when the level changes
+void hostPinSet(uint8_t pin, int level);
+// Level last written to an output pin
+int hostPinGet(uint8_t pin);
+
+#endif // __cplusplus
+
+#endif // ARDUINO_H
@@ -0,0 +1,7 @@
+/*
+ * AsyncTCP for the host build; ESPAsyncWebServer.h has everything used
+ */
+#ifndef ASYNC_TCP_H
+#define ASYNC_TCP_H
+
+#endif // ASYNC_TCP_H
@@ -0,0 +1,49 @@
+/*
+ * Adafruit DHT sensor library for the host build, implementation
+ */
+#include "DHT.h"
+#include "host_sim.h"
+
+// Start signal plus response and 40 bits
+#define DHT_READ_NS (23ULL * 1000000ULL)
+#define DHT_MIN_INTERVAL_NS (2000ULL * 1000000ULL)
+
+HostDht hostDht = { 22.5f, 55.0f, false, 0 };
+
+DHT::DHT(uint8_t pin, uint8_t type, uint8_t count)
+  : pin_(pin), type_(type), lastReadNs_(0), lastResult_(false), temperature_(NAN), humidity_(NAN) {}
+
+void DHT::begin(uint8_t usec) {
+  // The first read is never served from the cache
+  lastReadNs_ = 0;
+  lastResult_ = false;
+}
+
+// The clock is read with hostNowNs() so that tests hooking millis() only
+// see the firmware's own reads
+bool DHT::read(bool force) {
+  uint64_t now = hostNowNs();
+  if (!force && lastReadNs_ != 0 && now - lastReadNs_ < DHT_MIN_INTERVAL_NS) return lastResult_;
+
+  hostSleepNs(DHT_READ_NS);
+  lastReadNs_ = hostNowNs();
+  hostDht.reads++;
+  lastResult_ = !hostDht.fail;
+  if (lastResult_) {
+    // DHT11 resolution
+    float scale = type_ == DHT11 ? 10.0f : 1.0f;
+    temperature_ = roundf(hostDht.temperature * scale) / scale;
+    humidity_ = roundf(hostDht.humidity);
+  }
+  return lastResult_;
+}
+
+float DHT::readTemperature(bool S, bool force) {
+  if (!read(force)) return NAN;
+  return S ? temperature_ * 1.8f + 32 : temperature_;
+}
+
+float DHT::readHumidity(bool force) {
+  if (!read(force)) return NAN;
+  return humidity_;
+}
@@ -0,0 +1,46 @@
+/*
+ * Adafruit DHT sensor library for the host build
+ *
+ * A bus read takes as long as a DHT11 transaction (the 18 ms start
+ * signal plus the 40 data bits) and returns hostDht. Like the library,
+ * reads within 2 s of the last one return the cached values.
+ */
+#ifndef DHT_H
+#define DHT_H
+
+#include <Arduino.h>
+
+#define DHT11 11
+#define DHT12 12
+#define DHT22 22
+#define DHT21 21
+#define AM2301 21
+
+class DHT {
+ public:
+  DHT(uint8_t pin, uint8_t type, uint8_t count = 6);
+  void begin(uint8_t usec = 55);
+  float readTemperature(bool S = false, bool force = false);
+  float readHumidity(bool force = false);
+  bool read(bool force = false);
+
+ private:
+  uint8_t pin_;
+  uint8_t type_;
+  uint64_t lastReadNs_;
+  bool lastResult_;
+  float temperature_;
+  float humidity_;
+};
+
+// ===== HOST CONTROL =====
+struct HostDht {
+  float temperature;
+  float humidity;
+  bool fail;       // Reads time out and return NAN
+  uint32_t reads;  // Bus transactions so far
+};
+
+extern HostDht hostDht;
+
+#endif // DHT_H
@@ -0,0 +1,29 @@
+/*
+ * Arduino-ESP32 DNSServer for the host build; answers nothing
+ */
+#ifndef DNSServer_h
+#define DNSServer_h
+
+#include <Arduino.h>
+
+class DNSServer {
+ public:
+  DNSServer() : running_(false), ttl_(60) {}
+
+  void processNextRequest() {}
+  void setTTL(const uint32_t ttl) { ttl_ = ttl; }
+  bool start(const uint16_t port, const String& domainName, const IPAddress& resolvedIP) {
+    running_ = true;
+    return true;
+  }
+  void stop() { running_ = false; }
+
+  // Host only
+  bool running() const { return running_; }
+
+ private:
+  bool running_;
+  uint32_t ttl_;
+};
+
+#endif // DNSServer_h
@@ -0,0 +1,129 @@
+/*
+ * ESPAsyncWebServer for the host build, implementation
+ */
+#include "ESPAsyncWebServer.h"
+#include "host_sim.h"
+
+// The server hostHttpRequest() talks to
+static AsyncWebServer* httpServer = nullptr;
+
+// ===== REQUEST =====
+AsyncWebServerRequest::AsyncWebServerRequest(WebRequestMethod method, const String& url,
+                                             const HostHttpFields& params, const HostHttpFields& headers,
+                                             HostHttpReply& reply)
+  : method_(method), url_(url), headers_(headers), reply_(reply) {
+  for (const auto& param : params) params_.emplace_back(param.first, param.second, method == HTTP_POST);
+}
+
+AsyncWebServerRequest::~AsyncWebServerRequest() {
+  reply_.done = true;
+}
+
+bool AsyncWebServerRequest::hasHeader(const String& name) const {
+  for (const auto& header : headers_) {
+    if (header.first.equalsIgnoreCase(name)) return true;
+  }
+  return false;
+}
+
+String AsyncWebServerRequest::header(const char* name) const {
+  for (const auto& header : headers_) {
+    if (header.first.equalsIgnoreCase(name)) return header.second;
+  }
+  return String();
+}
+
+bool AsyncWebServerRequest::hasParam(const String& name, bool post) const {
+  return getParam(name, post) != nullptr;
+}
+
+const AsyncWebParameter* AsyncWebServerRequest::getParam(const String& name, bool post) const {
+  for (const auto& param : params_) {
+    if (param.name() == name && param.isPost() == post) return &param;
+  }
+  return nullptr;
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse(int code, const String& contentType,
+                                                             const String& content) {
+  return new AsyncWebServerResponse(code, contentType, content);
+}
+
+AsyncWebServerResponse* AsyncWebServerRequest::beginResponse_P(int code, const String& contentType,
+                                                               const uint8_t* content, size_t len) {
+  return new AsyncWebServerResponse(code, contentType, String((const char*)content, len));
+}
+
+void AsyncWebServerRequest::send(AsyncWebServerResponse* response) {
+  reply_.code = response->code;
+  reply_.contentType = response->contentType;
+  reply_.body = response->content;
+  reply_.headers = response->headers;
+  delete response;
+}
+
+void AsyncWebServerRequest::send(int code, const String& contentType, const String& content) {
+  send(beginResponse(code, contentType, content));
+}
+
+void AsyncWebServerRequest::redirect(const String& url) {
+  AsyncWebServerResponse* response = beginResponse(302);
+  response->addHeader("Location", url);
+  send(response);
+}
+
+// ===== SERVER =====
+AsyncWebServer::AsyncWebServer(uint16_t port) : port_(port), running_(false) {
+  if (port == 80) httpServer = this;
+}
+
+AsyncWebServer::~AsyncWebServer() {
+  if (httpServer == this) httpServer = nullptr;
+}
+
+void AsyncWebServer::begin() {
+  running_ = true;
+}
+
+void AsyncWebServer::end() {
+  running_ = false;
+}
+
+void AsyncWebServer::on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction onRequest) {
+  routes_.push_back({ uri, method, onRequest });
+}
+
+void AsyncWebServer::handle(AsyncWebServerRequest* request) {
+  if (!running_) return;
+  for (const Route& route : routes_) {
+    if (route.uri == request->url() && (route.method & request->method())) {
+      route.handler(request);
+      return;
+    }
+  }
+  if (notFound_) {
+    notFound_(request);
+  } else {
+    request->send(404);
+  }
+}
+
+// ===== HOST CONTROL =====
+String HostHttpReply::header(const char* name) const {
+  for (const auto& header : headers) {
+    if (header.first.equalsIgnoreCase(name)) return header.second;
+  }
+  return String();
+}
+
+void hostHttpRequest(WebRequestMethod method, const char* url, const HostHttpFields& params,
+                     HostHttpReply& reply, const HostHttpFields& headers) {
+  reply.done = false;
+  reply.code = 0;
+  String path(url);
+  hostSimAt(0, [method, path, params, headers, &reply] {
+    if (httpServer == nullptr) return;
+    AsyncWebServerRequest request(method, path, params, headers, reply);
+    httpServer->handle(&request);
+  });
+}
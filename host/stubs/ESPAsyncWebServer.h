@@ -0,0 +1,142 @@
+/*
+ * ESPAsyncWebServer for the host build
+ *
+ * Handlers are registered as with the library. There is no socket: the
+ * harness issues requests with hostHttpRequest(), which runs the handler
+ * on the system event task like AsyncTCP runs it on the device, and
+ * collects the response there.
+ *
+ *   HostHttpReply reply;
+ *   hostHttpRequest(HTTP_POST, "/connect", { { "ssid", "home" } }, reply);
+ *   hostSimRun(10);
+ *   // reply.code == 200, reply.body == "{\"success\":true,...}"
+ */
+#ifndef _ESPAsyncWebServer_H_
+#define _ESPAsyncWebServer_H_
+
+#include <Arduino.h>
+#include <functional>
+#include <utility>
+#include <vector>
+#include "AsyncTCP.h"
+
+typedef enum {
+  HTTP_GET = 0b00000001,
+  HTTP_POST = 0b00000010,
+  HTTP_DELETE = 0b00000100,
+  HTTP_PUT = 0b00001000,
+  HTTP_PATCH = 0b00010000,
+  HTTP_HEAD = 0b00100000,
+  HTTP_OPTIONS = 0b01000000,
+  HTTP_ANY = 0b01111111,
+} WebRequestMethod;
+
+typedef std::vector<std::pair<String, String>> HostHttpFields;
+
+class AsyncWebParameter {
+ public:
+  AsyncWebParameter(const String& name, const String& value, bool post)
+    : name_(name), value_(value), post_(post) {}
+  const String& name() const { return name_; }
+  const String& value() const { return value_; }
+  bool isPost() const { return post_; }
+
+ private:
+  String name_;
+  String value_;
+  bool post_;
+};
+
+class AsyncWebServerResponse {
+ public:
+  AsyncWebServerResponse(int code, const String& contentType, const String& content)
+    : code(code), contentType(contentType), content(content) {}
+  void addHeader(const String& name, const String& value) { headers.push_back({ name, value }); }
+
+  int code;
+  String contentType;
+  String content;
+  HostHttpFields headers;
+};
+
+struct HostHttpReply;
+
+class AsyncWebServerRequest {
+ public:
+  AsyncWebServerRequest(WebRequestMethod method, const String& url, const HostHttpFields& params,
+                        const HostHttpFields& headers, HostHttpReply& reply);
+  ~AsyncWebServerRequest();
+
+  WebRequestMethod method() const { return method_; }
+  const String& url() const { return url_; }
+
+  bool hasHeader(const String& name) const;
+  String header(const char* name) const;
+  bool hasParam(const String& name, bool post = false) const;
+  const AsyncWebParameter* getParam(const String& name, bool post = false) const;
+
+  AsyncWebServerResponse* beginResponse(int code, const String& contentType = String(),
+                                        const String& content = String());
+  AsyncWebServerResponse* beginResponse_P(int code, const String& contentType, const uint8_t* content,
+                                          size_t len);
+  void send(AsyncWebServerResponse* response);
+  void send(int code, const String& contentType = String(), const String& content = String());
+  void redirect(const String& url);
+
+ private:
+  WebRequestMethod method_;
+  String url_;
+  std::vector<AsyncWebParameter> params_;
+  HostHttpFields headers_;
+  HostHttpReply& reply_;
+};
+
+typedef std::function<void(AsyncWebServerRequest* request)> ArRequestHandlerFunction;
+
+class AsyncWebServer {
+ public:
+  explicit AsyncWebServer(uint16_t port);
+  ~AsyncWebServer();
+
+  void begin();
+  void end();
+  void on(const char* uri, WebRequestMethod method, ArRequestHandlerFunction onRequest);
+  void onNotFound(ArRequestHandlerFunction fn) { notFound_ = fn; }
+
+  // Runs the handler for a request; host only
+  void handle(AsyncWebServerRequest* request);
+
+ private:
+  struct Route {
+    String uri;
+    WebRequestMethod method;
+    ArRequestHandlerFunction handler;
+  };
+
+  uint16_t port_;
+  bool running_;
+  std::vector<Route> routes_;
+  ArRequestHandlerFunction notFound_;
+};
+
+// ===== HOST CONTROL =====
+struct HostHttpReply {
+  bool done;
+  int code;
+  String contentType;
+  String body;
+  HostHttpFields headers;
+
+  String header(const char* name) const;
+};
+
+/**
+ * Sends a request to the server on port 80. params are form fields for
+ * POST and query parameters otherwise. reply is filled in once the
+ * handler has run, when the harness next lets the simulation run; a
+ * server that is not running answers nothing.
+ */
+void hostHttpRequest(WebRequestMethod method, const char* url, const HostHttpFields& params,
+                     HostHttpReply& reply, const HostHttpFields& headers = HostHttpFields());
+
+#endif // _ESPAsyncWebServer_H_
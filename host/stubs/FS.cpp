@@ -0,0 +1,69 @@
+/*
+ * Arduino-ESP32 file system API for the host build, implementation
+ */
+#include "FS.h"
+#include "host_sim.h"
+
+// Programming one 256-byte flash page, SPIFFS bookkeeping included
+#define FLASH_PAGE_SIZE 256
+#define FLASH_PAGE_NS (1000ULL * 1000ULL)
+
+namespace fs {
+
+size_t File::write(const uint8_t* buf, size_t size) {
+  if (!data_ || !writable_) return 0;
+  size_t before = data_->size() / FLASH_PAGE_SIZE;
+  data_->insert(data_->end(), buf, buf + size);
+  size_t after = data_->size() / FLASH_PAGE_SIZE;
+  if (after > before) hostSleepNs((after - before) * FLASH_PAGE_NS);
+  return size;
+}
+
+int File::read() {
+  uint8_t c;
+  return read(&c, 1) == 1 ? c : -1;
+}
+
+int File::peek() {
+  return available() > 0 ? (*data_)[position_] : -1;
+}
+
+size_t File::read(uint8_t* buf, size_t size) {
+  if (!data_) return 0;
+  size_t n = min(size, data_->size() - position_);
+  memcpy(buf, data_->data() + position_, n);
+  position_ += n;
+  return n;
+}
+
+File FS::open(const char* path, const char* mode, const bool create) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  auto entry = files_.find(path);
+  if (strcmp(mode, FILE_READ) == 0) {
+    if (entry == files_.end()) return File();
+    // Readers get a snapshot; a later writer replaces the file
+    return File(std::make_shared<FileData>(*entry->second), false);
+  }
+  if (strcmp(mode, FILE_WRITE) == 0 || entry == files_.end()) {
+    std::shared_ptr<FileData> data = std::make_shared<FileData>();
+    files_[path] = data;
+    return File(data, true);
+  }
+  return File(entry->second, true);
+}
+
+bool FS::exists(const char* path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return files_.find(path) != files_.end();
+}
+
+bool FS::remove(const char* path) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return files_.erase(path) != 0;
+}
+
+}  // namespace fs
+
+#include "SPIFFS.h"
+
+fs::SPIFFSFS SPIFFS;
@@ -0,0 +1,68 @@
+/*
+ * Arduino-ESP32 file system API for the host build
+ *
+ * Files live in RAM for the life of the process. Writes take the time
+ * SPIFFS needs to program the flash pages they fill.
+ */
+#ifndef FS_H
+#define FS_H
+
+#include <Arduino.h>
+#include <map>
+#include <memory>
+#include <mutex>
+#include <string>
+#include <vector>
+
+#define FILE_READ "r"
+#define FILE_WRITE "w"
+#define FILE_APPEND "a"
+
+namespace fs {
+
+typedef std::vector<uint8_t> FileData;
+
+class File : public Stream {
+ public:
+  File() : position_(0), writable_(false) {}
+  File(std::shared_ptr<FileData> data, bool writable) : data_(data), position_(0), writable_(writable) {}
+
+  size_t write(uint8_t c) override { return write(&c, 1); }
+  size_t write(const uint8_t* buf, size_t size) override;
+  using Print::write;
+  int available() override { return data_ ? (int)(data_->size() - position_) : 0; }
+  int read() override;
+  int peek() override;
+  size_t read(uint8_t* buf, size_t size);
+  size_t size() const { return data_ ? data_->size() : 0; }
+  void close() { data_.reset(); }
+  explicit operator bool() const { return data_ != nullptr; }
+
+ private:
+  std::shared_ptr<FileData> data_;
+  size_t position_;
+  bool writable_;
+};
+
+class FS {
+ public:
+  File open(const char* path, const char* mode = FILE_READ, const bool create = false);
+  File open(const String& path, const char* mode = FILE_READ, const bool create = false) {
+    return open(path.c_str(), mode, create);
+  }
+  bool exists(const char* path);
+  bool exists(const String& path) { return exists(path.c_str()); }
+  bool remove(const char* path);
+  bool remove(const String& path) { return remove(path.c_str()); }
+
+ protected:
+  std::mutex mutex_;
+  std::map<std::string, std::shared_ptr<FileData>> files_;
+};
+
+}  // namespace fs
+
+using fs::File;
+using fs::FS;
+
+#endif // FS_H
@@ -0,0 +1,27 @@
+/*
+ * Arduino-ESP32 HTTPClient for the host build
+ *
+ * Only declared so that HttpUplink compiles; every request fails to
+ * connect.
+ */
+#ifndef HTTPClient_H_
+#define HTTPClient_H_
+
+#include <Arduino.h>
+
+#define HTTPC_ERROR_CONNECTION_REFUSED (-1)
+#define HTTP_CODE_OK 200
+
+class HTTPClient {
+ public:
+  void setReuse(bool reuse) {}
+  void setConnectTimeout(int32_t connectTimeout) {}
+  void setTimeout(uint16_t timeout) {}
+  bool begin(const String& url) { return false; }
+  void addHeader(const String& name, const String& value) {}
+  int POST(uint8_t* payload, size_t size) { return HTTPC_ERROR_CONNECTION_REFUSED; }
+  String getString() { return String(); }
+  void end() {}
+};
+
+#endif // HTTPClient_H_
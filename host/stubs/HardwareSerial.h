@@ -0,0 +1,34 @@
+/*
+ * Serial for the host build
+ *
+ * Output goes to stdout when echo is on (the default), otherwise it is
+ * discarded. Writes from several tasks are kept whole per call.
+ */
+#ifndef HARDWARE_SERIAL_H
+#define HARDWARE_SERIAL_H
+
+#include "Stream.h"
+
+class HardwareSerial : public Stream {
+ public:
+  void begin(unsigned long baud) {}
+  void end() {}
+
+  int available() override { return 0; }
+  int read() override { return -1; }
+  int peek() override { return -1; }
+
+  size_t write(uint8_t c) override;
+  size_t write(const uint8_t* buffer, size_t size) override;
+  using Print::write;
+  void flush() override;
+
+  operator bool() const { return true; }
+};
+
+extern HardwareSerial Serial;
+
+// ===== HOST CONTROL =====
+void hostSerialEcho(bool on);
+
+#endif // HARDWARE_SERIAL_H
@@ -0,0 +1,45 @@
+/*
+ * Arduino IPAddress for the host build
+ */
+#ifndef IPADDRESS_H
+#define IPADDRESS_H
+
+#include <stdint.h>
+#include <string.h>
+#include "Printable.h"
+#include "WString.h"
+
+class IPAddress : public Printable {
+ public:
+  IPAddress() { address_.dword = 0; }
+  IPAddress(uint8_t a, uint8_t b, uint8_t c, uint8_t d) {
+    address_.bytes[0] = a;
+    address_.bytes[1] = b;
+    address_.bytes[2] = c;
+    address_.bytes[3] = d;
+  }
+  IPAddress(uint32_t address) { address_.dword = address; }
+  IPAddress(const uint8_t* address) { memcpy(address_.bytes, address, 4); }
+
+  bool fromString(const char* address);
+
+  // Network byte order, as lwIP stores it
+  operator uint32_t() const { return address_.dword; }
+  bool operator==(const IPAddress& addr) const { return address_.dword == addr.address_.dword; }
+  bool operator!=(const IPAddress& addr) const { return address_.dword != addr.address_.dword; }
+  uint8_t operator[](int index) const { return address_.bytes[index]; }
+  uint8_t& operator[](int index) { return address_.bytes[index]; }
+
+  size_t printTo(Print& p) const override;
+  String toString() const;
+
+ private:
+  union {
+    uint8_t bytes[4];
+    uint32_t dword;
+  } address_;
+};
+
+extern const IPAddress INADDR_NONE;
+
+#endif // IPADDRESS_H
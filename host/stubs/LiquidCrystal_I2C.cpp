@@ -0,0 +1,153 @@
+/*
+ * LiquidCrystal_I2C for the host build, implementation
+ */
+#include "LiquidCrystal_I2C.h"
+#include <Wire.h>
+
+#define LCD_CLEARDISPLAY 0x01
+#define LCD_RETURNHOME 0x02
+#define LCD_ENTRYMODESET 0x04
+#define LCD_DISPLAYCONTROL 0x08
+#define LCD_FUNCTIONSET 0x20
+#define LCD_SETCGRAMADDR 0x40
+#define LCD_SETDDRAMADDR 0x80
+
+#define LCD_DISPLAYON 0x04
+#define LCD_ENTRYLEFT 0x02
+#define LCD_2LINE 0x08
+
+#define LCD_BACKLIGHT 0x08
+#define LCD_NOBACKLIGHT 0x00
+
+#define En 0x04
+#define Rs 0x01
+
+HostLcd hostLcd;
+
+// Display RAM addresses map to (line, column); line 2 starts at 0x40
+static void ramWrite(uint8_t value) {
+  uint8_t line = (hostLcd.address & 0x40) ? 1 : 0;
+  uint8_t col = hostLcd.address & 0x3f;
+  if (col < 40) hostLcd.ram[line][col] = (char)value;
+  hostLcd.address = (uint8_t)((line << 6) | ((col + 1) % 40));
+}
+
+static void ramClear() {
+  memset(hostLcd.ram, ' ', sizeof(hostLcd.ram));
+  hostLcd.address = 0;
+}
+
+LiquidCrystal_I2C::LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows)
+  : addr_(addr), cols_(cols), rows_(rows), backlightVal_(LCD_NOBACKLIGHT) {
+  ramClear();
+}
+
+void LiquidCrystal_I2C::init() {
+  Wire.begin();
+  begin(cols_, rows_);
+}
+
+void LiquidCrystal_I2C::begin(uint8_t cols, uint8_t rows) {
+  // Power-on wait and the 4-bit initialisation sequence
+  delay(50);
+  expanderWrite(backlightVal_);
+  delay(1000);
+  write4bits(0x03 << 4);
+  delayMicroseconds(4500);
+  write4bits(0x03 << 4);
+  delayMicroseconds(4500);
+  write4bits(0x03 << 4);
+  delayMicroseconds(150);
+  write4bits(0x02 << 4);
+
+  command(LCD_FUNCTIONSET | LCD_2LINE);
+  display();
+  clear();
+  command(LCD_ENTRYMODESET | LCD_ENTRYLEFT);
+  home();
+}
+
+void LiquidCrystal_I2C::clear() {
+  command(LCD_CLEARDISPLAY);
+  delayMicroseconds(2000);
+  hostLcd.clears++;
+  ramClear();
+}
+
+void LiquidCrystal_I2C::home() {
+  command(LCD_RETURNHOME);
+  delayMicroseconds(2000);
+  hostLcd.address = 0;
+}
+
+void LiquidCrystal_I2C::setCursor(uint8_t col, uint8_t row) {
+  static const uint8_t rowOffsets[] = { 0x00, 0x40, 0x14, 0x54 };
+  if (row >= rows_) row = rows_ - 1;
+  uint8_t address = col + rowOffsets[row];
+  command(LCD_SETDDRAMADDR | address);
+  hostLcd.address = address;
+}
+
+void LiquidCrystal_I2C::backlight() {
+  backlightVal_ = LCD_BACKLIGHT;
+  expanderWrite(0);
+}
+
+void LiquidCrystal_I2C::noBacklight() {
+  backlightVal_ = LCD_NOBACKLIGHT;
+  expanderWrite(0);
+}
+
+void LiquidCrystal_I2C::display() {
+  command(LCD_DISPLAYCONTROL | LCD_DISPLAYON);
+}
+
+void LiquidCrystal_I2C::noDisplay() {
+  command(LCD_DISPLAYCONTROL);
+}
+
+void LiquidCrystal_I2C::createChar(uint8_t location, uint8_t charmap[]) {
+  location &= 0x7;
+  command(LCD_SETCGRAMADDR | (location << 3));
+  for (int i = 0; i < 8; i++) {
+    send(charmap[i], Rs);
+  }
+}
+
+size_t LiquidCrystal_I2C::write(uint8_t value) {
+  send(value, Rs);
+  hostLcd.characters++;
+  ramWrite(value);
+  return 1;
+}
+
+void LiquidCrystal_I2C::command(uint8_t value) {
+  send(value, 0);
+  hostLcd.commands++;
+}
+
+void LiquidCrystal_I2C::send(uint8_t value, uint8_t mode) {
+  hostLcd.bytes++;
+  uint8_t highnib = value & 0xf0;
+  uint8_t lownib = (value << 4) & 0xf0;
+  write4bits(highnib | mode);
+  write4bits(lownib | mode);
+}
+
+void LiquidCrystal_I2C::write4bits(uint8_t value) {
+  expanderWrite(value);
+  pulseEnable(value);
+}
+
+void LiquidCrystal_I2C::expanderWrite(uint8_t data) {
+  Wire.beginTransmission(addr_);
+  Wire.write((uint8_t)(data | backlightVal_));
+  Wire.endTransmission();
+}
+
+void LiquidCrystal_I2C::pulseEnable(uint8_t data) {
+  expanderWrite(data | En);
+  delayMicroseconds(1);
+  expanderWrite(data & ~En);
+  delayMicroseconds(50);
+}
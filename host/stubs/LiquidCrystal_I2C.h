@@ -0,0 +1,63 @@
+/*
+ * LiquidCrystal_I2C (HD44780 behind a PCF8574 backpack) for the host build
+ *
+ * Same transfers as the library: every command or character is sent as
+ * two 4-bit nibbles, each one expander write plus an enable pulse of two
+ * more, so one LCD byte costs six I2C transactions on Wire. clear() and
+ * home() wait the 2 ms the controller needs. hostLcd counts the bytes
+ * and keeps the display RAM, so tests can read what the screen shows.
+ */
+#ifndef LIQUIDCRYSTAL_I2C_H
+#define LIQUIDCRYSTAL_I2C_H
+
+#include <Arduino.h>
+#include <string>
+
+class LiquidCrystal_I2C : public Print {
+ public:
+  LiquidCrystal_I2C(uint8_t addr, uint8_t cols, uint8_t rows);
+
+  void init();
+  void begin(uint8_t cols, uint8_t rows);
+  void clear();
+  void home();
+  void setCursor(uint8_t col, uint8_t row);
+  void backlight();
+  void noBacklight();
+  void display();
+  void noDisplay();
+  void createChar(uint8_t location, uint8_t charmap[]);
+
+  size_t write(uint8_t value) override;
+  using Print::write;
+
+ private:
+  void command(uint8_t value);
+  void send(uint8_t value, uint8_t mode);
+  void write4bits(uint8_t value);
+  void expanderWrite(uint8_t data);
+  void pulseEnable(uint8_t data);
+
+  uint8_t addr_;
+  uint8_t cols_;
+  uint8_t rows_;
+  uint8_t backlightVal_;
+};
+
+// ===== HOST CONTROL =====
+struct HostLcd {
+  uint32_t bytes;       // Every byte sent, custom character data included
+  uint32_t commands;
+  uint32_t characters;  // Written to display RAM
+  uint32_t clears;
+  uint8_t address;      // Display RAM address counter
+  char ram[2][40];      // Display RAM of both lines
+
+  // The visible part of a row
+  std::string row(uint8_t row, uint8_t cols = 16) const { return std::string(ram[row & 1], cols); }
+  void resetCounters() { bytes = commands = characters = clears = 0; }
+};
+
+extern HostLcd hostLcd;
+
+#endif // LIQUIDCRYSTAL_I2C_H
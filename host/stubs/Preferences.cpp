@@ -0,0 +1,102 @@
+/*
+ * Arduino-ESP32 Preferences for the host build, implementation
+ */
+#include "Preferences.h"
+#include <map>
+#include <mutex>
+#include <string>
+#include <vector>
+
+typedef std::map<std::string, std::vector<uint8_t>> NvsNamespace;
+
+static std::mutex nvsMutex;
+static std::map<std::string, NvsNamespace> nvs;
+
+bool Preferences::begin(const char* name, bool readOnly, const char* partitionLabel) {
+  if (open_ || name == nullptr || strlen(name) > 15) return false;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  // Opening a missing namespace read-only fails, as with NVS_READONLY
+  if (readOnly && nvs.find(name) == nvs.end()) return false;
+  nvs[name];
+  namespace_ = name;
+  readOnly_ = readOnly;
+  open_ = true;
+  return true;
+}
+
+void Preferences::end() {
+  open_ = false;
+}
+
+bool Preferences::clear() {
+  if (!open_ || readOnly_) return false;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  nvs[namespace_.c_str()].clear();
+  return true;
+}
+
+bool Preferences::remove(const char* key) {
+  if (!open_ || readOnly_) return false;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  return nvs[namespace_.c_str()].erase(key) != 0;
+}
+
+bool Preferences::isKey(const char* key) {
+  if (!open_) return false;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& space = nvs[namespace_.c_str()];
+  return space.find(key) != space.end();
+}
+
+size_t Preferences::putBytes(const char* key, const void* value, size_t len) {
+  if (!open_ || readOnly_ || key == nullptr || value == nullptr || len == 0) return 0;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  const uint8_t* bytes = (const uint8_t*)value;
+  nvs[namespace_.c_str()][key].assign(bytes, bytes + len);
+  return len;
+}
+
+size_t Preferences::getBytesLength(const char* key) {
+  if (!open_) return 0;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& space = nvs[namespace_.c_str()];
+  auto entry = space.find(key);
+  return entry == space.end() ? 0 : entry->second.size();
+}
+
+size_t Preferences::getBytes(const char* key, void* buf, size_t maxLen) {
+  if (!open_) return 0;
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  NvsNamespace& space = nvs[namespace_.c_str()];
+  auto entry = space.find(key);
+  // A buffer too small gets nothing, like nvs_get_blob()
+  if (entry == space.end() || entry->second.size() > maxLen) return 0;
+  memcpy(buf, entry->second.data(), entry->second.size());
+  return entry->second.size();
+}
+
+size_t Preferences::putString(const char* key, const char* value) {
+  return putBytes(key, value, strlen(value) + 1) ? strlen(value) : 0;
+}
+
+String Preferences::getString(const char* key, const String defaultValue) {
+  size_t length = getBytesLength(key);
+  if (length == 0) return defaultValue;
+  std::vector<char> buffer(length);
+  getBytes(key, buffer.data(), length);
+  return String(buffer.data(), length - 1);
+}
+
+size_t Preferences::putUInt(const char* key, uint32_t value) {
+  return putBytes(key, &value, sizeof(value));
+}
+
+uint32_t Preferences::getUInt(const char* key, uint32_t defaultValue) {
+  uint32_t value;
+  return getBytes(key, &value, sizeof(value)) == sizeof(value) ? value : defaultValue;
+}
+
+void hostPreferencesErase() {
+  std::lock_guard<std::mutex> lock(nvsMutex);
+  nvs.clear();
+}
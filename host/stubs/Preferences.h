@@ -0,0 +1,41 @@
+/*
+ * Arduino-ESP32 Preferences (NVS) for the host build
+ *
+ * Namespaces live in RAM for the life of the process, so a restart
+ * inside one test keeps them like flash does.
+ */
+#ifndef PREFERENCES_H
+#define PREFERENCES_H
+
+#include <Arduino.h>
+
+class Preferences {
+ public:
+  Preferences() : open_(false), readOnly_(true) {}
+  ~Preferences() { end(); }
+
+  bool begin(const char* name, bool readOnly = false, const char* partitionLabel = NULL);
+  void end();
+  bool clear();
+  bool remove(const char* key);
+  bool isKey(const char* key);
+
+  size_t putBytes(const char* key, const void* value, size_t len);
+  size_t getBytes(const char* key, void* buf, size_t maxLen);
+  size_t getBytesLength(const char* key);
+  size_t putString(const char* key, const char* value);
+  String getString(const char* key, const String defaultValue = String());
+  size_t putUInt(const char* key, uint32_t value);
+  uint32_t getUInt(const char* key, uint32_t defaultValue = 0);
+
+ private:
+  String namespace_;
+  bool open_;
+  bool readOnly_;
+};
+
+// ===== HOST CONTROL =====
+// Erases every namespace, as a fresh flash would have it
+void hostPreferencesErase();
+
+#endif // PREFERENCES_H
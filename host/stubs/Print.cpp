@@ -0,0 +1,144 @@
+/*
+ * Arduino Print and IPAddress for the host build, implementation
+ */
+#include "Print.h"
+#include "IPAddress.h"
+#include <math.h>
+#include <stdarg.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ===== PRINT =====
+size_t Print::write(const uint8_t* buffer, size_t size) {
+  size_t n = 0;
+  while (size--) {
+    if (!write(*buffer++)) break;
+    n++;
+  }
+  return n;
+}
+
+// Formats into a stack buffer, or a heap one for long output, like the core
+size_t Print::printf(const char* format, ...) {
+  char local[64];
+  char* buffer = local;
+  va_list arg;
+  va_start(arg, format);
+  va_list copy;
+  va_copy(copy, arg);
+  int len = vsnprintf(local, sizeof(local), format, copy);
+  va_end(copy);
+  if (len < 0) {
+    va_end(arg);
+    return 0;
+  }
+  if ((size_t)len >= sizeof(local)) {
+    buffer = (char*)malloc(len + 1);
+    if (buffer == nullptr) {
+      va_end(arg);
+      return 0;
+    }
+    vsnprintf(buffer, len + 1, format, arg);
+  }
+  va_end(arg);
+  len = write((const uint8_t*)buffer, len);
+  if (buffer != local) free(buffer);
+  return len;
+}
+
+size_t Print::print(long value, int base) {
+  return print((long long)value, base);
+}
+
+size_t Print::print(unsigned long value, int base) {
+  return print((unsigned long long)value, base);
+}
+
+size_t Print::print(long long value, int base) {
+  if (base == 0) return write((uint8_t)value);
+  if (base == 10 && value < 0) {
+    size_t n = print('-');
+    return n + printNumber(0 - (unsigned long long)value, 10);
+  }
+  return printNumber((unsigned long long)value, base);
+}
+
+size_t Print::print(unsigned long long value, int base) {
+  if (base == 0) return write((uint8_t)value);
+  return printNumber(value, base);
+}
+
+size_t Print::printNumber(unsigned long long n, uint8_t base) {
+  char buf[8 * sizeof(n) + 1];
+  char* str = &buf[sizeof(buf) - 1];
+  *str = '\0';
+  if (base < 2) base = 10;
+  do {
+    char c = n % base;
+    n /= base;
+    *--str = c < 10 ? c + '0' : c + 'A' - 10;
+  } while (n);
+  return write(str);
+}
+
+// The core's own algorithm, so the digits match the device
+size_t Print::printFloat(double number, uint8_t digits) {
+  size_t n = 0;
+  if (isnan(number)) return print("nan");
+  if (isinf(number)) return print("inf");
+  if (number > 4294967040.0) return print("ovf");
+  if (number < -4294967040.0) return print("ovf");
+
+  if (number < 0.0) {
+    n += print('-');
+    number = -number;
+  }
+
+  double rounding = 0.5;
+  for (uint8_t i = 0; i < digits; ++i) rounding /= 10.0;
+  number += rounding;
+
+  unsigned long intPart = (unsigned long)number;
+  double remainder = number - (double)intPart;
+  n += print(intPart);
+  if (digits > 0) n += print(".");
+  while (digits-- > 0) {
+    remainder *= 10.0;
+    int toPrint = int(remainder);
+    n += print(toPrint);
+    remainder -= toPrint;
+  }
+  return n;
+}
+
+// ===== IPADDRESS =====
+const IPAddress INADDR_NONE(0, 0, 0, 0);
+
+bool IPAddress::fromString(const char* address) {
+  unsigned parts[4];
+  char tail;
+  if (sscanf(address, "%u.%u.%u.%u%c", &parts[0], &parts[1], &parts[2], &parts[3], &tail) != 4) {
+    return false;
+  }
+  for (int i = 0; i < 4; i++) {
+    if (parts[i] > 255) return false;
+    address_.bytes[i] = (uint8_t)parts[i];
+  }
+  return true;
+}
+
+size_t IPAddress::printTo(Print& p) const {
+  size_t n = 0;
+  for (int i = 0; i < 4; i++) {
+    n += p.print(address_.bytes[i], DEC);
+    if (i < 3) n += p.print('.');
+  }
+  return n;
+}
+
+String IPAddress::toString() const {
+  char buf[16];
+  snprintf(buf, sizeof(buf), "%u.%u.%u.%u", address_.bytes[0], address_.bytes[1],
+           address_.bytes[2], address_.bytes[3]);
+  return String(buf);
+}
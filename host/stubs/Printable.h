@@ -0,0 +1,17 @@
+/*
+ * Arduino Printable for the host build
+ */
+#ifndef PRINTABLE_H
+#define PRINTABLE_H
+
+#include <stddef.h>
+
+class Print;
+
+class Printable {
+ public:
+  virtual ~Printable() {}
+  virtual size_t printTo(Print& p) const = 0;
+};
+
+#endif // PRINTABLE_H
@@ -0,0 +1,29 @@
+/*
+ * Arduino-ESP32 SPIFFS for the host build
+ */
+#ifndef SPIFFS_H
+#define SPIFFS_H
+
+#include "FS.h"
+
+namespace fs {
+
+class SPIFFSFS : public FS {
+ public:
+  bool begin(bool formatOnFail = false, const char* basePath = "/spiffs", uint8_t maxOpenFiles = 10,
+             const char* partitionLabel = NULL) {
+    return true;
+  }
+  void end() {}
+  bool format() {
+    std::lock_guard<std::mutex> lock(mutex_);
+    files_.clear();
+    return true;
+  }
+};
+
+}  // namespace fs
+
+extern fs::SPIFFSFS SPIFFS;
+
+#endif // SPIFFS_H
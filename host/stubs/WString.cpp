@@ -0,0 +1,404 @@
+/*
+ * Arduino String for the host build, implementation
+ */
+#include "WString.h"
+#include <ctype.h>
+#include <stdio.h>
+#include <stdlib.h>
+
+// ===== STORAGE =====
+void String::init() {
+  sso_ = false;
+  ssoLen_ = 0;
+  ptr_.buf = nullptr;
+  ptr_.cap = 0;
+  ptr_.len = 0;
+}
+
+void String::invalidate() {
+  if (!sso_) free(ptr_.buf);
+  init();
+}
+
+void String::setLen(unsigned int len) {
+  if (sso_) {
+    ssoLen_ = (unsigned char)len;
+  } else {
+    ptr_.len = len;
+  }
+}
+
+bool String::reserve(unsigned int size) {
+  if (buffer() && capacity() >= size) return true;
+  if (!changeBuffer(size)) return false;
+  if (length() == 0) wbuffer()[0] = '\0';
+  return true;
+}
+
+bool String::changeBuffer(unsigned int maxStrLen) {
+  // Small enough for the inline buffer
+  if (maxStrLen < SSO_SIZE - 1) {
+    if (sso_ || !ptr_.buf) {
+      if (!sso_) {
+        init();
+        ssoBuf_[0] = '\0';
+      }
+      sso_ = true;
+      return true;
+    }
+    // Shrinking from the heap into the inline buffer
+    char* old = ptr_.buf;
+    unsigned int len = ptr_.len;
+    memcpy(ssoBuf_, old, maxStrLen);
+    ssoBuf_[maxStrLen] = '\0';
+    free(old);
+    sso_ = true;
+    ssoLen_ = (unsigned char)(len < maxStrLen ? len : maxStrLen);
+    return true;
+  }
+
+  size_t newSize = (maxStrLen + 16) & ~(size_t)0xf;
+  unsigned int oldLen = length();
+  size_t oldSize = capacity() + 1;
+  char* grown = (char*)realloc(sso_ ? nullptr : ptr_.buf, newSize);
+  if (!grown) return false;
+  if (sso_) memcpy(grown, ssoBuf_, SSO_SIZE);
+  if (newSize > oldSize) memset(grown + oldSize, 0, newSize - oldSize);
+  sso_ = false;
+  ptr_.buf = grown;
+  ptr_.cap = newSize - 1;
+  ptr_.len = oldLen;
+  return true;
+}
+
+String& String::copy(const char* cstr, unsigned int length) {
+  if (!reserve(length)) {
+    invalidate();
+    return *this;
+  }
+  memmove(wbuffer(), cstr, length);
+  wbuffer()[length] = '\0';
+  setLen(length);
+  return *this;
+}
+
+void String::move(String& rhs) {
+  if (!sso_) free(ptr_.buf);
+  memcpy((void*)this, (const void*)&rhs, sizeof(String));
+  rhs.init();
+}
+
+// ===== CONSTRUCTORS =====
+String::String(const char* cstr) {
+  init();
+  if (cstr) copy(cstr, strlen(cstr));
+}
+
+String::String(const char* cstr, unsigned int length) {
+  init();
+  if (cstr) copy(cstr, length);
+}
+
+String::String(const String& str) {
+  init();
+  *this = str;
+}
+
+String::String(String&& rval) {
+  init();
+  move(rval);
+}
+
+String::String(const __FlashStringHelper* str) : String((const char*)str) {}
+
+String::String(char c) {
+  init();
+  char buf[2] = { c, '\0' };
+  *this = buf;
+}
+
+static const char* formatInteger(char* buf, size_t size, unsigned long long value, bool negative,
+                                 unsigned char base) {
+  char* p = buf + size - 1;
+  *p = '\0';
+  if (base < 2 || base > 36) base = 10;
+  do {
+    unsigned digit = value % base;
+    *--p = (char)(digit < 10 ? '0' + digit : 'a' + digit - 10);
+    value /= base;
+  } while (value);
+  if (negative) *--p = '-';
+  return p;
+}
+
+static const char* formatSigned(char* buf, size_t size, long long value, unsigned char base) {
+  // Only base 10 prints a sign, like itoa() and ltoa() on the device
+  if (base == 10 && value < 0) {
+    return formatInteger(buf, size, 0 - (unsigned long long)value, true, base);
+  }
+  return formatInteger(buf, size, (unsigned long long)value, false, base);
+}
+
+String::String(unsigned char value, unsigned char base) : String((unsigned long)value, base) {}
+String::String(int value, unsigned char base) : String((long)value, base) {}
+String::String(unsigned int value, unsigned char base) : String((unsigned long)value, base) {}
+
+String::String(long value, unsigned char base) {
+  init();
+  char buf[72];
+  *this = formatSigned(buf, sizeof(buf), value, base);
+}
+
+String::String(unsigned long value, unsigned char base) {
+  init();
+  char buf[72];
+  *this = formatInteger(buf, sizeof(buf), value, false, base);
+}
+
+String::String(long long value, unsigned char base) {
+  init();
+  char buf[72];
+  *this = formatSigned(buf, sizeof(buf), value, base);
+}
+
+String::String(unsigned long long value, unsigned char base) {
+  init();
+  char buf[72];
+  *this = formatInteger(buf, sizeof(buf), value, false, base);
+}
+
+String::String(float value, unsigned int decimalPlaces) : String((double)value, decimalPlaces) {}
+
+String::String(double value, unsigned int decimalPlaces) {
+  init();
+  // The device formats through a temporary heap buffer (dtostrf)
+  char* buf = (char*)malloc(decimalPlaces + 42);
+  if (!buf) return;
+  snprintf(buf, decimalPlaces + 42, "%.*f", (int)decimalPlaces, value);
+  *this = buf;
+  free(buf);
+}
+
+String::~String() {
+  if (!sso_) free(ptr_.buf);
+}
+
+// ===== ASSIGNMENT AND CONCATENATION =====
+String& String::operator=(const String& rhs) {
+  if (this == &rhs) return *this;
+  if (rhs.buffer()) {
+    copy(rhs.buffer(), rhs.length());
+  } else {
+    invalidate();
+  }
+  return *this;
+}
+
+String& String::operator=(String&& rval) {
+  if (this != &rval) move(rval);
+  return *this;
+}
+
+String& String::operator=(const char* cstr) {
+  if (cstr) {
+    copy(cstr, strlen(cstr));
+  } else {
+    invalidate();
+  }
+  return *this;
+}
+
+bool String::concat(const char* cstr, unsigned int length) {
+  if (!cstr) return false;
+  if (length == 0) return true;
+  unsigned int newLen = this->length() + length;
+  // cstr may point into this string's own buffer
+  if (buffer() && cstr >= buffer() && cstr < buffer() + this->length()) {
+    size_t offset = cstr - buffer();
+    if (!reserve(newLen)) return false;
+    cstr = buffer() + offset;
+  } else if (!reserve(newLen)) {
+    return false;
+  }
+  memmove(wbuffer() + this->length(), cstr, length);
+  wbuffer()[newLen] = '\0';
+  setLen(newLen);
+  return true;
+}
+
+bool String::concat(const String& str) {
+  return concat(str.c_str(), str.length());
+}
+
+bool String::concat(const char* cstr) {
+  return cstr && concat(cstr, strlen(cstr));
+}
+
+bool String::concat(char c) {
+  return concat(&c, 1);
+}
+
+bool String::concat(unsigned char num) { return concat(String(num)); }
+bool String::concat(int num) { return concat(String(num)); }
+bool String::concat(unsigned int num) { return concat(String(num)); }
+bool String::concat(long num) { return concat(String(num)); }
+bool String::concat(unsigned long num) { return concat(String(num)); }
+bool String::concat(float num) { return concat(String(num)); }
+bool String::concat(double num) { return concat(String(num)); }
+
+String operator+(const String& lhs, const String& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, const char* rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const char* lhs, const String& rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, char rhs) {
+  String result(lhs);
+  result.concat(rhs);
+  return result;
+}
+
+String operator+(const String& lhs, int rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, unsigned int rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, long rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, unsigned long rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, float rhs) { return lhs + String(rhs); }
+String operator+(const String& lhs, double rhs) { return lhs + String(rhs); }
+
+// ===== COMPARISON =====
+int String::compareTo(const String& s) const {
+  return strcmp(c_str(), s.c_str());
+}
+
+bool String::equals(const String& s) const {
+  return length() == s.length() && compareTo(s) == 0;
+}
+
+bool String::equals(const char* cstr) const {
+  return strcmp(c_str(), cstr ? cstr : "") == 0;
+}
+
+bool String::equalsIgnoreCase(const String& s) const {
+  if (length() != s.length()) return false;
+  return strcasecmp(c_str(), s.c_str()) == 0;
+}
+
+bool String::startsWith(const String& prefix) const {
+  return startsWith(prefix, 0);
+}
+
+bool String::startsWith(const String& prefix, unsigned int offset) const {
+  if (offset + prefix.length() > length()) return false;
+  return strncmp(c_str() + offset, prefix.c_str(), prefix.length()) == 0;
+}
+
+bool String::endsWith(const String& suffix) const {
+  if (suffix.length() > length()) return false;
+  return strcmp(c_str() + length() - suffix.length(), suffix.c_str()) == 0;
+}
+
+// ===== CHARACTERS AND SEARCH =====
+char String::charAt(unsigned int index) const {
+  return index < length() ? c_str()[index] : '\0';
+}
+
+void String::setCharAt(unsigned int index, char c) {
+  if (index < length()) wbuffer()[index] = c;
+}
+
+char& String::operator[](unsigned int index) {
+  static char dummy;
+  if (index >= length() || !buffer()) {
+    dummy = '\0';
+    return dummy;
+  }
+  return wbuffer()[index];
+}
+
+int String::indexOf(char ch, unsigned int fromIndex) const {
+  if (fromIndex >= length()) return -1;
+  const char* found = strchr(c_str() + fromIndex, ch);
+  return found ? (int)(found - c_str()) : -1;
+}
+
+int String::indexOf(const String& str, unsigned int fromIndex) const {
+  if (fromIndex >= length()) return -1;
+  const char* found = strstr(c_str() + fromIndex, str.c_str());
+  return found ? (int)(found - c_str()) : -1;
+}
+
+int String::lastIndexOf(char ch) const {
+  const char* found = strrchr(c_str(), ch);
+  return found ? (int)(found - c_str()) : -1;
+}
+
+String String::substring(unsigned int beginIndex, unsigned int endIndex) const {
+  if (beginIndex > endIndex) {
+    unsigned int swap = beginIndex;
+    beginIndex = endIndex;
+    endIndex = swap;
+  }
+  if (beginIndex >= length()) return String();
+  if (endIndex > length()) endIndex = length();
+  return String(c_str() + beginIndex, endIndex - beginIndex);
+}
+
+// ===== MODIFICATION =====
+void String::replace(char find, char replace) {
+  for (char* p = wbuffer(); p && *p; p++) {
+    if (*p == find) *p = replace;
+  }
+}
+
+void String::remove(unsigned int index, unsigned int count) {
+  if (index >= length()) return;
+  if (count > length() - index) count = length() - index;
+  char* p = wbuffer() + index;
+  memmove(p, p + count, length() - index - count + 1);
+  setLen(length() - count);
+}
+
+void String::toLowerCase() {
+  for (char* p = wbuffer(); p && *p; p++) *p = (char)tolower((unsigned char)*p);
+}
+
+void String::toUpperCase() {
+  for (char* p = wbuffer(); p && *p; p++) *p = (char)toupper((unsigned char)*p);
+}
+
+void String::trim() {
+  if (!buffer() || length() == 0) return;
+  const char* begin = c_str();
+  while (isspace((unsigned char)*begin)) begin++;
+  const char* end = c_str() + length();
+  while (end > begin && isspace((unsigned char)end[-1])) end--;
+  unsigned int len = end - begin;
+  memmove(wbuffer(), begin, len);
+  wbuffer()[len] = '\0';
+  setLen(len);
+}
+
+// ===== CONVERSION =====
+long String::toInt() const {
+  return atol(c_str());
+}
+
+float String::toFloat() const {
+  return (float)atof(c_str());
+}
+
+double String::toDouble() const {
+  return atof(c_str());
+}
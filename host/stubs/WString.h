@@ -0,0 +1,148 @@
+/*
+ * Arduino String for the host build
+ *
+ * Same storage policy as the Arduino-ESP32 2.x String: up to 13
+ * characters live inside the object, longer strings take a malloc()ed
+ * buffer rounded up to 16 bytes that grows with realloc(). Allocation
+ * counts measured on the host therefore match the device.
+ */
+#ifndef WSTRING_H
+#define WSTRING_H
+
+#include <stdint.h>
+#include <stddef.h>
+#include <string.h>
+
+class __FlashStringHelper;
+
+class String {
+ public:
+  String(const char* cstr = "");
+  String(const char* cstr, unsigned int length);
+  String(const String& str);
+  String(String&& rval);
+  explicit String(const __FlashStringHelper* str);
+  explicit String(char c);
+  explicit String(unsigned char value, unsigned char base = 10);
+  explicit String(int value, unsigned char base = 10);
+  explicit String(unsigned int value, unsigned char base = 10);
+  explicit String(long value, unsigned char base = 10);
+  explicit String(unsigned long value, unsigned char base = 10);
+  explicit String(long long value, unsigned char base = 10);
+  explicit String(unsigned long long value, unsigned char base = 10);
+  explicit String(float value, unsigned int decimalPlaces = 2);
+  explicit String(double value, unsigned int decimalPlaces = 2);
+  ~String();
+
+  // False if the buffer could not be allocated; the string is then invalid
+  bool reserve(unsigned int size);
+  unsigned int length() const { return sso_ ? ssoLen_ : ptr_.len; }
+  bool isEmpty() const { return length() == 0; }
+
+  String& operator=(const String& rhs);
+  String& operator=(String&& rval);
+  // A null pointer frees the buffer, as ArduinoJson relies on
+  String& operator=(const char* cstr);
+
+  bool concat(const String& str);
+  bool concat(const char* cstr);
+  bool concat(const char* cstr, unsigned int length);
+  bool concat(const uint8_t* cstr, unsigned int length) { return concat((const char*)cstr, length); }
+  bool concat(char c);
+  bool concat(unsigned char num);
+  bool concat(int num);
+  bool concat(unsigned int num);
+  bool concat(long num);
+  bool concat(unsigned long num);
+  bool concat(float num);
+  bool concat(double num);
+
+  template <typename T>
+  String& operator+=(const T& rhs) {
+    concat(rhs);
+    return *this;
+  }
+
+  explicit operator bool() const { return buffer() != nullptr; }
+
+  int compareTo(const String& s) const;
+  bool equals(const String& s) const;
+  bool equals(const char* cstr) const;
+  bool equalsIgnoreCase(const String& s) const;
+  bool operator==(const String& rhs) const { return equals(rhs); }
+  bool operator==(const char* cstr) const { return equals(cstr); }
+  bool operator!=(const String& rhs) const { return !equals(rhs); }
+  bool operator!=(const char* cstr) const { return !equals(cstr); }
+  bool operator<(const String& rhs) const { return compareTo(rhs) < 0; }
+  bool startsWith(const String& prefix) const;
+  bool startsWith(const String& prefix, unsigned int offset) const;
+  bool endsWith(const String& suffix) const;
+
+  char charAt(unsigned int index) const;
+  void setCharAt(unsigned int index, char c);
+  char operator[](unsigned int index) const { return charAt(index); }
+  char& operator[](unsigned int index);
+  const char* c_str() const { return buffer() ? buffer() : ""; }
+  char* begin() { return wbuffer(); }
+  char* end() { return wbuffer() + length(); }
+  const char* begin() const { return c_str(); }
+  const char* end() const { return c_str() + length(); }
+
+  int indexOf(char ch, unsigned int fromIndex = 0) const;
+  int indexOf(const String& str, unsigned int fromIndex = 0) const;
+  int lastIndexOf(char ch) const;
+  String substring(unsigned int beginIndex) const { return substring(beginIndex, length()); }
+  String substring(unsigned int beginIndex, unsigned int endIndex) const;
+
+  void replace(char find, char replace);
+  void remove(unsigned int index, unsigned int count = (unsigned int)-1);
+  void toLowerCase();
+  void toUpperCase();
+  void trim();
+
+  long toInt() const;
+  float toFloat() const;
+  double toDouble() const;
+
+ private:
+  // The device's String is 16 bytes: 15 characters of inline storage
+  // with the terminator, or pointer, capacity and length
+  enum { SSO_SIZE = 15 };
+
+  void init();
+  void invalidate();
+  bool changeBuffer(unsigned int maxStrLen);
+  String& copy(const char* cstr, unsigned int length);
+  void move(String& rhs);
+  void setLen(unsigned int len);
+  unsigned int capacity() const { return sso_ ? SSO_SIZE - 1 : ptr_.cap; }
+  const char* buffer() const { return sso_ ? ssoBuf_ : ptr_.buf; }
+  char* wbuffer() { return sso_ ? ssoBuf_ : ptr_.buf; }
+
+  struct Heap {
+    char* buf;
+    unsigned int cap;
+    unsigned int len;
+  };
+  union {
+    Heap ptr_;
+    char ssoBuf_[SSO_SIZE];
+  };
+  unsigned char ssoLen_;
+  bool sso_;
+};
+
+String operator+(const String& lhs, const String& rhs);
+String operator+(const String& lhs, const char* rhs);
+String operator+(const char* lhs, const String& rhs);
+String operator+(const String& lhs, char rhs);
+String operator+(const String& lhs, int rhs);
+String operator+(const String& lhs, unsigned int rhs);
+String operator+(const String& lhs, long rhs);
+String operator+(const String& lhs, unsigned long rhs);
+String operator+(const String& lhs, float rhs);
+String operator+(const String& lhs, double rhs);
+inline bool operator==(const char* lhs, const String& rhs) { return rhs.equals(lhs); }
+inline bool operator!=(const char* lhs, const String& rhs) { return !rhs.equals(lhs); }
+
+#endif // WSTRING_H
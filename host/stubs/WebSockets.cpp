@@ -0,0 +1,109 @@
+/*
+ * arduinoWebSockets common code for the host build
+ */
+#include "WebSockets.h"
+#include "host_sim.h"
+
+size_t WebSockets::writeHeader(uint8_t* header, WSopcode_t opcode, size_t length, const uint8_t* maskKey) {
+  size_t size = 0;
+  header[size++] = 0x80 | opcode;
+  uint8_t maskBit = maskKey ? 0x80 : 0x00;
+  if (length < 126) {
+    header[size++] = maskBit | (uint8_t)length;
+  } else if (length < 0x10000) {
+    header[size++] = maskBit | 126;
+    header[size++] = (uint8_t)(length >> 8);
+    header[size++] = (uint8_t)length;
+  } else {
+    header[size++] = maskBit | 127;
+    for (int shift = 56; shift >= 0; shift -= 8) header[size++] = (uint8_t)((uint64_t)length >> shift);
+  }
+  if (maskKey) {
+    memcpy(header + size, maskKey, 4);
+    size += 4;
+  }
+  return size;
+}
+
+bool WebSockets::parseFrame(uint8_t* buffer, size_t available, WsFrame& frame) {
+  if (available < 2) return false;
+  size_t size = 2;
+  bool masked = buffer[1] & 0x80;
+  uint64_t length = buffer[1] & 0x7f;
+  if (length == 126) {
+    if (available < 4) return false;
+    length = ((uint64_t)buffer[2] << 8) | buffer[3];
+    size = 4;
+  } else if (length == 127) {
+    if (available < 10) return false;
+    length = 0;
+    for (int i = 0; i < 8; i++) length = (length << 8) | buffer[2 + i];
+    size = 10;
+  }
+  const uint8_t* maskKey = buffer + size;
+  if (masked) size += 4;
+  if (available < size || available - size < length) return false;
+
+  frame.opcode = (WSopcode_t)(buffer[0] & 0x0f);
+  frame.headerSize = size;
+  frame.length = (size_t)length;
+  frame.payload = buffer + size;
+  if (masked) {
+    for (size_t i = 0; i < frame.length; i++) frame.payload[i] ^= maskKey[i & 3];
+  }
+  return true;
+}
+
+bool WebSockets::sendFrame(WSclient_t* client, WSopcode_t opcode, uint8_t* payload, size_t length,
+                           bool mask, bool headerToPayload) {
+  if (client->tcp == nullptr || !client->tcp->connected()) return false;
+
+  uint8_t maskKey[4];
+  if (mask) {
+    uint32_t key = esp_random();
+    memcpy(maskKey, &key, sizeof(key));
+  }
+  uint8_t header[WEBSOCKETS_MAX_HEADER_SIZE];
+  size_t headerSize = writeHeader(header, opcode, length, mask ? maskKey : nullptr);
+
+  uint8_t* data = headerToPayload ? payload + WEBSOCKETS_MAX_HEADER_SIZE : payload;
+  if (mask) {
+    for (size_t i = 0; i < length; i++) data[i] ^= maskKey[i & 3];
+  }
+
+  uint8_t* out;
+  uint8_t* allocated = nullptr;
+  if (headerToPayload) {
+    out = payload + WEBSOCKETS_MAX_HEADER_SIZE - headerSize;
+    memcpy(out, header, headerSize);
+  } else {
+    allocated = (uint8_t*)malloc(headerSize + length);
+    if (allocated == nullptr) return false;
+    memcpy(allocated, header, headerSize);
+    if (length) memcpy(allocated + headerSize, data, length);
+    out = allocated;
+  }
+
+  size_t total = headerSize + length;
+  size_t written = 0;
+  uint64_t deadline = hostNowNs() + (uint64_t)WEBSOCKETS_TCP_TIMEOUT * 1000000ULL;
+  bool ok = true;
+  while (written < total) {
+    int n = client->tcp->write(out + written, total - written);
+    if (n < 0) {
+      ok = false;
+      break;
+    }
+    written += n;
+    if (written == total) break;
+    // Socket full: the library keeps retrying until the timeout
+    if (hostNowNs() >= deadline) {
+      ok = false;
+      break;
+    }
+    delay(1);
+  }
+  free(allocated);
+  if (!ok) client->tcp->stop();
+  return ok;
+}
@@ -0,0 +1,93 @@
+/*
+ * arduinoWebSockets (links2004) common definitions for the host build
+ *
+ * Same frame format, constants and client record as the library, over
+ * the socketpair-backed WiFiClient. HTTP upgrade handshakes, fragments
+ * and extensions are not modeled.
+ */
+#ifndef WEBSOCKETS_H
+#define WEBSOCKETS_H
+
+#include <Arduino.h>
+#include <functional>
+#include <vector>
+#include "WiFiClient.h"
+
+class WiFiClientSecure;
+
+#define WEBSOCKETS_MAX_DATA_SIZE (15 * 1024)
+#define WEBSOCKETS_TCP_TIMEOUT (5000)
+#define WEBSOCKETS_MAX_HEADER_SIZE (14)
+#define WEBSOCKETS_NETWORK_CLASS WiFiClient
+#define WEBSOCKETS_YIELD() yield()
+
+typedef enum {
+  WStype_ERROR,
+  WStype_DISCONNECTED,
+  WStype_CONNECTED,
+  WStype_TEXT,
+  WStype_BIN,
+  WStype_FRAGMENT_TEXT_START,
+  WStype_FRAGMENT_BIN_START,
+  WStype_FRAGMENT,
+  WStype_FRAGMENT_FIN,
+  WStype_PING,
+  WStype_PONG,
+} WStype_t;
+
+typedef enum {
+  WSop_continuation = 0x00,
+  WSop_text = 0x01,
+  WSop_binary = 0x02,
+  WSop_close = 0x08,
+  WSop_ping = 0x09,
+  WSop_pong = 0x0A
+} WSopcode_t;
+
+typedef enum {
+  WSC_NOT_CONNECTED,
+  WSC_HEADER,
+  WSC_BODY,
+  WSC_CONNECTED
+} WSclientsStatus_t;
+
+typedef struct {
+  uint8_t num;
+  WSclientsStatus_t status;
+  WEBSOCKETS_NETWORK_CLASS* tcp;
+  WiFiClientSecure* ssl;  // Same as tcp for a wss:// connection, else null
+  bool isSSL;
+  std::vector<uint8_t> rx;  // Received bytes not parsed into a frame yet
+} WSclient_t;
+
+// One frame parsed from the front of a receive buffer
+struct WsFrame {
+  WSopcode_t opcode;
+  size_t headerSize;
+  size_t length;
+  uint8_t* payload;  // Unmasked in place
+};
+
+class WebSockets {
+ public:
+  virtual ~WebSockets() {}
+
+  // Header for a frame of length bytes; returns its size
+  static size_t writeHeader(uint8_t* header, WSopcode_t opcode, size_t length, const uint8_t* maskKey);
+  // Parses the first frame in buffer; false until it is complete
+  static bool parseFrame(uint8_t* buffer, size_t available, WsFrame& frame);
+
+ protected:
+  /**
+   * Sends one frame the way the library does: with headerToPayload the
+   * header goes into the WEBSOCKETS_MAX_HEADER_SIZE bytes in front of the
+   * payload and one write sends both, otherwise header and payload are
+   * copied into a malloc()ed buffer first. A client mask is applied to
+   * the payload in place. A socket that takes no data for
+   * WEBSOCKETS_TCP_TIMEOUT ms is given up on.
+   */
+  bool sendFrame(WSclient_t* client, WSopcode_t opcode, uint8_t* payload, size_t length,
+                 bool mask, bool headerToPayload);
+};
+
+#endif // WEBSOCKETS_H
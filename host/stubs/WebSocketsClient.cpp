@@ -0,0 +1,255 @@
+/*
+ * arduinoWebSockets client for the host build, implementation
+ */
+#include "WebSocketsClient.h"
+#include "host_sim.h"
+
+HostApiServer hostApi;
+
+WebSocketsClient::WebSocketsClient()
+  : _port(0), _lastConnectionFail(0), _reconnectInterval(500), _link(0) {
+  _client.num = 0;
+  _client.status = WSC_NOT_CONNECTED;
+  _client.tcp = nullptr;
+  _client.ssl = nullptr;
+  _client.isSSL = false;
+}
+
+WebSocketsClient::~WebSocketsClient() {}
+
+void WebSocketsClient::begin(const char* host, uint16_t port, const char* url, const char* protocol) {
+  _host = host;
+  _port = port;
+  _client.isSSL = false;
+  _client.status = WSC_NOT_CONNECTED;
+  _lastConnectionFail = 0;
+}
+
+void WebSocketsClient::beginSSL(const char* host, uint16_t port, const char* url,
+                                const char* fingerprint, const char* protocol) {
+  begin(host, port, url, protocol);
+  _client.isSSL = true;
+}
+
+void WebSocketsClient::loop() {
+  if (_port == 0) return;
+
+  if (_client.status == WSC_NOT_CONNECTED) {
+    if (millis() - _lastConnectionFail < _reconnectInterval) return;
+
+    // The library's connect blocks until it succeeds or fails; a refusal
+    // comes back after one round trip
+    uint32_t connectMs = hostApi.reachable ? hostApi.connectMs : hostApi.rttMs;
+    hostSleepNs((uint64_t)connectMs * 1000000ULL);
+    if (!hostApi.open(_link)) {
+      _lastConnectionFail = millis();
+      return;
+    }
+    // Upgrade request sent; the reply is queued one round trip away
+    _client.status = WSC_HEADER;
+    _lastConnectionFail = 0;
+    return;
+  }
+
+  if (!hostApi.isOpen(_link)) {
+    clientDisconnect(&_client);
+    return;
+  }
+
+  std::string text;
+  while (_client.status != WSC_NOT_CONNECTED && hostApi.poll(_link, text)) {
+    if (_client.status == WSC_HEADER) {
+      // The first message is the 101 Switching Protocols reply
+      _client.status = WSC_CONNECTED;
+      runCbEvent(WStype_CONNECTED, (uint8_t*)"/", 1);
+      continue;
+    }
+    // Handed over NUL terminated and writable
+    std::vector<uint8_t> payload(text.begin(), text.end());
+    payload.push_back('\0');
+    runCbEvent(WStype_TEXT, payload.data(), text.size());
+  }
+}
+
+void WebSocketsClient::clientDisconnect(WSclient_t* client) {
+  bool wasConnected = client->status == WSC_CONNECTED;
+  client->status = WSC_NOT_CONNECTED;
+  if (client->ssl) {
+    // Made by SecureWebSocketsClient; tcp is the same object
+    delete client->tcp;
+    client->ssl = nullptr;
+    client->tcp = nullptr;
+  }
+  _link = 0;
+  if (wasConnected) runCbEvent(WStype_DISCONNECTED, NULL, 0);
+}
+
+void WebSocketsClient::connectedCb() {
+  if (!hostApi.open(_link)) {
+    _lastConnectionFail = millis();
+    return;
+  }
+  _client.status = WSC_HEADER;
+}
+
+void WebSocketsClient::disconnect() {
+  if (_client.status == WSC_CONNECTED) hostApi.receive(_link, WSop_close, nullptr, 0);
+  if (_client.status != WSC_NOT_CONNECTED) clientDisconnect(&_client);
+}
+
+bool WebSocketsClient::send(WSopcode_t opcode, uint8_t* payload, size_t length, bool headerToPayload) {
+  if (_client.status != WSC_CONNECTED || !hostApi.isOpen(_link)) return false;
+  // A write that times out, e.g. with the TCP window full
+  if (hostApi.failSends) {
+    hostApi.failSends--;
+    return false;
+  }
+  uint8_t* data = headerToPayload ? payload + WEBSOCKETS_MAX_HEADER_SIZE : payload;
+  hostApi.receive(_link, opcode, data, length);
+
+  // The library masks the payload in place and writes the header in
+  // front of it; the caller's buffer ends up the same way here
+  uint32_t key = esp_random();
+  uint8_t maskKey[4];
+  memcpy(maskKey, &key, sizeof(key));
+  for (size_t i = 0; i < length; i++) data[i] ^= maskKey[i & 3];
+  if (headerToPayload) {
+    uint8_t header[WEBSOCKETS_MAX_HEADER_SIZE];
+    size_t headerSize = writeHeader(header, opcode, length, maskKey);
+    memcpy(payload + WEBSOCKETS_MAX_HEADER_SIZE - headerSize, header, headerSize);
+  }
+  return true;
+}
+
+bool WebSocketsClient::sendTXT(uint8_t* payload, size_t length, bool headerToPayload) {
+  if (length == 0) length = strlen((const char*)payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0));
+  return send(WSop_text, payload, length, headerToPayload);
+}
+
+bool WebSocketsClient::sendTXT(const uint8_t* payload, size_t length) {
+  if (length == 0) length = strlen((const char*)payload);
+  // Masked in a copy; the library does the same through its malloc()ed frame
+  std::vector<uint8_t> copy(payload, payload + length);
+  return send(WSop_text, copy.data(), length, false);
+}
+
+bool WebSocketsClient::sendTXT(char* payload, size_t length, bool headerToPayload) {
+  return sendTXT((uint8_t*)payload, length, headerToPayload);
+}
+
+bool WebSocketsClient::sendTXT(const char* payload, size_t length) {
+  return sendTXT((const uint8_t*)payload, length);
+}
+
+bool WebSocketsClient::sendTXT(String& payload) {
+  return sendTXT((const uint8_t*)payload.c_str(), payload.length());
+}
+
+bool WebSocketsClient::sendBIN(uint8_t* payload, size_t length, bool headerToPayload) {
+  return send(WSop_binary, payload, length, headerToPayload);
+}
+
+bool WebSocketsClient::sendBIN(const uint8_t* payload, size_t length) {
+  std::vector<uint8_t> copy(payload, payload + length);
+  return send(WSop_binary, copy.data(), length, false);
+}
+
+// ===== API SERVER =====
+HostApiServer::HostApiServer()
+  : reachable(true), connectMs(30), rttMs(30), acceptBinary(true), failSends(0), connects(0),
+    refused(0), hellos(0), pings(0), jsonSamples(0), binarySamples(0), rejected(0), lastAck(0),
+    bytesIn(0), lastSample(), link_(0), nextLink_(1) {}
+
+bool HostApiServer::linked() const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return link_ != 0;
+}
+
+bool HostApiServer::open(uint32_t& link) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (!reachable) {
+    refused++;
+    return false;
+  }
+  link_ = link = nextLink_++;
+  connects++;
+  inbound_.clear();
+  decoder_.reset();
+  // The 101 reply
+  queueLocked(std::string());
+  return true;
+}
+
+bool HostApiServer::isOpen(uint32_t link) const {
+  std::lock_guard<std::mutex> lock(mutex_);
+  return link != 0 && link == link_;
+}
+
+void HostApiServer::queueLocked(const std::string& text) {
+  inbound_.push_back({ hostNowNs() + (uint64_t)rttMs * 1000000ULL, text });
+}
+
+void HostApiServer::inject(const char* text) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (link_) queueLocked(text);
+}
+
+void HostApiServer::drop() {
+  std::lock_guard<std::mutex> lock(mutex_);
+  link_ = 0;
+  inbound_.clear();
+}
+
+bool HostApiServer::poll(uint32_t link, std::string& text) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (link != link_ || inbound_.empty() || inbound_.front().dueNs > hostNowNs()) return false;
+  text.swap(inbound_.front().text);
+  inbound_.pop_front();
+  return true;
+}
+
+// Finds "key": in a JSON text and returns the number after it, or def
+static long jsonNumber(const std::string& text, const char* key, long def) {
+  std::string quoted = std::string("\"") + key + "\":";
+  size_t at = text.find(quoted);
+  return at == std::string::npos ? def : atol(text.c_str() + at + quoted.size());
+}
+
+void HostApiServer::receive(uint32_t link, WSopcode_t opcode, const uint8_t* payload, size_t length) {
+  std::lock_guard<std::mutex> lock(mutex_);
+  if (link != link_) return;
+  bytesIn += length;
+
+  if (opcode == WSop_close) {
+    link_ = 0;
+    inbound_.clear();
+    return;
+  }
+  if (opcode == WSop_binary) {
+    if (decoder_.decode(payload, length, lastSample)) {
+      binarySamples++;
+    } else {
+      rejected++;
+    }
+    return;
+  }
+
+  std::string text((const char*)payload, length);
+  if (text == "ping") {
+    pings++;
+    return;
+  }
+  lastText = text;
+  if (text.find("\"action\":\"hello\"") != std::string::npos) {
+    hellos++;
+    long offered = jsonNumber(text, "binary", 0);
+    char reply[64];
+    snprintf(reply, sizeof(reply), "{\"action\":\"hello\",\"payload\":{\"binary\":%ld}}",
+             acceptBinary ? offered : 0L);
+    queueLocked(reply);
+  } else if (text.find("\"action\":\"updateenv\"") != std::string::npos) {
+    jsonSamples++;
+    long ack = jsonNumber(text, "ack", 0);
+    if (ack) lastAck = (uint32_t)ack;
+  }
+}
@@ -0,0 +1,127 @@
+/*
+ * arduinoWebSockets client for the host build
+ *
+ * There is no network behind it: the API server is hostApi, which lives
+ * in-process and answers the way tools/uplink_standin.py does. The
+ * TCP/TLS connect blocks the calling task for hostApi.connectMs, the
+ * upgrade reply and every server message arrive one hostApi.rttMs later
+ * through loop(), like on the device.
+ */
+#ifndef WEBSOCKETS_CLIENT_H
+#define WEBSOCKETS_CLIENT_H
+
+#include "WebSockets.h"
+#include <deque>
+#include <mutex>
+#include <string>
+#include "binary_telemetry.h"
+
+class WebSocketsClient : protected WebSockets {
+ public:
+  typedef std::function<void(WStype_t type, uint8_t* payload, size_t length)> WebSocketClientEvent;
+
+  WebSocketsClient();
+  virtual ~WebSocketsClient();
+
+  void begin(const char* host, uint16_t port, const char* url = "/", const char* protocol = "arduino");
+  void beginSSL(const char* host, uint16_t port, const char* url = "/", const char* fingerprint = "",
+                const char* protocol = "arduino");
+  void loop();
+  void onEvent(WebSocketClientEvent cbEvent) { _cbEvent = cbEvent; }
+
+  bool sendTXT(uint8_t* payload, size_t length = 0, bool headerToPayload = false);
+  bool sendTXT(const uint8_t* payload, size_t length = 0);
+  bool sendTXT(char* payload, size_t length = 0, bool headerToPayload = false);
+  bool sendTXT(const char* payload, size_t length = 0);
+  bool sendTXT(String& payload);
+  bool sendBIN(uint8_t* payload, size_t length, bool headerToPayload = false);
+  bool sendBIN(const uint8_t* payload, size_t length);
+
+  void disconnect();
+  void setReconnectInterval(unsigned long time) { _reconnectInterval = time; }
+  bool isConnected() { return _client.status == WSC_CONNECTED; }
+
+ protected:
+  virtual void runCbEvent(WStype_t type, uint8_t* payload, size_t length) {
+    if (_cbEvent) _cbEvent(type, payload, length);
+  }
+
+  // As in the library: connected or still upgrading
+  bool clientIsConnected(WSclient_t* client) { return client->status != WSC_NOT_CONNECTED; }
+  // A connect made outside loop(), as SecureWebSocketsClient makes its
+  // wss:// ones: the upgrade request goes to hostApi from here
+  void connectedCb();
+  void connectFailedCb() {}
+  void clientDisconnect(WSclient_t* client);
+  bool send(WSopcode_t opcode, uint8_t* payload, size_t length, bool headerToPayload);
+
+  String _host;
+  uint16_t _port;
+  WSclient_t _client;
+  WebSocketClientEvent _cbEvent;
+  unsigned long _lastConnectionFail;
+  unsigned long _reconnectInterval;
+  uint32_t _link;  // hostApi connection this client holds
+};
+
+// ===== HOST CONTROL =====
+/**
+ * The API server behind every WebSocketsClient. Set it up and read it
+ * between hostSimRun() calls; the client side runs on the firmware's
+ * tasks.
+ */
+class HostApiServer {
+ public:
+  HostApiServer();
+
+  // ----- Behaviour -----
+  bool reachable;       // False: connects are refused after one round trip
+  uint32_t connectMs;   // TCP connect plus TLS handshake, blocking the caller
+  uint32_t rttMs;       // Round trip for the upgrade and every reply
+  bool acceptBinary;    // Accepts the binary telemetry format in the hello reply
+  uint32_t failSends;   // Next sends fail on the client side; the link stays up
+
+  // ----- What it saw -----
+  uint32_t connects;
+  uint32_t refused;
+  uint32_t hellos;
+  uint32_t pings;
+  uint32_t jsonSamples;     // updateenv frames
+  uint32_t binarySamples;   // Binary frames that decoded
+  uint32_t rejected;        // Binary frames that did not
+  uint32_t lastAck;         // Last "ack" of an updateenv frame
+  uint32_t bytesIn;         // Payload bytes received
+  std::string lastText;     // Last text frame other than "ping"
+  TelemetrySample lastSample;
+
+  bool linked() const;
+  // Sends text to the connected client, arriving one rttMs from now
+  void inject(const char* text);
+  // Drops the connection; the client notices on its next loop()
+  void drop();
+
+  // ----- Client side -----
+  bool open(uint32_t& link);
+  bool isOpen(uint32_t link) const;
+  void receive(uint32_t link, WSopcode_t opcode, const uint8_t* payload, size_t length);
+  // Next message due for link, if any
+  bool poll(uint32_t link, std::string& text);
+
+ private:
+  struct Pending {
+    uint64_t dueNs;
+    std::string text;
+  };
+
+  void queueLocked(const std::string& text);
+
+  mutable std::mutex mutex_;
+  uint32_t link_;       // Current connection, 0 for none
+  uint32_t nextLink_;
+  std::deque<Pending> inbound_;
+  BinaryTelemetryDecoder decoder_;
+};
+
+extern HostApiServer hostApi;
+
+#endif // WEBSOCKETS_CLIENT_H
@@ -0,0 +1,311 @@
+/*
+ * arduinoWebSockets server for the host build, implementation
+ */
+#include "WebSocketsServer.h"
+#include <fcntl.h>
+#include <map>
+#include <mutex>
+#include <sys/socket.h>
+#include <unistd.h>
+#include "host_sim.h"
+
+// lwIP's TCP_SND_BUF in the Arduino-ESP32 2.x build
+#define SERVER_SEND_BUFFER 5744
+
+// Listening servers and the connections waiting for their next loop()
+static std::mutex listenMutex;
+static std::map<uint16_t, std::vector<int>> pendingAccepts;
+
+static void setNonBlocking(int fd) {
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL) | O_NONBLOCK);
+}
+
+WebSocketsServer::WebSocketsServer(uint16_t port, const String& origin, const String& protocol)
+  : _port(port), _runnning(false) {
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    _clients[i].num = i;
+    _clients[i].status = WSC_NOT_CONNECTED;
+    _clients[i].tcp = nullptr;
+    _clients[i].ssl = nullptr;
+    _clients[i].isSSL = false;
+  }
+}
+
+WebSocketsServer::~WebSocketsServer() {
+  close();
+}
+
+void WebSocketsServer::begin() {
+  std::lock_guard<std::mutex> lock(listenMutex);
+  pendingAccepts[_port];
+  _runnning = true;
+}
+
+void WebSocketsServer::close() {
+  {
+    std::lock_guard<std::mutex> lock(listenMutex);
+    pendingAccepts.erase(_port);
+  }
+  _runnning = false;
+  disconnect();
+}
+
+void WebSocketsServer::loop() {
+  if (!_runnning) return;
+
+  std::vector<int> accepted;
+  {
+    std::lock_guard<std::mutex> lock(listenMutex);
+    accepted.swap(pendingAccepts[_port]);
+  }
+  for (int fd : accepted) {
+    WSclient_t* slot = nullptr;
+    for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX && !slot; i++) {
+      if (!clientIsConnected(&_clients[i])) slot = &_clients[i];
+    }
+    if (slot == nullptr) {
+      // No free slot: the library rejects the upgrade and hangs up
+      ::close(fd);
+      continue;
+    }
+    delete slot->tcp;
+    slot->tcp = new WiFiClient(fd);
+    slot->status = WSC_CONNECTED;
+    slot->rx.clear();
+    runCbEvent(slot->num, WStype_CONNECTED, (uint8_t*)"/", 1);
+  }
+
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    WSclient_t* client = &_clients[i];
+    if (client->status == WSC_NOT_CONNECTED) continue;
+    if (!clientIsConnected(client)) {
+      clientDisconnect(client);
+      continue;
+    }
+    handleClientData(client);
+  }
+}
+
+bool WebSocketsServer::clientIsConnected(WSclient_t* client) {
+  return client->tcp != nullptr && client->tcp->connected() && client->status == WSC_CONNECTED;
+}
+
+void WebSocketsServer::clientDisconnect(WSclient_t* client) {
+  if (client->tcp) {
+    delete client->tcp;
+    client->tcp = nullptr;
+  }
+  client->rx.clear();
+  bool wasConnected = client->status == WSC_CONNECTED;
+  client->status = WSC_NOT_CONNECTED;
+  if (wasConnected) runCbEvent(client->num, WStype_DISCONNECTED, NULL, 0);
+}
+
+void WebSocketsServer::handleClientData(WSclient_t* client) {
+  uint8_t buffer[1024];
+  for (;;) {
+    int n = client->tcp->read(buffer, sizeof(buffer));
+    if (n < 0) {
+      clientDisconnect(client);
+      return;
+    }
+    if (n == 0) break;
+    client->rx.insert(client->rx.end(), buffer, buffer + n);
+  }
+
+  size_t offset = 0;
+  WsFrame frame;
+  while (client->status == WSC_CONNECTED &&
+         parseFrame(client->rx.data() + offset, client->rx.size() - offset, frame)) {
+    if (frame.length > WEBSOCKETS_MAX_DATA_SIZE) {
+      clientDisconnect(client);
+      return;
+    }
+    // The library hands text payloads over NUL terminated
+    std::vector<uint8_t> payload(frame.payload, frame.payload + frame.length);
+    payload.push_back('\0');
+    offset += frame.headerSize + frame.length;
+
+    switch (frame.opcode) {
+      case WSop_text:
+        runCbEvent(client->num, WStype_TEXT, payload.data(), frame.length);
+        break;
+      case WSop_binary:
+        runCbEvent(client->num, WStype_BIN, payload.data(), frame.length);
+        break;
+      case WSop_ping:
+        sendFrame(client, WSop_pong, payload.data(), frame.length, false, false);
+        runCbEvent(client->num, WStype_PING, payload.data(), frame.length);
+        break;
+      case WSop_pong:
+        runCbEvent(client->num, WStype_PONG, payload.data(), frame.length);
+        break;
+      case WSop_close:
+        sendFrame(client, WSop_close, NULL, 0, false, false);
+        clientDisconnect(client);
+        return;
+      default:
+        break;
+    }
+  }
+  if (client->status == WSC_CONNECTED) client->rx.erase(client->rx.begin(), client->rx.begin() + offset);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, uint8_t* payload, size_t length, bool headerToPayload) {
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return false;
+  if (length == 0) length = strlen((const char*)payload + (headerToPayload ? WEBSOCKETS_MAX_HEADER_SIZE : 0));
+  WSclient_t* client = &_clients[num];
+  if (!clientIsConnected(client)) return false;
+  return sendFrame(client, WSop_text, payload, length, false, headerToPayload);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, const uint8_t* payload, size_t length) {
+  return sendTXT(num, (uint8_t*)payload, length);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, char* payload, size_t length, bool headerToPayload) {
+  return sendTXT(num, (uint8_t*)payload, length, headerToPayload);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, const char* payload, size_t length) {
+  return sendTXT(num, (uint8_t*)payload, length);
+}
+
+bool WebSocketsServer::sendTXT(uint8_t num, String& payload) {
+  return sendTXT(num, (uint8_t*)payload.c_str(), payload.length());
+}
+
+bool WebSocketsServer::broadcastTXT(const char* payload, size_t length) {
+  bool ok = true;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (clientIsConnected(&_clients[i])) ok = sendTXT(i, payload, length) && ok;
+  }
+  return ok;
+}
+
+bool WebSocketsServer::sendBIN(uint8_t num, uint8_t* payload, size_t length, bool headerToPayload) {
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return false;
+  WSclient_t* client = &_clients[num];
+  if (!clientIsConnected(client)) return false;
+  return sendFrame(client, WSop_binary, payload, length, false, headerToPayload);
+}
+
+bool WebSocketsServer::sendBIN(uint8_t num, const uint8_t* payload, size_t length) {
+  return sendBIN(num, (uint8_t*)payload, length);
+}
+
+bool WebSocketsServer::sendPing(uint8_t num, uint8_t* payload, size_t length) {
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return false;
+  WSclient_t* client = &_clients[num];
+  if (!clientIsConnected(client)) return false;
+  return sendFrame(client, WSop_ping, payload, length, false, false);
+}
+
+void WebSocketsServer::disconnect() {
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) disconnect(i);
+}
+
+void WebSocketsServer::disconnect(uint8_t num) {
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX) return;
+  WSclient_t* client = &_clients[num];
+  if (clientIsConnected(client)) sendFrame(client, WSop_close, NULL, 0, false, false);
+  if (client->status != WSC_NOT_CONNECTED) clientDisconnect(client);
+}
+
+uint8_t WebSocketsServer::connectedClients(bool ping) {
+  uint8_t count = 0;
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if (clientIsConnected(&_clients[i])) count++;
+  }
+  return count;
+}
+
+IPAddress WebSocketsServer::remoteIP(uint8_t num) {
+  if (num >= WEBSOCKETS_SERVER_CLIENT_MAX || !clientIsConnected(&_clients[num])) return IPAddress();
+  return IPAddress(192, 168, 1, 100 + num);
+}
+
+// ===== HOST PEER =====
+bool HostWsPeer::connect(uint16_t port) {
+  close();
+  std::lock_guard<std::mutex> lock(listenMutex);
+  auto listener = pendingAccepts.find(port);
+  if (listener == pendingAccepts.end()) return false;
+
+  int fds[2];
+  if (socketpair(AF_UNIX, SOCK_STREAM, 0, fds) != 0) return false;
+  setNonBlocking(fds[0]);
+  setNonBlocking(fds[1]);
+  int size = SERVER_SEND_BUFFER;
+  setsockopt(fds[1], SOL_SOCKET, SO_SNDBUF, &size, sizeof(size));
+  setsockopt(fds[0], SOL_SOCKET, SO_RCVBUF, &size, sizeof(size));
+  fd_ = fds[0];
+  listener->second.push_back(fds[1]);
+  rx_.clear();
+  return true;
+}
+
+bool HostWsPeer::send(WSopcode_t opcode, const uint8_t* payload, size_t length) {
+  if (fd_ < 0) return false;
+  // Clients always mask
+  uint8_t maskKey[4] = { 0x37, 0xfa, 0x21, 0x3d };
+  std::vector<uint8_t> frame(WEBSOCKETS_MAX_HEADER_SIZE + length);
+  size_t headerSize = WebSockets::writeHeader(frame.data(), opcode, length, maskKey);
+  for (size_t i = 0; i < length; i++) frame[headerSize + i] = payload[i] ^ maskKey[i & 3];
+  size_t total = headerSize + length;
+  ssize_t n = ::send(fd_, frame.data(), total, MSG_DONTWAIT | MSG_NOSIGNAL);
+  return n == (ssize_t)total;
+}
+
+size_t HostWsPeer::receive() {
+  if (fd_ < 0) return 0;
+  uint8_t buffer[4096];
+  bool closed = false;
+  for (;;) {
+    ssize_t n = recv(fd_, buffer, sizeof(buffer), MSG_DONTWAIT);
+    if (n == 0) {
+      closed = true;
+      break;
+    }
+    if (n < 0) break;
+    rx_.insert(rx_.end(), buffer, buffer + n);
+  }
+
+  size_t received = 0;
+  size_t offset = 0;
+  WsFrame frame;
+  while (WebSockets::parseFrame(rx_.data() + offset, rx_.size() - offset, frame)) {
+    offset += frame.headerSize + frame.length;
+    switch (frame.opcode) {
+      case WSop_text:
+      case WSop_binary:
+        messages_.emplace_back((const char*)frame.payload, frame.length);
+        received++;
+        break;
+      case WSop_ping:
+        pings_++;
+        send(WSop_pong, frame.payload, frame.length);
+        break;
+      case WSop_close:
+        closed = true;
+        break;
+      default:
+        break;
+    }
+  }
+  rx_.erase(rx_.begin(), rx_.begin() + offset);
+
+  if (closed) {
+    ::close(fd_);
+    fd_ = -1;
+  }
+  return received;
+}
+
+void HostWsPeer::close() {
+  if (fd_ < 0) return;
+  send(WSop_close, nullptr, 0);
+  ::close(fd_);
+  fd_ = -1;
+  rx_.clear();
+}
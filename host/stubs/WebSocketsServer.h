@@ -0,0 +1,101 @@
+/*
+ * arduinoWebSockets server for the host build
+ *
+ * Clients are HostWsPeer objects on the harness side of a socketpair.
+ * The server's end has the ESP32's TCP send buffer, so a peer that stops
+ * reading fills it like a slow phone on WiFi does.
+ *
+ *   HostWsPeer phone;
+ *   phone.connect(81);         // accepted on the server's next loop()
+ *   phone.sendText("led1:128");
+ *   hostSimRun(100);
+ *   phone.receive();           // frames the hub sent, pings answered
+ */
+#ifndef WEBSOCKETS_SERVER_H
+#define WEBSOCKETS_SERVER_H
+
+#include "WebSockets.h"
+#include <string>
+
+#define WEBSOCKETS_SERVER_CLIENT_MAX (5)
+
+class WebSocketsServer : protected WebSockets {
+ public:
+  typedef std::function<void(uint8_t num, WStype_t type, uint8_t* payload, size_t length)>
+      WebSocketServerEvent;
+
+  explicit WebSocketsServer(uint16_t port, const String& origin = "", const String& protocol = "arduino");
+  virtual ~WebSocketsServer();
+
+  void begin();
+  void close();
+  void loop();
+  void onEvent(WebSocketServerEvent cbEvent) { _cbEvent = cbEvent; }
+
+  bool sendTXT(uint8_t num, uint8_t* payload, size_t length = 0, bool headerToPayload = false);
+  bool sendTXT(uint8_t num, const uint8_t* payload, size_t length = 0);
+  bool sendTXT(uint8_t num, char* payload, size_t length = 0, bool headerToPayload = false);
+  bool sendTXT(uint8_t num, const char* payload, size_t length = 0);
+  bool sendTXT(uint8_t num, String& payload);
+  bool broadcastTXT(const char* payload, size_t length = 0);
+  bool sendBIN(uint8_t num, uint8_t* payload, size_t length, bool headerToPayload = false);
+  bool sendBIN(uint8_t num, const uint8_t* payload, size_t length);
+  bool sendPing(uint8_t num, uint8_t* payload = NULL, size_t length = 0);
+
+  void disconnect();
+  void disconnect(uint8_t num);
+  uint8_t connectedClients(bool ping = false);
+  IPAddress remoteIP(uint8_t num);
+
+ protected:
+  virtual void runCbEvent(uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+    if (_cbEvent) _cbEvent(num, type, payload, length);
+  }
+
+  bool clientIsConnected(WSclient_t* client);
+  void clientDisconnect(WSclient_t* client);
+  void handleClientData(WSclient_t* client);
+
+  uint16_t _port;
+  WSclient_t _clients[WEBSOCKETS_SERVER_CLIENT_MAX];
+  WebSocketServerEvent _cbEvent;
+  bool _runnning;
+};
+
+// ===== HOST CONTROL =====
+// A WebSocket client on the harness side; call it only between
+// hostSimRun() calls
+class HostWsPeer {
+ public:
+  HostWsPeer() : fd_(-1), pings_(0) {}
+  ~HostWsPeer() { close(); }
+
+  // Queues a connection to the server on port; false if none listens
+  bool connect(uint16_t port);
+  // False once the server has closed the connection (see receive())
+  bool connected() const { return fd_ >= 0; }
+
+  bool sendText(const char* text) { return sendText((const uint8_t*)text, strlen(text)); }
+  bool sendText(const uint8_t* payload, size_t length) { return send(WSop_text, payload, length); }
+  bool sendBinary(const uint8_t* payload, size_t length) { return send(WSop_binary, payload, length); }
+
+  // Reads what has arrived, answers pings and returns the number of new
+  // text and binary messages
+  size_t receive();
+  const std::vector<std::string>& messages() const { return messages_; }
+  void clearMessages() { messages_.clear(); }
+  uint32_t pings() const { return pings_; }
+
+  // Sends a close frame and hangs up
+  void close();
+
+ private:
+  bool send(WSopcode_t opcode, const uint8_t* payload, size_t length);
+
+  int fd_;
+  std::vector<uint8_t> rx_;
+  std::vector<std::string> messages_;
+  uint32_t pings_;
+};
+
+#endif // WEBSOCKETS_SERVER_H
@@ -0,0 +1,305 @@
+/*
+ * WiFi for the host build, implementation
+ */
+#include "WiFi.h"
+#include <mutex>
+#include <string>
+#include <vector>
+#include "host_sim.h"
+
+#define SCAN_TIME 2500
+#define ASSOCIATE_TIME 300
+#define DHCP_TIME 1000
+#define FAIL_TIME 3000
+
+struct HostNetwork {
+  std::string ssid;
+  std::string password;
+  int8_t rssi;
+  uint8_t channel;
+  uint8_t bssid[6];
+};
+
+WiFiClass WiFi;
+
+static std::mutex wifiMutex;
+static std::vector<HostNetwork> networks;
+static std::vector<WiFiEventCb> callbacks;
+static wifi_mode_t wifiMode = WIFI_OFF;
+static wl_status_t staStatus = WL_IDLE_STATUS;
+static uint32_t attemptId = 0;      // Bumped to cancel a pending result
+static uint32_t attempts = 0;
+static IPAddress staticIP, staticGateway, staticSubnet, staticDns;
+static HostNetwork joined;          // Network of the last successful connect
+static bool scanning = false;
+static bool scanDone = false;
+static std::vector<HostNetwork> scanResults;
+static wifi_sta_config_t driverConfig;
+
+static const HostNetwork* findNetwork(const char* ssid) {
+  for (const HostNetwork& net : networks) {
+    if (net.ssid == ssid) return &net;
+  }
+  return nullptr;
+}
+
+// Runs the callbacks on the system event task, like the core's event loop
+static void raiseEvent(arduino_event_id_t event) {
+  hostSimAt(0, [event] {
+    std::vector<WiFiEventCb> targets;
+    {
+      std::lock_guard<std::mutex> lock(wifiMutex);
+      targets = callbacks;
+    }
+    for (WiFiEventCb callback : targets) callback(event);
+  });
+}
+
+void WiFiClass::onEvent(WiFiEventCb callback, arduino_event_id_t event) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  callbacks.push_back(callback);
+}
+
+bool WiFiClass::mode(wifi_mode_t mode) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  wifiMode = mode;
+  return true;
+}
+
+wifi_mode_t WiFiClass::getMode() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return wifiMode;
+}
+
+bool WiFiClass::config(IPAddress localIP, IPAddress gateway, IPAddress subnet,
+                       IPAddress dns1, IPAddress dns2) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  staticIP = localIP;
+  staticGateway = gateway;
+  staticSubnet = subnet;
+  staticDns = dns1;
+  return true;
+}
+
+wl_status_t WiFiClass::begin(const char* ssid, const char* passphrase, int32_t channel,
+                             const uint8_t* bssid, bool connect) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  if (wifiMode == WIFI_OFF || wifiMode == WIFI_AP) wifiMode = (wifiMode == WIFI_AP) ? WIFI_AP_STA : WIFI_STA;
+  uint32_t id = ++attemptId;
+  attempts++;
+  staStatus = WL_DISCONNECTED;
+
+  const HostNetwork* net = findNetwork(ssid);
+  bool found = net && (bssid == nullptr || memcmp(bssid, net->bssid, 6) == 0);
+  bool accepted = found && net->password == (passphrase ? passphrase : "");
+  if (!accepted) {
+    hostSimAt(FAIL_TIME, [id, found] {
+      {
+        std::lock_guard<std::mutex> lock(wifiMutex);
+        if (id != attemptId) return;
+        staStatus = found ? WL_CONNECT_FAILED : WL_NO_SSID_AVAIL;
+      }
+      raiseEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+    });
+    return staStatus;
+  }
+
+  bool known = channel != 0 && bssid != nullptr;
+  bool dhcp = (uint32_t)staticIP == 0;
+  uint32_t time = (known ? 0 : SCAN_TIME) + ASSOCIATE_TIME + (dhcp ? DHCP_TIME : 0);
+  HostNetwork target = *net;
+  hostSimAt(time, [id, target] {
+    {
+      std::lock_guard<std::mutex> lock(wifiMutex);
+      if (id != attemptId) return;
+      staStatus = WL_CONNECTED;
+      joined = target;
+    }
+    raiseEvent(ARDUINO_EVENT_WIFI_STA_CONNECTED);
+    raiseEvent(ARDUINO_EVENT_WIFI_STA_GOT_IP);
+  });
+  return staStatus;
+}
+
+bool WiFiClass::disconnect(bool wifiOff, bool eraseAp) {
+  bool wasUp;
+  {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    attemptId++;
+    wasUp = staStatus == WL_CONNECTED;
+    staStatus = WL_DISCONNECTED;
+    if (wifiOff) wifiMode = WIFI_OFF;
+  }
+  if (wasUp) raiseEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+  return true;
+}
+
+wl_status_t WiFiClass::status() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return staStatus;
+}
+
+IPAddress WiFiClass::localIP() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  if (staStatus != WL_CONNECTED) return IPAddress();
+  return (uint32_t)staticIP ? staticIP : IPAddress(192, 168, 1, 50);
+}
+
+IPAddress WiFiClass::gatewayIP() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return (uint32_t)staticGateway ? staticGateway : IPAddress(192, 168, 1, 1);
+}
+
+IPAddress WiFiClass::subnetMask() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return (uint32_t)staticSubnet ? staticSubnet : IPAddress(255, 255, 255, 0);
+}
+
+IPAddress WiFiClass::dnsIP(uint8_t index) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return (uint32_t)staticDns ? staticDns : IPAddress(192, 168, 1, 1);
+}
+
+uint8_t* WiFiClass::BSSID() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return staStatus == WL_CONNECTED ? joined.bssid : nullptr;
+}
+
+int32_t WiFiClass::channel() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return staStatus == WL_CONNECTED ? joined.channel : 0;
+}
+
+int8_t WiFiClass::RSSI() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return staStatus == WL_CONNECTED ? joined.rssi : 0;
+}
+
+int WiFiClass::hostByName(const char* host, IPAddress& result) {
+  return result.fromString(host) ? 1 : 0;
+}
+
+bool WiFiClass::softAPConfig(IPAddress localIP, IPAddress gateway, IPAddress subnet) {
+  return true;
+}
+
+bool WiFiClass::softAP(const char* ssid, const char* passphrase) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  wifiMode = wifiMode == WIFI_STA ? WIFI_AP_STA : WIFI_AP;
+  return true;
+}
+
+// ===== SCAN =====
+int16_t WiFiClass::scanNetworks(bool async) {
+  {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    if (scanning) return WIFI_SCAN_RUNNING;
+    scanning = true;
+    scanDone = false;
+  }
+  hostSimAt(SCAN_TIME, [] {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    scanResults = networks;
+    scanning = false;
+    scanDone = true;
+  });
+  if (async) return WIFI_SCAN_RUNNING;
+  delay(SCAN_TIME);
+  return scanComplete();
+}
+
+int16_t WiFiClass::scanComplete() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  if (scanning) return WIFI_SCAN_RUNNING;
+  return scanDone ? (int16_t)scanResults.size() : WIFI_SCAN_FAILED;
+}
+
+void WiFiClass::scanDelete() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  scanResults.clear();
+  scanDone = false;
+}
+
+String WiFiClass::SSID(uint8_t index) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return index < scanResults.size() ? String(scanResults[index].ssid.c_str()) : String();
+}
+
+int32_t WiFiClass::RSSI(uint8_t index) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return index < scanResults.size() ? scanResults[index].rssi : 0;
+}
+
+wifi_auth_mode_t WiFiClass::encryptionType(uint8_t index) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  if (index >= scanResults.size() || scanResults[index].password.empty()) return WIFI_AUTH_OPEN;
+  return WIFI_AUTH_WPA2_PSK;
+}
+
+// ===== DRIVER =====
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t* conf) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  memset(conf, 0, sizeof(*conf));
+  if (interface == WIFI_IF_STA) conf->sta = driverConfig;
+  return ESP_OK;
+}
+
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage) {
+  return ESP_OK;
+}
+
+// ===== HOST CONTROL =====
+void hostWifiAddNetwork(const char* ssid, const char* password, int8_t rssi, uint8_t channel) {
+  HostNetwork net;
+  net.ssid = ssid;
+  net.password = password ? password : "";
+  net.rssi = rssi;
+  net.channel = channel;
+  // A stable BSSID per SSID, with an Espressif OUI
+  uint32_t hash = 2166136261u;
+  for (const char* p = ssid; *p; p++) hash = (hash ^ (uint8_t)*p) * 16777619u;
+  const uint8_t bssid[6] = { 0x24, 0x0a, 0xc4, (uint8_t)(hash >> 16), (uint8_t)(hash >> 8), (uint8_t)hash };
+  memcpy(net.bssid, bssid, sizeof(bssid));
+
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  for (HostNetwork& existing : networks) {
+    if (existing.ssid == ssid) {
+      existing = net;
+      return;
+    }
+  }
+  networks.push_back(net);
+}
+
+void hostWifiRemoveNetwork(const char* ssid) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  for (size_t i = 0; i < networks.size(); i++) {
+    if (networks[i].ssid == ssid) {
+      networks.erase(networks.begin() + i);
+      return;
+    }
+  }
+}
+
+void hostWifiSetDriverConfig(const char* ssid, const char* password) {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  memset(&driverConfig, 0, sizeof(driverConfig));
+  // Neither field has to be NUL terminated in the driver
+  memcpy(driverConfig.ssid, ssid, strnlen(ssid, sizeof(driverConfig.ssid)));
+  memcpy(driverConfig.password, password, strnlen(password, sizeof(driverConfig.password)));
+}
+
+void hostWifiDropLink() {
+  {
+    std::lock_guard<std::mutex> lock(wifiMutex);
+    if (staStatus != WL_CONNECTED) return;
+    attemptId++;
+    staStatus = WL_CONNECTION_LOST;
+  }
+  raiseEvent(ARDUINO_EVENT_WIFI_STA_DISCONNECTED);
+}
+
+uint32_t hostWifiAttempts() {
+  std::lock_guard<std::mutex> lock(wifiMutex);
+  return attempts;
+}
@@ -0,0 +1,105 @@
+/*
+ * WiFi for the host build
+ *
+ * A station in a simulated radio neighbourhood. The harness lists the
+ * access points in range; begin() then succeeds or fails after the time
+ * a scan, association and DHCP take on the device, and raises the same
+ * events from the system event task:
+ *
+ *   hostWifiAddNetwork("home", "secret", -55);
+ *   hostWifiDropLink();         // the AP goes away
+ *
+ * Times: a connect with a known channel and BSSID skips the 2.5 s scan,
+ * a static address skips the 1 s of DHCP, association takes 300 ms.
+ * A wrong password or missing network fails after 3 s.
+ */
+#ifndef WIFI_H
+#define WIFI_H
+
+#include <Arduino.h>
+#include "WiFiClient.h"
+#include "esp_wifi.h"
+
+typedef enum {
+  ARDUINO_EVENT_WIFI_READY,
+  ARDUINO_EVENT_WIFI_SCAN_DONE,
+  ARDUINO_EVENT_WIFI_STA_START,
+  ARDUINO_EVENT_WIFI_STA_STOP,
+  ARDUINO_EVENT_WIFI_STA_CONNECTED,
+  ARDUINO_EVENT_WIFI_STA_DISCONNECTED,
+  ARDUINO_EVENT_WIFI_STA_GOT_IP,
+  ARDUINO_EVENT_WIFI_STA_LOST_IP,
+  ARDUINO_EVENT_WIFI_AP_START,
+  ARDUINO_EVENT_WIFI_AP_STOP,
+  ARDUINO_EVENT_MAX
+} arduino_event_id_t;
+#define WiFiEvent_t arduino_event_id_t
+typedef void (*WiFiEventCb)(arduino_event_id_t event);
+
+typedef enum { WIFI_OFF, WIFI_STA, WIFI_AP, WIFI_AP_STA } wifi_mode_t;
+
+typedef enum {
+  WL_IDLE_STATUS = 0,
+  WL_NO_SSID_AVAIL = 1,
+  WL_SCAN_COMPLETED = 2,
+  WL_CONNECTED = 3,
+  WL_CONNECT_FAILED = 4,
+  WL_CONNECTION_LOST = 5,
+  WL_DISCONNECTED = 6,
+  WL_NO_SHIELD = 255
+} wl_status_t;
+
+#define WIFI_SCAN_RUNNING (-1)
+#define WIFI_SCAN_FAILED (-2)
+
+class WiFiClass {
+ public:
+  void onEvent(WiFiEventCb callback, arduino_event_id_t event = ARDUINO_EVENT_MAX);
+  void persistent(bool persistent) {}
+  bool setAutoReconnect(bool autoReconnect) { return true; }
+
+  bool mode(wifi_mode_t mode);
+  wifi_mode_t getMode();
+
+  bool config(IPAddress localIP, IPAddress gateway, IPAddress subnet,
+              IPAddress dns1 = (uint32_t)0, IPAddress dns2 = (uint32_t)0);
+  wl_status_t begin(const char* ssid, const char* passphrase = nullptr, int32_t channel = 0,
+                    const uint8_t* bssid = nullptr, bool connect = true);
+  bool disconnect(bool wifiOff = false, bool eraseAp = false);
+  wl_status_t status();
+
+  IPAddress localIP();
+  IPAddress gatewayIP();
+  IPAddress subnetMask();
+  IPAddress dnsIP(uint8_t index = 0);
+  uint8_t* BSSID();
+  int32_t channel();
+  int8_t RSSI();
+  // Numeric addresses only; there is no DNS
+  int hostByName(const char* host, IPAddress& result);
+
+  bool softAPConfig(IPAddress localIP, IPAddress gateway, IPAddress subnet);
+  bool softAP(const char* ssid, const char* passphrase = nullptr);
+
+  int16_t scanNetworks(bool async = false);
+  int16_t scanComplete();
+  void scanDelete();
+  String SSID(uint8_t index);
+  int32_t RSSI(uint8_t index);
+  wifi_auth_mode_t encryptionType(uint8_t index);
+};
+
+extern WiFiClass WiFi;
+
+// ===== HOST CONTROL =====
+// Access points in range; a null or empty password is an open network
+void hostWifiAddNetwork(const char* ssid, const char* password, int8_t rssi, uint8_t channel = 6);
+void hostWifiRemoveNetwork(const char* ssid);
+// Station config the driver loads from its own NVS at start
+void hostWifiSetDriverConfig(const char* ssid, const char* password);
+// Drops the station link as if the AP went away
+void hostWifiDropLink();
+// Connection attempts made with begin()
+uint32_t hostWifiAttempts();
+
+#endif // WIFI_H
@@ -0,0 +1,27 @@
+/*
+ * WiFiClient for the host build, implementation
+ */
+#include "WiFiClient.h"
+#include <errno.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+void WiFiClient::stop() {
+  if (fd_ >= 0) close(fd_);
+  fd_ = -1;
+}
+
+int WiFiClient::write(const uint8_t* buffer, size_t size) {
+  if (fd_ < 0) return -1;
+  ssize_t n = send(fd_, buffer, size, MSG_DONTWAIT | MSG_NOSIGNAL);
+  if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+  return (int)n;
+}
+
+int WiFiClient::read(uint8_t* buffer, size_t size) {
+  if (fd_ < 0) return -1;
+  ssize_t n = recv(fd_, buffer, size, MSG_DONTWAIT);
+  if (n == 0) return -1;  // Closed by the peer
+  if (n < 0) return errno == EAGAIN || errno == EWOULDBLOCK ? 0 : -1;
+  return (int)n;
+}
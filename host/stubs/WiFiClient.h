@@ -0,0 +1,35 @@
+/*
+ * WiFiClient for the host build
+ *
+ * A connected TCP socket is one end of a host socketpair, so select()
+ * on fd() behaves as it does on lwIP. Only what the WebSockets stubs
+ * need.
+ */
+#ifndef WIFI_CLIENT_H
+#define WIFI_CLIENT_H
+
+#include <Arduino.h>
+
+class WiFiClient {
+ public:
+  WiFiClient() : fd_(-1) {}
+  explicit WiFiClient(int fd) : fd_(fd) {}
+  virtual ~WiFiClient() { stop(); }
+
+  int fd() const { return fd_; }
+  bool connected() const { return fd_ >= 0; }
+  void stop();
+
+  // Never waits: returns what the socket takes or has, -1 on errors
+  // other than a full or empty buffer
+  int write(const uint8_t* buffer, size_t size);
+  int read(uint8_t* buffer, size_t size);
+
+ private:
+  WiFiClient(const WiFiClient&) = delete;
+  WiFiClient& operator=(const WiFiClient&) = delete;
+
+  int fd_;
+};
+
+#endif // WIFI_CLIENT_H
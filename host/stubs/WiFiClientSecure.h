@@ -0,0 +1,80 @@
+/*
+ * WiFiClientSecure for the host build
+ *
+ * TLS is not simulated: the host SecureWebSocketsClient models a wss://
+ * connect as a fixed connect time (see HostApiServer in
+ * WebSocketsClient.h).
+ *
+ * With HOST_MBEDTLS, as test_secure_ws_client builds it, this is instead
+ * the part of Arduino-ESP32's WiFiClientSecure that
+ * secure_ws_client.cpp builds on: the sslclient_context of ssl_client.h
+ * over a host socket and the host's mbedTLS, torn down the way
+ * stop_ssl_socket() does it. Reads and writes are not needed there.
+ */
+#ifndef WIFI_CLIENT_SECURE_H
+#define WIFI_CLIENT_SECURE_H
+
+#include "WiFiClient.h"
+
+#ifdef HOST_MBEDTLS
+
+#include <mbedtls/ctr_drbg.h>
+#include <mbedtls/entropy.h>
+#include <mbedtls/net_sockets.h>
+#include <mbedtls/ssl.h>
+#include <unistd.h>
+
+struct sslclient_context {
+  int socket;
+  mbedtls_ssl_context ssl_ctx;
+  mbedtls_ssl_config ssl_conf;
+  mbedtls_ctr_drbg_context drbg_ctx;
+  mbedtls_entropy_context entropy_ctx;
+  mbedtls_x509_crt ca_cert;
+};
+
+class WiFiClientSecure : public WiFiClient {
+ public:
+  WiFiClientSecure() : sslclient(new sslclient_context), _connected(false) {
+    memset(sslclient, 0, sizeof(*sslclient));
+    sslclient->socket = -1;
+    mbedtls_ssl_init(&sslclient->ssl_ctx);
+    mbedtls_ssl_config_init(&sslclient->ssl_conf);
+    mbedtls_ctr_drbg_init(&sslclient->drbg_ctx);
+  }
+  ~WiFiClientSecure() override {
+    stop();
+    delete sslclient;
+  }
+
+  bool connected() const { return _connected; }
+
+  void stop() {
+    if (sslclient->socket >= 0) {
+      close(sslclient->socket);
+      sslclient->socket = -1;
+    }
+    if (sslclient->ssl_conf.ca_chain != NULL) mbedtls_x509_crt_free(&sslclient->ca_cert);
+    mbedtls_ssl_free(&sslclient->ssl_ctx);
+    mbedtls_ssl_config_free(&sslclient->ssl_conf);
+    mbedtls_ctr_drbg_free(&sslclient->drbg_ctx);
+    mbedtls_entropy_free(&sslclient->entropy_ctx);
+    memset(sslclient, 0, sizeof(*sslclient));
+    sslclient->socket = -1;
+    _connected = false;
+  }
+
+ protected:
+  sslclient_context* sslclient;
+  bool _connected;
+};
+
+#else
+
+struct mbedtls_x509_crt;
+
+class WiFiClientSecure : public WiFiClient {};
+
+#endif // HOST_MBEDTLS
+
+#endif // WIFI_CLIENT_SECURE_H
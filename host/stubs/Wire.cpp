@@ -0,0 +1,46 @@
+/*
+ * Arduino Wire for the host build, implementation
+ */
+#include "Wire.h"
+#include "host_sim.h"
+
+TwoWire Wire;
+HostI2c hostI2c = { 0, 0, 0 };
+
+bool TwoWire::begin(int sda, int scl, uint32_t frequency) {
+  if (frequency) clock_ = frequency;
+  return true;
+}
+
+bool TwoWire::setClock(uint32_t frequency) {
+  if (frequency == 0) return false;
+  clock_ = frequency;
+  return true;
+}
+
+void TwoWire::beginTransmission(uint8_t address) {
+  address_ = address;
+  pending_ = 0;
+}
+
+size_t TwoWire::write(uint8_t data) {
+  pending_++;
+  return 1;
+}
+
+size_t TwoWire::write(const uint8_t* data, size_t quantity) {
+  pending_ += quantity;
+  return quantity;
+}
+
+uint8_t TwoWire::endTransmission(bool sendStop) {
+  // Start and stop, then 8 bits plus the acknowledge per byte
+  uint64_t bits = (1 + pending_) * 9 + 2;
+  uint64_t ns = bits * 1000000000ULL / clock_;
+  hostI2c.transactions++;
+  hostI2c.bytes += pending_;
+  hostI2c.busNs += ns;
+  pending_ = 0;
+  hostSleepNs(ns);
+  return 0;
+}
@@ -0,0 +1,44 @@
+/*
+ * Arduino Wire (I2C master) for the host build
+ *
+ * Transfers go nowhere but take the time they take on the bus: a start,
+ * the address and data bytes of 9 clocks each, and a stop, at the clock
+ * set with setClock(). hostI2c counts them.
+ */
+#ifndef TWOWIRE_H
+#define TWOWIRE_H
+
+#include <Arduino.h>
+
+class TwoWire : public Print {
+ public:
+  TwoWire() : clock_(100000), address_(0), pending_(0) {}
+
+  bool begin(int sda = -1, int scl = -1, uint32_t frequency = 0);
+  bool setClock(uint32_t frequency);
+  uint32_t getClock() const { return clock_; }
+
+  void beginTransmission(uint8_t address);
+  uint8_t endTransmission(bool sendStop = true);
+  size_t write(uint8_t data) override;
+  size_t write(const uint8_t* data, size_t quantity) override;
+  using Print::write;
+
+ private:
+  uint32_t clock_;
+  uint8_t address_;
+  size_t pending_;  // Data bytes of the open transmission
+};
+
+extern TwoWire Wire;
+
+// ===== HOST CONTROL =====
+struct HostI2c {
+  uint32_t transactions;
+  uint32_t bytes;   // Data bytes, addresses not included
+  uint64_t busNs;   // Time the bus was busy
+};
+
+extern HostI2c hostI2c;
+
+#endif // TWOWIRE_H
@@ -0,0 +1,44 @@
+/*
+ * LEDC driver for the host build
+ *
+ * Duties are kept per channel. A hardware fade ends after its time on
+ * the simulated clock and raises LEDC_FADE_END_EVT from the system
+ * event task, like the fade interrupt on the device.
+ */
+#ifndef DRIVER_LEDC_H
+#define DRIVER_LEDC_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { LEDC_HIGH_SPEED_MODE, LEDC_LOW_SPEED_MODE, LEDC_SPEED_MODE_MAX } ledc_mode_t;
+typedef enum {
+  LEDC_CHANNEL_0, LEDC_CHANNEL_1, LEDC_CHANNEL_2, LEDC_CHANNEL_3,
+  LEDC_CHANNEL_4, LEDC_CHANNEL_5, LEDC_CHANNEL_6, LEDC_CHANNEL_7, LEDC_CHANNEL_MAX
+} ledc_channel_t;
+typedef enum { LEDC_FADE_NO_WAIT, LEDC_FADE_WAIT_DONE, LEDC_FADE_MAX } ledc_fade_mode_t;
+typedef enum { LEDC_FADE_END_EVT } ledc_cb_event_t;
+
+typedef struct {
+  ledc_cb_event_t event;
+  uint32_t speed_mode;
+  uint32_t channel;
+  uint32_t duty;
+} ledc_cb_param_t;
+
+typedef bool (*ledc_cb_t)(const ledc_cb_param_t* param, void* user_arg);
+
+typedef struct {
+  ledc_cb_t fade_cb;
+} ledc_cbs_t;
+
+esp_err_t ledc_fade_func_install(int intr_alloc_flags);
+esp_err_t ledc_cb_register(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_cbs_t* cbs, void* user_arg);
+uint32_t ledc_get_duty(ledc_mode_t speed_mode, ledc_channel_t channel);
+esp_err_t ledc_set_duty(ledc_mode_t speed_mode, ledc_channel_t channel, uint32_t duty);
+esp_err_t ledc_update_duty(ledc_mode_t speed_mode, ledc_channel_t channel);
+esp_err_t ledc_set_fade_with_time(ledc_mode_t speed_mode, ledc_channel_t channel,
+                                  uint32_t target_duty, int max_fade_time_ms);
+esp_err_t ledc_fade_start(ledc_mode_t speed_mode, ledc_channel_t channel, ledc_fade_mode_t fade_mode);
+
+#endif // DRIVER_LEDC_H
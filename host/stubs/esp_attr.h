@@ -0,0 +1,14 @@
+/*
+ * ESP-IDF memory placement attributes; no-ops on the host
+ */
+#ifndef ESP_ATTR_H
+#define ESP_ATTR_H
+
+#define IRAM_ATTR
+#define DRAM_ATTR
+#define RTC_DATA_ATTR
+#define RTC_NOINIT_ATTR
+#define RTC_IRAM_ATTR
+#define WORD_ALIGNED_ATTR __attribute__((aligned(4)))
+
+#endif // ESP_ATTR_H
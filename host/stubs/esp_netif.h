@@ -0,0 +1,14 @@
+/*
+ * ESP-NETIF for the host build
+ *
+ * There is no lwIP underneath, so no interface is ever found and the
+ * DHCP lease is unknown (dhcpLeaseRemaining() returns -1).
+ */
+#ifndef ESP_NETIF_H
+#define ESP_NETIF_H
+
+typedef struct esp_netif_obj esp_netif_t;
+
+inline esp_netif_t* esp_netif_get_handle_from_ifkey(const char* if_key) { return nullptr; }
+
+#endif // ESP_NETIF_H
@@ -0,0 +1,11 @@
+/*
+ * ESP-NETIF to lwIP glue for the host build
+ */
+#ifndef ESP_NETIF_NET_STACK_H
+#define ESP_NETIF_NET_STACK_H
+
+#include "esp_netif.h"
+
+inline void* esp_netif_get_netif_impl(esp_netif_t* esp_netif) { return nullptr; }
+
+#endif // ESP_NETIF_NET_STACK_H
@@ -0,0 +1,37 @@
+/*
+ * ESP-IDF WiFi driver calls for the host build
+ *
+ * The driver's saved station config is set by the harness with
+ * hostWifiSetDriverConfig(), as firmware before the credential store
+ * left it in NVS.
+ */
+#ifndef ESP_WIFI_H
+#define ESP_WIFI_H
+
+#include <stdint.h>
+#include "esp_err.h"
+
+typedef enum { WIFI_IF_STA, WIFI_IF_AP } wifi_interface_t;
+typedef enum { WIFI_STORAGE_FLASH, WIFI_STORAGE_RAM } wifi_storage_t;
+
+typedef enum {
+  WIFI_AUTH_OPEN, WIFI_AUTH_WEP, WIFI_AUTH_WPA_PSK, WIFI_AUTH_WPA2_PSK,
+  WIFI_AUTH_WPA_WPA2_PSK, WIFI_AUTH_WPA2_ENTERPRISE, WIFI_AUTH_WPA3_PSK, WIFI_AUTH_MAX
+} wifi_auth_mode_t;
+
+typedef struct {
+  uint8_t ssid[32];
+  uint8_t password[64];
+  uint8_t bssid_set;
+  uint8_t bssid[6];
+  uint8_t channel;
+} wifi_sta_config_t;
+
+typedef union {
+  wifi_sta_config_t sta;
+} wifi_config_t;
+
+esp_err_t esp_wifi_get_config(wifi_interface_t interface, wifi_config_t* conf);
+esp_err_t esp_wifi_set_storage(wifi_storage_t storage);
+
+#endif // ESP_WIFI_H
@@ -0,0 +1,28 @@
+/*
+ * FreeRTOS semaphores for the host build; queues of empty items, as in
+ * FreeRTOS itself
+ */
+#ifndef FREERTOS_SEMPHR_H
+#define FREERTOS_SEMPHR_H
+
+#include "queue.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef QueueHandle_t SemaphoreHandle_t;
+
+SemaphoreHandle_t xSemaphoreCreateMutex(void);
+SemaphoreHandle_t xSemaphoreCreateBinary(void);
+SemaphoreHandle_t xSemaphoreCreateCounting(UBaseType_t maxCount, UBaseType_t initialCount);
+#define vSemaphoreDelete(semaphore) vQueueDelete(semaphore)
+#define xSemaphoreTake(semaphore, ticks) xQueueReceive((semaphore), NULL, (ticks))
+#define xSemaphoreGive(semaphore) xQueueSend((semaphore), NULL, 0)
+#define xSemaphoreGiveFromISR(semaphore, woken) xQueueSendFromISR((semaphore), NULL, (woken))
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FREERTOS_SEMPHR_H
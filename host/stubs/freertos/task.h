@@ -0,0 +1,48 @@
+/*
+ * FreeRTOS tasks for the host build
+ *
+ * Every task is a host thread. Priorities and core affinity are kept
+ * but not enforced; see host/sim/host_sim.h.
+ */
+#ifndef FREERTOS_TASK_H
+#define FREERTOS_TASK_H
+
+#include "FreeRTOS.h"
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+typedef void (*TaskFunction_t)(void*);
+typedef struct tskTaskControlBlock* TaskHandle_t;
+
+BaseType_t xTaskCreatePinnedToCore(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                                   void* param, UBaseType_t priority, TaskHandle_t* created,
+                                   BaseType_t core);
+BaseType_t xTaskCreate(TaskFunction_t code, const char* name, uint32_t stackDepth,
+                       void* param, UBaseType_t priority, TaskHandle_t* created);
+void vTaskDelete(TaskHandle_t task);
+
+void vTaskDelay(TickType_t ticks);
+void vTaskDelayUntil(TickType_t* previousWake, TickType_t increment);
+TickType_t xTaskGetTickCount(void);
+TickType_t xTaskGetTickCountFromISR(void);
+
+// A suspended task stops at its next blocking call or clock read
+void vTaskSuspend(TaskHandle_t task);
+void vTaskResume(TaskHandle_t task);
+
+TaskHandle_t xTaskGetCurrentTaskHandle(void);
+char* pcTaskGetName(TaskHandle_t task);
+UBaseType_t uxTaskPriorityGet(TaskHandle_t task);
+// Stack use is not measured on the host: reports the whole stack
+UBaseType_t uxTaskGetStackHighWaterMark(TaskHandle_t task);
+
+void vTaskYield(void);
+#define taskYIELD() vTaskYield()
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif // FREERTOS_TASK_H
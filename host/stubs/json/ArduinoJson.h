@@ -0,0 +1,625 @@
+/*
+ * ArduinoJson 7 subset for the host build
+ *
+ * Read-only documents: deserializeJson() into a JsonDocument, then
+ * lookups through JsonVariantConst with is<T>(), as<T>(), operator| and
+ * string comparison, which is everything the firmware does with it.
+ * Like the library, the document takes its memory from an Allocator:
+ * one pool of nodes and one of string bytes, both grown by doubling.
+ * The nesting limit is ARDUINOJSON_DEFAULT_NESTING_LIMIT.
+ *
+ * It lives in its own directory so that builds with the real library
+ * (see host/CMakeLists.txt) put that one on the include path instead.
+ */
+#ifndef ARDUINOJSON_H
+#define ARDUINOJSON_H
+
+#include <Arduino.h>
+#include <errno.h>
+#include <limits>
+#include <type_traits>
+
+#define ARDUINOJSON_DEFAULT_NESTING_LIMIT 10
+
+namespace ArduinoJson {
+
+class Allocator {
+ public:
+  virtual void* allocate(size_t size) = 0;
+  virtual void deallocate(void* pointer) = 0;
+  virtual void* reallocate(void* pointer, size_t new_size) = 0;
+
+ protected:
+  ~Allocator() = default;
+};
+
+namespace detail {
+
+class DefaultAllocator : public Allocator {
+ public:
+  void* allocate(size_t size) override { return malloc(size); }
+  void deallocate(void* pointer) override { free(pointer); }
+  void* reallocate(void* pointer, size_t new_size) override { return realloc(pointer, new_size); }
+
+  static Allocator* instance() {
+    static DefaultAllocator allocator;
+    return &allocator;
+  }
+};
+
+enum NodeType : uint8_t { NODE_NULL, NODE_BOOL, NODE_INT, NODE_FLOAT, NODE_STRING, NODE_OBJECT, NODE_ARRAY };
+
+struct Node {
+  NodeType type;
+  bool boolean;
+  int32_t firstChild;   // Objects and arrays
+  int32_t next;         // Next member or element
+  uint32_t keyOffset;   // Member key in the string pool
+  uint32_t keyLength;
+  union {
+    int64_t integer;
+    double real;
+    struct {
+      uint32_t offset;
+      uint32_t length;
+    } string;
+  };
+};
+
+}  // namespace detail
+
+class DeserializationError {
+ public:
+  enum Code { Ok, EmptyInput, IncompleteInput, InvalidInput, NoMemory, TooDeep };
+
+  DeserializationError(Code code = Ok) : code_(code) {}
+  Code code() const { return code_; }
+  explicit operator bool() const { return code_ != Ok; }
+  bool operator==(Code code) const { return code_ == code; }
+  bool operator!=(Code code) const { return code_ != code; }
+
+  const char* c_str() const {
+    static const char* const names[] = { "Ok", "EmptyInput", "IncompleteInput", "InvalidInput", "NoMemory",
+                                         "TooDeep" };
+    return names[code_];
+  }
+
+ private:
+  Code code_;
+};
+
+class JsonDocument;
+class JsonObject {};
+class JsonArray {};
+
+class JsonVariantConst {
+ public:
+  JsonVariantConst() : doc_(nullptr), node_(-1) {}
+  JsonVariantConst(const JsonDocument* doc, int32_t node) : doc_(doc), node_(node) {}
+
+  JsonVariantConst operator[](const char* key) const;
+  JsonVariantConst operator[](const String& key) const { return (*this)[key.c_str()]; }
+  JsonVariantConst operator[](size_t index) const;
+  JsonVariantConst operator[](int index) const { return (*this)[(size_t)index]; }
+
+  bool isNull() const { return node() == nullptr || node()->type == detail::NODE_NULL; }
+  size_t size() const;
+
+  template <typename T>
+  bool is() const;
+  template <typename T>
+  T as() const;
+
+  // The value if it has the default's type, the default otherwise
+  template <typename T>
+  typename std::enable_if<!std::is_array<T>::value, T>::type operator|(const T& defaultValue) const {
+    return is<T>() ? as<T>() : defaultValue;
+  }
+  const char* operator|(const char* defaultValue) const {
+    return is<const char*>() ? as<const char*>() : defaultValue;
+  }
+
+  bool operator==(const char* text) const;
+  bool operator!=(const char* text) const { return !(*this == text); }
+
+ private:
+  const detail::Node* node() const;
+  const char* chars(uint32_t offset) const;
+  template <typename T>
+  bool isInteger() const;
+
+  const JsonDocument* doc_;
+  int32_t node_;
+};
+
+class JsonDocument {
+ public:
+  explicit JsonDocument(Allocator* allocator = detail::DefaultAllocator::instance())
+    : allocator_(allocator), nodes_(nullptr), nodeCount_(0), nodeCapacity_(0),
+      strings_(nullptr), stringLength_(0), stringCapacity_(0), overflowed_(false) {}
+  JsonDocument(const JsonDocument&) = delete;
+  JsonDocument& operator=(const JsonDocument&) = delete;
+  ~JsonDocument() { release(); }
+
+  void clear() {
+    release();
+    overflowed_ = false;
+  }
+  bool overflowed() const { return overflowed_; }
+
+  JsonVariantConst as() const { return JsonVariantConst(this, nodeCount_ ? 0 : -1); }
+  operator JsonVariantConst() const { return as(); }
+  JsonVariantConst operator[](const char* key) const { return as()[key]; }
+  JsonVariantConst operator[](const String& key) const { return as()[key.c_str()]; }
+  JsonVariantConst operator[](size_t index) const { return as()[index]; }
+  JsonVariantConst operator[](int index) const { return as()[(size_t)index]; }
+  bool isNull() const { return as().isNull(); }
+
+ private:
+  friend class JsonVariantConst;
+  friend class JsonParser;
+
+  void release() {
+    if (nodes_) allocator_->deallocate(nodes_);
+    if (strings_) allocator_->deallocate(strings_);
+    nodes_ = nullptr;
+    strings_ = nullptr;
+    nodeCount_ = nodeCapacity_ = stringLength_ = stringCapacity_ = 0;
+  }
+
+  // Index of a new null node, or -1 out of memory
+  int32_t addNode() {
+    if (nodeCount_ == nodeCapacity_) {
+      uint32_t capacity = nodeCapacity_ ? nodeCapacity_ * 2 : 16;
+      void* grown = nodes_ ? allocator_->reallocate(nodes_, capacity * sizeof(detail::Node))
+                           : allocator_->allocate(capacity * sizeof(detail::Node));
+      if (!grown) {
+        overflowed_ = true;
+        return -1;
+      }
+      nodes_ = (detail::Node*)grown;
+      nodeCapacity_ = capacity;
+    }
+    detail::Node& node = nodes_[nodeCount_];
+    memset(&node, 0, sizeof(node));
+    node.firstChild = node.next = -1;
+    return (int32_t)nodeCount_++;
+  }
+
+  bool addChar(char c) {
+    if (stringLength_ == stringCapacity_) {
+      uint32_t capacity = stringCapacity_ ? stringCapacity_ * 2 : 64;
+      void* grown = strings_ ? allocator_->reallocate(strings_, capacity) : allocator_->allocate(capacity);
+      if (!grown) {
+        overflowed_ = true;
+        return false;
+      }
+      strings_ = (char*)grown;
+      stringCapacity_ = capacity;
+    }
+    strings_[stringLength_++] = c;
+    return true;
+  }
+
+  Allocator* allocator_;
+  detail::Node* nodes_;
+  uint32_t nodeCount_;
+  uint32_t nodeCapacity_;
+  char* strings_;        // NUL-terminated strings, back to back
+  uint32_t stringLength_;
+  uint32_t stringCapacity_;
+  bool overflowed_;
+};
+
+// ===== VARIANT =====
+inline const detail::Node* JsonVariantConst::node() const {
+  if (doc_ == nullptr || node_ < 0 || (uint32_t)node_ >= doc_->nodeCount_) return nullptr;
+  return &doc_->nodes_[node_];
+}
+
+inline const char* JsonVariantConst::chars(uint32_t offset) const {
+  return doc_->strings_ + offset;
+}
+
+inline JsonVariantConst JsonVariantConst::operator[](const char* key) const {
+  const detail::Node* object = node();
+  if (object == nullptr || object->type != detail::NODE_OBJECT || key == nullptr) return JsonVariantConst();
+  size_t length = strlen(key);
+  for (int32_t child = object->firstChild; child >= 0; child = doc_->nodes_[child].next) {
+    const detail::Node& member = doc_->nodes_[child];
+    if (member.keyLength == length && memcmp(chars(member.keyOffset), key, length) == 0) {
+      return JsonVariantConst(doc_, child);
+    }
+  }
+  return JsonVariantConst();
+}
+
+inline JsonVariantConst JsonVariantConst::operator[](size_t index) const {
+  const detail::Node* array = node();
+  if (array == nullptr || array->type != detail::NODE_ARRAY) return JsonVariantConst();
+  for (int32_t child = array->firstChild; child >= 0; child = doc_->nodes_[child].next) {
+    if (index-- == 0) return JsonVariantConst(doc_, child);
+  }
+  return JsonVariantConst();
+}
+
+inline size_t JsonVariantConst::size() const {
+  const detail::Node* parent = node();
+  if (parent == nullptr || (parent->type != detail::NODE_OBJECT && parent->type != detail::NODE_ARRAY)) {
+    return 0;
+  }
+  size_t count = 0;
+  for (int32_t child = parent->firstChild; child >= 0; child = doc_->nodes_[child].next) count++;
+  return count;
+}
+
+inline bool JsonVariantConst::operator==(const char* text) const {
+  if (!is<const char*>() || text == nullptr) return false;
+  const detail::Node* n = node();
+  return n->string.length == strlen(text) && memcmp(chars(n->string.offset), text, n->string.length) == 0;
+}
+
+// Integers in range of T; floats only if they are whole numbers in range
+template <typename T>
+bool JsonVariantConst::isInteger() const {
+  const detail::Node* n = node();
+  if (n == nullptr) return false;
+  if (n->type == detail::NODE_INT) {
+    if (std::is_signed<T>::value) {
+      return n->integer >= (int64_t)std::numeric_limits<T>::min() &&
+             n->integer <= (int64_t)std::numeric_limits<T>::max();
+    }
+    return n->integer >= 0 && (uint64_t)n->integer <= (uint64_t)std::numeric_limits<T>::max();
+  }
+  return false;
+}
+
+template <typename T>
+bool JsonVariantConst::is() const {
+  const detail::Node* n = node();
+  if (std::is_same<T, bool>::value) return n && n->type == detail::NODE_BOOL;
+  if (std::is_same<T, const char*>::value || std::is_same<T, String>::value) {
+    return n && n->type == detail::NODE_STRING;
+  }
+  if (std::is_same<T, JsonObject>::value) return n && n->type == detail::NODE_OBJECT;
+  if (std::is_same<T, JsonArray>::value) return n && n->type == detail::NODE_ARRAY;
+  if (std::is_floating_point<T>::value) return n && (n->type == detail::NODE_INT || n->type == detail::NODE_FLOAT);
+  return isInteger<typename std::conditional<std::is_integral<T>::value, T, int>::type>();
+}
+
+namespace detail {
+
+template <typename T, typename Enable = void>
+struct Converter;
+
+template <typename T>
+struct Converter<T, typename std::enable_if<std::is_integral<T>::value && !std::is_same<T, bool>::value>::type> {
+  static T from(const Node* n, const char* strings) {
+    if (n == nullptr) return 0;
+    if (n->type == NODE_INT) return (T)n->integer;
+    if (n->type == NODE_FLOAT) return (T)n->real;
+    if (n->type == NODE_BOOL) return (T)n->boolean;
+    return 0;
+  }
+};
+
+template <typename T>
+struct Converter<T, typename std::enable_if<std::is_floating_point<T>::value>::type> {
+  static T from(const Node* n, const char* strings) {
+    if (n == nullptr) return 0;
+    if (n->type == NODE_INT) return (T)n->integer;
+    if (n->type == NODE_FLOAT) return (T)n->real;
+    return 0;
+  }
+};
+
+template <>
+struct Converter<bool> {
+  static bool from(const Node* n, const char* strings) {
+    if (n == nullptr) return false;
+    if (n->type == NODE_BOOL) return n->boolean;
+    if (n->type == NODE_INT) return n->integer != 0;
+    if (n->type == NODE_FLOAT) return n->real != 0;
+    return n->type != NODE_NULL;
+  }
+};
+
+template <>
+struct Converter<const char*> {
+  static const char* from(const Node* n, const char* strings) {
+    return n && n->type == NODE_STRING ? strings + n->string.offset : nullptr;
+  }
+};
+
+template <>
+struct Converter<String> {
+  static String from(const Node* n, const char* strings) {
+    return n && n->type == NODE_STRING ? String(strings + n->string.offset, n->string.length) : String();
+  }
+};
+
+}  // namespace detail
+
+template <typename T>
+T JsonVariantConst::as() const {
+  return detail::Converter<T>::from(node(), doc_ ? doc_->strings_ : nullptr);
+}
+
+// ===== PARSER =====
+class JsonParser {
+ public:
+  JsonParser(JsonDocument& doc, const char* input, size_t length)
+    : doc_(doc), p_(input), end_(input + length) {}
+
+  DeserializationError parse() {
+    doc_.clear();
+    skipSpace();
+    if (p_ == end_ || *p_ == '\0') return DeserializationError::EmptyInput;
+    int32_t root = doc_.addNode();
+    if (root < 0) return DeserializationError::NoMemory;
+    DeserializationError error = value(root, ARDUINOJSON_DEFAULT_NESTING_LIMIT);
+    if (error) doc_.clear();
+    return error;
+  }
+
+ private:
+  bool atEnd() const { return p_ == end_ || *p_ == '\0'; }
+
+  void skipSpace() {
+    while (!atEnd() && (*p_ == ' ' || *p_ == '\t' || *p_ == '\n' || *p_ == '\r')) p_++;
+  }
+
+  // Nodes may move when the pool grows, so they are always indexed
+  detail::Node& at(int32_t index) { return doc_.nodes_[index]; }
+
+  DeserializationError value(int32_t target, int depth) {
+    skipSpace();
+    if (atEnd()) return DeserializationError::IncompleteInput;
+    switch (*p_) {
+      case '{':
+        return object(target, depth);
+      case '[':
+        return array(target, depth);
+      case '"':
+      case '\'': {
+        uint32_t offset, length;
+        DeserializationError error = string(offset, length);
+        if (error) return error;
+        at(target).type = detail::NODE_STRING;
+        at(target).string.offset = offset;
+        at(target).string.length = length;
+        return DeserializationError::Ok;
+      }
+      default:
+        return literal(target);
+    }
+  }
+
+  DeserializationError object(int32_t target, int depth) {
+    if (depth == 0) return DeserializationError::TooDeep;
+    p_++;
+    at(target).type = detail::NODE_OBJECT;
+    int32_t last = -1;
+    skipSpace();
+    if (atEnd()) return DeserializationError::IncompleteInput;
+    if (*p_ == '}') {
+      p_++;
+      return DeserializationError::Ok;
+    }
+    for (;;) {
+      skipSpace();
+      if (atEnd()) return DeserializationError::IncompleteInput;
+      if (*p_ != '"' && *p_ != '\'') return DeserializationError::InvalidInput;
+      uint32_t keyOffset, keyLength;
+      DeserializationError error = string(keyOffset, keyLength);
+      if (error) return error;
+      skipSpace();
+      if (atEnd()) return DeserializationError::IncompleteInput;
+      if (*p_++ != ':') return DeserializationError::InvalidInput;
+
+      int32_t member = doc_.addNode();
+      if (member < 0) return DeserializationError::NoMemory;
+      at(member).keyOffset = keyOffset;
+      at(member).keyLength = keyLength;
+      if (last < 0) {
+        at(target).firstChild = member;
+      } else {
+        at(last).next = member;
+      }
+      last = member;
+      error = value(member, depth - 1);
+      if (error) return error;
+
+      skipSpace();
+      if (atEnd()) return DeserializationError::IncompleteInput;
+      char c = *p_++;
+      if (c == '}') return DeserializationError::Ok;
+      if (c != ',') return DeserializationError::InvalidInput;
+    }
+  }
+
+  DeserializationError array(int32_t target, int depth) {
+    if (depth == 0) return DeserializationError::TooDeep;
+    p_++;
+    at(target).type = detail::NODE_ARRAY;
+    int32_t last = -1;
+    skipSpace();
+    if (atEnd()) return DeserializationError::IncompleteInput;
+    if (*p_ == ']') {
+      p_++;
+      return DeserializationError::Ok;
+    }
+    for (;;) {
+      int32_t element = doc_.addNode();
+      if (element < 0) return DeserializationError::NoMemory;
+      if (last < 0) {
+        at(target).firstChild = element;
+      } else {
+        at(last).next = element;
+      }
+      last = element;
+      DeserializationError error = value(element, depth - 1);
+      if (error) return error;
+
+      skipSpace();
+      if (atEnd()) return DeserializationError::IncompleteInput;
+      char c = *p_++;
+      if (c == ']') return DeserializationError::Ok;
+      if (c != ',') return DeserializationError::InvalidInput;
+    }
+  }
+
+  bool put(char c) { return doc_.addChar(c); }
+
+  bool putUtf8(uint32_t code) {
+    if (code < 0x80) return put((char)code);
+    if (code < 0x800) return put((char)(0xC0 | (code >> 6))) && put((char)(0x80 | (code & 0x3F)));
+    if (code < 0x10000) {
+      return put((char)(0xE0 | (code >> 12))) && put((char)(0x80 | ((code >> 6) & 0x3F))) &&
+             put((char)(0x80 | (code & 0x3F)));
+    }
+    return put((char)(0xF0 | (code >> 18))) && put((char)(0x80 | ((code >> 12) & 0x3F))) &&
+           put((char)(0x80 | ((code >> 6) & 0x3F))) && put((char)(0x80 | (code & 0x3F)));
+  }
+
+  bool hex4(uint32_t& out) {
+    out = 0;
+    for (int i = 0; i < 4; i++) {
+      if (atEnd()) return false;
+      char c = *p_++;
+      out <<= 4;
+      if (c >= '0' && c <= '9') {
+        out |= c - '0';
+      } else if (c >= 'a' && c <= 'f') {
+        out |= c - 'a' + 10;
+      } else if (c >= 'A' && c <= 'F') {
+        out |= c - 'A' + 10;
+      } else {
+        return false;
+      }
+    }
+    return true;
+  }
+
+  DeserializationError string(uint32_t& offset, uint32_t& length) {
+    char quote = *p_++;
+    offset = doc_.stringLength_;
+    for (;;) {
+      if (atEnd()) return DeserializationError::IncompleteInput;
+      char c = *p_++;
+      if (c == quote) break;
+      if (c == '\\') {
+        if (atEnd()) return DeserializationError::IncompleteInput;
+        char escape = *p_++;
+        switch (escape) {
+          case '"': case '\'': case '\\': case '/': c = escape; break;
+          case 'b': c = '\b'; break;
+          case 'f': c = '\f'; break;
+          case 'n': c = '\n'; break;
+          case 'r': c = '\r'; break;
+          case 't': c = '\t'; break;
+          case 'u': {
+            uint32_t code;
+            if (!hex4(code)) return atEnd() ? DeserializationError::IncompleteInput : DeserializationError::InvalidInput;
+            // A high surrogate followed by a low one is one code point
+            if (code >= 0xD800 && code < 0xDC00 && end_ - p_ >= 6 && p_[0] == '\\' && p_[1] == 'u') {
+              const char* save = p_;
+              p_ += 2;
+              uint32_t low;
+              if (hex4(low) && low >= 0xDC00 && low < 0xE000) {
+                code = 0x10000 + ((code - 0xD800) << 10) + (low - 0xDC00);
+              } else {
+                p_ = save;
+              }
+            }
+            if (!putUtf8(code)) return DeserializationError::NoMemory;
+            continue;
+          }
+          default:
+            return DeserializationError::InvalidInput;
+        }
+      }
+      if (!put(c)) return DeserializationError::NoMemory;
+    }
+    length = doc_.stringLength_ - offset;
+    if (!put('\0')) return DeserializationError::NoMemory;
+    return DeserializationError::Ok;
+  }
+
+  DeserializationError literal(int32_t target) {
+    // Collect the token up to the next delimiter
+    const char* start = p_;
+    while (!atEnd() && *p_ != ',' && *p_ != '}' && *p_ != ']' && *p_ != ':' && *p_ != ' ' && *p_ != '\t' &&
+           *p_ != '\r' && *p_ != '\n') {
+      p_++;
+    }
+    size_t length = p_ - start;
+    if (length == 0) return DeserializationError::InvalidInput;
+    char token[64];
+    if (length >= sizeof(token)) return DeserializationError::InvalidInput;
+    memcpy(token, start, length);
+    token[length] = '\0';
+
+    detail::Node& node = at(target);
+    if (strcmp(token, "true") == 0 || strcmp(token, "false") == 0) {
+      node.type = detail::NODE_BOOL;
+      node.boolean = token[0] == 't';
+      return DeserializationError::Ok;
+    }
+    if (strcmp(token, "null") == 0) {
+      node.type = detail::NODE_NULL;
+      return DeserializationError::Ok;
+    }
+
+    const char* q = token;
+    if (*q == '-' || *q == '+') q++;
+    if (!(*q >= '0' && *q <= '9') && *q != '.') return DeserializationError::InvalidInput;
+    bool integral = strpbrk(token, ".eE") == nullptr;
+    char* parsed;
+    if (integral) {
+      errno = 0;
+      long long value = strtoll(token, &parsed, 10);
+      if (*parsed == '\0' && errno == 0) {
+        node.type = detail::NODE_INT;
+        node.integer = value;
+        return DeserializationError::Ok;
+      }
+    }
+    double value = strtod(token, &parsed);
+    if (*parsed != '\0') return DeserializationError::InvalidInput;
+    node.type = detail::NODE_FLOAT;
+    node.real = value;
+    return DeserializationError::Ok;
+  }
+
+  JsonDocument& doc_;
+  const char* p_;
+  const char* end_;
+};
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input, size_t length) {
+  return JsonParser(doc, input, length).parse();
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const uint8_t* input, size_t length) {
+  return deserializeJson(doc, (const char*)input, length);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const char* input) {
+  return deserializeJson(doc, input, input ? strlen(input) : 0);
+}
+
+inline DeserializationError deserializeJson(JsonDocument& doc, const String& input) {
+  return deserializeJson(doc, input.c_str(), input.length());
+}
+
+}  // namespace ArduinoJson
+
+using ArduinoJson::DeserializationError;
+using ArduinoJson::JsonArray;
+using ArduinoJson::JsonDocument;
+using ArduinoJson::JsonObject;
+using ArduinoJson::JsonVariantConst;
+using ArduinoJson::deserializeJson;
+
+#endif // ARDUINOJSON_H
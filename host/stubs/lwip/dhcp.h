@@ -0,0 +1,30 @@
+/*
+ * lwIP DHCP client state for the host build; only the fields the
+ * firmware reads
+ */
+#ifndef LWIP_DHCP_H
+#define LWIP_DHCP_H
+
+#include <stdint.h>
+
+typedef uint8_t u8_t;
+typedef uint16_t u16_t;
+typedef uint32_t u32_t;
+
+#define DHCP_COARSE_TIMER_SECS 60
+
+struct dhcp {
+  u8_t state;
+  u32_t offered_t0_lease;
+  u16_t lease_used;
+};
+
+struct netif {
+  struct dhcp* dhcp;
+  u8_t supplied;
+};
+
+#define netif_dhcp_data(netif) ((netif)->dhcp)
+#define dhcp_supplied_address(netif) ((netif)->supplied != 0)
+
+#endif // LWIP_DHCP_H
@@ -0,0 +1,20 @@
+/*
+ * lwIP sockets for the host build: the host's own
+ */
+#ifndef LWIP_SOCKETS_H
+#define LWIP_SOCKETS_H
+
+#include <errno.h>
+#include <fcntl.h>
+#include <netinet/in.h>
+#include <sys/select.h>
+#include <sys/socket.h>
+#include <unistd.h>
+
+// Arduino's IPAddress constant of the same name
+#undef INADDR_NONE
+
+#define lwip_socket socket
+#define lwip_connect connect
+
+#endif // LWIP_SOCKETS_H
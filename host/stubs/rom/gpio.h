@@ -0,0 +1,12 @@
+/*
+ * ROM GPIO register reads for the host build; levels set with hostPinSet()
+ */
+#ifndef ROM_GPIO_H
+#define ROM_GPIO_H
+
+#include <stdint.h>
+
+uint32_t gpio_input_get(void);
+uint32_t gpio_input_get_high(void);
+
+#endif // ROM_GPIO_H
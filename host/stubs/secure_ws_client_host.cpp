@@ -0,0 +1,52 @@
+/*
+ * wss:// client for the host build
+ *
+ * Stands in for libraries/HubCore/src/secure_ws_client.cpp, which needs
+ * mbedTLS. The handshake is part of hostApi.connectMs; every connect
+ * counts as a full one. test_secure_ws_client builds the real one
+ * against the host's mbedTLS.
+ */
+#include "secure_ws_client.h"
+
+SecureWebSocketsClient::SecureWebSocketsClient()
+  : rootCA_(nullptr), keyPin_(nullptr), pending_(nullptr) {
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+void SecureWebSocketsClient::setTrust(const char* rootCA, const char* keyPin) {
+  rootCA_ = rootCA;
+  keyPin_ = keyPin;
+  if (!rootCA_ && !keyPin_) Serial.println("Warning: API server certificate is not checked");
+}
+
+void SecureWebSocketsClient::loop() {
+  bool attempt = _port != 0 && _client.isSSL && _client.status == WSC_NOT_CONNECTED &&
+                 millis() - _lastConnectionFail >= _reconnectInterval;
+  uint32_t started = millis();
+  WebSocketsClient::loop();
+  if (!attempt) return;
+
+  if (_client.status == WSC_NOT_CONNECTED) {
+    stats_.failed++;
+  } else {
+    stats_.full++;
+    stats_.fullTime = millis() - started;
+  }
+}
+
+void SecureWebSocketsClient::disconnect() {
+  WebSocketsClient::disconnect();
+}
+
+void SecureWebSocketsClient::writeTlsStats(FrameWriter& w) const {
+  w.key("tls").raw("{");
+  w.key("full").integer(stats_.full);
+  w.key("resumed").integer(stats_.resumed);
+  w.key("failed").integer(stats_.failed);
+  w.key("fullMs").integer(stats_.fullTime);
+  w.key("resumedMs").integer(stats_.resumedTime);
+  w.key("verify").string(rootCA_ ? (keyPin_ ? "ca+pin" : "ca") : (keyPin_ ? "pin" : "none"));
+  w.raw("}");
+}
+
+void tlsSessionClear() {}
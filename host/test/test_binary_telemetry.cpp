@@ -0,0 +1,318 @@
+/*
+ * Binary telemetry frames, encoder to decoder
+ *
+ * Encodes sample streams with BinaryTelemetryEncoder and decodes them
+ * with BinaryTelemetryDecoder, checking every decoded sample against
+ * what was sent at wire resolution:
+ *
+ *   - a long drifting stream: key frames every BINARY_KEYFRAME_INTERVAL
+ *     deltas, the sequence number wrapping around
+ *   - steps too large for a delta and unknown readings force key frames
+ *   - a lost, repeated or malformed frame is rejected, and so is every
+ *     delta after a lost one until the next key frame
+ *   - through WebSocketUplink and the host API server: a send that fails
+ *     with the link up makes the next frame a key frame
+ *
+ * With --vectors FILE every decoded frame is written to FILE with the
+ * decoder's result, one "<hex>\t<sample or rejected>" line each and a
+ * "reset" line for every new decoder. The uplink_standin_decoder test
+ * runs tools/uplink_standin.py --check-vectors over it, so the stand-in
+ * and the firmware's decoder agree frame for frame.
+ */
+#include <WebSocketsClient.h>
+#include "binary_telemetry.h"
+#include "host_sim.h"
+#include "hub_uplink.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+static FILE* vectors = nullptr;
+
+// The stand-in's format_sample()
+static void formatSample(const TelemetrySample& s, char* out, size_t size) {
+  char temperature[16] = "--";
+  char humidity[16] = "--";
+  if (!isnan(s.temperature)) snprintf(temperature, sizeof(temperature), "%.1fC", s.temperature);
+  if (!isnan(s.humidity)) snprintf(humidity, sizeof(humidity), "%.1f%%", s.humidity);
+  snprintf(out, size, "%s %s motion=%d led1=%d led2=%d led3=%d", temperature, humidity, s.motion,
+           s.led1, s.led2, s.led3);
+}
+
+// The server end of one connection; records what it decodes
+struct Receiver {
+  BinaryTelemetryDecoder decoder;
+  uint32_t accepted;
+  uint32_t rejected;
+
+  Receiver() : accepted(0), rejected(0) {
+    if (vectors) fputs("reset\n", vectors);
+  }
+
+  bool receive(const uint8_t* frame, size_t length, TelemetrySample& out) {
+    bool ok = decoder.decode(frame, length, out);
+    ok ? accepted++ : rejected++;
+    if (vectors) {
+      char text[80] = "rejected";
+      if (ok) formatSample(out, text, sizeof(text));
+      for (size_t i = 0; i < length; i++) fprintf(vectors, "%02x", frame[i]);
+      fprintf(vectors, "\t%s\n", text);
+    }
+    return ok;
+  }
+};
+
+struct Frame {
+  uint8_t data[BINARY_FRAME_MAX_SIZE];
+  size_t length;
+};
+
+// Equal at the resolution of the wire format
+static bool sameSample(const TelemetrySample& a, const TelemetrySample& b) {
+  QuantizedSample qa = quantizeSample(a);
+  QuantizedSample qb = quantizeSample(b);
+  return qa.temperature == qb.temperature && qa.humidity == qb.humidity &&
+         qa.state == qb.state && qa.led1 == qb.led1;
+}
+
+static uint16_t frameSeq(const Frame& f) {
+  return f.data[2] | (f.data[3] << 8);
+}
+
+// Sensor noise for sample i: the same every time, within +-range tenths
+static float noise(uint32_t i, uint32_t range) {
+  uint32_t h = i * 2654435761u;
+  return ((int32_t)((h >> 16) % (2 * range + 1)) - (int32_t)range) / 10.0f;
+}
+
+// A room over a day: slow drift, sensor noise, motion and the odd LED
+// change. Sample i is the same on every call.
+static TelemetrySample roomSample(uint32_t i) {
+  TelemetrySample s;
+  s.temperature = 21.0f + 3.0f * sinf(i / 500.0f) + noise(i / 4, 3);
+  s.humidity = 45.0f + 10.0f * cosf(i / 700.0f) + noise(i / 3 + 7919, 5);
+  s.motion = (i / 7) % 5 == 0;
+  s.led1 = (i / 40) % 4 * 64;
+  s.led2 = (i / 300) % 2;
+  s.led3 = (i / 1000) % 2;
+  return s;
+}
+
+static Frame encodeFrame(BinaryTelemetryEncoder& encoder, const TelemetrySample& sample) {
+  Frame f;
+  f.length = encoder.encode(sample, f.data, sizeof(f.data));
+  return f;
+}
+
+// ===== ROUND TRIP =====
+static void testRoundTrip() {
+  // Past 65535 frames, so the sequence number wraps
+  const uint32_t FRAMES = 70000;
+  BinaryTelemetryEncoder encoder;
+  Receiver receiver;
+  uint32_t keys = 0, misplacedKeys = 0, mismatches = 0, bytes = 0;
+
+  for (uint32_t i = 0; i < FRAMES; i++) {
+    TelemetrySample sample = roomSample(i);
+    Frame f = encodeFrame(encoder, sample);
+    bytes += f.length;
+    bool key = f.data[1] == BINARY_FRAME_KEY;
+    keys += key;
+    misplacedKeys += key != (i % (BINARY_KEYFRAME_INTERVAL + 1) == 0);
+    CHECK(frameSeq(f) == (uint16_t)i, "frame %u has seq %u", i, frameSeq(f));
+
+    TelemetrySample out;
+    if (receiver.receive(f.data, f.length, out) && !sameSample(out, sample)) mismatches++;
+  }
+
+  printf("%u frames, %u key, %.2f B per frame\n", FRAMES, keys, (double)bytes / FRAMES);
+  CHECK(receiver.rejected == 0, "%u frames rejected", receiver.rejected);
+  CHECK(mismatches == 0, "%u frames decoded to a different sample", mismatches);
+  CHECK(misplacedKeys == 0, "%u key frames off the interval", misplacedKeys);
+  CHECK(bytes < FRAMES * 7, "%.2f B per frame", (double)bytes / FRAMES);
+}
+
+// ===== FORCED KEY FRAMES =====
+static void testForcedKeyFrames() {
+  struct Step {
+    float temperature;
+    float humidity;
+    int led1;
+    uint8_t type;
+  };
+  const Step steps[] = {
+    { 20.0f, 50.0f, 0, BINARY_FRAME_KEY },
+    { 20.1f, 50.0f, 0, BINARY_FRAME_DELTA },
+    { 32.9f, 50.0f, 0, BINARY_FRAME_KEY },      // +12.8 °C
+    { 20.2f, 50.0f, 0, BINARY_FRAME_DELTA },    // -12.7 °C, the largest delta
+    { 20.2f, 37.1f, 0, BINARY_FRAME_KEY },      // -12.9 %
+    { 20.2f, 49.8f, 0, BINARY_FRAME_DELTA },    // +12.7 %
+    { NAN, 49.8f, 0, BINARY_FRAME_KEY },        // Sensor lost
+    { NAN, 49.8f, 255, BINARY_FRAME_DELTA },    // Still lost, LED1 changes
+    { 21.0f, 49.8f, 255, BINARY_FRAME_KEY },    // Sensor back
+    { 21.0f, NAN, 255, BINARY_FRAME_KEY },
+    { -40.0f, 0.0f, 0, BINARY_FRAME_KEY },
+    { -39.9f, 0.1f, 1, BINARY_FRAME_DELTA },
+  };
+  BinaryTelemetryEncoder encoder;
+  Receiver receiver;
+
+  for (size_t i = 0; i < sizeof(steps) / sizeof(steps[0]); i++) {
+    TelemetrySample sample = { steps[i].temperature, steps[i].humidity, false, steps[i].led1,
+                               false, true };
+    Frame f = encodeFrame(encoder, sample);
+    CHECK(f.data[1] == steps[i].type, "step %zu: frame type %u", i, f.data[1]);
+    TelemetrySample out;
+    CHECK(receiver.receive(f.data, f.length, out), "step %zu rejected", i);
+    CHECK(sameSample(out, sample), "step %zu: %.1f/%.1f decoded as %.1f/%.1f", i,
+          sample.temperature, sample.humidity, out.temperature, out.humidity);
+  }
+}
+
+// ===== LOST AND REPEATED FRAMES =====
+static void testLostFrames() {
+  const uint32_t FRAMES = 3 * (BINARY_KEYFRAME_INTERVAL + 1);
+  const uint32_t LOST = 5;
+  const uint32_t NEXT_KEY = BINARY_KEYFRAME_INTERVAL + 1;
+  BinaryTelemetryEncoder encoder;
+  Frame frames[FRAMES];
+  TelemetrySample samples[FRAMES];
+  for (uint32_t i = 0; i < FRAMES; i++) {
+    samples[i] = roomSample(i * 13);
+    frames[i] = encodeFrame(encoder, samples[i]);
+  }
+
+  Receiver receiver;
+  TelemetrySample out;
+  for (uint32_t i = 0; i < FRAMES; i++) {
+    if (i == LOST) continue;
+    bool ok = receiver.receive(frames[i].data, frames[i].length, out);
+    bool expected = i < LOST || i >= NEXT_KEY;
+    CHECK(ok == expected, "frame %u %s", i, ok ? "accepted after a lost delta" : "rejected");
+    if (ok) CHECK(sameSample(out, samples[i]), "frame %u decoded to a different sample", i);
+  }
+  CHECK(receiver.rejected == NEXT_KEY - LOST - 1, "%u frames rejected", receiver.rejected);
+
+  // A repeated delta is rejected without losing the place in the stream
+  Receiver repeat;
+  for (uint32_t i = 0; i < 4; i++) repeat.receive(frames[i].data, frames[i].length, out);
+  CHECK(!repeat.receive(frames[3].data, frames[3].length, out), "repeated delta accepted");
+  CHECK(!repeat.receive(frames[2].data, frames[2].length, out), "old delta accepted");
+  CHECK(repeat.receive(frames[4].data, frames[4].length, out) && sameSample(out, samples[4]),
+        "stream lost after a repeated delta");
+
+  // A decoder that starts mid-stream waits for a key frame
+  Receiver late;
+  for (uint32_t i = 3; i <= NEXT_KEY; i++) late.receive(frames[i].data, frames[i].length, out);
+  CHECK(late.rejected == NEXT_KEY - 3 && late.accepted == 1, "%u rejected, %u accepted",
+        late.rejected, late.accepted);
+}
+
+// ===== MALFORMED FRAMES =====
+static void testMalformed() {
+  BinaryTelemetryEncoder encoder;
+  Receiver receiver;
+  TelemetrySample sample = { 22.5f, 40.0f, true, 128, false, false };
+  Frame key = encodeFrame(encoder, sample);
+  TelemetrySample out;
+  receiver.receive(key.data, key.length, out);
+
+  // Each one would otherwise be the next frame (seq 1)
+  const struct {
+    const char* what;
+    uint8_t data[12];
+    size_t length;
+  } bad[] = {
+    { "empty", {}, 0 },
+    { "short header", { 1, 2, 1 }, 3 },
+    { "version 2", { 2, 2, 1, 0, 0 }, 5 },
+    { "frame type 3", { 1, 3, 1, 0, 0 }, 5 },
+    { "key body of 5", { 1, 1, 1, 0, 0xe1, 0, 0x90, 1, 1 }, 9 },
+    { "key body of 7", { 1, 1, 1, 0, 0xe1, 0, 0x90, 1, 1, 0, 0 }, 11 },
+    { "delta without a mask", { 1, 2, 1, 0 }, 4 },
+    { "delta missing a field", { 1, 2, 1, 0, BINARY_CHANGED_TEMP | BINARY_CHANGED_LED1, 5 }, 6 },
+    { "delta with a byte left over", { 1, 2, 1, 0, BINARY_CHANGED_TEMP, 5, 0 }, 7 },
+  };
+  for (const auto& frame : bad) {
+    CHECK(!receiver.receive(frame.data, frame.length, out), "%s accepted", frame.what);
+  }
+
+  // None of them moved the decoder on
+  sample.temperature = 23.0f;
+  Frame delta = encodeFrame(encoder, sample);
+  CHECK(delta.data[1] == BINARY_FRAME_DELTA, "frame type %u", delta.data[1]);
+  CHECK(receiver.receive(delta.data, delta.length, out) && sameSample(out, sample),
+        "valid delta rejected after malformed frames");
+}
+
+// ===== FAILED SEND =====
+struct BinaryConfig : HubDefaults {
+  static constexpr bool binaryUplink = true;
+};
+
+static void testFailedSend() {
+  WebSocketsClient client;
+  client.begin("api.test", 80);
+  client.setReconnectInterval(0);
+  // Connects, then the 101 reply one round trip later
+  client.loop();
+  hostClockAdvance(hostApi.rttMs);
+  client.loop();
+  CHECK(client.isConnected(), "no connection to the host API server");
+
+  static uint8_t buffer[WEBSOCKETS_MAX_HEADER_SIZE + 200];
+  WebSocketUplink<BinaryConfig> uplink(client, buffer, sizeof(buffer));
+  uplink.reset();
+  uplink.accept(WebSocketUplink<BinaryConfig>::offeredVersion());
+  CHECK(uplink.binary(), "binary frames not in use");
+
+  uint32_t i = 0;
+  for (; i < 10; i++) CHECK(uplink.sendSample(roomSample(i)), "sample %u not sent", i);
+  CHECK(hostApi.binarySamples == 10, "server decoded %u frames", hostApi.binarySamples);
+
+  // The encoder has taken this sample as the base for the next delta
+  hostApi.failSends = 1;
+  CHECK(!uplink.sendSample(roomSample(i++)), "failed send reported as sent");
+
+  for (; i < 20; i++) {
+    CHECK(uplink.sendSample(roomSample(i)), "sample %u not sent", i);
+    CHECK(sameSample(hostApi.lastSample, roomSample(i)), "sample %u decoded wrong", i);
+  }
+  CHECK(hostApi.rejected == 0, "server rejected %u frames after the failed send",
+        hostApi.rejected);
+  CHECK(hostApi.binarySamples == 19, "server decoded %u frames", hostApi.binarySamples);
+  CHECK(hostApi.linked(), "the failed send dropped the link");
+}
+
+int main(int argc, char** argv) {
+  for (int i = 1; i + 1 < argc; i++) {
+    if (strcmp(argv[i], "--vectors") == 0) {
+      vectors = fopen(argv[++i], "w");
+      if (!vectors) {
+        perror(argv[i]);
+        return 2;
+      }
+    }
+  }
+  if (vectors) fputs("# Frames and BinaryTelemetryDecoder's results\n", vectors);
+
+  testRoundTrip();
+  testForcedKeyFrames();
+  testLostFrames();
+  testMalformed();
+  testFailedSend();
+
+  if (vectors) fclose(vectors);
+  if (failures == 0) printf("binary telemetry: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
@@ -0,0 +1,172 @@
+/*
+ * LCD traffic per frame, before and after the shadow framebuffer
+ *
+ * Draws the same sequence of normal-operation screens twice: with the
+ * clear-and-rewrite code updateLCD() used to have, and with the sketch's
+ * updateLCD(), which renders into LcdBuffer and sends only the changed
+ * cells. Prints the LCD bytes, I2C bytes and bus time of every frame,
+ * checks that both paths leave the same text on the display and that the
+ * shadow framebuffer sends no more than it has to.
+ *
+ * The sketch is not booted: the LCD is driven from main(), and delays
+ * only move the fake clock.
+ */
+#include <LiquidCrystal_I2C.h>
+#include <Wire.h>
+#include <string>
+#include <vector>
+#include "host_sim.h"
+#include "sketch.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+struct Screen {
+  const char* what;
+  float temperature;
+  float humidity;
+  bool motion;
+  int led1;
+  bool led2;
+  bool led3;
+};
+
+// A few minutes of a room: mostly periodic refreshes of the same values
+static const Screen screens[] = {
+  { "first frame",        22.5f, 55.0f, false, 0,   false, false },
+  { "refresh, unchanged", 22.5f, 55.0f, false, 0,   false, false },
+  { "temperature +0.1",   22.6f, 55.0f, false, 0,   false, false },
+  { "refresh, unchanged", 22.6f, 55.0f, false, 0,   false, false },
+  { "motion",             22.6f, 55.0f, true,  0,   false, false },
+  { "LED1 and LED2 on",   22.6f, 55.0f, true,  128, true,  false },
+  { "humidity +0.5",      22.6f, 55.5f, true,  128, true,  false },
+  { "motion stopped",     22.6f, 55.5f, false, 128, true,  false },
+  { "temperature 9.8",    9.8f,  55.5f, false, 128, true,  false },
+  { "refresh, unchanged", 9.8f,  55.5f, false, 128, true,  false },
+};
+static const size_t SCREEN_COUNT = sizeof(screens) / sizeof(screens[0]);
+
+struct Traffic {
+  uint32_t lcdBytes;
+  uint32_t i2cBytes;
+  uint32_t busUs;
+  uint32_t clears;
+  std::string rows[2];
+};
+
+static void resetCounters() {
+  hostLcd.resetCounters();
+  hostI2c.transactions = 0;
+  hostI2c.bytes = 0;
+  hostI2c.busNs = 0;
+}
+
+static Traffic traffic() {
+  Traffic t;
+  t.lcdBytes = hostLcd.bytes;
+  t.i2cBytes = hostI2c.bytes;
+  t.busUs = (uint32_t)(hostI2c.busNs / 1000);
+  t.clears = hostLcd.clears;
+  t.rows[0] = hostLcd.row(0);
+  t.rows[1] = hostLcd.row(1);
+  return t;
+}
+
+// updateLCD()'s normal-operation screen before the shadow framebuffer
+static void drawWithClear(LiquidCrystal_I2C& lcd, const Screen& s) {
+  lcd.clear();
+  lcd.write((uint8_t)0); // WiFi icon
+  lcd.setCursor(2, 0);
+  lcd.write(2); // Temperature icon
+  lcd.print(s.temperature, 1);
+  lcd.print("C ");
+  if (s.motion) {
+    lcd.setCursor(15, 0);
+    lcd.write(4); // Motion icon
+  }
+  lcd.setCursor(2, 1);
+  lcd.write(3); // Humidity icon
+  lcd.print(s.humidity, 1);
+  lcd.print("% ");
+  lcd.setCursor(10, 1);
+  lcd.print("L:");
+  lcd.print(s.led1 > 0 ? "1" : "-");
+  lcd.print(s.led2 ? "2" : "-");
+  lcd.print(s.led3 ? "3" : "-");
+}
+
+static std::string printable(const std::string& row) {
+  std::string out = row;
+  for (char& c : out) {
+    if ((uint8_t)c < 8) c = '0' + c;  // Custom characters as digits
+  }
+  return out;
+}
+
+int main() {
+  hostSerialEcho(false);
+
+  // Before: the sketch's LCD setup, then every screen cleared and rewritten
+  hostSketchSetupLcd();
+  LiquidCrystal_I2C lcd(0x27, 16, 2);
+  std::vector<Traffic> before;
+  for (const Screen& s : screens) {
+    resetCounters();
+    drawWithClear(lcd, s);
+    before.push_back(traffic());
+  }
+
+  // After: the same screens through updateLCD() from a fresh setup
+  hostSketchSetupLcd();
+  std::vector<Traffic> after;
+  for (const Screen& s : screens) {
+    resetCounters();
+    hostSketchShowNormalScreen(s.temperature, s.humidity, s.motion, s.led1, s.led2, s.led3);
+    after.push_back(traffic());
+  }
+
+  printf("%-20s | %9s %9s %8s | %9s %9s %8s\n", "", "before", "", "", "after", "", "");
+  printf("%-20s | %9s %9s %8s | %9s %9s %8s\n", "frame", "LCD bytes", "I2C bytes", "bus us",
+         "LCD bytes", "I2C bytes", "bus us");
+  for (size_t i = 0; i < SCREEN_COUNT; i++) {
+    printf("%-20s | %9u %9u %8u | %9u %9u %8u\n", screens[i].what, before[i].lcdBytes,
+           before[i].i2cBytes, before[i].busUs, after[i].lcdBytes, after[i].i2cBytes,
+           after[i].busUs);
+  }
+  printf("Before, every frame also waits 2 ms for lcd.clear()\n");
+
+  for (size_t i = 0; i < SCREEN_COUNT; i++) {
+    const Traffic& b = before[i];
+    const Traffic& a = after[i];
+    for (int row = 0; row < 2; row++) {
+      CHECK(a.rows[row] == b.rows[row], "%s, row %d: \"%s\" instead of \"%s\"", screens[i].what,
+            row, printable(a.rows[row]).c_str(), printable(b.rows[row]).c_str());
+    }
+    CHECK(b.clears == 1 && a.clears == 0, "%s: %u clears before, %u after", screens[i].what,
+          b.clears, a.clears);
+    // Only the first frame after setup redraws everything
+    if (i > 0) {
+      CHECK(a.lcdBytes < b.lcdBytes, "%s: %u LCD bytes, %u before", screens[i].what, a.lcdBytes,
+            b.lcdBytes);
+    }
+  }
+
+  // Two cursor moves and 32 cells, then only what changed
+  CHECK(after[0].lcdBytes == 2 + 32, "first frame: %u LCD bytes", after[0].lcdBytes);
+  CHECK(after[1].lcdBytes == 0, "unchanged frame: %u LCD bytes", after[1].lcdBytes);
+  CHECK(after[2].lcdBytes == 2, "one digit changed: %u LCD bytes", after[2].lcdBytes);
+  CHECK(after[4].lcdBytes == 2, "motion icon: %u LCD bytes", after[4].lcdBytes);
+
+  if (failures == 0) printf("lcd bytes: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
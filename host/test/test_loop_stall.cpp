@@ -0,0 +1,110 @@
+/*
+ * Longest network pass through WiFi setup and failures
+ *
+ * Walks the hub through the paths that used to block in delay(): the
+ * captive portal with a wrong and then the right password, a dropped
+ * WiFi link and an API server that refuses connections. After each
+ * step the longest pass of the network task must stay within
+ * NET_LOOP_BUDGET and the task must have kept its pace.
+ */
+#include <ESPAsyncWebServer.h>
+#include <WebSocketsClient.h>
+#include <WiFi.h>
+#include "host_sim.h"
+#include "loop_stats.h"
+#include "sketch.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+static uint32_t passCount() {
+  LoopRegionSummary summary;
+  return loopStatsSummary(REGION_NETWORK_PASS, summary) ? summary.count : 0;
+}
+
+/**
+ * Runs ms of simulated time and checks the network task: no pass over
+ * the budget so far, and at least one pass per budget's worth of time
+ */
+static void runStep(const char* step, uint32_t ms) {
+  uint32_t passes = passCount();
+  hostSimRun(ms);
+
+  LoopRegionSummary summary;
+  loopStatsSummary(REGION_NETWORK_PASS, summary);
+  CHECK(summary.maxUs <= hostNetLoopBudget * 1000, "%s: a pass took %u us (budget %u ms)", step,
+        summary.maxUs, hostNetLoopBudget);
+  CHECK(summary.count - passes >= ms / hostNetLoopBudget, "%s: %u passes in %u ms", step,
+        summary.count - passes, ms);
+}
+
+static String wifiStatus() {
+  HostHttpReply reply;
+  hostHttpRequest(HTTP_GET, "/status", {}, reply);
+  hostSimRun(10);
+  return reply.body;
+}
+
+static void connectFromPortal(const char* password) {
+  HostHttpReply reply;
+  hostHttpRequest(HTTP_POST, "/connect", { { "ssid", "home" }, { "password", password } }, reply);
+  hostSimRun(10);
+  CHECK(reply.code == 200, "/connect answered %d", reply.code);
+}
+
+int main() {
+  hostSerialEcho(false);
+  // The connect itself blocks the network task; it has to fit the budget
+  CHECK(hostApi.connectMs < hostNetLoopBudget, "API connect of %u ms", hostApi.connectMs);
+
+  // First boot: nothing saved, so the portal comes up
+  hostWifiAddNetwork("home", "hunter22", -58);
+  hostSimBoot(setup, loop);
+  runStep("boot", 5000);
+  CHECK(!hostSketchWifiConnected(), "connected without credentials");
+  CHECK(wifiStatus() == "{\"state\":\"idle\"}", "portal status %s", wifiStatus().c_str());
+
+  connectFromPortal("hunter2");
+  runStep("wrong password", 15000);
+  CHECK(wifiStatus() == "{\"state\":\"failed\"}", "after a wrong password: %s",
+        wifiStatus().c_str());
+  CHECK(!hostSketchWifiConnected(), "connected with a wrong password");
+
+  connectFromPortal("hunter22");
+  runStep("right password", 15000);
+  CHECK(wifiStatus() == "{\"state\":\"connected\"}", "after the right password: %s",
+        wifiStatus().c_str());
+  CHECK(hostSketchWifiConnected() && hostSketchApiConnected(), "not online (wifi %d, api %d)",
+        hostSketchWifiConnected(), hostSketchApiConnected());
+
+  hostWifiDropLink();
+  runStep("link lost", 15000);
+  CHECK(hostSketchWifiConnected() && hostSketchApiConnected(),
+        "not back online after a link loss (wifi %d, api %d)", hostSketchWifiConnected(),
+        hostSketchApiConnected());
+
+  // The API server goes down while the hub keeps reporting
+  hostApi.reachable = false;
+  uint32_t refused = hostApi.refused;
+  hostApi.drop();
+  runStep("api refused", 60000);
+  CHECK(!hostSketchApiConnected(), "API still connected");
+  CHECK(hostApi.refused > refused, "no reconnect attempt");
+
+  hostApi.reachable = true;
+  runStep("api back", 120000);
+  CHECK(hostSketchApiConnected(), "API not reconnected");
+
+  if (failures == 0) printf("loop stall: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
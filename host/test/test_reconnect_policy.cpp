@@ -0,0 +1,330 @@
+/*
+ * API reconnect backoff against a restarted server
+ *
+ * Runs ReconnectPolicy<HubDefaults> over a fake client, the way the
+ * sketch runs it over the API WebSocket, on the fake clock:
+ *
+ *   - a fleet of hubs losing a server that restarts, then completes a
+ *     limited number of handshakes per second and falls over when too
+ *     many connects arrive at once; prints connects over time and
+ *     checks the peak rate, that the server stays up and that every hub
+ *     is back
+ *   - one hub: the streak resets only after a connection that lasted
+ *     reconnectStable, a handshake that never ends fails after
+ *     reconnectTimeout, and the counters add up
+ *
+ * The fake client behaves like WebSocketsClient with the policy's hold
+ * interval: it connects only in a loop() with the interval at 0, and a
+ * refused connect raises no event.
+ */
+#include <memory>
+#include <vector>
+#include "host_sim.h"
+#include "reconnect_policy.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+#define STEP_MS 10            // Network task pass
+#define HANDSHAKE_MS 300      // TCP, TLS and upgrade when the server accepts
+
+// ===== SERVER =====
+struct FakeServer {
+  uint32_t capacity;     // Handshakes per second
+  uint32_t overload;     // Connects per second that knock it over
+  uint32_t restartMs;    // Down time after a restart or a fall
+  bool stall;            // Accepts TCP but never finishes a handshake
+
+  uint32_t upAt;
+  uint32_t generation;   // Bumped when it goes down; drops every link
+  uint32_t crashes;
+  std::vector<uint32_t> connectsPerSecond;
+  uint32_t second;
+  uint32_t accepted;     // Handshakes in the current second
+
+  FakeServer()
+    : capacity(100), overload(400), restartMs(20000), stall(false), upAt(0), generation(0),
+      crashes(0), second(0), accepted(0) {}
+
+  void restart(uint32_t now) {
+    upAt = now + restartMs;
+    generation++;
+  }
+
+  // A connect arriving now: true if the handshake will complete
+  bool connect(uint32_t now) {
+    uint32_t s = now / 1000;
+    if (connectsPerSecond.size() <= s) connectsPerSecond.resize(s + 1, 0);
+    if (s != second) {
+      second = s;
+      accepted = 0;
+    }
+    connectsPerSecond[s]++;
+    if ((int32_t)(now - upAt) < 0) return false;
+    if (connectsPerSecond[s] > overload) {
+      crashes++;
+      restart(now);
+      return false;
+    }
+    if (stall || accepted >= capacity) return false;
+    accepted++;
+    return true;
+  }
+};
+
+static FakeServer server;
+
+// ===== CLIENT =====
+class FakeClient;
+typedef ReconnectPolicy<HubDefaults, FakeClient> Link;
+
+class FakeClient {
+ public:
+  FakeClient()
+    : link(nullptr), disconnects(0), interval_(0), state_(IDLE), due_(0), generation_(0) {}
+
+  void setReconnectInterval(unsigned long interval) { interval_ = interval; }
+
+  void loop() {
+    uint32_t now = millis();
+    switch (state_) {
+      case IDLE:
+        if (interval_ != 0) return;
+        // A refused connect returns to IDLE without an event
+        if (server.connect(now)) {
+          state_ = HANDSHAKE;
+          due_ = now + HANDSHAKE_MS;
+          generation_ = server.generation;
+        } else if (server.stall) {
+          state_ = HANDSHAKE;
+          due_ = UINT32_MAX;
+        }
+        break;
+      case HANDSHAKE:
+        if (server.generation != generation_) {
+          state_ = IDLE;
+        } else if (due_ != UINT32_MAX && (int32_t)(now - due_) >= 0) {
+          state_ = OPEN;
+          link->connected();
+        }
+        break;
+      case OPEN:
+        if (server.generation != generation_) {
+          state_ = IDLE;
+          link->disconnected();
+        }
+        break;
+    }
+  }
+
+  void disconnect() {
+    bool wasOpen = state_ == OPEN;
+    state_ = IDLE;
+    if (wasOpen) link->disconnected();
+    disconnects++;
+  }
+
+  bool isOpen() const { return state_ == OPEN; }
+
+  Link* link;
+  uint32_t disconnects;
+
+ private:
+  enum State { IDLE, HANDSHAKE, OPEN };
+  unsigned long interval_;
+  State state_;
+  uint32_t due_;
+  uint32_t generation_;
+};
+
+struct Hub {
+  FakeClient client;
+  Link link;
+
+  Hub() : link(client) { client.link = &link; }
+};
+
+static void step(std::vector<std::unique_ptr<Hub>>& hubs) {
+  hostClockAdvance(STEP_MS);
+  for (auto& hub : hubs) hub->link.loop();
+}
+
+static void runFor(std::vector<std::unique_ptr<Hub>>& hubs, uint32_t ms) {
+  for (uint32_t t = 0; t < ms; t += STEP_MS) step(hubs);
+}
+
+static size_t connectedCount(const std::vector<std::unique_ptr<Hub>>& hubs) {
+  size_t n = 0;
+  for (const auto& hub : hubs) n += hub->client.isOpen() && hub->link.isConnected();
+  return n;
+}
+
+// ===== FLEET =====
+static void testFleetRestart() {
+  const size_t HUBS = 1000;
+  const uint32_t DURATION = 180000;
+  // Bring the fleet up against a server that takes everyone at once
+  server = FakeServer();
+  server.capacity = HUBS;
+  server.overload = HUBS;
+  std::vector<std::unique_ptr<Hub>> hubs;
+  for (size_t i = 0; i < HUBS; i++) {
+    hubs.emplace_back(new Hub());
+    hubs.back()->link.begin();
+  }
+  runFor(hubs, 1000);
+  CHECK(connectedCount(hubs) == HUBS, "%zu of %zu hubs up before the restart",
+        connectedCount(hubs), HUBS);
+
+  FakeServer restarted;
+  restarted.generation = server.generation;
+  server = restarted;
+  uint32_t restartAt = millis();
+  server.restart(restartAt);
+  uint32_t backAt = 0;
+  for (uint32_t t = 0; t < DURATION; t += STEP_MS) {
+    step(hubs);
+    if (!backAt && connectedCount(hubs) == HUBS) backAt = millis() - restartAt;
+  }
+
+  // Connects per 10 s after the restart, as a bar chart
+  uint32_t first = restartAt / 1000;
+  uint32_t peak = 0;
+  uint32_t peakUp = 0;  // Once the server accepts again
+  for (uint32_t s = first; s < server.connectsPerSecond.size(); s++) {
+    peak = max(peak, server.connectsPerSecond[s]);
+    if (s * 1000 >= restartAt + server.restartMs) peakUp = max(peakUp, server.connectsPerSecond[s]);
+  }
+  printf("Fleet of %zu hubs, server down %u s, %u handshakes/s, falls over above %u connects/s\n",
+         HUBS, server.restartMs / 1000, server.capacity, server.overload);
+  for (uint32_t s = first; s < server.connectsPerSecond.size() && s < first + backAt / 1000 + 10;
+       s += 10) {
+    uint32_t count = 0;
+    for (uint32_t i = s; i < s + 10 && i < server.connectsPerSecond.size(); i++) {
+      count += server.connectsPerSecond[i];
+    }
+    printf("%4us %6u %.*s\n", s - first, count, (int)(count * 50 / (peak * 10)),
+           "##################################################");
+  }
+  printf("peak %u connects/s, %u once the server is back; fell over %u times; ", peak, peakUp,
+         server.crashes);
+  if (backAt) {
+    printf("all back after %.1f s\n", backAt / 1000.0);
+  } else {
+    printf("not all back after %u s\n", DURATION / 1000);
+  }
+
+  CHECK(server.crashes == 0, "the server fell over %u times", server.crashes);
+  CHECK(peakUp <= server.capacity * 2, "%u connects/s against %u handshakes/s", peakUp,
+        server.capacity);
+  CHECK(backAt != 0 && backAt <= 120000, "fleet back after %u ms", backAt);
+
+  uint32_t attempts = 0, fails = 0, connects = 0, maxTime = 0;
+  for (const auto& hub : hubs) {
+    const ReconnectStats& stats = hub->link.stats();
+    attempts += stats.attempts;
+    fails += stats.failures;
+    connects += stats.connects;
+    maxTime = max(maxTime, stats.maxConnectTime);
+    CHECK(stats.connectTime >= server.restartMs, "hub back %u ms after a %u ms restart",
+          stats.connectTime, server.restartMs);
+  }
+  CHECK(connects == 2 * HUBS, "%u connects", connects);
+  CHECK(attempts == fails + connects, "%u attempts, %u failures, %u connects", attempts, fails,
+        connects);
+  CHECK(maxTime <= backAt + STEP_MS, "longest reconnect %u ms, fleet back after %u ms", maxTime,
+        backAt);
+}
+
+// ===== ONE HUB =====
+// Widest wait seen over a number of drops of a connection that lasted upMs
+static uint32_t widestWaitAfterDrops(uint32_t upMs, int drops) {
+  std::vector<std::unique_ptr<Hub>> hubs;
+  hubs.emplace_back(new Hub());
+  Link& link = hubs[0]->link;
+  server = FakeServer();
+  server.restartMs = 0;
+  link.begin();
+  runFor(hubs, 1000);
+
+  uint32_t widest = 0;
+  for (int i = 0; i < drops; i++) {
+    runFor(hubs, upMs);
+    server.restart(millis());
+    step(hubs);
+    widest = max(widest, link.delay());
+    // Reconnect, whatever the wait
+    for (uint32_t t = 0; t <= HubDefaults::reconnectCap && !link.isConnected(); t += STEP_MS) {
+      step(hubs);
+    }
+    CHECK(link.isConnected(), "no reconnect after drop %d", i);
+  }
+  return widest;
+}
+
+static void testStreakReset() {
+  // Stable connections: every drop starts over at reconnectBase
+  uint32_t stable = widestWaitAfterDrops(HubDefaults::reconnectStable, 10);
+  CHECK(stable <= HubDefaults::reconnectBase, "waited %u ms after a stable connection", stable);
+
+  // Short-lived ones keep the streak, so the window keeps doubling
+  uint32_t flapping = widestWaitAfterDrops(HubDefaults::reconnectStable / 10, 10);
+  CHECK(flapping > 4 * HubDefaults::reconnectBase, "waited at most %u ms while flapping",
+        flapping);
+}
+
+static void testHandshakeTimeout() {
+  std::vector<std::unique_ptr<Hub>> hubs;
+  hubs.emplace_back(new Hub());
+  Link& link = hubs[0]->link;
+  FakeClient& client = hubs[0]->client;
+  server = FakeServer();
+  server.restartMs = 0;
+  server.stall = true;
+
+  link.begin();
+  step(hubs);
+  uint32_t start = millis();
+  CHECK(link.stats().attempts == 1, "%u attempts after begin()", link.stats().attempts);
+
+  // Still waiting just before the timeout
+  while (millis() - start + STEP_MS < HubDefaults::reconnectTimeout) step(hubs);
+  CHECK(link.stats().failures == 0 && client.disconnects == 0, "gave up after %u ms",
+        (uint32_t)(millis() - start));
+  step(hubs);
+  CHECK(link.stats().failures == 1, "%u failures after the timeout", link.stats().failures);
+  CHECK(client.disconnects == 1, "%u disconnects after the timeout", client.disconnects);
+  CHECK(link.delay() <= HubDefaults::reconnectBase, "first wait %u ms", link.delay());
+
+  // The server finishes handshakes again; the next attempt gets through
+  server.stall = false;
+  for (int t = 0; t < 10000 && !link.isConnected(); t += STEP_MS) step(hubs);
+  const ReconnectStats& stats = link.stats();
+  CHECK(link.isConnected(), "no connection once the server answers");
+  CHECK(stats.attempts == 2 && stats.failures == 1 && stats.connects == 1,
+        "%u attempts, %u failures, %u connects", stats.attempts, stats.failures, stats.connects);
+  CHECK(stats.connectTime >= HubDefaults::reconnectTimeout + HANDSHAKE_MS,
+        "connected %u ms after begin()", stats.connectTime);
+  CHECK(stats.maxConnectTime == stats.connectTime, "longest %u ms, last %u ms",
+        stats.maxConnectTime, stats.connectTime);
+}
+
+int main() {
+  randomSeed(1);
+  testFleetRestart();
+  testStreakReset();
+  testHandshakeTimeout();
+
+  if (failures == 0) printf("reconnect policy: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
@@ -0,0 +1,275 @@
+/*
+ * wss:// connects against the TLS stand-in
+ *
+ * Builds libraries/HubCore/src/secure_ws_client.cpp against the host's
+ * mbedTLS and connects SecureWebSocketsClient over loopback to
+ * tools/tls_standin.py, which makes its own CA and server certificate.
+ * Once TLS is up the WebSocket upgrade goes to hostApi as usual (see
+ * connectedCb() in stubs/WebSocketsClient.h).
+ *
+ *   - a full handshake, then a resumed one, as the stand-in saw them too
+ *   - the CA key pinned without the root CA and a key nobody has are
+ *     rejected, and a rejected server is not cached; the CA key with
+ *     the root CA and the server key alone are accepted
+ *   - a server that accepts TCP and never answers: no loop() pass takes
+ *     much longer than TLS_CONNECT_SLICE, and the connect fails after
+ *     WEBSOCKETS_TCP_TIMEOUT
+ *
+ * The loop runs on the fake clock; sockets and the stand-in run in real
+ * time, so pass lengths are measured with the host's clock.
+ *
+ *   test_secure_ws_client <python> <tools/tls_standin.py> <certificate dir>
+ */
+#include <WebSocketsClient.h>
+#include <arpa/inet.h>
+#include <poll.h>
+#include <signal.h>
+#include <sys/wait.h>
+#include <chrono>
+#include <fstream>
+#include <sstream>
+#include <string>
+#include "host_sim.h"
+#include "secure_ws_client.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+#define STEP_MS 10           // Fake time per loop() pass
+#define SILENT_STEP_MS 250   // The same against the silent server, to wait less
+#define PASS_SLACK_MS 50     // Scheduling noise allowed on top of the slice
+#define WRONG_PIN "AAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAAA="
+
+// ===== STAND-IN =====
+struct StandIn {
+  pid_t pid;
+  int out;              // Its stdout and stderr
+  std::string buffer;   // Read, not yet split into lines
+  uint16_t port;
+  std::string rootCA;
+  std::string serverPin;
+  std::string caPin;
+};
+
+static StandIn standIn;
+
+// Next line the stand-in prints, waiting up to ms of real time
+static bool readLine(std::string& line, int ms) {
+  auto deadline = std::chrono::steady_clock::now() + std::chrono::milliseconds(ms);
+  for (;;) {
+    size_t end = standIn.buffer.find('\n');
+    if (end != std::string::npos) {
+      line = standIn.buffer.substr(0, end);
+      standIn.buffer.erase(0, end + 1);
+      return true;
+    }
+    auto left = std::chrono::duration_cast<std::chrono::milliseconds>(
+      deadline - std::chrono::steady_clock::now()).count();
+    struct pollfd fd = { standIn.out, POLLIN, 0 };
+    if (left <= 0 || ::poll(&fd, 1, (int)left) <= 0) return false;
+    char chunk[512];
+    ssize_t n = read(standIn.out, chunk, sizeof(chunk));
+    if (n <= 0) return false;
+    standIn.buffer.append(chunk, n);
+  }
+}
+
+// The quoted value in line after prefix
+static std::string after(const std::string& line, const char* prefix, char end) {
+  size_t at = line.find(prefix);
+  if (at == std::string::npos) return std::string();
+  at += strlen(prefix);
+  return line.substr(at, line.find(end, at) - at);
+}
+
+static bool startStandIn(const char* python, const char* script, const char* dir) {
+  int pipeFd[2];
+  if (pipe(pipeFd) != 0) return false;
+  standIn.pid = fork();
+  if (standIn.pid == 0) {
+    dup2(pipeFd[1], STDOUT_FILENO);
+    dup2(pipeFd[1], STDERR_FILENO);
+    close(pipeFd[0]);
+    execl(python, python, "-u", script, "serve", "--name", "127.0.0.1", "--listen", "127.0.0.1",
+          "--port", "0", "--dir", dir, (char*)NULL);
+    _exit(127);
+  }
+  close(pipeFd[1]);
+  standIn.out = pipeFd[0];
+  if (standIn.pid < 0) return false;
+
+  // Making the certificates the first time takes a few openssl runs
+  std::string line;
+  while (readLine(line, 60000)) {
+    if (line.find("apiKeyPin()") != std::string::npos) {
+      standIn.serverPin = after(line, "return \"", '"');
+    } else if (line.find("the CA key: ") != std::string::npos) {
+      standIn.caPin = after(line, "the CA key: ", '\n');
+    } else if (line.rfind("listening on ", 0) == 0) {
+      standIn.port = atoi(line.c_str() + line.rfind(':') + 1);
+      break;
+    }
+  }
+  std::ifstream ca(std::string(dir) + "/ca.pem");
+  std::stringstream pem;
+  pem << ca.rdbuf();
+  standIn.rootCA = pem.str();
+  return standIn.port && !standIn.serverPin.empty() && !standIn.caPin.empty() &&
+         !standIn.rootCA.empty();
+}
+
+static void stopStandIn() {
+  if (standIn.pid <= 0) return;
+  kill(standIn.pid, SIGTERM);
+  waitpid(standIn.pid, nullptr, 0);
+}
+
+// "full" or "resumed" for the next handshake the stand-in logs
+static std::string nextHandshake() {
+  std::string line;
+  while (readLine(line, 5000)) {
+    if (line.find(" full handshake (") != std::string::npos) return "full";
+    if (line.find(" resumed (") != std::string::npos) return "resumed";
+  }
+  return "none";
+}
+
+// ===== CONNECTS =====
+struct Attempt {
+  bool connected;      // The WebSocket is up
+  TlsStats stats;
+  uint32_t passes;     // loop() passes until TLS connected or failed
+  double longestMs;    // Real time of the longest pass
+};
+
+// One wss:// connect with a new client, the way the network task runs
+// it, with stepMs of fake time per pass
+static Attempt connectOnce(const char* rootCA, const char* keyPin, uint16_t port,
+                           uint32_t stepMs = STEP_MS) {
+  Attempt attempt = {};
+  SecureWebSocketsClient client;
+  client.setTrust(rootCA, keyPin);
+  client.beginSSL("127.0.0.1", port, "/");
+  client.setReconnectInterval(0);
+
+  const TlsStats& stats = client.tlsStats();
+  uint32_t limit = WEBSOCKETS_TCP_TIMEOUT / stepMs + 10;
+  while (stats.full + stats.resumed + stats.failed == 0 && attempt.passes < limit) {
+    auto started = std::chrono::steady_clock::now();
+    client.loop();
+    std::chrono::duration<double, std::milli> took = std::chrono::steady_clock::now() - started;
+    attempt.longestMs = max(attempt.longestMs, took.count());
+    attempt.passes++;
+    hostClockAdvance(stepMs);
+  }
+  // The upgrade reply comes from hostApi a round trip later
+  for (int i = 0; i < 20 && !stats.failed && !client.isConnected(); i++) {
+    hostClockAdvance(STEP_MS);
+    client.loop();
+  }
+  attempt.connected = client.isConnected();
+  attempt.stats = stats;
+  client.disconnect();
+  return attempt;
+}
+
+static void testFullThenResumed() {
+  tlsSessionClear();
+  Attempt first = connectOnce(standIn.rootCA.c_str(), standIn.serverPin.c_str(), standIn.port);
+  CHECK(first.connected, "no connection with the root CA and the server pin");
+  CHECK(first.stats.full == 1 && first.stats.resumed == 0, "%u full, %u resumed",
+        first.stats.full, first.stats.resumed);
+  std::string seen = nextHandshake();
+  CHECK(seen == "full", "the stand-in saw %s", seen.c_str());
+
+  Attempt second = connectOnce(standIn.rootCA.c_str(), standIn.serverPin.c_str(), standIn.port);
+  CHECK(second.connected, "no connection from the cached session");
+  CHECK(second.stats.resumed == 1 && second.stats.full == 0, "%u full, %u resumed",
+        second.stats.full, second.stats.resumed);
+  seen = nextHandshake();
+  CHECK(seen == "resumed", "the stand-in saw %s", seen.c_str());
+
+  printf("full handshake %u passes, longest %.1f ms; resumed %u passes, longest %.1f ms\n",
+         first.passes, first.longestMs, second.passes, second.longestMs);
+  CHECK(first.longestMs <= TLS_CONNECT_SLICE + PASS_SLACK_MS, "a pass took %.1f ms",
+        first.longestMs);
+  CHECK(second.longestMs <= TLS_CONNECT_SLICE + PASS_SLACK_MS, "a pass took %.1f ms",
+        second.longestMs);
+}
+
+static void testPins() {
+  tlsSessionClear();
+  // Without the root CA only the server's own key counts
+  Attempt caKeyAlone = connectOnce(nullptr, standIn.caPin.c_str(), standIn.port);
+  CHECK(!caKeyAlone.connected && caKeyAlone.stats.failed == 1,
+        "the CA key pinned without the root CA was accepted");
+  Attempt again = connectOnce(nullptr, standIn.caPin.c_str(), standIn.port);
+  CHECK(!again.connected && again.stats.resumed == 0, "a rejected server was resumed");
+
+  Attempt wrong = connectOnce(standIn.rootCA.c_str(), WRONG_PIN, standIn.port);
+  CHECK(!wrong.connected && wrong.stats.failed == 1, "a pin on no key was accepted");
+
+  Attempt caKey = connectOnce(standIn.rootCA.c_str(), standIn.caPin.c_str(), standIn.port);
+  CHECK(caKey.connected && caKey.stats.full == 1, "the CA key with the root CA was rejected");
+  Attempt serverKey = connectOnce(nullptr, standIn.serverPin.c_str(), standIn.port);
+  CHECK(serverKey.connected && serverKey.stats.full == 1, "the server key alone was rejected");
+}
+
+static void testSilentServer() {
+  // Accepts TCP in the kernel, never reads the ClientHello
+  int fd = socket(AF_INET, SOCK_STREAM, 0);
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+  socklen_t length = sizeof(addr);
+  bool listening = bind(fd, (struct sockaddr*)&addr, sizeof(addr)) == 0 && listen(fd, 4) == 0 &&
+                   getsockname(fd, (struct sockaddr*)&addr, &length) == 0;
+  CHECK(listening, "no listening socket");
+
+  tlsSessionClear();
+  uint32_t started = millis();
+  Attempt silent =
+    connectOnce(standIn.rootCA.c_str(), nullptr, ntohs(addr.sin_port), SILENT_STEP_MS);
+  uint32_t gaveUp = millis() - started;
+  close(fd);
+
+  printf("silent server: %u passes, longest %.1f ms, gave up after %u ms\n", silent.passes,
+         silent.longestMs, gaveUp);
+  CHECK(!silent.connected && silent.stats.failed == 1, "%u failed", silent.stats.failed);
+  CHECK(gaveUp >= WEBSOCKETS_TCP_TIMEOUT, "gave up after %u ms", gaveUp);
+  CHECK(silent.passes >= WEBSOCKETS_TCP_TIMEOUT / SILENT_STEP_MS, "%u passes", silent.passes);
+  CHECK(silent.longestMs <= TLS_CONNECT_SLICE + PASS_SLACK_MS, "a pass took %.1f ms",
+        silent.longestMs);
+}
+
+int main(int argc, char** argv) {
+  if (argc != 4) {
+    fprintf(stderr, "usage: %s <python> <tls_standin.py> <certificate dir>\n", argv[0]);
+    return 2;
+  }
+  signal(SIGPIPE, SIG_IGN);
+  if (!startStandIn(argv[1], argv[2], argv[3])) {
+    fprintf(stderr, "the TLS stand-in did not start\n");
+    stopStandIn();
+    return 1;
+  }
+
+  testFullThenResumed();
+  testPins();
+  testSilentServer();
+  stopStandIn();
+
+  if (failures == 0) printf("secure ws client: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
@@ -0,0 +1,221 @@
+/*
+ * Back-pressure in the task graph
+ *
+ * Runs the sketch's tasks on the simulated ESP32 and stalls one consumer
+ * at a time to check that its producers never block on it:
+ *
+ *   network -> actuatorQueue -> io   a flood of LED commands is compacted
+ *                                    to the newest per target, and the
+ *                                    server's ack waits until it is
+ *                                    applied, also across a reconnect
+ *   io -> displayQueue -> display    frames overwrite the single slot
+ *   dht_sampler -> io                a sampler stopped mid-publish costs
+ *                                    readers a few ticks, then the last
+ *                                    reading
+ */
+#include <DHT.h>
+#include <WebSocketsClient.h>
+#include <WebSocketsServer.h>
+#include <WiFi.h>
+#include <atomic>
+#include "dht_sampler.h"
+#include "host_sim.h"
+#include "loop_stats.h"
+#include "sketch.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+static uint32_t regionCount(LoopRegion region) {
+  LoopRegionSummary summary;
+  return loopStatsSummary(region, summary) ? summary.count : 0;
+}
+
+static uint32_t regionMaxUs(LoopRegion region) {
+  LoopRegionSummary summary;
+  return loopStatsSummary(region, summary) ? summary.maxUs : 0;
+}
+
+// ===== NETWORK -> IO =====
+static void testActuatorFlood(HostWsPeer& phone) {
+  TaskHandle_t io = hostTaskFind("io");
+  uint32_t droppedBefore = hostSketchDroppedCommands();
+  uint32_t passesBefore = regionCount(REGION_NETWORK_PASS);
+
+  vTaskSuspend(io);
+  // A slider drag and a few toggles in one burst, more than the queue holds
+  char text[64];
+  for (int i = 1; i <= 40; i++) {
+    snprintf(text, sizeof(text), "{\"op\":\"led1\",\"id\":%d,\"value\":%d}", i, i * 5);
+    phone.sendText(text);
+    if (i % 10 == 0) phone.sendText(i % 20 ? "led2:1" : "led2:0");
+  }
+  phone.sendText("led3:1");
+  hostSimRun(500);
+
+  phone.receive();
+  // Acks do not wait for the io task; the fan-out keeps the newest few
+  CHECK(!phone.messages().empty(), "no acks while io was stalled");
+  phone.clearMessages();
+  UBaseType_t waiting = uxQueueMessagesWaiting(hostSketchActuatorQueue());
+  CHECK(waiting <= hostActuatorQueueLength, "%u commands queued", (unsigned)waiting);
+  CHECK(hostSketchDroppedCommands() > droppedBefore, "no superseded command was dropped");
+  CHECK(regionCount(REGION_NETWORK_PASS) > passesBefore + 50, "the network task stalled");
+  CHECK(hostSketchLed1() == 0, "LED1 changed with io stalled");
+
+  vTaskResume(io);
+  hostSimRun(500);
+  CHECK(uxQueueMessagesWaiting(hostSketchActuatorQueue()) == 0, "commands left over");
+  CHECK(hostSketchLed1() == 200, "LED1 is %d, the last set-point was 200", hostSketchLed1());
+  CHECK(!hostSketchLed2(), "LED2 did not end off");
+  CHECK(hostSketchLed3(), "LED3 did not end on");
+}
+
+static void testServerAckWaitsForIo() {
+  TaskHandle_t io = hostTaskFind("io");
+  uint32_t ackBefore = hostApi.lastAck;
+  int led1Before = hostSketchLed1();
+
+  vTaskSuspend(io);
+  char text[128];
+  for (uint32_t seq = 1; seq <= 20; seq++) {
+    snprintf(text, sizeof(text),
+             "{\"action\":\"device_control\",\"seq\":%u,\"payload\":{\"led1\":%u,\"led3\":%s}}",
+             seq, seq * 10 + 5, seq % 2 ? "true" : "false");
+    hostApi.inject(text);
+  }
+  hostSimRun(1000);
+  CHECK(hostSketchLed1() == led1Before, "LED1 changed with io stalled");
+  CHECK(hostApi.lastAck == ackBefore, "ack %u sent before the commands were applied",
+        hostApi.lastAck);
+
+  vTaskResume(io);
+  hostSimRun(1000);
+  CHECK(hostApi.lastAck == 20, "server got ack %u", hostApi.lastAck);
+  CHECK(hostSketchLed1() == 205, "LED1 is %d after the server's set-points", hostSketchLed1());
+  CHECK(!hostSketchLed3(), "LED3 did not follow the last set-point");
+}
+
+// Set-points from the last connection still queued when the next one starts
+static void testReconnectWithCommandsQueued() {
+  TaskHandle_t io = hostTaskFind("io");
+
+  vTaskSuspend(io);
+  hostApi.inject("{\"action\":\"device_control\",\"seq\":900,\"payload\":{\"led1\":10}}");
+  hostSimRun(500);
+  hostApi.drop();
+  for (int i = 0; i < 20 && !hostApi.linked(); i++) hostSimRun(500);
+  CHECK(hostApi.linked(), "the API link did not come back");
+  hostSimRun(500);
+
+  // Sequence numbers start over; LED1's old set-point is still queued
+  hostApi.lastAck = 0;
+  hostApi.inject("{\"action\":\"device_control\",\"seq\":1,\"payload\":{\"led3\":true}}");
+  hostApi.inject("{\"action\":\"device_control\",\"seq\":2,\"payload\":{\"led2\":true}}");
+  hostSimRun(1000);
+  CHECK(hostApi.lastAck == 0, "ack %u sent with io stalled", hostApi.lastAck);
+
+  vTaskResume(io);
+  hostSimRun(1000);
+  CHECK(hostApi.lastAck == 2, "server got ack %u", hostApi.lastAck);
+  CHECK(hostSketchLed1() == 10, "LED1 is %d, the queued set-point was 10", hostSketchLed1());
+  CHECK(hostSketchLed2() && hostSketchLed3(), "LED2 and LED3 did not follow the new connection");
+}
+
+// ===== IO -> DISPLAY =====
+static void testDisplayStall(HostWsPeer& phone) {
+  TaskHandle_t display = hostTaskFind("display");
+  uint32_t ioPasses = regionCount(REGION_READ_SENSORS);
+  uint32_t draws = regionCount(REGION_UPDATE_LCD);
+
+  vTaskSuspend(display);
+  for (int i = 0; i < 10; i++) {
+    phone.sendText(i % 2 ? "led2:1" : "led2:0");
+    hostSimRun(500);
+  }
+  // 5 s of 10 ms polls; the io task never waited for the display
+  CHECK(regionCount(REGION_READ_SENSORS) >= ioPasses + 450, "io ran %u passes",
+        regionCount(REGION_READ_SENSORS) - ioPasses);
+  CHECK(uxQueueMessagesWaiting(hostSketchDisplayQueue()) == 1, "display queue not holding one frame");
+  CHECK(regionCount(REGION_UPDATE_LCD) == draws, "frames drawn with the display stalled");
+
+  vTaskResume(display);
+  hostSimRun(500);
+  CHECK(uxQueueMessagesWaiting(hostSketchDisplayQueue()) == 0, "the latest frame was not drawn");
+  CHECK(regionCount(REGION_UPDATE_LCD) == draws + 1, "%u frames drawn after the stall",
+        regionCount(REGION_UPDATE_LCD) - draws);
+  phone.receive();
+  phone.clearMessages();
+}
+
+// ===== DHT SAMPLER -> IO =====
+// The sampler's only millis() call is inside publish(), with the snapshot
+// marked as being written
+static std::atomic<bool> freezeSampler(false);
+static std::atomic<bool> samplerFrozen(false);
+
+static void freezeSamplerInPublish() {
+  if (!freezeSampler || strcmp(pcTaskGetName(NULL), "dht_sampler") != 0) return;
+  freezeSampler = false;
+  samplerFrozen = true;
+  vTaskSuspend(NULL);
+}
+
+static void testSamplerFrozenMidPublish() {
+  float before = hostSketchTemperature();
+  uint32_t ioPasses = regionCount(REGION_READ_SENSORS);
+
+  hostClockHook(freezeSamplerInPublish);
+  freezeSampler = true;
+  hostDht.temperature = before + 3.0f;
+  hostSimRun(3000);
+  CHECK(samplerFrozen, "the sampler never published");
+
+  // Readers give up after a few ticks and keep the last consistent reading
+  CHECK(hostSketchTemperature() == before, "torn reading %.1f picked up", hostSketchTemperature());
+  CHECK(regionCount(REGION_READ_SENSORS) > ioPasses + 100, "io ran %u passes",
+        regionCount(REGION_READ_SENSORS) - ioPasses);
+  uint32_t limitUs = (DHT_SAMPLER_READ_TRIES + 1) * 1000;
+  CHECK(regionMaxUs(REGION_READ_SENSORS) <= limitUs, "readSensors took %u us",
+        regionMaxUs(REGION_READ_SENSORS));
+
+  hostClockHook(nullptr);
+  vTaskResume(hostTaskFind("dht_sampler"));
+  hostSimRun(100);
+  CHECK(hostSketchTemperature() == before + 3.0f, "temperature %.1f after the sampler resumed",
+        hostSketchTemperature());
+}
+
+int main() {
+  hostSerialEcho(false);
+  hostWifiAddNetwork("home", "hunter22", -58);
+  hostWifiSetDriverConfig("home", "hunter22");
+  hostSimBoot(setup, loop);
+  hostSimRun(15000);
+  CHECK(hostSketchWifiConnected() && hostSketchApiConnected(), "the hub is not online");
+
+  HostWsPeer phone;
+  CHECK(phone.connect(hostLocalPort), "no local server");
+  hostSimRun(500);
+  phone.receive();
+  phone.clearMessages();
+
+  testActuatorFlood(phone);
+  testServerAckWaitsForIo();
+  testReconnectWithCommandsQueued();
+  testDisplayStall(phone);
+  testSamplerFrozenMidPublish();
+
+  if (failures == 0) printf("task graph: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
@@ -0,0 +1,153 @@
+/*
+ * Acks of the server-to-device command pipeline
+ *
+ * Drives UplinkCommandPipeline the way the sketch does, with the
+ * actuator queue as a list the test applies from in any order it likes,
+ * and checks that the acknowledged sequence number never covers a
+ * set-point the actuators have not applied:
+ *
+ *   - several targets submitted in one flush, applied one at a time
+ *   - set-points held back by coalescing
+ *   - a reconnect while set-points of the last connection are queued
+ *
+ * Nothing here boots the simulation; the fake clock is passed in.
+ */
+#include <deque>
+#include "host_sim.h"
+#include "uplink_commands.h"
+
+static int failures = 0;
+
+#define CHECK(cond, ...)                                             \
+  do {                                                               \
+    if (!(cond)) {                                                   \
+      fprintf(stderr, "%s:%d: FAIL: %s: ", __FILE__, __LINE__, #cond); \
+      fprintf(stderr, __VA_ARGS__);                                  \
+      fprintf(stderr, "\n");                                         \
+      failures++;                                                    \
+    }                                                                \
+  } while (0)
+
+struct Submitted {
+  uint8_t target;
+  int value;
+  uint32_t ticket;
+};
+
+// The actuator queue
+static std::deque<Submitted> queue;
+
+static void submit(uint8_t target, int value, uint32_t ticket) {
+  queue.push_back({ target, value, ticket });
+}
+
+// Applies the queued set-point for target, wherever it is in the queue
+static bool applyTarget(UplinkCommandPipeline& pipeline, uint8_t target) {
+  for (auto it = queue.begin(); it != queue.end(); ++it) {
+    if (it->target != target) continue;
+    pipeline.applied(it->target, it->ticket);
+    queue.erase(it);
+    return true;
+  }
+  return false;
+}
+
+static void applyAll(UplinkCommandPipeline& pipeline) {
+  while (!queue.empty()) applyTarget(pipeline, queue.front().target);
+}
+
+static void command(UplinkCommandPipeline& pipeline, uint32_t seq, uint8_t target, int value) {
+  CHECK(pipeline.accept(seq), "seq %u not accepted", seq);
+  pipeline.set(target, value, seq);
+}
+
+// Two targets due in one flush go out in target order, not seq order
+static void testFlushOrder() {
+  UplinkCommandPipeline pipeline;
+  queue.clear();
+  uint32_t now = 1000;
+  command(pipeline, 5, 1, 50);
+  command(pipeline, 7, 0, 70);
+  pipeline.flush(now, submit);
+  CHECK(queue.size() == 2 && queue.front().target == 0, "target 0 not submitted first");
+  CHECK(pipeline.ackable() == 4, "ack %u with seq 5 and 7 in flight", pipeline.ackable());
+
+  // Seq 7 is applied first; seq 5 is still queued
+  applyTarget(pipeline, 0);
+  CHECK(pipeline.ackable() == 4, "ack %u with seq 5 not applied", pipeline.ackable());
+  applyTarget(pipeline, 1);
+  CHECK(pipeline.ackable() == 7, "ack %u with everything applied", pipeline.ackable());
+}
+
+// A set-point within the coalescing interval waits for the next flush
+static void testCoalescing() {
+  UplinkCommandPipeline pipeline;
+  queue.clear();
+  uint32_t now = 1000;
+  command(pipeline, 1, 0, 10);
+  pipeline.flush(now, submit);
+  applyAll(pipeline);
+  CHECK(pipeline.ackable() == 1, "ack %u after seq 1", pipeline.ackable());
+
+  command(pipeline, 2, 0, 20);
+  command(pipeline, 3, 1, 1);
+  command(pipeline, 4, 0, 40);
+  pipeline.flush(now + 10, submit);
+  applyAll(pipeline);
+  CHECK(pipeline.coalesced() == 1, "%u coalesced", pipeline.coalesced());
+  CHECK(pipeline.ackable() == 1, "ack %u with seq 2 and 4 held", pipeline.ackable());
+
+  pipeline.flush(now + UPLINK_COALESCE_INTERVAL, submit);
+  CHECK(queue.size() == 1 && queue.front().value == 40, "held set-point not submitted");
+  CHECK(pipeline.ackable() == 1, "ack %u with seq 4 in flight", pipeline.ackable());
+  applyAll(pipeline);
+  CHECK(pipeline.ackable() == 4, "ack %u with everything applied", pipeline.ackable());
+
+  // Retransmits are dropped and counted
+  CHECK(!pipeline.accept(4) && !pipeline.accept(2), "retransmit accepted");
+  CHECK(pipeline.duplicates() == 2, "%u duplicates", pipeline.duplicates());
+}
+
+// Sequence numbers start over while the last connection's set-point is queued
+static void testReconnect() {
+  UplinkCommandPipeline pipeline;
+  queue.clear();
+  uint32_t now = 1000;
+  command(pipeline, 900, 0, 90);
+  pipeline.flush(now, submit);
+
+  pipeline.reset();
+  command(pipeline, 1, 1, 1);
+  pipeline.flush(now + 10, submit);
+  CHECK(pipeline.ackable() == 0, "ack %u with nothing applied", pipeline.ackable());
+
+  // The old set-point is applied after the reset, the new one is not yet
+  applyTarget(pipeline, 0);
+  CHECK(pipeline.ackable() == 0, "ack %u with seq 1 not applied", pipeline.ackable());
+  applyTarget(pipeline, 1);
+  CHECK(pipeline.ackable() == 1, "ack %u after seq 1", pipeline.ackable());
+
+  // Same target on both sides of the reset
+  now += UPLINK_COALESCE_INTERVAL;
+  command(pipeline, 2, 0, 20);
+  pipeline.flush(now, submit);
+  pipeline.reset();
+  command(pipeline, 1, 0, 10);
+  pipeline.flush(now + UPLINK_COALESCE_INTERVAL, submit);
+  CHECK(queue.size() == 2, "%zu set-points queued", queue.size());
+  applyTarget(pipeline, 0);
+  CHECK(pipeline.ackable() == 0, "ack %u with only the old set-point applied",
+        pipeline.ackable());
+  applyTarget(pipeline, 0);
+  CHECK(pipeline.ackable() == 1, "ack %u after seq 1", pipeline.ackable());
+}
+
+int main() {
+  testFlushOrder();
+  testCoalescing();
+  testReconnect();
+
+  if (failures == 0) printf("uplink commands: all checks passed\n");
+  fflush(stdout);
+  hostSimExit(failures != 0);
+}
@@ -0,0 +1,44 @@
+/*
+ * HubCore - shared firmware core for the Smart Home Hub sketches
+ *
+ * The sketches differ only in pins, actuators, display pages and how
+ * they reach the API server. Everything else lives here, and each sketch
+ * selects what it needs through a HubDefaults-derived config struct (see
+ * hub_config.h) instead of carrying its own copy. HubApp (hub_app.h) runs
+ * the whole firmware from that struct.
+ */
+#ifndef HUB_CORE_H
+#define HUB_CORE_H
+
+#include "hub_config.h"
+#include "telemetry_frame.h"
+#include "binary_telemetry.h"
+#include "telemetry_store.h"
+#include "telemetry_batch.h"
+#include "report_filter.h"
+#include "dht_sampler.h"
+#include "motion_sensor.h"
+#include "lcd_buffer.h"
+#include "pwm_fader.h"
+#include "wifi_scan.h"
+#include "credential_store.h"
+#include "client_fanout.h"
+#include "uplink_commands.h"
+#include "actuator_map.h"
+#include "hub_uplink.h"
+#include "reconnect_policy.h"
+#include "secure_ws_client.h"
+#include "trust_anchors.h"
+#include "boot_timeline.h"
+#include "command_protocol.h"
+#include "loop_stats.h"
+#include "mem_stats.h"
+#include "glyph_cache.h"
+#include "async_lcd.h"
+#include "hub_display.h"
+#include "hub_wifi.h"
+#include "hub_portal.h"
+#include "hub_api_link.h"
+#include "hub_app.h"
+
+#endif // HUB_CORE_H
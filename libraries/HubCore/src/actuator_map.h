@@ -0,0 +1,65 @@
+/*
+ * Table-driven device_control handling
+ *
+ * Each sketch lists its actuators once in its HubConfig (see
+ * hub_config.h), with the output each one drives, and the same code reads
+ * {"<name>":value,...} objects for all of them:
+ *
+ *   applyDeviceControl(Config::actuatorTable(), Config::actuatorCount,
+ *                      doc["device_control"], setActuator);
+ */
+#ifndef ACTUATOR_MAP_H
+#define ACTUATOR_MAP_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "glyph_cache.h"
+#include "pwm_fader.h"
+
+// Telemetry frames carry up to three actuators: a level and two switches
+#define HUB_MAX_ACTUATORS 3
+
+enum ActuatorKind : uint8_t {
+  ACTUATOR_LEVEL,   // Integer 0-255, clamped
+  ACTUATOR_SWITCH   // Boolean, passed on as 0/1
+};
+
+// An actuator in a HubConfig: its device_control field, the output it
+// drives and how the LCD shows it. Trailing members may be left out.
+struct HubActuator {
+  const char* name;       // Field name in device_control objects
+  ActuatorKind kind;
+  uint8_t pin;
+  uint8_t pwmChannel;     // LEDC channel driving pin, levels only
+  uint32_t pwmFrequency;  // Hz, levels only
+  uint16_t fadeTime;      // Hardware fade to a new level (ms), 0 steps straight to it
+  FadeCurve fadeCurve;
+  char symbol;            // Marks the actuator on the sensor screen while on
+  const char* label;      // Device screen label, up to 2 characters
+  Glyph glyph;            // Device screen icon
+};
+
+/**
+ * Calls apply(index, value) for every actuator present in control, where
+ * index is the position in the table. Fields of the wrong type and fields
+ * not in the table are ignored. Returns how many were applied.
+ */
+template <typename Apply>
+size_t applyDeviceControl(const HubActuator* actuators, size_t count, JsonVariantConst control,
+                          Apply apply) {
+  size_t applied = 0;
+  for (size_t i = 0; i < count; i++) {
+    JsonVariantConst field = control[actuators[i].name];
+    if (actuators[i].kind == ACTUATOR_LEVEL) {
+      if (!field.is<int>()) continue;
+      apply((uint8_t)i, constrain(field.as<int>(), 0, 255));
+    } else {
+      if (!field.is<bool>()) continue;
+      apply((uint8_t)i, field.as<bool>() ? 1 : 0);
+    }
+    applied++;
+  }
+  return applied;
+}
+
+#endif // ACTUATOR_MAP_H
@@ -0,0 +1,56 @@
+/*
+ * Queued driver for an HD44780 behind a PCF8574 I2C backpack
+ *
+ * Callers only enqueue bytes; a background task streams them to the
+ * expander, packing up to ASYNC_LCD_BATCH LCD bytes into one I2C
+ * transaction. Each LCD byte is sent as two nibbles, each strobed with
+ * one expander write with EN high and one with EN low, instead of the
+ * three writes plus microsecond delays LiquidCrystal_I2C uses.
+ *
+ * The panel must already be initialised in 4-bit mode (LiquidCrystal_I2C
+ * init() does that); after begin() nothing else may write to the LCD.
+ *
+ * Callers never wait for the bus: when a burst outruns the queue the
+ * rest of it is dropped and takeOverflow() reports it, so the caller can
+ * redraw everything once the queue has drained.
+ */
+#ifndef ASYNC_LCD_H
+#define ASYNC_LCD_H
+
+#include <Arduino.h>
+
+#define ASYNC_LCD_QUEUE_LENGTH 128   // LCD bytes; a full redraw with glyph uploads is ~80
+#define ASYNC_LCD_BATCH 30           // LCD bytes per I2C transaction (4 expander bytes each)
+#define ASYNC_LCD_TASK_STACK 2048
+#define ASYNC_LCD_TASK_PRIORITY 1
+#define ASYNC_LCD_TASK_CORE 0
+
+class AsyncLcd {
+ public:
+  explicit AsyncLcd(uint8_t address);
+
+  // Sets the bus clock and starts the writer task
+  void begin(uint32_t clockHz);
+
+  void setCursor(uint8_t col, uint8_t row);
+  size_t write(uint8_t c);
+  void createChar(uint8_t slot, const uint8_t bitmap[8]);
+
+  // True once after bytes were dropped; the panel no longer matches
+  // what the caller drew
+  bool takeOverflow();
+
+ private:
+  void command(uint8_t value);
+  void enqueue(uint16_t entry);
+  static void taskEntry(void* arg);
+  void run();
+  void sendByte(uint8_t value, uint8_t mode);
+
+  uint8_t address_;
+  QueueHandle_t queue_;
+  TaskHandle_t task_;
+  bool overflow_;
+};
+
+#endif // ASYNC_LCD_H
@@ -0,0 +1,169 @@
+/*
+ * Compact binary telemetry implementation
+ */
+#include "binary_telemetry.h"
+
+#define BINARY_HEADER_SIZE 4
+#define BINARY_KEY_BODY_SIZE 6
+
+static void putU16(uint8_t* p, uint16_t v) {
+  p[0] = v & 0xFF;
+  p[1] = v >> 8;
+}
+
+static uint16_t getU16(const uint8_t* p) {
+  return p[0] | (p[1] << 8);
+}
+
+QuantizedSample quantizeSample(const TelemetrySample& sample) {
+  QuantizedSample q;
+  q.temperature = isnan(sample.temperature)
+                    ? BINARY_TEMP_INVALID
+                    : (int16_t)constrain(lroundf(sample.temperature * 10.0f), -32767, 32767);
+  q.humidity = isnan(sample.humidity)
+                 ? BINARY_HUM_INVALID
+                 : (uint16_t)constrain(lroundf(sample.humidity * 10.0f), 0, 65534);
+  q.state = (sample.motion ? BINARY_STATE_MOTION : 0) |
+            (sample.led2 ? BINARY_STATE_LED2 : 0) |
+            (sample.led3 ? BINARY_STATE_LED3 : 0);
+  q.led1 = constrain(sample.led1, 0, 255);
+  return q;
+}
+
+TelemetrySample expandSample(const QuantizedSample& q) {
+  TelemetrySample sample;
+  sample.temperature = q.temperature == BINARY_TEMP_INVALID ? NAN : q.temperature / 10.0f;
+  sample.humidity = q.humidity == BINARY_HUM_INVALID ? NAN : q.humidity / 10.0f;
+  sample.motion = q.state & BINARY_STATE_MOTION;
+  sample.led2 = q.state & BINARY_STATE_LED2;
+  sample.led3 = q.state & BINARY_STATE_LED3;
+  sample.led1 = q.led1;
+  return sample;
+}
+
+// A field can be delta-coded if both ends are valid and the step fits int8
+static bool fitsDelta(int32_t from, int32_t to, int32_t invalid) {
+  if (from == invalid || to == invalid) return false;
+  int32_t d = to - from;
+  return d >= -128 && d <= 127;
+}
+
+BinaryTelemetryEncoder::BinaryTelemetryEncoder() {
+  reset();
+  sequence_ = 0;
+}
+
+void BinaryTelemetryEncoder::reset() {
+  havePrevious_ = false;
+  sinceKeyFrame_ = 0;
+}
+
+size_t BinaryTelemetryEncoder::encode(const TelemetrySample& sample, uint8_t* out, size_t capacity) {
+  if (capacity < BINARY_FRAME_MAX_SIZE) return 0;
+
+  QuantizedSample q = quantizeSample(sample);
+  bool key = !havePrevious_ || sinceKeyFrame_ >= BINARY_KEYFRAME_INTERVAL;
+  if (!key && q.temperature != previous_.temperature &&
+      !fitsDelta(previous_.temperature, q.temperature, BINARY_TEMP_INVALID)) {
+    key = true;
+  }
+  if (!key && q.humidity != previous_.humidity &&
+      !fitsDelta(previous_.humidity, q.humidity, BINARY_HUM_INVALID)) {
+    key = true;
+  }
+
+  out[0] = BINARY_TELEMETRY_VERSION;
+  putU16(out + 2, sequence_++);
+  size_t len = BINARY_HEADER_SIZE;
+
+  if (key) {
+    out[1] = BINARY_FRAME_KEY;
+    putU16(out + len, (uint16_t)q.temperature);
+    putU16(out + len + 2, q.humidity);
+    out[len + 4] = q.state;
+    out[len + 5] = q.led1;
+    len += BINARY_KEY_BODY_SIZE;
+    sinceKeyFrame_ = 0;
+  } else {
+    out[1] = BINARY_FRAME_DELTA;
+    uint8_t* mask = out + len++;
+    *mask = 0;
+    if (q.temperature != previous_.temperature) {
+      *mask |= BINARY_CHANGED_TEMP;
+      out[len++] = (uint8_t)(int8_t)(q.temperature - previous_.temperature);
+    }
+    if (q.humidity != previous_.humidity) {
+      *mask |= BINARY_CHANGED_HUM;
+      out[len++] = (uint8_t)(int8_t)(q.humidity - previous_.humidity);
+    }
+    if (q.state != previous_.state) {
+      *mask |= BINARY_CHANGED_STATE;
+      out[len++] = q.state;
+    }
+    if (q.led1 != previous_.led1) {
+      *mask |= BINARY_CHANGED_LED1;
+      out[len++] = q.led1;
+    }
+    sinceKeyFrame_++;
+  }
+
+  previous_ = q;
+  havePrevious_ = true;
+  return len;
+}
+
+BinaryTelemetryDecoder::BinaryTelemetryDecoder() {
+  reset();
+}
+
+void BinaryTelemetryDecoder::reset() {
+  havePrevious_ = false;
+  sequence_ = 0;
+}
+
+bool BinaryTelemetryDecoder::decode(const uint8_t* frame, size_t length, TelemetrySample& out) {
+  if (length < BINARY_HEADER_SIZE || frame[0] != BINARY_TELEMETRY_VERSION) return false;
+
+  uint16_t seq = getU16(frame + 2);
+  const uint8_t* p = frame + BINARY_HEADER_SIZE;
+  const uint8_t* end = frame + length;
+
+  if (frame[1] == BINARY_FRAME_KEY) {
+    if (end - p != BINARY_KEY_BODY_SIZE) return false;
+    previous_.temperature = (int16_t)getU16(p);
+    previous_.humidity = getU16(p + 2);
+    previous_.state = p[4];
+    previous_.led1 = p[5];
+  } else if (frame[1] == BINARY_FRAME_DELTA) {
+    // Deltas only make sense on top of the frame right before them
+    if (!havePrevious_ || seq != (uint16_t)(sequence_ + 1) || p >= end) return false;
+
+    uint8_t mask = *p++;
+    QuantizedSample next = previous_;
+    if (mask & BINARY_CHANGED_TEMP) {
+      if (p >= end) return false;
+      next.temperature += (int8_t)*p++;
+    }
+    if (mask & BINARY_CHANGED_HUM) {
+      if (p >= end) return false;
+      next.humidity += (int8_t)*p++;
+    }
+    if (mask & BINARY_CHANGED_STATE) {
+      if (p >= end) return false;
+      next.state = *p++;
+    }
+    if (mask & BINARY_CHANGED_LED1) {
+      if (p >= end) return false;
+      next.led1 = *p++;
+    }
+    if (p != end) return false;
+    previous_ = next;
+  } else {
+    return false;
+  }
+
+  havePrevious_ = true;
+  sequence_ = seq;
+  out = expandSample(previous_);
+  return true;
+}
@@ -0,0 +1,95 @@
+/*
+ * Compact binary telemetry frames for the API uplink
+ *
+ * Frame layout (little endian):
+ *   [0]    protocol version (BINARY_TELEMETRY_VERSION)
+ *   [1]    frame type (BINARY_FRAME_KEY or BINARY_FRAME_DELTA)
+ *   [2..3] sequence number
+ *
+ * Key frame body (6 bytes):
+ *   int16  temperature in 0.1 °C, BINARY_TEMP_INVALID if unknown
+ *   uint16 humidity in 0.1 %, BINARY_HUM_INVALID if unknown
+ *   uint8  state bits (BINARY_STATE_*)
+ *   uint8  LED1 intensity
+ *
+ * Delta frame body: one change-mask byte (BINARY_CHANGED_*) followed by
+ * only the changed fields, in this order:
+ *   int8   temperature delta in 0.1 °C
+ *   int8   humidity delta in 0.1 %
+ *   uint8  state bits
+ *   uint8  LED1 intensity
+ *
+ * Deltas are relative to the previous frame. The device id is not part of
+ * the frame; it is sent once in the hello handshake after connecting.
+ */
+#ifndef BINARY_TELEMETRY_H
+#define BINARY_TELEMETRY_H
+
+#include <Arduino.h>
+#include "telemetry_frame.h"
+
+#define BINARY_TELEMETRY_VERSION 1
+#define BINARY_FRAME_MAX_SIZE 10
+#define BINARY_KEYFRAME_INTERVAL 30  // Deltas between two key frames
+
+#define BINARY_FRAME_KEY 0x01
+#define BINARY_FRAME_DELTA 0x02
+
+#define BINARY_TEMP_INVALID ((int16_t)0x8000)
+#define BINARY_HUM_INVALID ((uint16_t)0xFFFF)
+
+#define BINARY_STATE_MOTION 0x01
+#define BINARY_STATE_LED2 0x02
+#define BINARY_STATE_LED3 0x04
+
+#define BINARY_CHANGED_TEMP 0x01
+#define BINARY_CHANGED_HUM 0x02
+#define BINARY_CHANGED_STATE 0x04
+#define BINARY_CHANGED_LED1 0x08
+
+// A sample reduced to the fixed-width values carried on the wire
+struct QuantizedSample {
+  int16_t temperature;
+  uint16_t humidity;
+  uint8_t state;
+  uint8_t led1;
+};
+
+class BinaryTelemetryEncoder {
+ public:
+  BinaryTelemetryEncoder();
+
+  // Forces a key frame next; call whenever the link is (re)established
+  void reset();
+
+  // Writes one frame; returns its length, or 0 if capacity is too small
+  size_t encode(const TelemetrySample& sample, uint8_t* out, size_t capacity);
+
+ private:
+  QuantizedSample previous_;
+  bool havePrevious_;
+  uint16_t sequence_;
+  uint8_t sinceKeyFrame_;
+};
+
+class BinaryTelemetryDecoder {
+ public:
+  BinaryTelemetryDecoder();
+
+  // Forget the previous frame; a key frame is required next
+  void reset();
+
+  // Decodes one frame; returns false for malformed, unsupported or
+  // out-of-sequence frames
+  bool decode(const uint8_t* frame, size_t length, TelemetrySample& out);
+
+ private:
+  QuantizedSample previous_;
+  bool havePrevious_;
+  uint16_t sequence_;
+};
+
+QuantizedSample quantizeSample(const TelemetrySample& sample);
+TelemetrySample expandSample(const QuantizedSample& q);
+
+#endif // BINARY_TELEMETRY_H
@@ -0,0 +1,47 @@
+/*
+ * Boot timeline implementation
+ */
+#include "boot_timeline.h"
+
+static const char* const markNames[BOOT_MARK_COUNT] = {
+  "wifiStart",
+  "wifiIp",
+  "apiConnected",
+  "firstTelemetry"
+};
+
+// 0 until reached; all marks are set by the network task
+static uint32_t marks[BOOT_MARK_COUNT];
+static bool fastConnect = false;
+
+void bootMark(BootMark mark) {
+  if (marks[mark]) return;
+  marks[mark] = max(millis(), 1UL);
+
+  if (mark == BOOT_FIRST_TELEMETRY) {
+    Serial.printf("[boot] wifi start=%lums ip=%lums api=%lums first telemetry=%lums (%s connect)\n",
+                  (unsigned long)marks[BOOT_WIFI_START],
+                  (unsigned long)marks[BOOT_WIFI_IP],
+                  (unsigned long)marks[BOOT_API_CONNECTED],
+                  (unsigned long)marks[BOOT_FIRST_TELEMETRY],
+                  fastConnect ? "fast" : "full");
+  }
+}
+
+void bootSetFastConnect(bool fast) {
+  if (!marks[BOOT_WIFI_IP]) fastConnect = fast;
+}
+
+void writeBootTimeline(FrameWriter& w) {
+  w.key("boot").raw("{");
+  for (int i = 0; i < BOOT_MARK_COUNT; i++) {
+    w.key(markNames[i]);
+    if (marks[i]) {
+      w.integer(marks[i]);
+    } else {
+      w.raw("null");
+    }
+  }
+  w.key("fast").boolean(fastConnect);
+  w.raw("}");
+}
@@ -0,0 +1,31 @@
+/*
+ * Boot timeline for the Smart Home Hub firmware
+ *
+ * Records when each startup milestone is first reached, in milliseconds
+ * since boot, and prints the timeline once the first telemetry frame
+ * has gone out.
+ */
+#ifndef BOOT_TIMELINE_H
+#define BOOT_TIMELINE_H
+
+#include <Arduino.h>
+#include "telemetry_frame.h"
+
+enum BootMark {
+  BOOT_WIFI_START,      // First WiFi.begin()
+  BOOT_WIFI_IP,         // Station has an IP address
+  BOOT_API_CONNECTED,   // API server reached
+  BOOT_FIRST_TELEMETRY, // First telemetry frame sent
+  BOOT_MARK_COUNT
+};
+
+// Records a milestone; only the first call for each one counts
+void bootMark(BootMark mark);
+
+// Whether the first connection used the cached AP and lease
+void bootSetFastConnect(bool fast);
+
+// Appends "boot":{"wifiStart":ms,...,"fast":..}; unreached marks are null
+void writeBootTimeline(FrameWriter& w);
+
+#endif // BOOT_TIMELINE_H
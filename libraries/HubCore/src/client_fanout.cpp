@@ -0,0 +1,228 @@
+/*
+ * Fan-out layer for the local WebSocket server implementation
+ */
+#include "client_fanout.h"
+#include <lwip/sockets.h>
+
+#define CLIENT_BIT(num) (1UL << (num))
+
+FanoutServer::FanoutServer(uint16_t port)
+  : WebSocketsServer(port), eventHead_(0), eventCount_(0),
+    connected_(0), lastPing_(0), lastReport_(0) {
+  memset(states_, 0, sizeof(states_));
+  memset(stats_, 0, sizeof(stats_));
+}
+
+void FanoutServer::setRenderer(FanoutState state, uint8_t *frame, size_t capacity,
+                               FanoutRenderer render) {
+  states_[state].frame = frame;
+  states_[state].capacity = capacity;
+  states_[state].render = render;
+}
+
+void FanoutServer::markState(FanoutState state, int num) {
+  uint32_t targets = num < 0 ? connected_ : connected_ & CLIENT_BIT(num);
+  uint32_t merged = states_[state].pending & targets;
+  for (uint8_t i = 0; merged; i++, merged >>= 1) {
+    if (merged & 1) stats_[i].coalesced++;
+  }
+  states_[state].pending |= targets;
+}
+
+bool FanoutServer::sendEvent(const char *payload, size_t length, int num) {
+  if (length > FANOUT_EVENT_SIZE) return false;
+  uint32_t targets = num < 0 ? connected_ : connected_ & CLIENT_BIT(num);
+  if (!targets) return true;
+
+  // Per-client bound: a client that is too far behind loses its oldest
+  for (uint8_t i = 0; i < WEBSOCKETS_SERVER_CLIENT_MAX; i++) {
+    if ((targets & CLIENT_BIT(i)) && queuedFrames(i) >= FANOUT_CLIENT_EVENTS) {
+      dropOldestEvent(i);
+    }
+  }
+  reclaimEvents();
+
+  // Ring full: the oldest frame goes for everyone still waiting on it
+  if (eventCount_ == FANOUT_EVENT_SLOTS) {
+    uint32_t lost = events_[eventHead_].pending;
+    for (uint8_t i = 0; lost; i++, lost >>= 1) {
+      if (lost & 1) stats_[i].droppedEvents++;
+    }
+    eventHead_ = (eventHead_ + 1) % FANOUT_EVENT_SLOTS;
+    eventCount_--;
+  }
+
+  EventSlot &slot = events_[(eventHead_ + eventCount_) % FANOUT_EVENT_SLOTS];
+  memcpy(slot.frame + WEBSOCKETS_MAX_HEADER_SIZE, payload, length);
+  slot.length = length;
+  slot.pending = targets;
+  eventCount_++;
+  return true;
+}
+
+void FanoutServer::service() {
+  uint32_t now = millis();
+
+  for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+    uint32_t bit = CLIENT_BIT(num);
+    if (!(connected_ & bit)) continue;
+    if (!writable(num)) {
+      bool waiting = queuedFrames(num) > 0;
+      for (size_t s = 0; s < FANOUT_STATE_COUNT; s++) {
+        if (states_[s].pending & bit) waiting = true;
+      }
+      if (waiting) stats_[num].blockedPasses++;
+      continue;
+    }
+
+    // Events first so replies and edges keep their order
+    size_t sent = 0;
+    for (size_t i = 0; i < eventCount_ && sent < FANOUT_SENDS_PER_PASS; i++) {
+      EventSlot &slot = events_[(eventHead_ + i) % FANOUT_EVENT_SLOTS];
+      if (!(slot.pending & bit)) continue;
+      if (sent && !writable(num)) break;
+      sendFrame(num, slot.frame, slot.length);
+      slot.pending &= ~bit;
+      sent++;
+    }
+
+    if (now - lastPing_ >= FANOUT_PING_INTERVAL) {
+      sendPing(num, (uint8_t *)&now, sizeof(now));
+    }
+  }
+  reclaimEvents();
+
+  // State frames are rendered once and go to every pending client that
+  // can take them; the others keep their flag for the next call
+  for (size_t s = 0; s < FANOUT_STATE_COUNT; s++) {
+    StateSource &source = states_[s];
+    source.pending &= connected_;
+    if (!source.pending || !source.render) continue;
+
+    uint32_t ready = 0;
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+      if ((source.pending & CLIENT_BIT(num)) && writable(num)) ready |= CLIENT_BIT(num);
+    }
+    if (!ready) continue;
+
+    size_t length = source.render((char *)source.frame + WEBSOCKETS_MAX_HEADER_SIZE,
+                                  source.capacity);
+    for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+      if (!(ready & CLIENT_BIT(num))) continue;
+      if (length) sendFrame(num, source.frame, length);
+      source.pending &= ~CLIENT_BIT(num);
+    }
+  }
+
+  if (now - lastPing_ >= FANOUT_PING_INTERVAL) lastPing_ = now;
+  if (FANOUT_REPORT_INTERVAL && now - lastReport_ >= FANOUT_REPORT_INTERVAL) {
+    lastReport_ = now;
+    report();
+  }
+}
+
+size_t FanoutServer::queuedBytes(uint8_t num) const {
+  size_t bytes = 0;
+  for (size_t i = 0; i < eventCount_; i++) {
+    const EventSlot &slot = events_[(eventHead_ + i) % FANOUT_EVENT_SLOTS];
+    if (slot.pending & CLIENT_BIT(num)) bytes += slot.length;
+  }
+  return bytes;
+}
+
+size_t FanoutServer::queuedFrames(uint8_t num) const {
+  size_t frames = 0;
+  for (size_t i = 0; i < eventCount_; i++) {
+    if (events_[(eventHead_ + i) % FANOUT_EVENT_SLOTS].pending & CLIENT_BIT(num)) frames++;
+  }
+  return frames;
+}
+
+void FanoutServer::report() {
+  if (!connected_) return;
+  for (uint8_t num = 0; num < WEBSOCKETS_SERVER_CLIENT_MAX; num++) {
+    if (!(connected_ & CLIENT_BIT(num))) continue;
+    const FanoutClientStats &s = stats_[num];
+    Serial.printf("[ws] client %u: sent=%u (%uB) queued=%u (%uB) dropped=%u coalesced=%u "
+                  "blocked=%u rtt=%ums\n",
+                  num, s.sentFrames, s.sentBytes, (unsigned)queuedFrames(num),
+                  (unsigned)queuedBytes(num), s.droppedEvents, s.coalesced,
+                  s.blockedPasses, s.rttMs);
+  }
+}
+
+void FanoutServer::runCbEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length) {
+  uint32_t bit = CLIENT_BIT(num);
+  switch (type) {
+    case WStype_CONNECTED:
+      memset(&stats_[num], 0, sizeof(stats_[num]));
+      connected_ |= bit;
+      break;
+
+    case WStype_DISCONNECTED:
+      connected_ &= ~bit;
+      for (size_t i = 0; i < eventCount_; i++) {
+        events_[(eventHead_ + i) % FANOUT_EVENT_SLOTS].pending &= ~bit;
+      }
+      for (size_t s = 0; s < FANOUT_STATE_COUNT; s++) states_[s].pending &= ~bit;
+      reclaimEvents();
+      break;
+
+    case WStype_PONG:
+      if (length == sizeof(uint32_t)) {
+        uint32_t sentAt;
+        memcpy(&sentAt, payload, sizeof(sentAt));
+        stats_[num].rttMs = millis() - sentAt;
+      }
+      break;
+
+    default:
+      break;
+  }
+  WebSocketsServer::runCbEvent(num, type, payload, length);
+}
+
+/**
+ * True if the client's socket has room in its send buffer, so a write
+ * will not block the network task
+ */
+bool FanoutServer::writable(uint8_t num) {
+  WEBSOCKETS_NETWORK_CLASS *tcp = _clients[num].tcp;
+  if (tcp == nullptr) return false;
+  int fd = tcp->fd();
+  if (fd < 0) return false;
+
+  fd_set set;
+  FD_ZERO(&set);
+  FD_SET(fd, &set);
+  timeval timeout = { 0, 0 };
+  return select(fd + 1, nullptr, &set, nullptr, &timeout) > 0;
+}
+
+void FanoutServer::dropOldestEvent(uint8_t num) {
+  for (size_t i = 0; i < eventCount_; i++) {
+    EventSlot &slot = events_[(eventHead_ + i) % FANOUT_EVENT_SLOTS];
+    if (slot.pending & CLIENT_BIT(num)) {
+      slot.pending &= ~CLIENT_BIT(num);
+      stats_[num].droppedEvents++;
+      return;
+    }
+  }
+}
+
+// Frees slots at the head of the ring that every client has been sent
+void FanoutServer::reclaimEvents() {
+  while (eventCount_ && (events_[eventHead_].pending & connected_) == 0) {
+    eventHead_ = (eventHead_ + 1) % FANOUT_EVENT_SLOTS;
+    eventCount_--;
+  }
+}
+
+void FanoutServer::sendFrame(uint8_t num, uint8_t *frame, size_t length) {
+  // The header goes in front of the payload in place; the server does not
+  // mask, so the same frame can be sent to every client
+  if (sendTXT(num, frame, length, true)) {
+    stats_[num].sentFrames++;
+    stats_[num].sentBytes += length;
+  }
+}
@@ -0,0 +1,129 @@
+/*
+ * Fan-out layer for the local WebSocket server
+ *
+ * Nothing is written to a client socket from the code that produces a
+ * frame. Frames are queued and sent by service() on the network task,
+ * only to clients whose socket can take data, so one slow client no
+ * longer stalls the others.
+ *
+ * Two kinds of traffic:
+ *   - State frames (device status, network list) are never queued. A
+ *     client just gets a pending flag, and the frame is rendered once
+ *     from the current state when it is sent. Repeated updates for a
+ *     client that has not caught up coalesce into one frame.
+ *   - Event frames (motion edges, replies) are copied once into a shared
+ *     ring with a mask of the clients that still need them. A client
+ *     that falls more than FANOUT_CLIENT_EVENTS behind loses its oldest
+ *     events.
+ *
+ * Every client is pinged regularly to measure its round trip time.
+ */
+#ifndef CLIENT_FANOUT_H
+#define CLIENT_FANOUT_H
+
+#include <Arduino.h>
+#include <WebSocketsServer.h>
+#include "telemetry_frame.h"
+
+#define FANOUT_EVENT_SLOTS 16         // Event frames shared by all clients
+#define FANOUT_EVENT_SIZE TELEMETRY_FRAME_SIZE
+#define FANOUT_CLIENT_EVENTS 6        // Events a client may fall behind before drops
+#define FANOUT_SENDS_PER_PASS 2       // Event frames per client per service() call
+#define FANOUT_PING_INTERVAL 10000    // Round trip measurement period (ms)
+#define FANOUT_REPORT_INTERVAL 30000  // Time between Serial reports (ms), 0 for none
+
+static_assert(WEBSOCKETS_SERVER_CLIENT_MAX <= 32, "client masks are 32 bits wide");
+
+// Frames rendered from current state when sent
+enum FanoutState {
+  FANOUT_STATE_STATUS,
+  FANOUT_STATE_WIFI_LIST,
+  FANOUT_STATE_PROFILE,
+  FANOUT_STATE_COUNT
+};
+
+// Writes a state frame into payload, returns its length or 0
+typedef size_t (*FanoutRenderer)(char *payload, size_t capacity);
+
+struct FanoutClientStats {
+  uint32_t sentFrames;
+  uint32_t sentBytes;
+  uint32_t droppedEvents;    // Lost to drop-oldest
+  uint32_t coalesced;        // State updates merged into one frame
+  uint32_t blockedPasses;    // service() calls that found the socket full
+  uint32_t rttMs;            // Last ping round trip, 0 until measured
+};
+
+class FanoutServer : public WebSocketsServer {
+ public:
+  explicit FanoutServer(uint16_t port);
+
+  // frame must have WEBSOCKETS_MAX_HEADER_SIZE bytes in front of the
+  // capacity the renderer may fill; it is only used inside service()
+  void setRenderer(FanoutState state, uint8_t *frame, size_t capacity, FanoutRenderer render);
+
+  // Flags a state frame for one client, or for all when num is negative
+  void markState(FanoutState state, int num = -1);
+
+  // Copies an event frame for one client, or for all when num is negative.
+  // Returns false if it is too large for an event slot.
+  bool sendEvent(const char *payload, size_t length, int num = -1);
+
+  // Sends what the clients can take right now; call after loop()
+  void service();
+
+  // Event bytes and frames still queued for a client
+  size_t queuedBytes(uint8_t num) const;
+  size_t queuedFrames(uint8_t num) const;
+  const FanoutClientStats &stats(uint8_t num) const { return stats_[num]; }
+
+  void report();
+
+ protected:
+  void runCbEvent(uint8_t num, WStype_t type, uint8_t *payload, size_t length) override;
+
+ private:
+  struct EventSlot {
+    uint8_t frame[WEBSOCKETS_MAX_HEADER_SIZE + FANOUT_EVENT_SIZE];
+    size_t length;
+    uint32_t pending;  // Clients that have not been sent this frame
+  };
+  struct StateSource {
+    uint8_t *frame;
+    size_t capacity;
+    FanoutRenderer render;
+    uint32_t pending;
+  };
+
+  bool writable(uint8_t num);
+  void dropOldestEvent(uint8_t num);
+  void reclaimEvents();
+  void sendFrame(uint8_t num, uint8_t *frame, size_t length);
+
+  EventSlot events_[FANOUT_EVENT_SLOTS];
+  size_t eventHead_;   // Oldest slot
+  size_t eventCount_;
+  StateSource states_[FANOUT_STATE_COUNT];
+  uint32_t connected_;
+  FanoutClientStats stats_[WEBSOCKETS_SERVER_CLIENT_MAX];
+  uint32_t lastPing_;
+  uint32_t lastReport_;
+};
+
+// Stands in for FanoutServer in a sketch without local clients
+class NullFanoutServer {
+ public:
+  explicit NullFanoutServer(uint16_t port) {}
+
+  void begin() {}
+  template <typename Callback>
+  void onEvent(Callback cbEvent) {}
+  void setRenderer(FanoutState state, uint8_t *frame, size_t capacity, FanoutRenderer render) {}
+  void markState(FanoutState state, int num = -1) {}
+  bool sendEvent(const char *payload, size_t length, int num = -1) { return false; }
+  void loop() {}
+  void service() {}
+  IPAddress remoteIP(uint8_t num) { return IPAddress(); }
+};
+
+#endif // CLIENT_FANOUT_H
@@ -0,0 +1,288 @@
+/*
+ * Command protocol for local WebSocket clients implementation
+ */
+#include "command_protocol.h"
+#include "telemetry_frame.h"
+
+static const char *const statusNames[] = { "ok", "bad_request", "unknown", "rejected" };
+
+static bool fieldEquals(const char *data, size_t length, const char *text) {
+  return strlen(text) == length && memcmp(data, text, length) == 0;
+}
+
+static CommandOp lookupOp(const char *name, size_t length) {
+  for (uint8_t op = CMD_NONE + 1; op < CMD_COUNT; op++) {
+    if (fieldEquals(name, length, commandSpecs[op].name)) return (CommandOp)op;
+  }
+  return CMD_NONE;
+}
+
+// Parses a decimal integer spanning exactly [p, end)
+static bool parseInteger(const char *p, const char *end, int32_t &out) {
+  bool negative = p < end && *p == '-';
+  if (negative) p++;
+  if (p == end) return false;
+
+  int64_t value = 0;
+  for (; p < end; p++) {
+    if (*p < '0' || *p > '9') return false;
+    value = value * 10 + (*p - '0');
+    if (value > INT32_MAX) return false;
+  }
+  out = negative ? -value : value;
+  return true;
+}
+
+static CommandStatus checkFields(const Command &command) {
+  uint8_t needs = commandSpecs[command.op].needs;
+  if ((needs & CMD_NEEDS_VALUE) && !command.hasValue) return CMD_BAD_REQUEST;
+  if ((needs & CMD_NEEDS_SSID) && command.ssid.length == 0) return CMD_BAD_REQUEST;
+  return CMD_OK;
+}
+
+// ===== LEGACY TEXT =====
+
+static CommandStatus parseText(const char *p, const char *end, Command &out) {
+  const char *colon = (const char *)memchr(p, ':', end - p);
+  out.op = lookupOp(p, (colon ? colon : end) - p);
+  if (out.op == CMD_NONE) return CMD_UNKNOWN;
+  if (!colon) return checkFields(out);
+
+  const char *arg = colon + 1;
+  if (out.op == CMD_CONNECT) {
+    const char *sep = (const char *)memchr(arg, '|', end - arg);
+    if (!sep) return CMD_BAD_REQUEST;
+    out.ssid = { arg, (size_t)(sep - arg) };
+    out.password = { sep + 1, (size_t)(end - sep - 1) };
+  } else {
+    if (!parseInteger(arg, end, out.value)) return CMD_BAD_REQUEST;
+    out.hasValue = true;
+  }
+  return checkFields(out);
+}
+
+// ===== JSON =====
+
+static const char *skipSpace(const char *p, const char *end) {
+  while (p < end && (*p == ' ' || *p == '\t' || *p == '\r' || *p == '\n')) p++;
+  return p;
+}
+
+static int hexDigit(char c) {
+  if (c >= '0' && c <= '9') return c - '0';
+  if (c >= 'a' && c <= 'f') return c - 'a' + 10;
+  if (c >= 'A' && c <= 'F') return c - 'A' + 10;
+  return -1;
+}
+
+static bool readHex4(const char *p, const char *end, uint32_t &out) {
+  if (end - p < 4) return false;
+  out = 0;
+  for (int i = 0; i < 4; i++) {
+    int d = hexDigit(p[i]);
+    if (d < 0) return false;
+    out = (out << 4) | d;
+  }
+  return true;
+}
+
+/**
+ * Decodes the string starting at the opening quote *p over itself.
+ * On success field covers the decoded bytes and p is past the closing
+ * quote.
+ */
+static bool parseString(char *&p, char *end, CommandField &field) {
+  char *out = ++p;
+  field.data = out;
+  while (p < end) {
+    char c = *p++;
+    if (c == '"') {
+      field.length = out - field.data;
+      return true;
+    }
+    if ((unsigned char)c < 0x20) return false;
+    if (c != '\\') {
+      *out++ = c;
+      continue;
+    }
+
+    if (p == end) return false;
+    switch (*p++) {
+      case '"':  *out++ = '"'; break;
+      case '\\': *out++ = '\\'; break;
+      case '/':  *out++ = '/'; break;
+      case 'b':  *out++ = '\b'; break;
+      case 'f':  *out++ = '\f'; break;
+      case 'n':  *out++ = '\n'; break;
+      case 'r':  *out++ = '\r'; break;
+      case 't':  *out++ = '\t'; break;
+      case 'u': {
+        uint32_t cp;
+        if (!readHex4(p, end, cp)) return false;
+        p += 4;
+        if (cp >= 0xD800 && cp <= 0xDBFF) {
+          uint32_t low;
+          if (end - p < 6 || p[0] != '\\' || p[1] != 'u' || !readHex4(p + 2, end, low) ||
+              low < 0xDC00 || low > 0xDFFF) {
+            return false;
+          }
+          p += 6;
+          cp = 0x10000 + ((cp - 0xD800) << 10) + (low - 0xDC00);
+        } else if (cp >= 0xDC00 && cp <= 0xDFFF) {
+          return false;
+        }
+        // UTF-8 is never longer than the escape it replaces
+        if (cp < 0x80) {
+          *out++ = cp;
+        } else if (cp < 0x800) {
+          *out++ = 0xC0 | (cp >> 6);
+          *out++ = 0x80 | (cp & 0x3F);
+        } else if (cp < 0x10000) {
+          *out++ = 0xE0 | (cp >> 12);
+          *out++ = 0x80 | ((cp >> 6) & 0x3F);
+          *out++ = 0x80 | (cp & 0x3F);
+        } else {
+          *out++ = 0xF0 | (cp >> 18);
+          *out++ = 0x80 | ((cp >> 12) & 0x3F);
+          *out++ = 0x80 | ((cp >> 6) & 0x3F);
+          *out++ = 0x80 | (cp & 0x3F);
+        }
+        break;
+      }
+      default:
+        return false;
+    }
+  }
+  return false;
+}
+
+// Numbers must be integers; true/false read as 1/0
+static bool parseScalar(char *&p, char *end, int32_t &out) {
+  const char *start = p;
+  while (p < end && (*p == '-' || (*p >= '0' && *p <= '9'))) p++;
+  if (p > start) return parseInteger(start, p, out);
+
+  if (end - p >= 4 && memcmp(p, "true", 4) == 0) {
+    p += 4;
+    out = 1;
+    return true;
+  }
+  if (end - p >= 5 && memcmp(p, "false", 5) == 0) {
+    p += 5;
+    out = 0;
+    return true;
+  }
+  return false;
+}
+
+static CommandStatus parseJson(char *p, char *end, Command &out) {
+  CommandField opName = { nullptr, 0 };
+
+  p = (char *)skipSpace(p + 1, end);
+  if (p < end && *p == '}') return CMD_BAD_REQUEST;
+  for (;;) {
+    CommandField key;
+    if (p == end || *p != '"' || !parseString(p, end, key)) return CMD_BAD_REQUEST;
+    p = (char *)skipSpace(p, end);
+    if (p == end || *p != ':') return CMD_BAD_REQUEST;
+    p = (char *)skipSpace(p + 1, end);
+    if (p == end) return CMD_BAD_REQUEST;
+
+    // Flat objects only: a nested value is an error, not something to skip
+    if (*p == '"') {
+      CommandField value;
+      if (!parseString(p, end, value)) return CMD_BAD_REQUEST;
+      if (fieldEquals(key.data, key.length, "op")) {
+        opName = value;
+      } else if (fieldEquals(key.data, key.length, "ssid")) {
+        out.ssid = value;
+      } else if (fieldEquals(key.data, key.length, "password")) {
+        out.password = value;
+      }
+    } else {
+      int32_t value;
+      if (!parseScalar(p, end, value)) return CMD_BAD_REQUEST;
+      if (fieldEquals(key.data, key.length, "id")) {
+        if (value < 0) return CMD_BAD_REQUEST;
+        out.id = value;
+      } else if (fieldEquals(key.data, key.length, "value")) {
+        out.value = value;
+        out.hasValue = true;
+      }
+    }
+
+    p = (char *)skipSpace(p, end);
+    if (p == end) return CMD_BAD_REQUEST;
+    if (*p == '}') break;
+    if (*p != ',') return CMD_BAD_REQUEST;
+    p = (char *)skipSpace(p + 1, end);
+  }
+  if (skipSpace(p + 1, end) != end) return CMD_BAD_REQUEST;
+
+  if (opName.data == nullptr) return CMD_BAD_REQUEST;
+  out.op = lookupOp(opName.data, opName.length);
+  if (out.op == CMD_NONE) return CMD_UNKNOWN;
+  return checkFields(out);
+}
+
+// ===== BINARY =====
+
+static CommandStatus parseBinary(const uint8_t *p, const uint8_t *end, Command &out) {
+  if (end - p < 3) return CMD_BAD_REQUEST;
+  uint8_t op = p[0];
+  out.id = p[1] | (p[2] << 8);
+  p += 3;
+  if (op == CMD_NONE || op >= CMD_COUNT) return CMD_UNKNOWN;
+  out.op = (CommandOp)op;
+
+  switch (out.op) {
+    case CMD_LED1:
+      if (end - p != 2) return CMD_BAD_REQUEST;
+      out.value = (int16_t)(p[0] | (p[1] << 8));
+      out.hasValue = true;
+      break;
+    case CMD_LED2:
+    case CMD_LED3:
+      if (end - p != 1) return CMD_BAD_REQUEST;
+      out.value = p[0];
+      out.hasValue = true;
+      break;
+    case CMD_CONNECT: {
+      if (p == end || end - p - 1 < p[0]) return CMD_BAD_REQUEST;
+      out.ssid = { (const char *)p + 1, p[0] };
+      p += 1 + p[0];
+      if (p == end || end - p - 1 != p[0]) return CMD_BAD_REQUEST;
+      out.password = { (const char *)p + 1, p[0] };
+      break;
+    }
+    default:
+      if (p != end) return CMD_BAD_REQUEST;
+      break;
+  }
+  return checkFields(out);
+}
+
+CommandStatus parseCommand(uint8_t *data, size_t length, bool binary, Command &out) {
+  memset(&out, 0, sizeof(out));
+  out.op = CMD_NONE;
+  if (length == 0) return CMD_BAD_REQUEST;
+
+  if (binary) return parseBinary(data, data + length, out);
+
+  char *text = (char *)data;
+  char *end = text + length;
+  char *start = (char *)skipSpace(text, end);
+  if (start < end && *start == '{') return parseJson(start, end, out);
+  return parseText(text, end, out);
+}
+
+size_t writeCommandAck(char *buffer, size_t capacity, const Command &command,
+                       CommandStatus status) {
+  FrameWriter w(buffer, capacity);
+  w.raw("{\"action\":\"ack\",\"payload\":{");
+  w.key("id").integer(command.id);
+  w.key("op").string(commandSpecs[command.op].name);
+  w.key("status").string(statusNames[status]);
+  w.raw("}}");
+  return w.finish();
+}
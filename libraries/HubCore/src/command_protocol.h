@@ -0,0 +1,87 @@
+/*
+ * Command protocol for local WebSocket clients
+ *
+ * Three encodings of the same commands are accepted:
+ *
+ *   JSON text:   {"op":"led1","id":42,"value":128}
+ *                {"op":"connect","id":7,"ssid":"..","password":".."}
+ *   Legacy text: scan | connect:<ssid>|<password> | led1:<0-255> |
+ *                led2:<0|1> | led3:<0|1> | profile
+ *   Binary:      op (u8), id (u16 LE), then per op:
+ *                led1 value (i16 LE), led2/led3 value (u8),
+ *                connect ssid length (u8) + ssid + password length (u8) +
+ *                password, scan and profile nothing
+ *
+ * Messages are parsed in place: string fields point into the received
+ * buffer, and JSON escapes are decoded over the original bytes (the
+ * decoded form is never longer). Nothing is allocated.
+ *
+ * A non-zero id asks for an acknowledgement, which is always JSON:
+ *   {"action":"ack","payload":{"id":42,"op":"led1","status":"ok"}}
+ */
+#ifndef COMMAND_PROTOCOL_H
+#define COMMAND_PROTOCOL_H
+
+#include <Arduino.h>
+
+enum CommandOp : uint8_t {
+  CMD_NONE,
+  CMD_SCAN,
+  CMD_CONNECT,
+  CMD_LED1,
+  CMD_LED2,
+  CMD_LED3,
+  CMD_PROFILE,  // Latency histograms, answered with a "profile" frame
+  CMD_COUNT
+};
+
+enum CommandStatus : uint8_t {
+  CMD_OK,
+  CMD_BAD_REQUEST,  // Malformed message or missing field
+  CMD_UNKNOWN,      // No such op
+  CMD_REJECTED      // Well formed, but the device refused it
+};
+
+#define CMD_NEEDS_VALUE 0x01
+#define CMD_NEEDS_SSID 0x02
+
+struct CommandSpec {
+  const char *name;
+  uint8_t needs;  // CMD_NEEDS_* fields the parser checks for
+};
+
+// Indexed by CommandOp
+constexpr CommandSpec commandSpecs[CMD_COUNT] = {
+  { "", 0 },
+  { "scan", 0 },
+  { "connect", CMD_NEEDS_SSID },
+  { "led1", CMD_NEEDS_VALUE },
+  { "led2", CMD_NEEDS_VALUE },
+  { "led3", CMD_NEEDS_VALUE },
+  { "profile", 0 },
+};
+
+// A string inside the received message; not NUL terminated
+struct CommandField {
+  const char *data;
+  size_t length;
+};
+
+struct Command {
+  CommandOp op;
+  int32_t id;         // Request ID to acknowledge, 0 for none
+  int32_t value;      // Booleans are 0/1
+  bool hasValue;
+  CommandField ssid;
+  CommandField password;
+};
+
+// Decodes one message. data is modified when JSON escapes are decoded.
+// out.id is filled in even when the result is not CMD_OK, if it was read.
+CommandStatus parseCommand(uint8_t *data, size_t length, bool binary, Command &out);
+
+// {"action":"ack","payload":{"id":..,"op":"..","status":".."}}
+size_t writeCommandAck(char *buffer, size_t capacity, const Command &command,
+                       CommandStatus status);
+
+#endif // COMMAND_PROTOCOL_H
@@ -0,0 +1,167 @@
+/*
+ * Persistent WiFi credential store implementation
+ */
+#include "credential_store.h"
+#include <Preferences.h>
+
+#define CREDENTIAL_VERSION 2
+#define MIN_VALID_EPOCH 1600000000UL
+
+// NVS blob layout: version byte, count byte, then the entries
+struct CredentialBlob {
+  uint8_t version;
+  uint8_t count;
+  WifiCredential entries[CREDENTIAL_MAX_NETWORKS];
+};
+
+// Version 1 entries had no lease expiry
+struct WifiCredentialV1 {
+  char ssid[33];
+  char password[65];
+  uint8_t flags;
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint32_t ip;
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+};
+
+struct CredentialBlobV1 {
+  uint8_t version;
+  uint8_t count;
+  WifiCredentialV1 entries[CREDENTIAL_MAX_NETWORKS];
+};
+
+// Keeps the networks and access points; a lease of unknown age is dropped
+static void upgradeFromV1(CredentialBlob& blob) {
+  CredentialBlobV1 old;
+  memcpy(&old, &blob, sizeof(old));
+  memset(blob.entries, 0, sizeof(blob.entries));
+  for (size_t i = 0; i < old.count; i++) {
+    WifiCredential& entry = blob.entries[i];
+    memcpy(entry.ssid, old.entries[i].ssid, sizeof(entry.ssid));
+    memcpy(entry.password, old.entries[i].password, sizeof(entry.password));
+    entry.flags = old.entries[i].flags & CREDENTIAL_HAS_AP;
+    memcpy(entry.bssid, old.entries[i].bssid, sizeof(entry.bssid));
+    entry.channel = old.entries[i].channel;
+  }
+  blob.version = CREDENTIAL_VERSION;
+}
+
+bool leaseUsable(const WifiCredential& net, time_t now) {
+  return (net.flags & CREDENTIAL_HAS_LEASE) && now > (time_t)MIN_VALID_EPOCH &&
+         (int32_t)(net.leaseExpires - (uint32_t)now) >= CREDENTIAL_LEASE_MARGIN;
+}
+
+CredentialStore::CredentialStore() : count_(0) {
+  memset(entries_, 0, sizeof(entries_));
+}
+
+void CredentialStore::begin() {
+  count_ = 0;
+  Preferences prefs;
+  if (!prefs.begin(CREDENTIAL_NAMESPACE, true)) return;
+
+  static CredentialBlob blob;
+  size_t length = prefs.getBytes("nets", &blob, sizeof(blob));
+  prefs.end();
+  if (length == sizeof(CredentialBlobV1) && blob.version == 1 &&
+      blob.count <= CREDENTIAL_MAX_NETWORKS) {
+    upgradeFromV1(blob);
+    length = sizeof(blob);
+  }
+  if (length != sizeof(blob) || blob.version != CREDENTIAL_VERSION ||
+      blob.count > CREDENTIAL_MAX_NETWORKS) {
+    return;
+  }
+
+  memcpy(entries_, blob.entries, sizeof(entries_));
+  count_ = blob.count;
+  for (size_t i = 0; i < count_; i++) {
+    entries_[i].ssid[sizeof(entries_[i].ssid) - 1] = '\0';
+    entries_[i].password[sizeof(entries_[i].password) - 1] = '\0';
+  }
+}
+
+int CredentialStore::find(const char* ssid) const {
+  for (size_t i = 0; i < count_; i++) {
+    if (strcmp(entries_[i].ssid, ssid) == 0) return i;
+  }
+  return -1;
+}
+
+void CredentialStore::save() {
+  static CredentialBlob blob;
+  memset(&blob, 0, sizeof(blob));
+  blob.version = CREDENTIAL_VERSION;
+  blob.count = count_;
+  memcpy(blob.entries, entries_, sizeof(entries_));
+
+  Preferences prefs;
+  if (!prefs.begin(CREDENTIAL_NAMESPACE, false)) return;
+  prefs.putBytes("nets", &blob, sizeof(blob));
+  prefs.end();
+}
+
+void CredentialStore::remember(const char* ssid, const char* password) {
+  int found = find(ssid);
+  WifiCredential entry;
+  if (found >= 0) {
+    if (found == 0 && strcmp(entries_[0].password, password) == 0) return;
+    entry = entries_[found];
+    if (strcmp(entry.password, password) != 0) entry.flags = 0;
+  } else {
+    memset(&entry, 0, sizeof(entry));
+    strlcpy(entry.ssid, ssid, sizeof(entry.ssid));
+    found = count_ < CREDENTIAL_MAX_NETWORKS ? count_++ : count_ - 1;
+  }
+  strlcpy(entry.password, password, sizeof(entry.password));
+
+  // Shift the more recent ones down and put this one first
+  memmove(&entries_[1], &entries_[0], found * sizeof(WifiCredential));
+  entries_[0] = entry;
+  save();
+}
+
+void CredentialStore::recordConnection(const char* ssid, const uint8_t* bssid, uint8_t channel) {
+  int found = find(ssid);
+  if (found < 0 || !bssid || !channel) return;
+  WifiCredential& entry = entries_[found];
+
+  // Reconnects to the same AP happen all the time; spare the flash
+  if ((entry.flags & CREDENTIAL_HAS_AP) && entry.channel == channel &&
+      memcmp(entry.bssid, bssid, sizeof(entry.bssid)) == 0) {
+    return;
+  }
+  memcpy(entry.bssid, bssid, sizeof(entry.bssid));
+  entry.channel = channel;
+  entry.flags |= CREDENTIAL_HAS_AP;
+  save();
+}
+
+void CredentialStore::recordLease(const char* ssid, IPAddress ip, IPAddress gateway,
+                                  IPAddress subnet, IPAddress dns, uint32_t expires) {
+  int found = find(ssid);
+  if (found < 0 || (uint32_t)ip == 0) return;
+  WifiCredential& entry = entries_[found];
+  entry.ip = ip;
+  entry.gateway = gateway;
+  entry.subnet = subnet;
+  entry.dns = dns;
+  entry.leaseExpires = expires;
+  entry.flags |= CREDENTIAL_HAS_LEASE;
+  save();
+}
+
+void CredentialStore::forgetCache(size_t index) {
+  if (index >= count_ || entries_[index].flags == 0) return;
+  entries_[index].flags = 0;
+  save();
+}
+
+void CredentialStore::clear() {
+  count_ = 0;
+  memset(entries_, 0, sizeof(entries_));
+  save();
+}
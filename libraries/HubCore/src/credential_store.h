@@ -0,0 +1,95 @@
+/*
+ * Persistent WiFi credential store
+ *
+ * Keeps up to CREDENTIAL_MAX_NETWORKS networks in NVS, most recently
+ * connected first. For each one it also caches the access point
+ * (BSSID and channel) and the DHCP lease of the last connection.
+ * WiFi.begin() with the BSSID and channel skips the scan, and a static
+ * config with the cached lease skips DHCP. Together they cut
+ * association from seconds to a few hundred milliseconds.
+ *
+ * A lease is only cached with its expiry in wall-clock time, and only
+ * used while at least CREDENTIAL_LEASE_MARGIN of it is left (see
+ * leaseUsable()). Nothing renews an address set statically, so the
+ * sketch hands it back to DHCP before the lease runs out. Without a
+ * valid clock (after a power cycle, before NTP) DHCP is used.
+ *
+ * The cache is only a hint. A fast connect that fails is retried with a
+ * full scan and DHCP, and the cache is dropped (see forgetCache()).
+ *
+ * Only the owner task touches the store; it is not locked.
+ */
+#ifndef CREDENTIAL_STORE_H
+#define CREDENTIAL_STORE_H
+
+#include <Arduino.h>
+#include <IPAddress.h>
+#include <time.h>
+
+#define CREDENTIAL_MAX_NETWORKS 4
+#define CREDENTIAL_NAMESPACE "wifi"
+#define CREDENTIAL_LEASE_MARGIN 600  // Lease time a cached lease must have left to be used (s)
+
+#define CREDENTIAL_HAS_AP 0x01     // bssid and channel are valid
+#define CREDENTIAL_HAS_LEASE 0x02  // ip, gateway, subnet, dns and leaseExpires are valid
+
+struct WifiCredential {
+  char ssid[33];
+  char password[65];
+  uint8_t flags;        // CREDENTIAL_HAS_*
+  uint8_t bssid[6];
+  uint8_t channel;
+  uint32_t ip;          // IPv4 addresses as stored by IPAddress
+  uint32_t gateway;
+  uint32_t subnet;
+  uint32_t dns;
+  uint32_t leaseExpires; // time() when the lease runs out
+};
+
+class CredentialStore {
+ public:
+  CredentialStore();
+
+  // Loads the saved networks; an empty or unreadable store is not an error
+  void begin();
+
+  size_t count() const { return count_; }
+  // 0 is the network to try first
+  const WifiCredential& at(size_t index) const { return entries_[index]; }
+
+  /**
+   * Saves a network that has just been connected to, or moves it to
+   * the front. The least recently used network is dropped when the
+   * store is full. A changed password drops the cached AP and lease.
+   */
+  void remember(const char* ssid, const char* password);
+
+  /**
+   * Caches the access point the connection to ssid ended up on. NVS is
+   * only written when something changed.
+   */
+  void recordConnection(const char* ssid, const uint8_t* bssid, uint8_t channel);
+
+  // Caches the DHCP lease of ssid, valid until expires (time())
+  void recordLease(const char* ssid, IPAddress ip, IPAddress gateway, IPAddress subnet,
+                   IPAddress dns, uint32_t expires);
+
+  // Drops the cached AP and lease of one network after a failed fast connect
+  void forgetCache(size_t index);
+
+  // Removes every saved network
+  void clear();
+
+ private:
+  int find(const char* ssid) const;
+  void save();
+
+  WifiCredential entries_[CREDENTIAL_MAX_NETWORKS];
+  size_t count_;
+};
+
+// True if net has a cached lease with CREDENTIAL_LEASE_MARGIN left at
+// wall-clock time now
+bool leaseUsable(const WifiCredential& net, time_t now);
+
+#endif // CREDENTIAL_STORE_H
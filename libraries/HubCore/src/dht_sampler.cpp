@@ -0,0 +1,83 @@
+/*
+ * Background DHT sampler implementation
+ */
+#include "dht_sampler.h"
+
+DhtSampler::DhtSampler(uint8_t pin, uint8_t type)
+  : dht_(pin, type),
+    periodMs_(2000),
+    task_(nullptr),
+    sequence_(0),
+    temperature_(NAN),
+    humidity_(NAN),
+    timestamp_(0),
+    errorCount_(0) {}
+
+void DhtSampler::begin(uint32_t periodMs) {
+  if (task_ != nullptr) return;
+
+  periodMs_ = periodMs;
+  dht_.begin();
+  xTaskCreatePinnedToCore(taskEntry, "dht_sampler", DHT_SAMPLER_STACK_SIZE,
+                          this, DHT_SAMPLER_PRIORITY, &task_, DHT_SAMPLER_CORE);
+}
+
+bool DhtSampler::read(DhtReading& out) const {
+  DhtReading copy;
+  for (int tries = 0; tries < DHT_SAMPLER_READ_TRIES; tries++) {
+    uint32_t before = sequence_.load(std::memory_order_acquire);
+    if (before & 1) {
+      // Writer in progress, and possibly preempted by this task: let it finish
+      vTaskDelay(1);
+      continue;
+    }
+
+    copy.temperature = temperature_;
+    copy.humidity = humidity_;
+    copy.timestamp = timestamp_;
+    copy.errorCount = errorCount_;
+
+    std::atomic_thread_fence(std::memory_order_acquire);
+    if (sequence_.load(std::memory_order_relaxed) == before) {
+      out = copy;
+      return out.timestamp != 0;
+    }
+  }
+
+  // No consistent copy this time; the caller keeps its last one
+  return false;
+}
+
+void DhtSampler::taskEntry(void* arg) {
+  static_cast<DhtSampler*>(arg)->run();
+}
+
+void DhtSampler::run() {
+  TickType_t lastWake = xTaskGetTickCount();
+  for (;;) {
+    // readTemperature() performs the bus transaction, readHumidity()
+    // returns the value captured by the same transaction
+    float t = dht_.readTemperature();
+    float h = dht_.readHumidity();
+    publish(t, h, !isnan(t) && !isnan(h));
+
+    vTaskDelayUntil(&lastWake, pdMS_TO_TICKS(periodMs_));
+  }
+}
+
+void DhtSampler::publish(float temperature, float humidity, bool ok) {
+  uint32_t seq = sequence_.load(std::memory_order_relaxed);
+  sequence_.store(seq + 1, std::memory_order_relaxed);
+  std::atomic_thread_fence(std::memory_order_release);
+
+  if (ok) {
+    temperature_ = temperature;
+    humidity_ = humidity;
+    uint32_t now = millis();
+    timestamp_ = now != 0 ? now : 1;
+  } else {
+    errorCount_ = errorCount_ + 1;
+  }
+
+  sequence_.store(seq + 2, std::memory_order_release);
+}
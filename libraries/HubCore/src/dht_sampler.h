@@ -0,0 +1,63 @@
+/*
+ * Background DHT sampler for the Smart Home Hub firmware
+ *
+ * A dedicated FreeRTOS task owns the DHT sensor and reads it at a fixed
+ * period. The last good reading is published through a sequence-locked
+ * snapshot, so consumers never touch the sensor bus and wait at most a
+ * few ticks.
+ */
+#ifndef DHT_SAMPLER_H
+#define DHT_SAMPLER_H
+
+#include <Arduino.h>
+#include <DHT.h>
+#include <atomic>
+
+#define DHT_SAMPLER_STACK_SIZE 3072
+// At least the priority of any task on the same core that calls read(),
+// so a reader can never hold the writer off mid-publish
+#define DHT_SAMPLER_PRIORITY 2
+#define DHT_SAMPLER_CORE 1
+// Attempts read() makes at a consistent snapshot before giving up
+#define DHT_SAMPLER_READ_TRIES 4
+
+// Last reading published by the sampler
+struct DhtReading {
+  float temperature;
+  float humidity;
+  uint32_t timestamp;   // millis() of the last good reading, 0 if none yet
+  uint32_t errorCount;  // Failed reads since boot
+};
+
+class DhtSampler {
+ public:
+  DhtSampler(uint8_t pin, uint8_t type);
+
+  // Starts the sampling task; periodMs should not be below the sensor's
+  // own refresh time (about 1 s for DHT11, 2 s for DHT22)
+  void begin(uint32_t periodMs);
+
+  // Copies the latest snapshot; returns false until a good reading
+  // exists. Never spins: if the writer holds the snapshot through
+  // DHT_SAMPLER_READ_TRIES attempts, out is left as it was and false
+  // is returned.
+  bool read(DhtReading& out) const;
+
+ private:
+  static void taskEntry(void* arg);
+  void run();
+  void publish(float temperature, float humidity, bool ok);
+
+  DHT dht_;
+  uint32_t periodMs_;
+  TaskHandle_t task_;
+
+  // Odd while the sampler task is writing the snapshot
+  std::atomic<uint32_t> sequence_;
+  volatile float temperature_;
+  volatile float humidity_;
+  volatile uint32_t timestamp_;
+  volatile uint32_t errorCount_;
+};
+
+#endif // DHT_SAMPLER_H
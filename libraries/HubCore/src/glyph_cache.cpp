@@ -0,0 +1,97 @@
+/*
+ * LCD icons and their CGRAM slots
+ */
+#include "glyph_cache.h"
+
+// Indexed by Glyph
+static const uint8_t glyphBitmaps[GLYPH_COUNT][8] = {
+  // None
+  { 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000, 0b00000 },
+  // WiFi connected
+  { 0b00000, 0b00000, 0b00100, 0b01110, 0b10101, 0b00100, 0b00000, 0b00000 },
+  // AP mode
+  { 0b00000, 0b01110, 0b10001, 0b10101, 0b10001, 0b01110, 0b00000, 0b00000 },
+  // Temperature
+  { 0b00100, 0b01010, 0b01010, 0b01010, 0b01110, 0b11111, 0b11111, 0b01110 },
+  // Humidity
+  { 0b00100, 0b00100, 0b01010, 0b01010, 0b10001, 0b10001, 0b10001, 0b01110 },
+  // Motion
+  { 0b00000, 0b00100, 0b01110, 0b11111, 0b00100, 0b00100, 0b00000, 0b00000 },
+  // Loading animation frames
+  { 0b00000, 0b00000, 0b00000, 0b11100, 0b11100, 0b00000, 0b00000, 0b00000 },
+  { 0b00000, 0b00000, 0b00000, 0b00111, 0b00111, 0b00000, 0b00000, 0b00000 },
+  { 0b00000, 0b00000, 0b11100, 0b00000, 0b00000, 0b00111, 0b00000, 0b00000 },
+  // Fan
+  { 0b00000, 0b01110, 0b01010, 0b11111, 0b10101, 0b00100, 0b01110, 0b00000 },
+  // Light
+  { 0b00000, 0b00000, 0b01110, 0b10001, 0b10001, 0b01110, 0b01110, 0b00000 },
+};
+
+GlyphCache::GlyphCache()
+    : lcd_(nullptr), upload_(nullptr), screenStart_(0), clock_(0), uploads_(0) {
+  memset(slotOf_, -1, sizeof(slotOf_));
+  memset(glyphIn_, -1, sizeof(glyphIn_));
+  memset(lastUsed_, 0, sizeof(lastUsed_));
+}
+
+void GlyphCache::begin(void* lcd, Upload upload) {
+  lcd_ = lcd;
+  upload_ = upload;
+  memset(slotOf_, -1, sizeof(slotOf_));
+  memset(glyphIn_, -1, sizeof(glyphIn_));
+  memset(lastUsed_, 0, sizeof(lastUsed_));
+  clock_ = 0;
+  screenStart_ = 0;
+  uploads_ = 0;
+}
+
+void GlyphCache::beginScreen(const Glyph* glyphs, size_t count) {
+  screenStart_ = ++clock_;
+  for (size_t i = 0; i < count; i++) {
+    slotFor(glyphs[i]);
+  }
+}
+
+uint8_t GlyphCache::slotFor(Glyph glyph) {
+  int8_t slot = slotOf_[glyph];
+  if (slot < 0) {
+    // Prefer an empty slot, then the least recently used one that
+    // the current screen does not show
+    uint8_t victim = 0;
+    bool victimFree = false;
+    for (uint8_t s = 0; s < GLYPH_SLOTS; s++) {
+      if (glyphIn_[s] < 0) {
+        victim = s;
+        break;
+      }
+      bool free = lastUsed_[s] < screenStart_;
+      if ((free && !victimFree) ||
+          (free == victimFree && lastUsed_[s] < lastUsed_[victim])) {
+        victim = s;
+        victimFree = free;
+      }
+    }
+
+    if (glyphIn_[victim] >= 0) slotOf_[glyphIn_[victim]] = -1;
+    glyphIn_[victim] = glyph;
+    slotOf_[glyph] = victim;
+    slot = victim;
+
+    if (lcd_ != nullptr) {
+      upload_(lcd_, slot, glyphBitmaps[glyph]);
+      uploads_++;
+    }
+  }
+
+  lastUsed_[slot] = ++clock_;
+  return slot;
+}
+
+void GlyphCache::reload() {
+  if (lcd_ == nullptr) return;
+  for (uint8_t s = 0; s < GLYPH_SLOTS; s++) {
+    if (glyphIn_[s] < 0) continue;
+    upload_(lcd_, s, glyphBitmaps[glyphIn_[s]]);
+    uploads_++;
+  }
+}
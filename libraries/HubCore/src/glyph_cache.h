@@ -0,0 +1,77 @@
+/*
+ * CGRAM slot management for the LCD icons
+ *
+ * The HD44780 has 8 CGRAM slots for custom characters, fewer than the
+ * icons the hub screens use between them. GlyphCache maps the logical
+ * icons onto the slots and uploads a glyph only when it is not already
+ * resident. Slots used by the screen being drawn are never evicted;
+ * otherwise the least recently used slot is reused.
+ */
+#ifndef GLYPH_CACHE_H
+#define GLYPH_CACHE_H
+
+#include <Arduino.h>
+
+#define GLYPH_SLOTS 8
+
+// Logical icons; the bitmaps are in glyph_cache.cpp
+enum Glyph : uint8_t {
+  GLYPH_NONE,  // No icon, never uploaded
+  GLYPH_WIFI,
+  GLYPH_AP,
+  GLYPH_TEMP,
+  GLYPH_HUMIDITY,
+  GLYPH_MOTION,
+  GLYPH_LOADING1,
+  GLYPH_LOADING2,
+  GLYPH_LOADING3,
+  GLYPH_FAN,
+  GLYPH_LIGHT,
+  GLYPH_COUNT
+};
+
+class GlyphCache {
+ public:
+  GlyphCache();
+
+  // Call once after the panel is initialised; CGRAM content is undefined
+  // at power-up. Works with any LCD driver offering createChar().
+  template <typename Lcd>
+  void begin(Lcd& lcd) {
+    begin(&lcd, &upload<Lcd>);
+  }
+
+  // Starts a new screen. The glyphs it needs (and any animation frames
+  // shown on it) are loaded up front so drawing never uploads.
+  void beginScreen(const Glyph* glyphs, size_t count);
+
+  // CGRAM slot holding the glyph, uploading it first if needed
+  uint8_t slotFor(Glyph glyph);
+
+  // Uploads every resident glyph again, into the slot it already has
+  void reload();
+
+  // CGRAM writes since begin()
+  uint32_t uploads() const { return uploads_; }
+
+ private:
+  typedef void (*Upload)(void* lcd, uint8_t slot, const uint8_t* bitmap);
+
+  template <typename Lcd>
+  static void upload(void* lcd, uint8_t slot, const uint8_t* bitmap) {
+    static_cast<Lcd*>(lcd)->createChar(slot, const_cast<uint8_t*>(bitmap));
+  }
+
+  void begin(void* lcd, Upload upload);
+
+  void* lcd_;
+  Upload upload_;
+  int8_t slotOf_[GLYPH_COUNT];       // -1 when not resident
+  int8_t glyphIn_[GLYPH_SLOTS];      // -1 when empty
+  uint32_t lastUsed_[GLYPH_SLOTS];
+  uint32_t screenStart_;
+  uint32_t clock_;
+  uint32_t uploads_;
+};
+
+#endif // GLYPH_CACHE_H
@@ -0,0 +1,271 @@
+/*
+ * Connection to the API server, selected by HubConfig::transport
+ *
+ *   HubApiLink<HubConfig, Listener> api(listener);
+ *
+ * names HttpApiLink or WebSocketApiLink. Both give the owner task the
+ * same interface, so the rest of the firmware does not care how frames
+ * reach the server:
+ *
+ *   api.begin();                  // Once the station has an address
+ *   api.loop();                   // Every pass of the owner task
+ *   api.sendSample(sample, ack);  // updateenv, or a binary frame
+ *   api.sendText(frame, length);  // JSON written after the header room
+ *
+ * Frames passed to sendText() start with WEBSOCKETS_MAX_HEADER_SIZE bytes
+ * of room for the WebSocket header. Messages from the server go to the
+ * Listener:
+ *
+ *   void onApiConnected();
+ *   void onApiMessage(JsonDocument& doc);
+ */
+#ifndef HUB_API_LINK_H
+#define HUB_API_LINK_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <WebSockets.h>
+#include <type_traits>
+#include "hub_config.h"
+#include "hub_uplink.h"
+#include "reconnect_policy.h"
+#include "secure_ws_client.h"
+#include "loop_stats.h"
+#include "mem_stats.h"
+#include "boot_timeline.h"
+
+/**
+ * Every frame is a POST, and commands come back in the response. After
+ * a failed post the link counts as down for Config::dataSendInterval,
+ * so samples are buffered instead of each one waiting out the timeout.
+ */
+template <class Config, class Listener>
+class HttpApiLink {
+ public:
+  explicit HttpApiLink(Listener& listener)
+    : listener_(listener), begun_(false), up_(false), retryAt_(0) {}
+
+  void begin() {
+    begun_ = true;
+    up_ = false;
+    retryAt_ = millis();
+  }
+
+  void loop() {
+    if (begun_ && !up_ && (int32_t)(millis() - retryAt_) >= 0) {
+      up_ = true;
+      listener_.onApiConnected();
+    }
+  }
+
+  bool connected() const { return up_; }
+
+  bool sendSample(const TelemetrySample& sample, uint32_t ack = 0) {
+    return post(sample_, writeUpdateEnvFrame(sample_, sizeof(sample_), sample, Config::deviceId(), ack));
+  }
+
+  bool sendText(uint8_t* frame, size_t length) {
+    return post((char*)frame + WEBSOCKETS_MAX_HEADER_SIZE, length);
+  }
+
+  void writeStats(FrameWriter& w) const {}
+
+ private:
+  bool post(const char* body, size_t length) {
+    if (!length || !up_) return false;
+
+    String response;
+    int code = http_.post(body, length, &response);
+    if (code != HTTP_CODE_OK) {
+      Serial.printf("API post failed (%d)\n", code);
+      up_ = false;
+      retryAt_ = millis() + Config::dataSendInterval;
+      return false;
+    }
+
+    bootMark(BOOT_API_CONNECTED);
+    if (response.length()) {
+      MemSiteScope memScope(MEM_SITE_API_MESSAGE);
+      JsonDocument doc(memStatsJsonAllocator());
+      if (!deserializeJson(doc, response)) listener_.onApiMessage(doc);
+    }
+    return true;
+  }
+
+  Listener& listener_;
+  HttpUplink<Config> http_;
+  bool begun_;
+  bool up_;
+  uint32_t retryAt_;  // millis() of the next try while down
+  char sample_[TELEMETRY_FRAME_SIZE];
+};
+
+/**
+ * A persistent WebSocket, reconnected with jittered backoff (see
+ * reconnect_policy.h). Each connection opens with a hello that offers
+ * binary telemetry (see binary_telemetry.h); the server's reply is
+ * handled here. wss:// endpoints resume their TLS session and check
+ * Config::apiRootCA() and apiKeyPin().
+ */
+template <class Config, class Listener>
+class WebSocketApiLink {
+ public:
+  explicit WebSocketApiLink(Listener& listener)
+    : listener_(listener), uplink_(client_, frame_, sizeof(frame_)), policy_(client_),
+      lastPing_(0) {}
+
+  // Parses Config::endpoint() and connects right away
+  void begin() {
+    String url = Config::endpoint();
+    String host, path;
+    uint16_t port;
+    bool secure;
+
+    if (url.startsWith("wss://")) {
+      url = url.substring(6);
+      port = 443;
+      secure = true;
+    } else if (url.startsWith("ws://")) {
+      url = url.substring(5);
+      port = 80;
+      secure = false;
+    } else {
+      Serial.println("Invalid WebSocket URL format");
+      return;
+    }
+
+    int pathIndex = url.indexOf('/');
+    if (pathIndex > 0) {
+      host = url.substring(0, pathIndex);
+      path = url.substring(pathIndex);
+    } else {
+      host = url;
+      path = "/";
+    }
+
+    // Explicit port, e.g. a local stand-in server
+    int portIndex = host.indexOf(':');
+    if (portIndex > 0) {
+      port = host.substring(portIndex + 1).toInt();
+      host = host.substring(0, portIndex);
+    }
+
+    Serial.print("Connecting to WebSocket API: ");
+    Serial.print(host);
+    Serial.print(":");
+    Serial.print(port);
+    Serial.println(path);
+
+    client_.setTrust(Config::apiRootCA(), Config::apiKeyPin());
+    if (secure) {
+      client_.beginSSL(host.c_str(), port, path.c_str());
+    } else {
+      client_.begin(host.c_str(), port, path.c_str());
+    }
+    client_.onEvent([this](WStype_t type, uint8_t* payload, size_t length) {
+      onEvent(type, payload, length);
+    });
+    policy_.begin();
+  }
+
+  void loop() {
+    LOOP_STATS_TIME(REGION_API_LOOP, policy_.loop());
+
+    // Keeps idle proxies from closing the connection
+    if (policy_.isConnected() && millis() - lastPing_ >= Config::pingInterval) {
+      client_.sendTXT("ping");
+      lastPing_ = millis();
+    }
+  }
+
+  bool connected() const { return policy_.isConnected(); }
+
+  bool sendSample(const TelemetrySample& sample, uint32_t ack = 0) {
+    return uplink_.sendSample(sample, ack);
+  }
+
+  bool sendText(uint8_t* frame, size_t length) {
+    return length && client_.sendTXT(frame, length, true);
+  }
+
+  // Appends the "reconnect" and "tls" statistics
+  void writeStats(FrameWriter& w) const {
+    policy_.writeStats(w, "reconnect");
+    client_.writeTlsStats(w);
+  }
+
+ private:
+  void onEvent(WStype_t type, uint8_t* payload, size_t length) {
+    LOOP_STATS_SCOPE(REGION_API_EVENT);
+    switch (type) {
+      case WStype_DISCONNECTED:
+        Serial.println("Disconnected from API WebSocket server");
+        policy_.disconnected();
+        if (policy_.delay()) Serial.printf("Reconnecting to API in %lu ms\n", (unsigned long)policy_.delay());
+        break;
+
+      case WStype_CONNECTED:
+        Serial.println("Connected to API WebSocket server");
+        policy_.connected();
+        bootMark(BOOT_API_CONNECTED);
+        uplink_.reset();
+        lastPing_ = millis();
+        sendHello();
+        listener_.onApiConnected();
+        break;
+
+      case WStype_TEXT: {
+        MemSiteScope memScope(MEM_SITE_API_MESSAGE);
+        Serial.print("Received data from API server: ");
+        Serial.println((char*)payload);
+
+        JsonDocument doc(memStatsJsonAllocator());
+        if (deserializeJson(doc, payload, length)) break;
+
+        // Hello acknowledgement: {"action":"hello","payload":{"binary":1}}
+        if (doc["action"] == "hello") {
+          uplink_.accept(doc["payload"]["binary"] | 0);
+          Serial.printf("API uplink format: %s\n", uplink_.binary() ? "binary" : "JSON");
+        } else {
+          listener_.onApiMessage(doc);
+        }
+        break;
+      }
+
+      case WStype_ERROR:
+        Serial.println("WebSocket API Error!");
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  /**
+   * Identifies the device once per connection and offers the binary
+   * telemetry format. Frames stay JSON unless the server accepts.
+   */
+  void sendHello() {
+    FrameWriter w(uplink_.payload(), uplink_.capacity());
+    w.raw("{\"action\":\"hello\",\"payload\":{");
+    w.key("deviceId").string(Config::deviceId());
+    w.key("binary").integer(uplink_.offeredVersion());
+    w.raw("}}");
+    uplink_.sendText(w.finish());
+  }
+
+  Listener& listener_;
+  SecureWebSocketsClient client_;
+  // Samples and the hello are built here, after room for the header
+  uint8_t frame_[WEBSOCKETS_MAX_HEADER_SIZE + TELEMETRY_FRAME_SIZE];
+  WebSocketUplink<Config> uplink_;
+  ReconnectPolicy<Config, SecureWebSocketsClient> policy_;
+  uint32_t lastPing_;
+};
+
+template <class Config, class Listener>
+using HubApiLink = typename std::conditional<Config::transport == HubTransport::Http,
+                                             HttpApiLink<Config, Listener>,
+                                             WebSocketApiLink<Config, Listener>>::type;
+
+#endif // HUB_API_LINK_H
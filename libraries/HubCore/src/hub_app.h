@@ -0,0 +1,965 @@
+/*
+ * The Smart Home Hub firmware, shared by every sketch
+ *
+ * A sketch declares its pins, transport and actuators in a HubConfig
+ * (see hub_config.h) and hands the rest to HubApp:
+ *
+ *   HubApp<HubConfig> hub;
+ *
+ *   void setup() { hub.begin(); }
+ *   void loop() { vTaskDelete(NULL); }
+ *
+ * The work runs in three FreeRTOS tasks that only talk through queues:
+ *
+ *   network  WiFi and the captive portal (hub_wifi.h, hub_portal.h), the
+ *            API link (hub_api_link.h) and local WebSocket clients.
+ *            Pinned to the core that runs the WiFi stack.
+ *   io       Owns the actuator outputs and the PIR input; takes actuator
+ *            commands from the network task and reads the DHT sampler.
+ *   display  Sole owner of the LCD after begin() (hub_display.h); draws
+ *            the frames the io task posts.
+ *
+ * Up to HUB_MAX_ACTUATORS actuators are reported in telemetry, in table
+ * order, under the field names of the original hub: led1 for slot 0,
+ * which may be a level, and led2 and led3 for slots 1 and 2, which must
+ * be switches. Local clients drive them with the led1..led3 commands;
+ * device_control from the server uses the names in the table.
+ */
+#ifndef HUB_APP_H
+#define HUB_APP_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include <SPIFFS.h>
+#include <WebSockets.h>
+#include <type_traits>
+#include "hub_config.h"
+#include "hub_wifi.h"
+#include "hub_portal.h"
+#include "hub_api_link.h"
+#include "hub_display.h"
+#include "actuator_map.h"
+#include "client_fanout.h"
+#include "command_protocol.h"
+#include "dht_sampler.h"
+#include "motion_sensor.h"
+#include "pwm_fader.h"
+#include "report_filter.h"
+#include "telemetry_batch.h"
+#include "telemetry_frame.h"
+#include "telemetry_store.h"
+#include "uplink_commands.h"
+#include "wifi_scan.h"
+#include "boot_timeline.h"
+#include "loop_stats.h"
+#include "mem_stats.h"
+
+// ----- Tasks -----
+#define HUB_NET_CORE 0               // Same core as the WiFi stack
+#define HUB_APP_CORE 1
+#define HUB_NET_TASK_STACK 8192
+#define HUB_IO_TASK_STACK 4096
+#define HUB_DISPLAY_TASK_STACK 3072
+#define HUB_NET_TASK_PRIORITY 3
+#define HUB_IO_TASK_PRIORITY 2
+#define HUB_DISPLAY_TASK_PRIORITY 1
+static_assert(DHT_SAMPLER_PRIORITY >= HUB_IO_TASK_PRIORITY, "the io task reads the DHT sampler on its core");
+#define HUB_NET_TASK_PERIOD 5        // Network task polling period (ms)
+#define HUB_IO_TASK_PERIOD 10        // Sensor polling period (ms)
+#define HUB_ACTUATOR_QUEUE_LENGTH 8
+#define HUB_MOTION_EVENT_QUEUE_LENGTH 8
+#define HUB_NET_LOOP_BUDGET 50       // Longest acceptable network pass (ms)
+#define HUB_DIAG_INTERVAL 60000      // Time between heap/stack reports to the API server (ms)
+#define HUB_METRICS_JSON_SIZE (MEM_STATS_JSON_SIZE + 384)  // /api/metrics: boot timeline, reconnects, TLS and memory
+
+// Backfill, batch, diag and network list frames
+#define HUB_BULK_FRAME_SIZE (BACKFILL_FRAME_SIZE > BATCH_FRAME_SIZE ? BACKFILL_FRAME_SIZE : BATCH_FRAME_SIZE)
+
+static_assert(HUB_MAX_ACTUATORS <= UPLINK_MAX_TARGETS, "every actuator needs a pipeline slot");
+
+// Actuator set-point passed from the network task to the io task
+struct ActuatorCommand {
+  uint8_t target;   // Index in Config::actuatorTable()
+  int value;
+  uint32_t ticket;  // From the uplink command pipeline, 0 for local commands
+};
+
+// Motion start/stop passed from the io task to the network task
+struct MotionEvent {
+  bool detected;
+  uint32_t timestamp;  // millis() of the edge that caused it
+};
+
+template <class Config>
+class HubApp {
+  static_assert(Config::actuatorCount <= HUB_MAX_ACTUATORS, "telemetry carries up to three actuators");
+  static_assert(Config::actuatorCount < 2 || Config::actuatorTable()[1].kind == ACTUATOR_SWITCH,
+                "led2 is reported as a switch");
+  static_assert(Config::actuatorCount < 3 || Config::actuatorTable()[2].kind == ACTUATOR_SWITCH,
+                "led3 is reported as a switch");
+
+ public:
+  HubApp()
+    : temperature_(0), humidity_(0), motionDetected_(false), lcdState_(STARTING),
+      lastMotionTime_(0), pirActive_(false), actuatorQueue_(nullptr), displayQueue_(nullptr),
+      motionEventQueue_(nullptr), droppedCommands_(0), lastAckSent_(0), ackRequested_(false),
+      lastDataSend_(0), lastDiag_(0), lastBackfill_(0), lastPersist_(0), spiffsReady_(false),
+      uplinkFilter_(Config::tempDeadband, Config::humDeadband, Config::dataSendInterval,
+                    Config::reportMinInterval),
+      statusFilter_(Config::tempDeadband, Config::humDeadband, Config::statusHeartbeat,
+                    Config::reportMinInterval),
+      dht_(Config::dhtPin, Config::dhtType), motionSensor_(Config::pirPin),
+      faders_{ { faderChannel(0), 8 }, { faderChannel(1), 8 }, { faderChannel(2), 8 } },
+      wifi_(*this), portal_(wifi_, wifiScan_), api_(*this), local_(Config::localPort) {
+    memset(actuators_, 0, sizeof(actuators_));
+    self_ = this;
+  }
+
+  /**
+   * Sets up the outputs, the sensors and the LCD, then starts the tasks.
+   * WiFi association runs in the background while the rest carries on.
+   */
+  void begin() {
+    Serial.begin(115200);
+    Serial.println("\nSmart Home Hub Starting...");
+
+    setupActuators();
+    if (Config::motionLedPin != HUB_NO_PIN) {
+      pinMode(Config::motionLedPin, OUTPUT);
+      digitalWrite(Config::motionLedPin, LOW);
+    }
+
+    // Start background DHT sampling
+    dht_.begin(Config::dhtSampleInterval);
+    telemetryBatch_.configure(Config::batchWindow, Config::batchSize);
+
+    display_.begin();
+
+    // Create the inter-task queues and start the local tasks
+    actuatorQueue_ = xQueueCreate(HUB_ACTUATOR_QUEUE_LENGTH, sizeof(ActuatorCommand));
+    displayQueue_ = xQueueCreate(1, sizeof(DisplayFrame));
+    motionEventQueue_ = xQueueCreate(HUB_MOTION_EVENT_QUEUE_LENGTH, sizeof(MotionEvent));
+    motionSensor_.begin();
+    TaskHandle_t task;
+    xTaskCreatePinnedToCore(ioTaskEntry, "io", HUB_IO_TASK_STACK, this, HUB_IO_TASK_PRIORITY,
+                            &task, HUB_APP_CORE);
+    memStatsAddTask(task, "io");
+    xTaskCreatePinnedToCore(displayTaskEntry, "display", HUB_DISPLAY_TASK_STACK, this,
+                            HUB_DISPLAY_TASK_PRIORITY, &task, HUB_APP_CORE);
+    memStatsAddTask(task, "display");
+
+    // Saved networks first, the captive portal when none connects
+    wifiScan_.begin();
+    wifi_.begin();
+
+    // The telemetry backlog survives reboots in SPIFFS
+    if (!SPIFFS.begin(true)) {
+      Serial.println("SPIFFS initialization failed!");
+    } else {
+      spiffsReady_ = true;
+      if (Config::persistBacklog && telemetryStore_.load(SPIFFS, Config::backlogPath())) {
+        Serial.printf("Restored %u buffered samples\n", (unsigned)telemetryStore_.size());
+      }
+    }
+
+    // Local WebSocket clients, if the sketch has any
+    local_.begin();
+    local_.onEvent([this](uint8_t num, WStype_t type, uint8_t* payload, size_t length) {
+      onLocalEvent(num, type, payload, length);
+    });
+    local_.setRenderer(FANOUT_STATE_STATUS, txFrame_, TELEMETRY_FRAME_SIZE, renderStatusFrame);
+    local_.setRenderer(FANOUT_STATE_WIFI_LIST, bulkFrame_, HUB_BULK_FRAME_SIZE, renderWifiList);
+    local_.setRenderer(FANOUT_STATE_PROFILE, profileFrame_, PROFILE_SIZE, renderProfile);
+
+    // Heap and stack statistics, next to the portal routes
+    portal_.server().on("/api/metrics", HTTP_GET, [this](AsyncWebServerRequest* request) {
+      handleMetricsRequest(request);
+    });
+
+    // Networking starts last so it never races the setup code above
+    xTaskCreatePinnedToCore(networkTaskEntry, "network", HUB_NET_TASK_STACK, this,
+                            HUB_NET_TASK_PRIORITY, &task, HUB_NET_CORE);
+    memStatsAddTask(task, "network");
+
+    Serial.println("System initialization complete");
+  }
+
+  // ----- State, for diagnostics and the host tests -----
+  // Written by the owner task and only read elsewhere
+  bool wifiConnected() const { return wifi_.connected(); }
+  bool apiConnected() const { return api_.connected(); }
+  QueueHandle_t actuatorQueue() const { return actuatorQueue_; }
+  QueueHandle_t displayQueue() const { return displayQueue_; }
+  uint32_t droppedCommands() const { return droppedCommands_; }
+  int actuator(size_t index) const { return actuators_[index]; }
+  float temperature() const { return temperature_; }
+  HubDisplay<Config>& display() { return display_; }
+
+  // ----- HubWifi events, on the network task -----
+  void onWifiConnecting() {
+    lcdState_ = CONNECTING_WIFI;
+    postDisplayFrame();
+  }
+
+  void onWifiConnected() {
+    lcdState_ = NORMAL_OPERATION;
+    postDisplayFrame();
+    api_.begin();
+  }
+
+  void onWifiLost() {}
+
+  void onAccessPoint(bool started) {
+    lcdState_ = AP_MODE;
+    postDisplayFrame();
+    if (!started) return;
+
+    // Have the network list ready before the first page load
+    wifiScan_.request();
+    portal_.begin();
+  }
+
+  void onConnectResult(int clientNum, bool success) {
+    sendConnectStatus(clientNum, success ? "connected" : "failed");
+  }
+
+  // ----- API link events, on the network task -----
+  void onApiConnected() {
+    // Command sequence numbers are per connection
+    uplinkCommands_.reset();
+    lastAckSent_ = 0;
+    ackRequested_ = false;
+    // Send initial data upon connection; JSON until the server accepts binary
+    sendDataToServer();
+    // Live data goes first, the backlog follows after Config::backfillInterval
+    lastBackfill_ = millis();
+  }
+
+  void onApiMessage(JsonDocument& doc) {
+    if (doc["action"] == "config") {
+      applyUplinkConfig(doc["payload"]);
+    } else if (doc["action"] == "device_control") {
+      handleDeviceControl(doc["seq"] | (uint32_t)0, doc["payload"]);
+    } else if (doc["device_control"].is<JsonObject>()) {
+      // Bare form used by the other hub firmware
+      handleDeviceControl(doc["seq"] | (uint32_t)0, doc["device_control"]);
+    }
+
+    // {"new_wifi":{"ssid":..,"password":..}}: the portal takes over if it fails
+    if (doc["new_wifi"].is<JsonObject>()) {
+      const char* ssid = doc["new_wifi"]["ssid"] | "";
+      const char* password = doc["new_wifi"]["password"] | "";
+      Serial.printf("Received new WiFi configuration from server: %s\n", ssid);
+      wifi_.request(ssid, strlen(ssid), password, strlen(password), -1);
+    }
+  }
+
+ private:
+  typedef typename std::conditional<Config::localPort != 0, FanoutServer, NullFanoutServer>::type LocalServer;
+  typedef CommandStatus (HubApp::*CommandHandler)(uint8_t clientNum, const Command& command);
+
+  // Latency histograms only fit in a sketch with local clients to ask for them
+  static constexpr size_t PROFILE_SIZE = Config::localPort ? LOOP_STATS_PROFILE_SIZE : 1;
+
+  static uint8_t faderChannel(size_t index) {
+    return index < Config::actuatorCount ? Config::actuatorTable()[index].pwmChannel : 0;
+  }
+
+  static void networkTaskEntry(void* param) { static_cast<HubApp*>(param)->networkTask(); }
+  static void ioTaskEntry(void* param) { static_cast<HubApp*>(param)->ioTask(); }
+  static void displayTaskEntry(void* param) { static_cast<HubApp*>(param)->displayTask(); }
+
+  bool online() const { return wifi_.connected() && api_.connected(); }
+
+  // ===== OUTPUTS =====
+  void setupActuators() {
+    for (size_t i = 0; i < Config::actuatorCount; i++) {
+      const HubActuator& actuator = Config::actuatorTable()[i];
+      pinMode(actuator.pin, OUTPUT);
+      if (actuator.kind == ACTUATOR_SWITCH) {
+        digitalWrite(actuator.pin, LOW);
+        continue;
+      }
+      ledcAttachPin(actuator.pin, actuator.pwmChannel);
+      ledcSetup(actuator.pwmChannel, actuator.pwmFrequency, 8);
+      ledcWrite(actuator.pwmChannel, 0);
+      if (!faders_[i].begin()) {
+        Serial.println("LEDC fade unit unavailable");
+      }
+    }
+  }
+
+  /**
+   * Drives one output. Reported after the output and its state are
+   * updated, so an ack never gets ahead of the telemetry it rides in.
+   */
+  void applyActuatorCommand(const ActuatorCommand& cmd) {
+    if (cmd.target >= Config::actuatorCount) return;
+    const HubActuator& actuator = Config::actuatorTable()[cmd.target];
+    if (actuator.kind == ACTUATOR_LEVEL) {
+      int level = constrain(cmd.value, 0, 255);
+      faders_[cmd.target].fadeTo(level, actuator.fadeTime, actuator.fadeCurve);
+      actuators_[cmd.target] = level;
+    } else {
+      digitalWrite(actuator.pin, cmd.value ? HIGH : LOW);
+      actuators_[cmd.target] = cmd.value != 0;
+    }
+    Serial.printf("%s: %d\n", actuator.name, actuators_[cmd.target]);
+
+    if (cmd.ticket) uplinkCommands_.applied(cmd.target, cmd.ticket);
+  }
+
+  /**
+   * Queues an actuator command for the io task. When the queue is full it
+   * is compacted to the newest command per target, so the latest
+   * set-point always wins. Only commands superseded by a newer one for
+   * the same target are dropped, and the newer one reports the dropped
+   * command's ticket if it has none of its own; a dropped command for
+   * another target would be acknowledged unapplied. Called from the
+   * network task only.
+   */
+  void submitActuatorCommand(uint8_t target, int value, uint32_t ticket = 0) {
+    ActuatorCommand cmd = { target, value, ticket };
+    if (xQueueSend(actuatorQueue_, &cmd, 0) == pdTRUE) return;
+
+    ActuatorCommand pending[HUB_ACTUATOR_QUEUE_LENGTH + 1];
+    size_t count = 0;
+    while (count < HUB_ACTUATOR_QUEUE_LENGTH && xQueueReceive(actuatorQueue_, &pending[count], 0) == pdTRUE) {
+      count++;
+    }
+    pending[count++] = cmd;
+
+    // Queue order is kept, so acks still follow the order commands arrived in
+    size_t kept = 0;
+    for (size_t i = 0; i < count; i++) {
+      bool superseded = false;
+      for (size_t j = i + 1; j < count && !superseded; j++) {
+        superseded = pending[j].target == pending[i].target;
+        if (superseded && !pending[j].ticket) pending[j].ticket = pending[i].ticket;
+      }
+      if (superseded) {
+        droppedCommands_++;
+      } else {
+        pending[kept++] = pending[i];
+      }
+    }
+    // At most one command per target is left, well within the queue length
+    for (size_t i = 0; i < kept; i++) {
+      xQueueSend(actuatorQueue_, &pending[i], 0);
+    }
+  }
+
+  static void submitUplinkSetPoint(uint8_t target, int value, uint32_t ticket) {
+    self_->submitActuatorCommand(target, value, ticket);
+  }
+
+  // Captures the values reported in telemetry frames
+  TelemetrySample currentSample() const {
+    TelemetrySample sample;
+    sample.temperature = temperature_;
+    sample.humidity = humidity_;
+    sample.motion = motionDetected_;
+    sample.led1 = actuators_[0];
+    sample.led2 = actuators_[1] != 0;
+    sample.led3 = actuators_[2] != 0;
+    return sample;
+  }
+
+  // ===== NETWORK TASK =====
+  // Services WiFi, the local WebSocket server and the API link
+  void networkTask() {
+    for (;;) {
+      unsigned long passStart = millis();
+      loopStatsBeginPass();
+
+      // Motion edges go out ahead of everything else
+      publishMotionEvents();
+
+      // Run requested WiFi scans and push finished ones to local clients
+      if (wifiScan_.poll()) {
+        local_.markState(FANOUT_STATE_WIFI_LIST);
+      }
+
+      // Send data to server, or buffer it while the API link is down.
+      // Batches sample at a fixed rate, single frames go out on change.
+      if (telemetryBatch_.enabled()) {
+        if (millis() - lastDataSend_ >= Config::batchSampleInterval) {
+          LOOP_STATS_TIME(REGION_SEND_DATA, sendDataToServer());
+          lastDataSend_ = millis();
+        }
+      } else if (uplinkFilter_.shouldReport(currentSample(), millis())) {
+        LOOP_STATS_TIME(REGION_SEND_DATA, sendDataToServer());
+      }
+
+      if (wifi_.connected()) {
+        LOOP_STATS_TIME(REGION_WEBSOCKET_LOOP, local_.loop());
+        LOOP_STATS_TIME(REGION_WEBSOCKET_FANOUT, local_.service());
+
+        api_.loop();
+
+        // Apply server set-points and acknowledge them
+        uplinkCommands_.flush(millis(), submitUplinkSetPoint);
+        sendCommandAck();
+
+        // Replay buffered samples a batch at a time
+        drainBacklog();
+      }
+
+      // Sample the heap; warnings are reported without waiting for the next diag
+      bool memWarning = memStatsPoll();
+      if (online() && (memWarning || millis() - lastDiag_ >= HUB_DIAG_INTERVAL)) {
+        sendDiag();
+      }
+
+      persistBacklog();
+
+      // Connect, reconnect or fall back to the captive portal
+      wifi_.loop();
+
+      LOOP_STATS_TIME(REGION_BROADCAST_STATUS, broadcastDeviceStatus());
+
+      loopStatsEndPass();
+
+      unsigned long passTime = millis() - passStart;
+      if (passTime > HUB_NET_LOOP_BUDGET) {
+        Serial.printf("Network pass took %lums (budget %dms)\n", passTime, HUB_NET_LOOP_BUDGET);
+      }
+
+      vTaskDelay(pdMS_TO_TICKS(HUB_NET_TASK_PERIOD));
+    }
+  }
+
+  /**
+   * Pushes the device status to local clients when it has changed, or
+   * when the heartbeat is due
+   */
+  void broadcastDeviceStatus() {
+    TelemetrySample sample = currentSample();
+    if (!statusFilter_.shouldReport(sample, millis())) return;
+    statusFilter_.markReported(sample, millis());
+    local_.markState(FANOUT_STATE_STATUS);
+  }
+
+  /**
+   * Sends motion_detected/motion_stopped to local clients and the API
+   * server as soon as the io task reports them.
+   */
+  void publishMotionEvents() {
+    MotionEvent event;
+    while (xQueueReceive(motionEventQueue_, &event, 0) == pdTRUE) {
+      if (!wifi_.connected()) continue;
+
+      char* payload = (char*)txFrame_ + WEBSOCKETS_MAX_HEADER_SIZE;
+      size_t len = writeMotionEventFrame(payload, TELEMETRY_FRAME_SIZE, event.detected,
+                                         millis() - event.timestamp, Config::deviceId());
+      if (!len) continue;
+      // Local clients first: the API client masks the payload in place
+      local_.sendEvent(payload, len);
+      if (api_.connected()) api_.sendText(txFrame_, len);
+    }
+  }
+
+  void sendDataToServer() {
+    if (telemetryBatch_.enabled()) {
+      telemetryBatch_.add(currentSample(), millis());
+      if (telemetryBatch_.ready()) sendBatch();
+      return;
+    }
+
+    TelemetrySample sample = currentSample();
+    uplinkFilter_.markReported(sample, millis());
+
+    if (!online()) {
+      telemetryStore_.push(sample);
+      return;
+    }
+
+    Serial.printf("Sending data to server: %.1f°C, %.1f%%, motion %s\n", sample.temperature,
+                  sample.humidity, sample.motion ? "yes" : "no");
+
+    // A failed send is backfilled like a sample taken while offline
+    if (api_.sendSample(sample)) {
+      bootMark(BOOT_FIRST_TELEMETRY);
+    } else {
+      telemetryStore_.push(sample);
+    }
+  }
+
+  /**
+   * Ships the closed windows as one "batch" frame. While the API link is
+   * down each window goes into the store-and-forward buffer as its mean.
+   */
+  void sendBatch() {
+    if (online()) {
+      char* payload = (char*)bulkFrame_ + WEBSOCKETS_MAX_HEADER_SIZE;
+      size_t len = writeBatchFrame(payload, HUB_BULK_FRAME_SIZE, telemetryBatch_, Config::deviceId());
+      if (api_.sendText(bulkFrame_, len)) {
+        telemetryBatch_.clear();
+        return;
+      }
+    }
+
+    for (size_t i = 0; i < telemetryBatch_.size(); i++) {
+      telemetryStore_.push(batchEntryMean(telemetryBatch_.at(i)));
+    }
+    telemetryBatch_.clear();
+  }
+
+  /**
+   * Applies {"batchWindow":ms,"batchSize":n} from the server and echoes
+   * the settings actually in use. Omitted fields keep their current value.
+   */
+  void applyUplinkConfig(JsonVariantConst config) {
+    uint32_t window = config["batchWindow"] | telemetryBatch_.window();
+    uint8_t size = config["batchSize"] | telemetryBatch_.batchSize();
+    if (window) window = constrain(window, BATCH_WINDOW_MIN, BATCH_WINDOW_MAX);
+
+    // Whatever was collected under the old settings goes out first
+    if (telemetryBatch_.size()) sendBatch();
+    telemetryBatch_.configure(window, size);
+    Serial.printf("Uplink batching: window %lums, %u per frame\n",
+                  (unsigned long)telemetryBatch_.window(), telemetryBatch_.batchSize());
+
+    FrameWriter w((char*)txFrame_ + WEBSOCKETS_MAX_HEADER_SIZE, TELEMETRY_FRAME_SIZE);
+    w.raw("{\"action\":\"config\",\"payload\":{");
+    w.key("batchWindow").integer(telemetryBatch_.window());
+    w.key("batchSize").integer(telemetryBatch_.batchSize());
+    w.raw("}}");
+    api_.sendText(txFrame_, w.finish());
+  }
+
+  /**
+   * Applies {"<actuator>":value,...} from the server; omitted fields are
+   * left alone. Retransmits are not applied again, only acknowledged
+   * again.
+   */
+  void handleDeviceControl(uint32_t seq, JsonVariantConst control) {
+    if (!uplinkCommands_.accept(seq)) {
+      Serial.printf("device_control %lu already seen\n", (unsigned long)seq);
+      ackRequested_ = true;
+      return;
+    }
+
+    applyDeviceControl(Config::actuatorTable(), Config::actuatorCount, control,
+                       [this, seq](uint8_t target, int value) {
+                         uplinkCommands_.set(target, value, seq);
+                       });
+  }
+
+  /**
+   * Sends a telemetry frame carrying the new ack as soon as the commands
+   * behind it are applied, instead of waiting for the next report. Always
+   * JSON and never batched, since only updateenv has an ack field.
+   */
+  void sendCommandAck() {
+    if (!api_.connected()) return;
+    uint32_t ack = uplinkCommands_.ackable();
+    if (ack == 0 || (ack <= lastAckSent_ && !ackRequested_)) return;
+
+    TelemetrySample sample = currentSample();
+    if (api_.sendSample(sample, ack)) {
+      lastAckSent_ = ack;
+      ackRequested_ = false;
+      uplinkFilter_.markReported(sample, millis());
+    }
+  }
+
+  /**
+   * Sends the oldest buffered samples as one "backfill" frame. Runs at
+   * most every Config::backfillInterval so live telemetry and commands
+   * keep flowing; samples are only dropped from the store once sent.
+   */
+  void drainBacklog() {
+    if (!api_.connected() || telemetryStore_.size() == 0) return;
+    if (millis() - lastBackfill_ < Config::backfillInterval) return;
+    lastBackfill_ = millis();
+
+    telemetryStore_.anchorClock();
+    size_t count = min((size_t)BACKFILL_BATCH, telemetryStore_.size());
+    char* payload = (char*)bulkFrame_ + WEBSOCKETS_MAX_HEADER_SIZE;
+    size_t len = writeBackfillFrame(payload, HUB_BULK_FRAME_SIZE, telemetryStore_, count,
+                                    Config::deviceId());
+    if (api_.sendText(bulkFrame_, len)) {
+      telemetryStore_.pop(count);
+      if (telemetryStore_.size() == 0) {
+        Serial.println("Telemetry backlog drained");
+      }
+    }
+  }
+
+  /**
+   * Writes the backlog to SPIFFS at most every Config::persistInterval
+   * while it changes, so a reboot during an outage keeps the samples.
+   */
+  void persistBacklog() {
+    if (!Config::persistBacklog || !spiffsReady_ || !telemetryStore_.dirty()) return;
+    if (millis() - lastPersist_ < Config::persistInterval) return;
+    lastPersist_ = millis();
+
+    telemetryStore_.anchorClock();
+    if (!telemetryStore_.save(SPIFFS, Config::backlogPath())) {
+      Serial.println("Failed to persist telemetry backlog");
+    }
+  }
+
+  /**
+   * Reports heap and stack statistics to the API server:
+   *   {"action":"diag","payload":{"deviceId":..,"uptime":s,"heap":..,...}}
+   */
+  void sendDiag() {
+    lastDiag_ = millis();
+    FrameWriter w((char*)bulkFrame_ + WEBSOCKETS_MAX_HEADER_SIZE, HUB_BULK_FRAME_SIZE);
+    w.raw("{\"action\":\"diag\",\"payload\":{");
+    w.key("deviceId").string(Config::deviceId());
+    w.key("uptime").integer(millis() / 1000);
+    writeBootTimeline(w);
+    api_.writeStats(w);
+    writeMemStats(w);
+    w.raw("}}");
+    api_.sendText(bulkFrame_, w.finish());
+  }
+
+  void handleMetricsRequest(AsyncWebServerRequest* request) {
+    // The async web server serves requests one at a time
+    static char json[HUB_METRICS_JSON_SIZE];
+
+    FrameWriter w(json, sizeof(json));
+    w.raw("{");
+    w.key("uptime").integer(millis() / 1000);
+    writeBootTimeline(w);
+    api_.writeStats(w);
+    writeMemStats(w);
+    w.raw("}");
+    size_t len = w.finish();
+    request->send(len ? 200 : 500, "application/json", len ? json : "{}");
+  }
+
+  // ===== LOCAL CLIENTS =====
+  void onLocalEvent(uint8_t clientNum, WStype_t type, uint8_t* payload, size_t length) {
+    LOOP_STATS_SCOPE(REGION_LOCAL_EVENT);
+    switch (type) {
+      case WStype_CONNECTED: {
+        IPAddress ip = local_.remoteIP(clientNum);
+        Serial.printf("Client [%u] connected from %s\n", clientNum, ip.toString().c_str());
+
+        // Status is only broadcast on change, so new clients get it now
+        local_.markState(FANOUT_STATE_STATUS, clientNum);
+
+        // Send the network list as soon as a client connects
+        wifiScan_.request();
+        local_.markState(FANOUT_STATE_WIFI_LIST, clientNum);
+        break;
+      }
+
+      case WStype_TEXT:
+        Serial.printf("Received from client [%u]: %.*s\n", clientNum, (int)length, (char*)payload);
+        dispatchCommand(clientNum, payload, length, false);
+        break;
+
+      case WStype_BIN:
+        dispatchCommand(clientNum, payload, length, true);
+        break;
+
+      case WStype_DISCONNECTED:
+        Serial.printf("Client [%u] disconnected\n", clientNum);
+        break;
+
+      default:
+        break;
+    }
+  }
+
+  /**
+   * Parses a message from a local client in place, runs its handler and
+   * acknowledges it if the client gave a request ID
+   */
+  void dispatchCommand(uint8_t clientNum, uint8_t* payload, size_t length, bool binary) {
+    // Indexed by CommandOp, like commandSpecs
+    static const CommandHandler handlers[] = {
+      nullptr,
+      &HubApp::handleScanCommand,
+      &HubApp::handleConnectCommand,
+      &HubApp::handleActuatorCommand,  // led1
+      &HubApp::handleActuatorCommand,  // led2
+      &HubApp::handleActuatorCommand,  // led3
+      &HubApp::handleProfileCommand,
+    };
+    static_assert(sizeof(handlers) / sizeof(handlers[0]) == CMD_COUNT, "one handler per command op");
+
+    MemSiteScope memScope(MEM_SITE_LOCAL_COMMAND);
+    Command command;
+    CommandStatus status = parseCommand(payload, length, binary, command);
+    if (status == CMD_OK) {
+      status = (this->*handlers[command.op])(clientNum, command);
+    } else {
+      Serial.printf("Client [%u] sent an invalid command (status %u)\n", clientNum, status);
+    }
+
+    if (command.id == 0) return;
+    char ack[96];
+    size_t len = writeCommandAck(ack, sizeof(ack), command, status);
+    if (len) local_.sendEvent(ack, len, clientNum);
+  }
+
+  // Handlers run on the network task; actuator changes go through the io task
+  CommandStatus handleScanCommand(uint8_t clientNum, const Command& command) {
+    // Cached list now, the fresh one is pushed when the rescan ends
+    wifiScan_.request(true);
+    local_.markState(FANOUT_STATE_WIFI_LIST, clientNum);
+    return CMD_OK;
+  }
+
+  CommandStatus handleConnectCommand(uint8_t clientNum, const Command& command) {
+    bool accepted = wifi_.request(command.ssid.data, command.ssid.length, command.password.data,
+                                  command.password.length, clientNum);
+    // The final result follows once the attempt completes
+    sendConnectStatus(clientNum, accepted ? "connecting" : "failed");
+    return accepted ? CMD_OK : CMD_REJECTED;
+  }
+
+  // led1..led3 drive actuator slots 0..2
+  CommandStatus handleActuatorCommand(uint8_t clientNum, const Command& command) {
+    uint8_t target = command.op - CMD_LED1;
+    if (target >= Config::actuatorCount) return CMD_REJECTED;
+    if (Config::actuatorTable()[target].kind == ACTUATOR_LEVEL) {
+      submitActuatorCommand(target, constrain(command.value, 0, 255));
+    } else {
+      submitActuatorCommand(target, command.value != 0);
+    }
+    return CMD_OK;
+  }
+
+  CommandStatus handleProfileCommand(uint8_t clientNum, const Command& command) {
+    local_.markState(FANOUT_STATE_PROFILE, clientNum);
+    return CMD_OK;
+  }
+
+  // {"action":"connectstatus","payload":"connecting"|"connected"|"failed"}
+  void sendConnectStatus(int clientNum, const char* state) {
+    char frame[64];
+    FrameWriter w(frame, sizeof(frame));
+    w.raw("{\"action\":\"connectstatus\",\"payload\":").string(state).raw("}");
+    size_t len = w.finish();
+    if (len) local_.sendEvent(frame, len, clientNum);
+  }
+
+  // Fan-out renderers, called by the local server on the network task
+  static size_t renderStatusFrame(char* payload, size_t capacity) {
+    return writeStatusFrame(payload, capacity, self_->currentSample());
+  }
+
+  // The cached network list as a "getwifi" frame
+  static size_t renderWifiList(char* payload, size_t capacity) {
+    return self_->wifiScan_.writeJson(payload, capacity, "{\"action\":\"getwifi\",\"payload\":{", "}}");
+  }
+
+  /**
+   * {"action":"profile","payload":{...}} with the histograms of every
+   * timed region, or only their counts if the buckets do not fit
+   */
+  static size_t renderProfile(char* payload, size_t capacity) {
+    for (int buckets = 1; buckets >= 0; buckets--) {
+      FrameWriter w(payload, capacity);
+      w.raw("{\"action\":\"profile\",\"payload\":");
+      loopStatsWriteProfile(w, buckets);
+      w.raw("}");
+      size_t len = w.finish();
+      if (len) return len;
+    }
+    return 0;
+  }
+
+  // ===== IO TASK =====
+  /**
+   * Owns the actuator outputs and the PIR input. Commands arrive through
+   * actuatorQueue_; waiting on it doubles as the polling period.
+   */
+  void ioTask() {
+    unsigned long lastFramePost = 0;
+    ActuatorCommand cmd;
+
+    for (;;) {
+      bool changed = false;
+      if (xQueueReceive(actuatorQueue_, &cmd, pdMS_TO_TICKS(HUB_IO_TASK_PERIOD)) == pdTRUE) {
+        do {
+          applyActuatorCommand(cmd);
+        } while (xQueueReceive(actuatorQueue_, &cmd, 0) == pdTRUE);
+        changed = true;
+      }
+
+      // Chain the next fade segments
+      for (size_t i = 0; i < Config::actuatorCount; i++) {
+        if (Config::actuatorTable()[i].kind == ACTUATOR_LEVEL) faders_[i].update();
+      }
+
+      LOOP_STATS_TIME(REGION_READ_SENSORS, readSensors());
+      if (updateMotion()) changed = true;
+
+      // Regular LCD updates
+      if (changed || millis() - lastFramePost >= Config::lcdUpdateInterval) {
+        postDisplayFrame();
+        lastFramePost = millis();
+      }
+    }
+  }
+
+  // Picks up the latest temperature and humidity from the sampler task
+  void readSensors() {
+    DhtReading reading;
+    if (dht_.read(reading)) {
+      temperature_ = reading.temperature;
+      humidity_ = reading.humidity;
+    }
+  }
+
+  /**
+   * Applies the PIR edges captured by the interrupt. Motion starts on a
+   * rising edge and stops Config::motionTimeout after the output last
+   * went low, so a retriggering PIR does not produce stop/start pairs.
+   * Returns true if motionDetected_ changed.
+   */
+  bool updateMotion() {
+    bool changed = false;
+    MotionEdge edge;
+    while (motionSensor_.nextEdge(edge)) {
+      pirActive_ = edge.level;
+      lastMotionTime_ = edge.timestamp;
+      if (edge.level && !motionDetected_) {
+        motionDetected_ = true;
+        setMotionLed(true);
+        postMotionEvent(true, edge.timestamp);
+        changed = true;
+      }
+    }
+
+    if (motionDetected_ && !pirActive_ && millis() - lastMotionTime_ >= Config::motionTimeout) {
+      motionDetected_ = false;
+      setMotionLed(false);
+      postMotionEvent(false, lastMotionTime_ + Config::motionTimeout);
+      changed = true;
+    }
+    return changed;
+  }
+
+  void setMotionLed(bool on) {
+    if (Config::motionLedPin != HUB_NO_PIN) digitalWrite(Config::motionLedPin, on ? HIGH : LOW);
+  }
+
+  void postMotionEvent(bool detected, uint32_t timestamp) {
+    MotionEvent event = { detected, timestamp };
+    xQueueSend(motionEventQueue_, &event, 0);
+  }
+
+  // ===== DISPLAY TASK =====
+  /**
+   * Hands the current screen contents to the display task. The queue
+   * holds a single frame, so a newer frame replaces one not drawn yet.
+   */
+  void postDisplayFrame() {
+    DisplayFrame frame;
+    frame.state = lcdState_;
+    frame.temperature = temperature_;
+    frame.humidity = humidity_;
+    frame.motion = motionDetected_;
+    frame.wifiConnected = wifi_.connected();
+    memcpy(frame.actuators, actuators_, sizeof(frame.actuators));
+    xQueueOverwrite(displayQueue_, &frame);
+  }
+
+  /**
+   * Draws posted frames, alternates the sensor and device screens when
+   * the sketch has both, and runs the loading animation while connecting.
+   */
+  void displayTask() {
+    DisplayFrame frame;
+    frame.state = STARTING;
+    bool devicePage = false;
+    unsigned long lastAnimationUpdate = 0;
+    unsigned long lastPageChange = 0;
+
+    for (;;) {
+      bool redraw = false;
+      if (xQueueReceive(displayQueue_, &frame, pdMS_TO_TICKS(Config::animationInterval)) == pdTRUE) {
+        redraw = true;
+      }
+
+      if (Config::displayPageInterval && HubDisplay<Config>::hasDevicePage() &&
+          millis() - lastPageChange >= Config::displayPageInterval) {
+        devicePage = !devicePage && frame.state == NORMAL_OPERATION;
+        lastPageChange = millis();
+        redraw = true;
+      }
+
+      if (redraw) {
+        LOOP_STATS_TIME(REGION_UPDATE_LCD, display_.draw(frame, devicePage));
+      }
+
+      // Loading animation for connecting screens
+      if ((frame.state == CONNECTING_WIFI || frame.state == STARTING) &&
+          millis() - lastAnimationUpdate >= Config::animationInterval) {
+        display_.animate();
+        lastAnimationUpdate = millis();
+      }
+    }
+  }
+
+  static HubApp* self_;  // For the plain function callbacks
+
+  // Sensor and actuator state is written by the io task and only read elsewhere
+  float temperature_;
+  float humidity_;
+  bool motionDetected_;
+  int actuators_[HUB_MAX_ACTUATORS];  // Levels 0-255, switches 0/1
+  volatile LcdState lcdState_;        // Written by the network task
+  unsigned long lastMotionTime_;      // Last PIR edge
+  bool pirActive_;                    // PIR output level after the last edge
+
+  QueueHandle_t actuatorQueue_;
+  QueueHandle_t displayQueue_;
+  QueueHandle_t motionEventQueue_;
+  uint32_t droppedCommands_;
+
+  // Owned by the network task from here on.
+  // device_control commands from the API server; the io task reports
+  // back every set-point it has applied.
+  UplinkCommandPipeline uplinkCommands_;
+  uint32_t lastAckSent_;
+  bool ackRequested_;  // Resend the ack even if it has not moved
+  unsigned long lastDataSend_;
+  unsigned long lastDiag_;
+  unsigned long lastBackfill_;
+  unsigned long lastPersist_;
+  bool spiffsReady_;
+
+  // Samples taken while the API link is down, drained once it is back
+  TelemetryStore telemetryStore_;
+  TelemetryBatch telemetryBatch_;
+  // Change detection for the API uplink and the local status broadcast
+  ReportFilter uplinkFilter_;
+  ReportFilter statusFilter_;
+  // Nearby networks, shared by /scan and the local WebSocket clients
+  WifiScanService wifiScan_;
+
+  // Outgoing frames, built one at a time. The leading bytes are left for
+  // the WebSocket header so header and payload go out in one write.
+  uint8_t txFrame_[WEBSOCKETS_MAX_HEADER_SIZE + TELEMETRY_FRAME_SIZE];
+  uint8_t bulkFrame_[WEBSOCKETS_MAX_HEADER_SIZE + HUB_BULK_FRAME_SIZE];
+  uint8_t profileFrame_[WEBSOCKETS_MAX_HEADER_SIZE + PROFILE_SIZE];
+
+  DhtSampler dht_;
+  MotionSensor motionSensor_;
+  PwmFader faders_[HUB_MAX_ACTUATORS];  // Level actuators only, owned by the io task
+  HubDisplay<Config> display_;          // Owned by the display task after begin()
+  HubWifi<Config, HubApp> wifi_;
+  HubPortal<HubWifi<Config, HubApp>> portal_;
+  HubApiLink<Config, HubApp> api_;
+  LocalServer local_;
+};
+
+template <class Config>
+HubApp<Config>* HubApp<Config>::self_ = nullptr;
+
+template <class Config>
+constexpr size_t HubApp<Config>::PROFILE_SIZE;
+
+#endif // HUB_APP_H
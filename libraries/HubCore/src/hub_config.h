@@ -0,0 +1,123 @@
+/*
+ * Compile-time configuration for sketches built on HubCore
+ *
+ * A sketch describes itself with a struct derived from HubDefaults and
+ * overrides only what differs, usually its pins, its transport and its
+ * actuators:
+ *
+ *   constexpr HubActuator actuators[] = {
+ *     { "fan", ACTUATOR_LEVEL, 25, 0, 1000, 1000, FADE_EASE_IN_OUT, 'F', "F", GLYPH_FAN },
+ *   };
+ *
+ *   struct HubConfig : HubDefaults {
+ *     static constexpr uint8_t dhtPin = 14;
+ *     static constexpr HubTransport transport = HubTransport::Http;
+ *     static const char* endpoint() { return "http://host/data"; }
+ *     static constexpr const HubActuator* actuatorTable() { return actuators; }
+ *     static constexpr size_t actuatorCount = sizeof(actuators) / sizeof(actuators[0]);
+ *   };
+ *
+ * The templates in HubCore take that struct as a parameter, so features a
+ * sketch does not select are never compiled into it and the settings it
+ * does select fold into constants.
+ */
+#ifndef HUB_CONFIG_H
+#define HUB_CONFIG_H
+
+#include <Arduino.h>
+#include "trust_anchors.h"
+#include "actuator_map.h"
+
+#define HUB_NO_PIN 0xFF  // For optional pins
+
+enum class HubTransport : uint8_t {
+  Http,       // One POST per report, commands in the response
+  WebSocket   // Persistent connection, commands pushed by the server
+};
+
+struct HubDefaults {
+  // ----- Hardware -----
+  static constexpr uint8_t dhtPin = 26;
+  static constexpr uint8_t dhtType = 11;            // DHT11
+  static constexpr uint8_t pirPin = 25;
+  static constexpr uint8_t motionLedPin = HUB_NO_PIN;  // Lit while motion is detected
+  static constexpr uint8_t lcdAddress = 0x27;
+  static constexpr uint32_t lcdClock = 400000;      // PCF8574 is rated for 100 kHz; most backpacks run at 400 kHz
+  // Stream LCD bytes through the AsyncLcd writer task instead of writing
+  // them from the display task
+  static constexpr bool asyncLcd = false;
+  // device_control fields and their outputs, in telemetry order (see
+  // HubActuator); none by default
+  static constexpr const HubActuator* actuatorTable() { return nullptr; }
+  static constexpr size_t actuatorCount = 0;
+
+  // ----- Local clients -----
+  static const char* apSsid() { return "Smart Home Hub"; }
+  static const char* apPassword() { return ""; }
+  // WebSocket server for local clients (see command_protocol.h), 0 for none
+  static constexpr uint16_t localPort = 0;
+
+  // ----- Timing (ms) -----
+  static constexpr uint32_t motionTimeout = 5000;        // Hold after the PIR output drops
+  static constexpr uint32_t dataSendInterval = 60000;    // Longest gap between API updates
+  static constexpr uint32_t lcdUpdateInterval = 2000;
+  static constexpr uint32_t animationInterval = 250;     // Loading animation frames
+  static constexpr uint32_t displayPageInterval = 0;     // Sensor and device screens alternate, 0 for sensors only
+  static constexpr uint32_t dhtSampleInterval = 2000;
+  static constexpr uint32_t pingInterval = 30000;        // API WebSocket keep-alive
+
+  // ----- Report by exception -----
+  // Frames go out when a value moves past its deadband or motion or an
+  // actuator changes, and at least once per heartbeat otherwise
+  static constexpr float tempDeadband = 0.3f;            // °C
+  static constexpr float humDeadband = 2.0f;             // %
+  static constexpr uint32_t statusHeartbeat = 30000;     // Longest gap between local status frames
+  static constexpr uint32_t reportMinInterval = 250;     // Coalesces bursts such as slider drags
+
+  // ----- Batched uplink -----
+  // Window and batch size can be changed by the server with
+  // {"action":"config","payload":{"batchWindow":ms,"batchSize":n}}
+  static constexpr uint32_t batchWindow = 0;             // Aggregation window, 0 sends every sample
+  static constexpr uint8_t batchSize = 6;                // Windows per batch frame
+  static constexpr uint32_t batchSampleInterval = 2000;  // Sampling period while batching
+
+  // ----- Store and forward -----
+  static constexpr uint32_t backfillInterval = 500;      // Minimum gap between backfill frames
+  static constexpr bool persistBacklog = true;           // Keep the backlog in SPIFFS across reboots
+  static constexpr uint32_t persistInterval = 60000;     // Backlog flush period while it changes
+  static const char* backlogPath() { return "/backlog.bin"; }
+  static const char* ntpServer() { return "pool.ntp.org"; }
+
+  // ----- WiFi station -----
+  static constexpr uint32_t wifiSettleTime = 500;        // Wait after WiFi.disconnect()
+  static constexpr uint32_t wifiConnectTimeout = 10000;  // A full scan-and-DHCP connection
+  static constexpr uint32_t wifiFastConnectTimeout = 2000;  // A connection with cached AP and lease
+  static constexpr uint32_t leaseCheckInterval = 10000;  // DHCP lease checks while connected
+  static constexpr uint32_t leaseMax = 604800;           // Longest lease cached, for "infinite" ones (s)
+
+  // ----- API server -----
+  static constexpr HubTransport transport = HubTransport::WebSocket;
+  // Offer binary telemetry frames in the WebSocket hello handshake
+  static constexpr bool binaryUplink = false;
+  // Longest blocking connect or response wait on the HTTP transport (ms)
+  static constexpr uint16_t httpTimeout = 2000;
+  // API WebSocket reconnects (see reconnect_policy.h): the random wait
+  // doubles from reconnectBase up to reconnectCap, and starts over once a
+  // connection has lasted reconnectStable. An attempt that has neither
+  // connected nor failed after reconnectTimeout counts as failed. (ms)
+  static constexpr uint32_t reconnectBase = 1000;
+  static constexpr uint32_t reconnectCap = 60000;
+  static constexpr uint32_t reconnectStable = 30000;
+  static constexpr uint32_t reconnectTimeout = 5000;
+
+  static const char* endpoint() { return ""; }
+  static const char* deviceId() { return "esp32-smart-hub"; }
+  // Trust for wss:// endpoints (see secure_ws_client.h): a root CA in PEM
+  // and/or a base64 SHA-256 public key pin. The default trusts the Let's
+  // Encrypt roots (trust_anchors.h); returning nullptr from both is an
+  // explicit opt-out that leaves the server unchecked.
+  static const char* apiRootCA() { return ISRG_ROOTS_PEM; }
+  static const char* apiKeyPin() { return nullptr; }
+};
+
+#endif // HUB_CONFIG_H
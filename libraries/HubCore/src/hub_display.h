@@ -0,0 +1,262 @@
+/*
+ * The hub's LCD screens, shared by every sketch
+ *
+ * Screens are drawn from a DisplayFrame snapshot into an LcdBuffer, so
+ * only changed cells go out over I2C, with their icons placed in CGRAM by
+ * a GlyphCache. In normal operation the sensor screen shows the climate,
+ * motion and one mark per actuator that is on. A sketch that sets
+ * Config::displayPageInterval alternates it with a device screen, which
+ * lists the level or state of every actuator that has a label.
+ *
+ * With Config::asyncLcd the bytes go through the AsyncLcd writer task;
+ * otherwise the caller's task writes them, which suits a sketch that
+ * already draws from a task of its own.
+ */
+#ifndef HUB_DISPLAY_H
+#define HUB_DISPLAY_H
+
+#include <Arduino.h>
+#include <Wire.h>
+#include <LiquidCrystal_I2C.h>
+#include <type_traits>
+#include "hub_config.h"
+#include "lcd_buffer.h"
+#include "glyph_cache.h"
+#include "async_lcd.h"
+
+enum LcdState : uint8_t {
+  STARTING, CONNECTING_WIFI, AP_MODE, NORMAL_OPERATION, API_ERROR, SENSOR_ERROR
+};
+
+// Snapshot of everything the LCD shows
+struct DisplayFrame {
+  LcdState state;
+  float temperature;
+  float humidity;
+  bool motion;
+  bool wifiConnected;
+  int actuators[HUB_MAX_ACTUATORS];  // Indexed like Config::actuatorTable()
+};
+
+template <class Config>
+class HubDisplay {
+ public:
+  HubDisplay()
+    : panel_(Config::lcdAddress, LCD_COLS, LCD_ROWS), writer_(Config::lcdAddress),
+      animationFrame_(0) {}
+
+  /**
+   * Initialises the panel and shows the splash screen for a second. The
+   * sensor and loading icons are loaded first, in slots 0-7, and stay
+   * resident unless a device screen needs the room.
+   */
+  void begin() {
+    static const Glyph resident[] = {
+      GLYPH_WIFI, GLYPH_AP, GLYPH_TEMP, GLYPH_HUMIDITY, GLYPH_MOTION,
+      GLYPH_LOADING1, GLYPH_LOADING2, GLYPH_LOADING3
+    };
+
+    panel_.init();
+    panel_.backlight();
+    if (Config::asyncLcd) {
+      writer_.begin(Config::lcdClock);
+    } else {
+      Wire.setClock(Config::lcdClock);
+    }
+    glyphs_.begin(sink());
+    glyphs_.beginScreen(resident, sizeof(resident) / sizeof(resident[0]));
+
+    drawSplash(" Starting...");
+    flush();
+    delay(1000);
+    // The next screen is drawn in full
+    screen_.invalidate();
+  }
+
+  // Draws frame; devicePage picks the device screen in normal operation
+  void draw(const DisplayFrame& frame, bool devicePage = false) {
+    switch (frame.state) {
+      case STARTING:
+        drawSplash(" Starting...");
+        break;
+
+      case CONNECTING_WIFI:
+        beginLoadingScreen();
+        screen_.setCursor(0, 0);
+        screen_.print("Connecting WiFi");
+        screen_.setCursor(0, 1);
+        screen_.print("Please wait....");
+        break;
+
+      case AP_MODE: {
+        static const Glyph needed[] = { GLYPH_AP };
+        beginScreen(needed, 1);
+        screen_.setCursor(0, 0);
+        drawGlyph(GLYPH_AP);
+        screen_.print(" Setup Mode");
+        screen_.setCursor(0, 1);
+        screen_.print(Config::apSsid());
+        break;
+      }
+
+      case NORMAL_OPERATION:
+        if (devicePage) {
+          drawDevices(frame);
+        } else {
+          drawSensors(frame);
+        }
+        break;
+
+      case API_ERROR:
+        beginScreen(nullptr, 0);
+        screen_.setCursor(0, 0);
+        screen_.print("API Connection");
+        screen_.setCursor(0, 1);
+        screen_.print("Failed!");
+        break;
+
+      case SENSOR_ERROR:
+        beginScreen(nullptr, 0);
+        screen_.setCursor(0, 0);
+        screen_.print("Sensor Error");
+        screen_.setCursor(0, 1);
+        screen_.print("Check DHT11");
+        break;
+    }
+    flush();
+  }
+
+  // Advances the loading animation in the bottom right corner
+  void animate() {
+    animationFrame_ = (animationFrame_ + 1) % 3;
+    screen_.setCursor(15, 1);
+    drawGlyph((Glyph)(GLYPH_LOADING1 + animationFrame_));
+    flush();
+  }
+
+  // Whether any actuator is on the device screen
+  static bool hasDevicePage() {
+    for (size_t i = 0; i < Config::actuatorCount; i++) {
+      if (Config::actuatorTable()[i].label) return true;
+    }
+    return false;
+  }
+
+ private:
+  typedef typename std::conditional<Config::asyncLcd, AsyncLcd, LiquidCrystal_I2C>::type Sink;
+
+  Sink& sink() { return sink(std::integral_constant<bool, Config::asyncLcd>()); }
+  AsyncLcd& sink(std::true_type) { return writer_; }
+  LiquidCrystal_I2C& sink(std::false_type) { return panel_; }
+
+  // Clears the shadow buffer and makes the listed glyphs resident
+  void beginScreen(const Glyph* needed, size_t count) {
+    screen_.clear();
+    glyphs_.beginScreen(needed, count);
+  }
+
+  // A screen with the loading animation in its corner
+  void beginLoadingScreen() {
+    static const Glyph needed[] = { GLYPH_LOADING1, GLYPH_LOADING2, GLYPH_LOADING3 };
+    beginScreen(needed, 3);
+  }
+
+  void drawGlyph(Glyph glyph) {
+    screen_.write(glyphs_.slotFor(glyph));
+  }
+
+  void drawSplash(const char* status) {
+    beginLoadingScreen();
+    screen_.setCursor(0, 0);
+    screen_.print(" Smart Home Hub ");
+    screen_.setCursor(0, 1);
+    screen_.print(status);
+  }
+
+  void drawSensors(const DisplayFrame& frame) {
+    static const Glyph needed[] = { GLYPH_WIFI, GLYPH_AP, GLYPH_TEMP, GLYPH_HUMIDITY, GLYPH_MOTION };
+    beginScreen(needed, sizeof(needed) / sizeof(needed[0]));
+
+    // First row: WiFi status, temperature and motion
+    drawGlyph(frame.wifiConnected ? GLYPH_WIFI : GLYPH_AP);
+    screen_.setCursor(2, 0);
+    drawGlyph(GLYPH_TEMP);
+    printReading(frame.temperature, "C");
+    if (frame.motion) {
+      screen_.setCursor(15, 0);
+      drawGlyph(GLYPH_MOTION);
+    }
+
+    // Second row: humidity and which actuators are on
+    screen_.setCursor(2, 1);
+    drawGlyph(GLYPH_HUMIDITY);
+    printReading(frame.humidity, "%");
+    if (Config::actuatorCount) {
+      screen_.setCursor(10, 1);
+      screen_.print("L:");
+      for (size_t i = 0; i < Config::actuatorCount; i++) {
+        char symbol = Config::actuatorTable()[i].symbol;
+        if (frame.actuators[i] <= 0) {
+          symbol = '-';
+        } else if (!symbol) {
+          symbol = '1' + i;
+        }
+        screen_.write(symbol);
+      }
+    }
+  }
+
+  // Two actuators per row, 8 cells each: icon, label, level or state
+  void drawDevices(const DisplayFrame& frame) {
+    Glyph needed[HUB_MAX_ACTUATORS];
+    size_t count = 0;
+    for (size_t i = 0; i < Config::actuatorCount; i++) {
+      Glyph glyph = Config::actuatorTable()[i].glyph;
+      if (glyph != GLYPH_NONE) needed[count++] = glyph;
+    }
+    beginScreen(needed, count);
+
+    size_t cell = 0;
+    for (size_t i = 0; i < Config::actuatorCount; i++) {
+      const HubActuator& actuator = Config::actuatorTable()[i];
+      if (!actuator.label) continue;
+      screen_.setCursor((cell % 2) * 8, cell / 2);
+      cell++;
+      if (actuator.glyph != GLYPH_NONE) drawGlyph(actuator.glyph);
+      screen_.print(actuator.label);
+      screen_.print(":");
+      if (actuator.kind == ACTUATOR_LEVEL) {
+        screen_.print(frame.actuators[i] * 100 / 255);
+        screen_.print("%");
+      } else {
+        screen_.print(frame.actuators[i] ? "ON" : "OFF");
+      }
+    }
+  }
+
+  void printReading(float value, const char* unit) {
+    if (isnan(value)) {
+      screen_.print("--.-");
+    } else {
+      screen_.print(value, 1);
+    }
+    screen_.print(unit);
+  }
+
+  void flush() {
+    // Bytes the writer had no room for last time: redraw glyphs and cells
+    if (Config::asyncLcd && writer_.takeOverflow()) {
+      glyphs_.reload();
+      screen_.invalidate();
+    }
+    screen_.flushTo(sink());
+  }
+
+  LiquidCrystal_I2C panel_;  // Only initialises the panel when asyncLcd is set
+  AsyncLcd writer_;          // Not started unless asyncLcd is set
+  LcdBuffer screen_;         // Shadow of the LCD contents
+  GlyphCache glyphs_;
+  uint8_t animationFrame_;
+};
+
+#endif // HUB_DISPLAY_H
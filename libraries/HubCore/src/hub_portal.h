@@ -0,0 +1,136 @@
+/*
+ * Captive portal web server
+ *
+ * Serves the portal page (portal_page.cpp) and the routes it uses to pick
+ * a network: /scan lists the networks from the shared WifiScanService,
+ * /connect queues the credentials with the HubWifi state machine and
+ * /status reports how that attempt went. The routes operating systems
+ * probe to detect a captive portal redirect to the page.
+ *
+ * The server is started the first time the access point comes up and
+ * keeps running; other routes can be added through server().
+ */
+#ifndef HUB_PORTAL_H
+#define HUB_PORTAL_H
+
+#include <Arduino.h>
+#include <AsyncTCP.h>
+#include <ESPAsyncWebServer.h>
+#include "hub_wifi.h"
+#include "wifi_scan.h"
+#include "mem_stats.h"
+#include "portal_page.h"
+#include "portal_gz.h"
+
+template <class Wifi>
+class HubPortal {
+ public:
+  HubPortal(Wifi& wifi, WifiScanService& scan)
+    : wifi_(wifi), scan_(scan), server_(80), started_(false) {}
+
+  AsyncWebServer& server() { return server_; }
+
+  // Adds the portal routes and starts the server; later calls do nothing
+  void begin() {
+    if (started_) return;
+    started_ = true;
+
+    // Captive portal detection routes
+    static const char* const probes[] = {
+      "/generate_204", "/connecttest.txt", "/hotspot-detect.html", "/fwlink"
+    };
+    for (const char* probe : probes) {
+      server_.on(probe, HTTP_GET, [](AsyncWebServerRequest* request) {
+        request->redirect("http://4.3.2.1");
+      });
+    }
+
+    // WiFi scanning and connection routes
+    server_.on("/scan", HTTP_GET, [this](AsyncWebServerRequest* request) { handleScan(request); });
+    server_.on("/connect", HTTP_POST, [this](AsyncWebServerRequest* request) { handleConnect(request); });
+    server_.on("/status", HTTP_GET, [this](AsyncWebServerRequest* request) { handleStatus(request); });
+
+    // Main page
+    server_.on("/", HTTP_GET, handlePage);
+
+    // Anything else goes to the main page
+    server_.onNotFound([](AsyncWebServerRequest* request) {
+      request->redirect("/");
+    });
+
+    server_.begin();
+  }
+
+ private:
+  /**
+   * Serves the page pre-compressed from flash (see tools/build_portal.py).
+   * Clients holding the current copy get a 304.
+   */
+  static void handlePage(AsyncWebServerRequest* request) {
+    if (request->hasHeader("If-None-Match") &&
+        request->header("If-None-Match") == PORTAL_HTML_ETAG) {
+      AsyncWebServerResponse* response = request->beginResponse(304);
+      response->addHeader("ETag", PORTAL_HTML_ETAG);
+      request->send(response);
+      return;
+    }
+
+    AsyncWebServerResponse* response;
+    if (request->hasHeader("Accept-Encoding") &&
+        request->header("Accept-Encoding").indexOf("gzip") >= 0) {
+      response = request->beginResponse_P(200, "text/html", portal_html_gz, portal_html_gz_len);
+      response->addHeader("Content-Encoding", "gzip");
+    } else {
+      response = request->beginResponse(200, "text/html", portal_html);
+    }
+    // Revalidate on every load so a firmware update is picked up at once
+    response->addHeader("Cache-Control", "no-cache");
+    response->addHeader("ETag", PORTAL_HTML_ETAG);
+    request->send(response);
+  }
+
+  void handleScan(AsyncWebServerRequest* request) {
+    // The async web server serves requests one at a time
+    static char json[WIFI_SCAN_JSON_SIZE];
+    MemSiteScope memScope(MEM_SITE_HTTP_SCAN);
+
+    scan_.request();
+    size_t len = scan_.writeJson(json, sizeof(json), "{", "}");
+    request->send(200, "application/json", len ? json : "{\"networks\":[],\"scanning\":true}");
+  }
+
+  void handleConnect(AsyncWebServerRequest* request) {
+    MemSiteScope memScope(MEM_SITE_HTTP_CONNECT);
+    String ssid, password;
+    if (request->hasParam("ssid", true)) {
+      ssid = request->getParam("ssid", true)->value();
+    }
+    if (request->hasParam("password", true)) {
+      password = request->getParam("password", true)->value();
+    }
+
+    bool accepted = wifi_.request(ssid.c_str(), ssid.length(), password.c_str(), password.length(), -1);
+    String response = "{\"success\":" + String(accepted ? "true" : "false") + ",\"pending\":true}";
+    request->send(200, "application/json", response);
+  }
+
+  void handleStatus(AsyncWebServerRequest* request) {
+    MemSiteScope memScope(MEM_SITE_HTTP_STATUS);
+    const char* state = "idle";
+    switch (wifi_.result()) {
+      case CONNECT_PENDING: state = "connecting"; break;
+      case CONNECT_OK:      state = "connected"; break;
+      case CONNECT_FAILED:  state = "failed"; break;
+      default: break;
+    }
+    String response = String("{\"state\":\"") + state + "\"}";
+    request->send(200, "application/json", response);
+  }
+
+  Wifi& wifi_;
+  WifiScanService& scan_;
+  AsyncWebServer server_;
+  bool started_;
+};
+
+#endif // HUB_PORTAL_H
@@ -0,0 +1,128 @@
+/*
+ * API uplink transports, selected by HubConfig::transport
+ *
+ *   HubUplink<HubConfig> uplink(...);
+ *
+ * names HttpUplink or WebSocketUplink. Only the selected one is
+ * instantiated; the other costs nothing in the sketch that does not use
+ * it.
+ */
+#ifndef HUB_UPLINK_H
+#define HUB_UPLINK_H
+
+#include <Arduino.h>
+#include <HTTPClient.h>
+#include <WebSocketsClient.h>
+#include <type_traits>
+#include "hub_config.h"
+#include "telemetry_frame.h"
+#include "binary_telemetry.h"
+
+/**
+ * One POST per report. The connection is kept open between posts when
+ * the server allows it, so a report no longer pays for a TCP (and TLS)
+ * handshake every time.
+ */
+template <class Config>
+class HttpUplink {
+ public:
+  HttpUplink() : configured_(false) {}
+
+  /**
+   * POSTs a JSON body to Config::endpoint(). On HTTP 200 the response
+   * body is stored in *response if given. Returns the status code, or a
+   * negative HTTPC_ERROR_* code when the request could not be made.
+   */
+  int post(const char* body, size_t length, String* response = nullptr) {
+    if (!configured_) {
+      http_.setReuse(true);
+      http_.setConnectTimeout(Config::httpTimeout);
+      http_.setTimeout(Config::httpTimeout);
+      configured_ = true;
+    }
+    if (!http_.begin(Config::endpoint())) return HTTPC_ERROR_CONNECTION_REFUSED;
+    http_.addHeader("Content-Type", "application/json");
+
+    int code = http_.POST((uint8_t*)body, length);
+    if (code == HTTP_CODE_OK && response) *response = http_.getString();
+    // Leaves the socket open for the next post unless the server closed it
+    http_.end();
+    return code;
+  }
+
+ private:
+  HTTPClient http_;
+  bool configured_;
+};
+
+/**
+ * Telemetry over the persistent API WebSocket. Frames are built in a
+ * caller-owned buffer whose first WEBSOCKETS_MAX_HEADER_SIZE bytes are
+ * left for the WebSocket header, so the library sends header and payload
+ * in one write. Binary frames are used only when Config::binaryUplink is
+ * set and the server accepted them for this connection.
+ */
+template <class Config>
+class WebSocketUplink {
+ public:
+  WebSocketUplink(WebSocketsClient& client, uint8_t* frame, size_t capacity)
+    : client_(client), frame_(frame), capacity_(capacity - WEBSOCKETS_MAX_HEADER_SIZE),
+      binary_(false) {}
+
+  // Call on every new connection: frames are JSON until the server accepts binary
+  void reset() {
+    binary_ = false;
+    encoder_.reset();
+  }
+
+  // Binary format version to offer in the hello handshake, 0 for none
+  static int offeredVersion() {
+    return Config::binaryUplink ? BINARY_TELEMETRY_VERSION : 0;
+  }
+
+  // Applies the version the server accepted in its hello reply
+  void accept(int version) {
+    binary_ = Config::binaryUplink && version == BINARY_TELEMETRY_VERSION;
+  }
+
+  bool binary() const { return binary_; }
+
+  // Payload area for JSON frames written by the caller; see sendText()
+  char* payload() { return (char*)frame_ + WEBSOCKETS_MAX_HEADER_SIZE; }
+  size_t capacity() const { return capacity_; }
+
+  bool sendText(size_t length) {
+    return length && client_.sendTXT(frame_, length, true);
+  }
+
+  /**
+   * Sends one sample. Frames that acknowledge commands are always JSON,
+   * since only updateenv has an ack field. After a failed binary send
+   * the next frame is a key frame.
+   */
+  bool sendSample(const TelemetrySample& sample, uint32_t ack = 0) {
+    if (binary_ && ack == 0) {
+      size_t length = encoder_.encode(sample, (uint8_t*)payload(), capacity_);
+      if (length && client_.sendBIN(frame_, length, true)) return true;
+      // The encoder has moved on to this sample, which the server never
+      // got; a delta on top of it would decode wrong, so start over
+      encoder_.reset();
+      return false;
+    }
+    return sendText(writeUpdateEnvFrame(payload(), capacity_, sample, Config::deviceId(), ack));
+  }
+
+ private:
+  WebSocketsClient& client_;
+  uint8_t* frame_;
+  size_t capacity_;
+  BinaryTelemetryEncoder encoder_;
+  bool binary_;
+};
+
+template <class Config>
+using HubUplink = typename std::conditional<Config::transport == HubTransport::Http,
+                                            HttpUplink<Config>,
+                                            WebSocketUplink<Config>>::type;
+
+#endif // HUB_UPLINK_H
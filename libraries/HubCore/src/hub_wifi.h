@@ -0,0 +1,447 @@
+/*
+ * WiFi station and captive portal access point
+ *
+ * Connects to the saved networks (see credential_store.h), most recently
+ * used first and with the cached AP and lease where it can, and falls
+ * back to an access point with a captive DNS server when none of them
+ * connects. New credentials from the portal page, a local client or the
+ * API server are queued with request() from any task.
+ *
+ * Everything else runs in loop(), which never waits: the state machine
+ * checks its timeouts on every pass of the owner task. The owner is told
+ * about each transition through its Listener:
+ *
+ *   void onWifiConnecting();                    // Attempt on a new request
+ *   void onWifiConnected();                     // Station has an IP address
+ *   void onWifiLost();
+ *   void onAccessPoint(bool started);           // Portal pending, then up
+ *   void onConnectResult(int clientNum, bool success);
+ */
+#ifndef HUB_WIFI_H
+#define HUB_WIFI_H
+
+#include <Arduino.h>
+#include <WiFi.h>
+#include <DNSServer.h>
+#include <atomic>
+#include <esp_wifi.h>
+#include <esp_netif.h>
+#include <esp_netif_net_stack.h>
+#include <lwip/dhcp.h>
+#include "hub_config.h"
+#include "credential_store.h"
+#include "telemetry_store.h"
+#include "boot_timeline.h"
+
+#define HUB_WIFI_FLAG_GOT_IP 0x01
+#define HUB_WIFI_FLAG_LOST 0x02
+
+enum WifiConnectResult : uint8_t {
+  CONNECT_NONE, CONNECT_PENDING, CONNECT_OK, CONNECT_FAILED
+};
+
+// Captive portal address, also what the portal's detection routes redirect to
+static const IPAddress hubPortalIP(4, 3, 2, 1);
+
+template <class Config, class Listener>
+class HubWifi {
+ public:
+  explicit HubWifi(Listener& listener)
+    : listener_(listener), state_(CONNECTING), stateSince_(0), connected_(false),
+      result_(CONNECT_NONE), events_(0), requests_(nullptr), pendingClient_(-1),
+      portalStarted_(false), candidate_(-1), fastAttempt_(false), usedLease_(false),
+      leaseExpires_(0), leasePending_(false) {
+    self_ = this;
+  }
+
+  /**
+   * Starts connecting to the saved networks, or shuts the station down
+   * for the portal when there are none. Association runs in the
+   * background; loop() carries it on.
+   */
+  void begin() {
+    requests_ = xQueueCreate(1, sizeof(Request));
+    listener_.onWifiConnecting();
+
+    WiFi.onEvent(onEvent);
+    credentials_.begin();
+    if (credentials_.count() == 0) importDriverCredentials();
+
+    // The credential store and the state machine own reconnects; keep the
+    // core from writing its own copy to flash or reconnecting behind them
+    WiFi.persistent(false);
+    WiFi.setAutoReconnect(false);
+
+    if (credentials_.count() == 0) {
+      Serial.println("No saved networks");
+      startPortal();
+      return;
+    }
+    candidate_ = 0;
+    fastAttempt_ = true;
+    beginAttempt();
+  }
+
+  /**
+   * Queues a connection attempt for the owner task and returns at once.
+   * clientNum is handed back in onConnectResult(), -1 for none.
+   */
+  bool request(const char* ssid, size_t ssidLength, const char* password,
+               size_t passwordLength, int clientNum) {
+    if (ssidLength == 0 || ssidLength >= sizeof(Request::ssid) ||
+        passwordLength >= sizeof(Request::password)) {
+      return false;
+    }
+
+    Request req;
+    memcpy(req.ssid, ssid, ssidLength);
+    req.ssid[ssidLength] = '\0';
+    memcpy(req.password, password, passwordLength);
+    req.password[passwordLength] = '\0';
+    req.clientNum = clientNum;
+
+    result_ = CONNECT_PENDING;
+    xQueueOverwrite(requests_, &req);
+    return true;
+  }
+
+  /**
+   * Answers captive DNS queries and advances the connection one step.
+   * Call on every pass of the owner task.
+   */
+  void loop() {
+    if (!connected_) dns_.processNextRequest();
+    update();
+  }
+
+  bool connected() const { return connected_; }
+
+  // Outcome of the last request(), for the portal's status polling
+  WifiConnectResult result() const { return result_; }
+
+ private:
+  enum State : uint8_t {
+    SETTLING,               // Station shut down, WiFi.begin() follows
+    CONNECTING,             // Waiting for an IP address
+    CONNECTED,
+    PORTAL_PENDING,         // Station shut down, access point follows
+    PORTAL                  // Captive portal running
+  };
+
+  // Credentials handed from another task to the owner task
+  struct Request {
+    char ssid[33];
+    char password[65];
+    int clientNum;
+  };
+
+  // Runs on the WiFi event task; only records what happened
+  static void onEvent(WiFiEvent_t event) {
+    switch (event) {
+      case ARDUINO_EVENT_WIFI_STA_GOT_IP:
+        self_->events_.fetch_or(HUB_WIFI_FLAG_GOT_IP);
+        break;
+      case ARDUINO_EVENT_WIFI_STA_DISCONNECTED:
+        self_->events_.fetch_or(HUB_WIFI_FLAG_LOST);
+        break;
+      default:
+        break;
+    }
+  }
+
+  void enter(State state) {
+    state_ = state;
+    stateSince_ = millis();
+  }
+
+  /**
+   * Firmware before the credential store left the last network in the
+   * WiFi driver's own NVS config. On the first boot with an empty store
+   * it is copied over, so an upgraded hub does not fall back to the
+   * portal. From then on the driver keeps its config in RAM only.
+   */
+  void importDriverCredentials() {
+    // The driver loads its saved config when it starts with NVS enabled,
+    // which is still the core's default at this point
+    WiFi.mode(WIFI_STA);
+    wifi_config_t config;
+    if (esp_wifi_get_config(WIFI_IF_STA, &config) == ESP_OK && config.sta.ssid[0]) {
+      // Neither field has to be NUL terminated
+      char ssid[sizeof(config.sta.ssid) + 1];
+      char password[sizeof(config.sta.password) + 1];
+      memcpy(ssid, config.sta.ssid, sizeof(config.sta.ssid));
+      ssid[sizeof(config.sta.ssid)] = '\0';
+      memcpy(password, config.sta.password, sizeof(config.sta.password));
+      password[sizeof(config.sta.password)] = '\0';
+      Serial.printf("Importing saved network %s\n", ssid);
+      credentials_.remember(ssid, password);
+    }
+    esp_wifi_set_storage(WIFI_STORAGE_RAM);
+  }
+
+  /**
+   * Starts connecting to pendingSsid_, or to saved network candidate_.
+   * A fast attempt uses the cached AP (no scan) and lease (no DHCP) as
+   * far as they are known; anything else is a full scan and DHCP.
+   */
+  void beginAttempt() {
+    bootMark(BOOT_WIFI_START);
+    usedLease_ = false;
+
+    if (candidate_ < 0) {
+      fastAttempt_ = false;
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+      WiFi.begin(pendingSsid_, pendingPassword_);
+      enter(CONNECTING);
+      return;
+    }
+
+    const WifiCredential& net = credentials_.at(candidate_);
+    bool useAp = fastAttempt_ && (net.flags & CREDENTIAL_HAS_AP);
+    usedLease_ = fastAttempt_ && leaseUsable(net, time(nullptr));
+    fastAttempt_ = useAp || usedLease_;
+
+    if (usedLease_) {
+      leaseExpires_ = net.leaseExpires;
+      WiFi.config(IPAddress(net.ip), IPAddress(net.gateway), IPAddress(net.subnet), IPAddress(net.dns));
+    } else {
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+    }
+    Serial.printf("Connecting to saved network %s (%s)\n", net.ssid,
+                  fastAttempt_ ? "cached" : "scan");
+    WiFi.begin(net.ssid, net.password, useAp ? net.channel : 0, useAp ? net.bssid : NULL);
+    enter(CONNECTING);
+  }
+
+  /**
+   * After a failed attempt on a saved network: retry it without the
+   * cache, then move on to the next one, then fall back to the portal.
+   */
+  void nextAttempt() {
+    if (fastAttempt_) {
+      credentials_.forgetCache(candidate_);
+      fastAttempt_ = false;
+    } else if (candidate_ + 1 < (int)credentials_.count()) {
+      candidate_++;
+      fastAttempt_ = true;
+    } else {
+      candidate_ = -1;
+      startPortal();
+      return;
+    }
+    WiFi.disconnect();
+    enter(SETTLING);
+  }
+
+  void finishRequest(bool success) {
+    result_ = success ? CONNECT_OK : CONNECT_FAILED;
+    if (pendingClient_ < 0) return;
+
+    listener_.onConnectResult(pendingClient_, success);
+    pendingClient_ = -1;
+  }
+
+  // Shuts the station down; the access point follows once the radio has settled
+  void startPortal() {
+    connected_ = false;
+    listener_.onAccessPoint(false);
+    WiFi.disconnect(true);
+    enter(PORTAL_PENDING);
+  }
+
+  void startAccessPoint() {
+    WiFi.mode(WIFI_AP);
+    WiFi.softAPConfig(hubPortalIP, hubPortalIP, IPAddress(255, 255, 255, 0));
+    WiFi.softAP(Config::apSsid(), Config::apPassword());
+
+    // Every name resolves to the portal
+    dns_.setTTL(300);
+    dns_.start(53, "*", hubPortalIP);
+    portalStarted_ = true;
+    listener_.onAccessPoint(true);
+
+    Serial.print("AP Started. SSID: ");
+    Serial.println(Config::apSsid());
+    Serial.print("AP IP address: ");
+    Serial.println(hubPortalIP);
+  }
+
+  void onConnected() {
+    connected_ = true;
+    Serial.print("Connected! IP: ");
+    Serial.println(WiFi.localIP());
+
+    // Save the network and where it was found for the next connect;
+    // copies, since remember() reorders the store
+    WifiCredential net;
+    if (candidate_ < 0) {
+      strlcpy(net.ssid, pendingSsid_, sizeof(net.ssid));
+      strlcpy(net.password, pendingPassword_, sizeof(net.password));
+    } else {
+      net = credentials_.at(candidate_);
+    }
+    credentials_.remember(net.ssid, net.password);
+    credentials_.recordConnection(net.ssid, WiFi.BSSID(), WiFi.channel());
+    leasePending_ = !usedLease_;
+    candidate_ = 0;
+    bootSetFastConnect(usedLease_);
+    bootMark(BOOT_WIFI_IP);
+
+    // Stop DNS server and AP mode
+    dns_.stop();
+    WiFi.mode(WIFI_STA);
+
+    // Wall-clock time for buffered samples
+    configTime(0, 0, Config::ntpServer());
+
+    enter(CONNECTED);
+    listener_.onWifiConnected();
+    finishRequest(true);
+  }
+
+  void update() {
+    uint32_t events = events_.exchange(0);
+    unsigned long elapsed = millis() - stateSince_;
+
+    // A new request wins over whatever is in progress
+    Request req;
+    if (xQueueReceive(requests_, &req, 0) == pdTRUE) {
+      Serial.printf("Connecting to %s\n", req.ssid);
+      strlcpy(pendingSsid_, req.ssid, sizeof(pendingSsid_));
+      strlcpy(pendingPassword_, req.password, sizeof(pendingPassword_));
+      pendingClient_ = req.clientNum;
+      candidate_ = -1;
+
+      connected_ = false;
+      listener_.onWifiConnecting();
+
+      // Disconnect from existing networks and let the radio settle
+      WiFi.disconnect(true);
+      enter(SETTLING);
+      return;
+    }
+
+    switch (state_) {
+      case SETTLING:
+        if (elapsed >= Config::wifiSettleTime) beginAttempt();
+        break;
+
+      case CONNECTING:
+        if ((events & HUB_WIFI_FLAG_GOT_IP) || WiFi.status() == WL_CONNECTED) {
+          onConnected();
+        } else if (elapsed >= (fastAttempt_ ? Config::wifiFastConnectTimeout : Config::wifiConnectTimeout)) {
+          Serial.println("Connection failed");
+          if (candidate_ >= 0) {
+            nextAttempt();
+            break;
+          }
+          finishRequest(false);
+          if (portalStarted_) {
+            listener_.onAccessPoint(true);
+            enter(PORTAL);
+          } else {
+            startPortal();
+          }
+        }
+        break;
+
+      case CONNECTED:
+        if ((events & HUB_WIFI_FLAG_LOST) || WiFi.status() != WL_CONNECTED) {
+          connected_ = false;
+          Serial.println("WiFi connection lost");
+          listener_.onWifiLost();
+
+          // Straight back to the same AP, then the other saved networks,
+          // before going back to AP mode
+          candidate_ = 0;
+          fastAttempt_ = true;
+          beginAttempt();
+        } else if (elapsed >= Config::leaseCheckInterval) {
+          updateLease();
+          stateSince_ = millis();
+        }
+        break;
+
+      case PORTAL_PENDING:
+        if (elapsed >= Config::wifiSettleTime) {
+          startAccessPoint();
+          enter(PORTAL);
+        }
+        break;
+
+      case PORTAL:
+        break;
+    }
+  }
+
+  /**
+   * Seconds left on the station's DHCP lease, or -1 while DHCP has not
+   * bound an address. Reads lwIP's client state without the core lock;
+   * a torn read only delays recording the lease.
+   */
+  static long dhcpLeaseRemaining() {
+    struct netif* netif = (struct netif*)esp_netif_get_netif_impl(
+        esp_netif_get_handle_from_ifkey("WIFI_STA_DEF"));
+    if (netif == NULL || !dhcp_supplied_address(netif)) return -1;
+    const struct dhcp* dhcp = netif_dhcp_data(netif);
+    long left = (long)min(dhcp->offered_t0_lease, (u32_t)Config::leaseMax) -
+                (long)dhcp->lease_used * DHCP_COARSE_TIMER_SECS;
+    return left > 0 ? left : -1;
+  }
+
+  /**
+   * Keeps the cached lease honest while connected. A DHCP lease is saved
+   * with its expiry once the clock is set. A cached lease in use is
+   * handed back to DHCP before it runs out, since a static address is
+   * never renewed; the API link reconnects on the new address.
+   */
+  void updateLease() {
+    time_t now = time(nullptr);
+    if (!wallClockValid()) return;
+
+    if (usedLease_) {
+      if ((int32_t)(leaseExpires_ - (uint32_t)now) >= CREDENTIAL_LEASE_MARGIN) return;
+      Serial.println("Cached lease ending, switching to DHCP");
+      usedLease_ = false;
+      leasePending_ = true;
+      WiFi.config(INADDR_NONE, INADDR_NONE, INADDR_NONE);
+      return;
+    }
+
+    if (!leasePending_) return;
+    long left = dhcpLeaseRemaining();
+    if (left < 0) return;
+    // remember() put the connected network first
+    credentials_.recordLease(credentials_.at(0).ssid, WiFi.localIP(), WiFi.gatewayIP(),
+                             WiFi.subnetMask(), WiFi.dnsIP(), (uint32_t)now + left);
+    leasePending_ = false;
+  }
+
+  static HubWifi* self_;  // For onEvent(), which takes no context
+
+  Listener& listener_;
+  State state_;
+  unsigned long stateSince_;
+  bool connected_;
+  volatile WifiConnectResult result_;
+  std::atomic<uint32_t> events_;
+  QueueHandle_t requests_;
+  char pendingSsid_[33];
+  char pendingPassword_[65];
+  int pendingClient_;
+  bool portalStarted_;
+  DNSServer dns_;
+  // Saved networks, tried in order at boot and after the link is lost.
+  // candidate_ is the one being tried, -1 for pendingSsid_.
+  CredentialStore credentials_;
+  int candidate_;
+  bool fastAttempt_;       // Using the cached AP and lease
+  bool usedLease_;         // Static config from the cache, so no new lease to record
+  uint32_t leaseExpires_;  // End of the cached lease in use (time())
+  bool leasePending_;      // DHCP lease to record once bound and the clock is set
+};
+
+template <class Config, class Listener>
+HubWifi<Config, Listener>* HubWifi<Config, Listener>::self_ = nullptr;
+
+#endif // HUB_WIFI_H
@@ -0,0 +1,25 @@
+/*
+ * Shadow framebuffer implementation
+ */
+#include "lcd_buffer.h"
+
+LcdBuffer::LcdBuffer() : shownValid_(false), col_(0), row_(0) {
+  clear();
+}
+
+void LcdBuffer::clear() {
+  memset(cells_, ' ', sizeof(cells_));
+  col_ = 0;
+  row_ = 0;
+}
+
+void LcdBuffer::setCursor(uint8_t col, uint8_t row) {
+  col_ = col;
+  row_ = row < LCD_ROWS ? row : LCD_ROWS - 1;
+}
+
+size_t LcdBuffer::write(uint8_t c) {
+  if (col_ >= LCD_COLS) return 1;
+  cells_[row_][col_++] = c;
+  return 1;
+}
@@ -0,0 +1,79 @@
+/*
+ * Shadow framebuffer for the 16x2 character LCD
+ *
+ * Screens are drawn into RAM with the usual Print API and flushTo() sends
+ * only the cells that differ from what the LCD already shows. Every I2C
+ * byte to the LCD costs the same whether it is a command or a character,
+ * so runs of changed cells are joined across single unchanged cells
+ * rather than paying for another setCursor().
+ */
+#ifndef LCD_BUFFER_H
+#define LCD_BUFFER_H
+
+#include <Arduino.h>
+
+#define LCD_COLS 16
+#define LCD_ROWS 2
+
+class LcdBuffer : public Print {
+ public:
+  LcdBuffer();
+
+  // Fills the buffer with blanks and homes the cursor; nothing is sent
+  void clear();
+  void setCursor(uint8_t col, uint8_t row);
+
+  // Characters past the end of a row are dropped
+  size_t write(uint8_t c) override;
+  using Print::write;
+
+  // Sends the changed cells; returns the number of bytes sent
+  template <typename Lcd>
+  size_t flushTo(Lcd& lcd);
+
+  // Forgets what the LCD shows, so the next flushTo() redraws every cell.
+  // Call after writing to the LCD directly.
+  void invalidate() { shownValid_ = false; }
+
+ private:
+  uint8_t cells_[LCD_ROWS][LCD_COLS];
+  uint8_t shown_[LCD_ROWS][LCD_COLS];
+  bool shownValid_;
+  uint8_t col_;
+  uint8_t row_;
+};
+
+// Defined here so it works with any LCD driver offering setCursor()
+// and write(), without a virtual call per byte
+template <typename Lcd>
+size_t LcdBuffer::flushTo(Lcd& lcd) {
+  size_t sent = 0;
+
+  for (uint8_t row = 0; row < LCD_ROWS; row++) {
+    // Column the LCD address counter points at, or -1 if unknown
+    int cursor = -1;
+    for (uint8_t col = 0; col < LCD_COLS; col++) {
+      if (shownValid_ && cells_[row][col] == shown_[row][col]) continue;
+
+      // Rewriting one unchanged cell costs the same as a cursor move
+      if (cursor >= 0 && col - cursor <= 1) {
+        while (cursor < col) {
+          lcd.write(cells_[row][cursor++]);
+          sent++;
+        }
+      } else {
+        lcd.setCursor(col, row);
+        sent++;
+      }
+      lcd.write(cells_[row][col]);
+      shown_[row][col] = cells_[row][col];
+      cursor = col + 1;
+      sent++;
+    }
+  }
+
+  shownValid_ = true;
+  return sent;
+}
+
+#endif // LCD_BUFFER_H
@@ -0,0 +1,244 @@
+/*
+ * Loop latency statistics implementation
+ */
+#include "loop_stats.h"
+
+#if LOOP_STATS_ENABLED
+
+#include <stdlib.h>
+
+#define SUB_BUCKETS (1 << LOOP_STATS_SUB_BITS)
+
+struct RegionStats {
+  // Since the last report
+  uint32_t calls;
+  uint64_t totalCycles;
+  uint32_t maxCycles;
+  // Since boot
+  uint32_t count;
+  uint64_t sumCycles;
+  uint32_t peakCycles;
+  uint32_t buckets[LOOP_STATS_BUCKETS];
+};
+
+static const char* const regionNames[REGION_COUNT] = {
+  "readSensors",
+  "updateLCD",
+  "broadcastDeviceStatus",
+  "sendDataToServer",
+  "webSocket.loop",
+  "webSocket.service",
+  "apiClient.loop",
+  "onWebSocketEvent",
+  "apiWebSocketEvent",
+  "networkPass"
+};
+
+static RegionStats regions[REGION_COUNT];
+static uint32_t passSamples[LOOP_STATS_WINDOW];
+static uint32_t passCount = 0;      // Passes since the last report
+static uint32_t passMaxUs = 0;
+static uint32_t passStartUs = 0;
+static uint32_t passStartCycles = 0;
+static unsigned long lastReport = 0;
+
+// Regions are recorded from several tasks
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+static int compareUint32(const void* a, const void* b) {
+  uint32_t x = *(const uint32_t*)a;
+  uint32_t y = *(const uint32_t*)b;
+  return (x > y) - (x < y);
+}
+
+static uint32_t bucketFor(uint32_t cycles) {
+  if (cycles < (1u << LOOP_STATS_MIN_SHIFT)) return 0;
+  uint32_t msb = 31 - __builtin_clz(cycles);
+  uint32_t sub = (cycles >> (msb - LOOP_STATS_SUB_BITS)) & (SUB_BUCKETS - 1);
+  return 1 + ((msb - LOOP_STATS_MIN_SHIFT) << LOOP_STATS_SUB_BITS) + sub;
+}
+
+// Largest value that falls into a bucket
+static uint32_t bucketLimit(uint32_t bucket) {
+  if (bucket == 0) return (1u << LOOP_STATS_MIN_SHIFT) - 1;
+  uint32_t msb = LOOP_STATS_MIN_SHIFT + ((bucket - 1) >> LOOP_STATS_SUB_BITS);
+  uint32_t sub = (bucket - 1) & (SUB_BUCKETS - 1);
+  uint32_t width = 1u << (msb - LOOP_STATS_SUB_BITS);
+  return (1u << msb) + (sub + 1) * width - 1;
+}
+
+// Upper bound of the bucket holding the given percentile, in cycles
+static uint32_t percentile(const RegionStats& stats, uint32_t percent) {
+  uint32_t rank = ((uint64_t)stats.count * percent + 99) / 100;
+  uint32_t seen = 0;
+  for (uint32_t i = 0; i < LOOP_STATS_BUCKETS; i++) {
+    seen += stats.buckets[i];
+    if (seen >= rank) return min(bucketLimit(i), stats.peakCycles);
+  }
+  return stats.peakCycles;
+}
+
+// Copies one region, optionally starting a new report window
+static void takeRegion(int region, RegionStats& out, bool resetWindow) {
+  portENTER_CRITICAL(&statsMux);
+  out = regions[region];
+  if (resetWindow) {
+    regions[region].calls = 0;
+    regions[region].totalCycles = 0;
+    regions[region].maxCycles = 0;
+  }
+  portEXIT_CRITICAL(&statsMux);
+}
+
+// Opens the profile object up to the start of the regions array
+static void writeProfileHeader(FrameWriter& w) {
+  w.raw("{");
+  w.key("mhz").integer(ESP.getCpuFreqMHz());
+  w.key("subBits").integer(LOOP_STATS_SUB_BITS);
+  w.key("minShift").integer(LOOP_STATS_MIN_SHIFT);
+  w.key("regions").raw("[");
+}
+
+static void writeRegion(FrameWriter& w, int region, const RegionStats& stats, bool buckets) {
+  w.raw("{");
+  w.key("name").string(regionNames[region]);
+  w.key("count").integer(stats.count);
+  w.key("max").integer(stats.peakCycles);
+  if (buckets) {
+    // Only the span of buckets in use
+    uint32_t lo = 0;
+    uint32_t hi = LOOP_STATS_BUCKETS - 1;
+    while (lo < hi && stats.buckets[lo] == 0) lo++;
+    while (hi > lo && stats.buckets[hi] == 0) hi--;
+    w.key("lo").integer(lo);
+    w.key("b").raw("[");
+    for (uint32_t i = lo; i <= hi; i++) {
+      if (i > lo) w.raw(",");
+      w.integer(stats.buckets[i]);
+    }
+    w.raw("]");
+  }
+  w.raw("}");
+}
+
+void loopStatsBeginPass() {
+  passStartUs = micros();
+  passStartCycles = ESP.getCycleCount();
+}
+
+// Passes are only counted for the task that owns the report
+void loopStatsEndPass() {
+  loopStatsAddRegion(REGION_NETWORK_PASS, ESP.getCycleCount() - passStartCycles);
+  uint32_t elapsed = micros() - passStartUs;
+  passSamples[passCount % LOOP_STATS_WINDOW] = elapsed;
+  passCount++;
+  if (elapsed > passMaxUs) passMaxUs = elapsed;
+
+  if (millis() - lastReport >= LOOP_STATS_REPORT_INTERVAL) {
+    loopStatsReport();
+    lastReport = millis();
+  }
+}
+
+void loopStatsAddRegion(LoopRegion region, uint32_t elapsedCycles) {
+  uint32_t bucket = bucketFor(elapsedCycles);
+  portENTER_CRITICAL(&statsMux);
+  RegionStats& stats = regions[region];
+  stats.calls++;
+  stats.totalCycles += elapsedCycles;
+  if (elapsedCycles > stats.maxCycles) stats.maxCycles = elapsedCycles;
+  stats.count++;
+  stats.sumCycles += elapsedCycles;
+  if (elapsedCycles > stats.peakCycles) stats.peakCycles = elapsedCycles;
+  stats.buckets[bucket]++;
+  portEXIT_CRITICAL(&statsMux);
+}
+
+void loopStatsReport() {
+  if (passCount == 0) return;
+
+  // Percentiles are taken over the most recent LOOP_STATS_WINDOW passes
+  static uint32_t sorted[LOOP_STATS_WINDOW];
+  uint32_t n = passCount < LOOP_STATS_WINDOW ? passCount : LOOP_STATS_WINDOW;
+  memcpy(sorted, passSamples, n * sizeof(uint32_t));
+  qsort(sorted, n, sizeof(uint32_t), compareUint32);
+
+  Serial.printf("[loop] passes=%u p50=%uus p90=%uus p99=%uus max=%uus\n",
+                passCount,
+                sorted[n * 50 / 100],
+                sorted[n * 90 / 100],
+                sorted[n * 99 / 100],
+                passMaxUs);
+
+  // Window figures are reset as they are printed, percentiles and the
+  // histograms cover everything since boot
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  for (int i = 0; i < REGION_COUNT; i++) {
+    RegionStats stats;
+    takeRegion(i, stats, true);
+    if (stats.calls == 0) continue;
+    Serial.printf("[loop]   %-22s calls=%u total=%lums avg=%uus max=%uus"
+                  " | p50=%uus p99=%uus\n",
+                  regionNames[i],
+                  stats.calls,
+                  (unsigned long)(stats.totalCycles / mhz / 1000),
+                  (uint32_t)(stats.totalCycles / stats.calls / mhz),
+                  stats.maxCycles / mhz,
+                  percentile(stats, 50) / mhz,
+                  percentile(stats, 99) / mhz);
+
+#if LOOP_STATS_SERIAL_PROFILE
+    // Same layout as the WebSocket export, one region per line
+    static char line[512];
+    FrameWriter w(line, sizeof(line));
+    writeProfileHeader(w);
+    writeRegion(w, i, stats, true);
+    w.raw("]}");
+    if (w.finish()) Serial.printf("[prof] %s\n", line);
+#endif
+  }
+
+  passCount = 0;
+  passMaxUs = 0;
+}
+
+bool loopStatsSummary(LoopRegion region, LoopRegionSummary& out) {
+  RegionStats stats;
+  takeRegion(region, stats, false);
+  if (stats.count == 0) return false;
+
+  uint32_t mhz = ESP.getCpuFreqMHz();
+  out.count = stats.count;
+  out.totalUs = stats.sumCycles / mhz;
+  out.p50Us = percentile(stats, 50) / mhz;
+  out.p90Us = percentile(stats, 90) / mhz;
+  out.p99Us = percentile(stats, 99) / mhz;
+  out.maxUs = stats.peakCycles / mhz;
+  return true;
+}
+
+const char* loopStatsRegionName(LoopRegion region) {
+  return region < REGION_COUNT ? regionNames[region] : "";
+}
+
+void loopStatsWriteProfile(FrameWriter& w, bool buckets) {
+  writeProfileHeader(w);
+  bool first = true;
+  for (int i = 0; i < REGION_COUNT; i++) {
+    RegionStats stats;
+    takeRegion(i, stats, false);
+    if (stats.count == 0) continue;
+    if (!first) w.raw(",");
+    writeRegion(w, i, stats, buckets);
+    first = false;
+  }
+  w.raw("]}");
+}
+
+#else
+
+void loopStatsWriteProfile(FrameWriter& w, bool buckets) {
+  w.raw("{\"regions\":[]}");
+}
+
+#endif // LOOP_STATS_ENABLED
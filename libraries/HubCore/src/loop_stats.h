@@ -0,0 +1,123 @@
+/*
+ * Loop latency statistics for the Smart Home Hub firmware
+ *
+ * Measures how long each pass of the network loop takes, and how long
+ * the individual subsystems and handlers take, and prints a summary
+ * over Serial.
+ *
+ * Regions are timed with the CPU cycle counter and recorded into one
+ * log-linear histogram each: every power of two is split into
+ * 2^LOOP_STATS_SUB_BITS equal buckets, so the bucket width stays within
+ * 25% of the value at any scale. The histograms accumulate from boot and
+ * can be exported as JSON (see loopStatsWriteProfile() and
+ * tools/render_profile.py).
+ */
+#ifndef LOOP_STATS_H
+#define LOOP_STATS_H
+
+#include <Arduino.h>
+#include "telemetry_frame.h"
+
+// Set to 0 to compile the instrumentation out completely
+#ifndef LOOP_STATS_ENABLED
+#define LOOP_STATS_ENABLED 1
+#endif
+
+#define LOOP_STATS_WINDOW 256            // Loop passes kept for percentiles
+#define LOOP_STATS_REPORT_INTERVAL 30000 // Time between Serial reports (ms)
+#define LOOP_STATS_SERIAL_PROFILE 1      // Print the histograms with every report
+#define LOOP_STATS_PROFILE_SIZE 2048     // Fits the profile of every region
+
+// Histogram layout: bucket 0 holds everything below 2^LOOP_STATS_MIN_SHIFT
+// cycles, then 2^LOOP_STATS_SUB_BITS buckets per power of two up to 2^32
+#define LOOP_STATS_SUB_BITS 2
+#define LOOP_STATS_MIN_SHIFT 7
+#define LOOP_STATS_BUCKETS (1 + ((32 - LOOP_STATS_MIN_SHIFT) << LOOP_STATS_SUB_BITS))
+
+// Subsystems and handlers timed by the firmware tasks
+enum LoopRegion {
+  REGION_READ_SENSORS,
+  REGION_UPDATE_LCD,
+  REGION_BROADCAST_STATUS,
+  REGION_SEND_DATA,
+  REGION_WEBSOCKET_LOOP,
+  REGION_WEBSOCKET_FANOUT,
+  REGION_API_LOOP,
+  REGION_LOCAL_EVENT,  // onWebSocketEvent, inside webSocket.loop
+  REGION_API_EVENT,    // apiWebSocketEvent, inside apiClient.loop
+  REGION_NETWORK_PASS, // A whole pass of the network task
+  REGION_COUNT
+};
+
+// Percentiles of one region since boot, from its histogram, in µs
+struct LoopRegionSummary {
+  uint32_t count;
+  uint64_t totalUs;
+  uint32_t p50Us;
+  uint32_t p90Us;
+  uint32_t p99Us;
+  uint32_t maxUs;
+};
+
+#if LOOP_STATS_ENABLED
+
+void loopStatsBeginPass();
+void loopStatsEndPass();
+void loopStatsAddRegion(LoopRegion region, uint32_t elapsedCycles);
+void loopStatsReport();
+
+// False if the region has not run yet
+bool loopStatsSummary(LoopRegion region, LoopRegionSummary& out);
+const char* loopStatsRegionName(LoopRegion region);
+
+/**
+ * Writes the histograms as a profile object:
+ *   {"mhz":240,"subBits":2,"minShift":7,"regions":[
+ *     {"name":"readSensors","count":n,"max":cycles,"lo":i,"b":[...]},...]}
+ * "b" holds the counts of buckets lo, lo+1, ... up to the last one in use.
+ * Without buckets only the name, count and max are written.
+ */
+void loopStatsWriteProfile(FrameWriter& w, bool buckets = true);
+
+// Runs a statement and charges its duration to the given region
+#define LOOP_STATS_TIME(region, statement)                              \
+  do {                                                                  \
+    uint32_t _regionStart = ESP.getCycleCount();                        \
+    statement;                                                          \
+    loopStatsAddRegion(region, ESP.getCycleCount() - _regionStart);     \
+  } while (0)
+
+// Charges the rest of the enclosing scope to the given region
+class LoopStatsScope {
+ public:
+  explicit LoopStatsScope(LoopRegion region)
+    : region_(region), start_(ESP.getCycleCount()) {}
+  ~LoopStatsScope() { loopStatsAddRegion(region_, ESP.getCycleCount() - start_); }
+
+ private:
+  LoopRegion region_;
+  uint32_t start_;
+};
+#define LOOP_STATS_SCOPE(region) LoopStatsScope _regionScope(region)
+
+#else
+
+inline void loopStatsBeginPass() {}
+inline void loopStatsEndPass() {}
+inline void loopStatsReport() {}
+inline bool loopStatsSummary(LoopRegion region, LoopRegionSummary& out) { return false; }
+inline const char* loopStatsRegionName(LoopRegion region) { return ""; }
+void loopStatsWriteProfile(FrameWriter& w, bool buckets = true);
+
+#define LOOP_STATS_TIME(region, statement) \
+  do {                                     \
+    statement;                             \
+  } while (0)
+
+#define LOOP_STATS_SCOPE(region) \
+  do {                           \
+  } while (0)
+
+#endif // LOOP_STATS_ENABLED
+
+#endif // LOOP_STATS_H
@@ -0,0 +1,212 @@
+/*
+ * Heap and stack statistics implementation
+ */
+#include "mem_stats.h"
+
+#if MEM_STATS_ENABLED
+
+#include <esp_heap_caps.h>
+#include <new>
+
+struct TaskEntry {
+  TaskHandle_t task;
+  const char* name;
+};
+
+struct SiteStats {
+  uint32_t calls;
+  uint32_t allocations;     // Allocations made inside the scope, over all calls
+  uint32_t allocatedBytes;
+  int32_t blocks;           // Net blocks left allocated over all calls
+  int32_t bytes;
+};
+
+struct HeapSample {
+  uint32_t freeBytes;
+  uint32_t largestBlock;
+  uint32_t minFreeBytes;
+  uint32_t allocatedBlocks;
+  uint8_t fragmentation;  // Percent
+  bool warning;           // Fragmented or low, until it recovers
+  uint32_t stackFree[MEM_STATS_MAX_TASKS];
+};
+
+static const char* const siteNames[MEM_SITE_COUNT] = {
+  "apiMessage",
+  "localCommand",
+  "httpScan",
+  "httpConnect",
+  "httpStatus"
+};
+
+static TaskEntry tasks[MEM_STATS_MAX_TASKS];
+static uint8_t taskCount = 0;
+static SiteStats sites[MEM_SITE_COUNT];
+static HeapSample latest;
+static unsigned long lastSample = 0;
+static bool sampled = false;
+static bool fragWarning = false;
+static bool lowHeapWarning = false;
+
+// Sites are recorded from the network and async_tcp tasks, and the sample
+// is read by both
+static portMUX_TYPE statsMux = portMUX_INITIALIZER_UNLOCKED;
+
+// Running allocation counters of the current task. Scopes read the
+// difference, so other tasks allocating at the same time do not count.
+static __thread uint32_t taskAllocations = 0;
+static __thread uint32_t taskAllocatedBytes = 0;
+
+void memStatsAddTask(TaskHandle_t task, const char* name) {
+  if (task == NULL || taskCount >= MEM_STATS_MAX_TASKS) return;
+  tasks[taskCount].task = task;
+  tasks[taskCount].name = name;
+  taskCount++;
+}
+
+static void takeSample(HeapSample& sample) {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  sample.freeBytes = info.total_free_bytes;
+  sample.largestBlock = info.largest_free_block;
+  sample.minFreeBytes = info.minimum_free_bytes;
+  sample.allocatedBlocks = info.allocated_blocks;
+  sample.fragmentation = info.total_free_bytes
+    ? 100 - (uint64_t)info.largest_free_block * 100 / info.total_free_bytes
+    : 0;
+
+  // ESP-IDF reports the high-water mark in bytes
+  for (uint8_t i = 0; i < taskCount; i++) {
+    sample.stackFree[i] = uxTaskGetStackHighWaterMark(tasks[i].task);
+  }
+}
+
+bool memStatsPoll() {
+  if (sampled && millis() - lastSample < MEM_STATS_SAMPLE_INTERVAL) return false;
+  lastSample = millis();
+
+  HeapSample sample;
+  takeSample(sample);
+
+  bool raised = false;
+  if (!fragWarning && sample.fragmentation >= MEM_STATS_FRAG_WARN) {
+    fragWarning = raised = true;
+    Serial.printf("[mem] WARNING heap fragmented: %u%% (free=%u largest=%u)\n",
+                  sample.fragmentation, sample.freeBytes, sample.largestBlock);
+  } else if (fragWarning && sample.fragmentation <= MEM_STATS_FRAG_CLEAR) {
+    fragWarning = false;
+  }
+
+  if (!lowHeapWarning && sample.freeBytes < MEM_STATS_LOW_HEAP_WARN) {
+    lowHeapWarning = raised = true;
+    Serial.printf("[mem] WARNING heap low: free=%u min=%u\n",
+                  sample.freeBytes, sample.minFreeBytes);
+  } else if (lowHeapWarning && sample.freeBytes >= MEM_STATS_LOW_HEAP_WARN) {
+    lowHeapWarning = false;
+  }
+  sample.warning = fragWarning || lowHeapWarning;
+
+  portENTER_CRITICAL(&statsMux);
+  latest = sample;
+  sampled = true;
+  portEXIT_CRITICAL(&statsMux);
+  return raised;
+}
+
+void writeMemStats(FrameWriter& w) {
+  HeapSample sample;
+  SiteStats siteSnapshot[MEM_SITE_COUNT];
+  portENTER_CRITICAL(&statsMux);
+  sample = latest;
+  memcpy(siteSnapshot, sites, sizeof(sites));
+  portEXIT_CRITICAL(&statsMux);
+
+  w.key("heap").integer(sample.freeBytes);
+  w.key("largest").integer(sample.largestBlock);
+  w.key("minHeap").integer(sample.minFreeBytes);
+  w.key("blocks").integer(sample.allocatedBlocks);
+  w.key("frag").integer(sample.fragmentation);
+  w.key("warn").boolean(sample.warning);
+
+  w.key("stacks").raw("{");
+  for (uint8_t i = 0; i < taskCount; i++) {
+    w.key(tasks[i].name).integer(sample.stackFree[i]);
+  }
+  w.raw("}");
+
+  w.key("sites").raw("{");
+  for (int i = 0; i < MEM_SITE_COUNT; i++) {
+    w.key(siteNames[i]).raw("{");
+    w.key("calls").integer(siteSnapshot[i].calls);
+    w.key("allocs").integer(siteSnapshot[i].allocations);
+    w.key("allocBytes").integer(siteSnapshot[i].allocatedBytes);
+    w.key("blocks").integer(siteSnapshot[i].blocks);
+    w.key("bytes").integer(siteSnapshot[i].bytes);
+    w.raw("}");
+  }
+  w.raw("}");
+}
+
+void memStatsCountAllocation(size_t size) {
+  taskAllocations++;
+  taskAllocatedBytes += size;
+}
+
+// heap_caps_get_info() walks the heap, so scopes only go around request
+// handlers, never around per-pass work
+MemSiteScope::MemSiteScope(MemSite site) : site_(site) {
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+  blocks_ = info.allocated_blocks;
+  bytes_ = info.total_allocated_bytes;
+  allocations_ = taskAllocations;
+  allocatedBytes_ = taskAllocatedBytes;
+}
+
+// The allocation counts are exact for the task. The retained figures
+// come from the whole heap, and other tasks allocate concurrently, so
+// single readings are noisy; the trend over many calls is what matters.
+MemSiteScope::~MemSiteScope() {
+  uint32_t allocations = taskAllocations - allocations_;
+  uint32_t allocatedBytes = taskAllocatedBytes - allocatedBytes_;
+  multi_heap_info_t info;
+  heap_caps_get_info(&info, MALLOC_CAP_8BIT);
+
+  portENTER_CRITICAL(&statsMux);
+  SiteStats& stats = sites[site_];
+  stats.calls++;
+  stats.allocations += allocations;
+  stats.allocatedBytes += allocatedBytes;
+  stats.blocks += (int32_t)(info.allocated_blocks - blocks_);
+  stats.bytes += (int32_t)(info.total_allocated_bytes - bytes_);
+  portEXIT_CRITICAL(&statsMux);
+}
+
+// ===== ALLOCATION COUNTING =====
+// Replaces the global operator new, so every C++ allocation is counted
+// against the task that makes it. delete stays the library's free().
+void* operator new(size_t size) {
+  memStatsCountAllocation(size);
+  void* pointer = malloc(size ? size : 1);
+#if __cpp_exceptions
+  if (!pointer) throw std::bad_alloc();
+#else
+  if (!pointer) abort();
+#endif
+  return pointer;
+}
+
+void* operator new[](size_t size) {
+  return operator new(size);
+}
+
+void* operator new(size_t size, const std::nothrow_t&) noexcept {
+  memStatsCountAllocation(size);
+  return malloc(size ? size : 1);
+}
+
+void* operator new[](size_t size, const std::nothrow_t&) noexcept {
+  return operator new(size, std::nothrow);
+}
+
+#endif // MEM_STATS_ENABLED
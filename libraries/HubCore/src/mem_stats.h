@@ -0,0 +1,123 @@
+/*
+ * Heap and stack statistics for the Smart Home Hub firmware
+ *
+ * Samples the 8-bit capable heap (free bytes, largest free block, lowest
+ * free since boot) and the stack high-water mark of each registered task.
+ * Call sites wrapped in a MemSiteScope also record how many allocations
+ * they make (transient churn) and how many heap blocks and bytes they
+ * leave allocated. If a site's retained count keeps growing, it is
+ * leaking.
+ *
+ * Allocations are counted per task as they happen: C++ new, and
+ * JsonDocuments built on memStatsJsonAllocator(). String buffers come
+ * from malloc(), which the Arduino-ESP32 2.x heap offers no hook for;
+ * they only show in the retained figures.
+ *
+ * Fragmentation is the share of free heap that one allocation cannot
+ * use: 100 - largest free block * 100 / free bytes.
+ */
+#ifndef MEM_STATS_H
+#define MEM_STATS_H
+
+#include <Arduino.h>
+#include <ArduinoJson.h>
+#include "telemetry_frame.h"
+
+// Set to 0 to compile the instrumentation out completely
+#ifndef MEM_STATS_ENABLED
+#define MEM_STATS_ENABLED 1
+#endif
+
+#define MEM_STATS_SAMPLE_INTERVAL 5000  // Time between heap samples (ms)
+#define MEM_STATS_FRAG_WARN 50          // Fragmentation that raises a warning (%)
+#define MEM_STATS_FRAG_CLEAR 40         // ...and clears it again (%)
+#define MEM_STATS_LOW_HEAP_WARN 16384   // Free heap that raises a warning (bytes)
+#define MEM_STATS_MAX_TASKS 4
+#define MEM_STATS_JSON_SIZE 768         // Fits every member writeMemStats() emits
+
+// Call sites that allocate while handling requests
+enum MemSite {
+  MEM_SITE_API_MESSAGE,    // JsonDocument per API server message
+  MEM_SITE_LOCAL_COMMAND,  // Local WebSocket command dispatch
+  MEM_SITE_HTTP_SCAN,
+  MEM_SITE_HTTP_CONNECT,
+  MEM_SITE_HTTP_STATUS,
+  MEM_SITE_COUNT
+};
+
+#if MEM_STATS_ENABLED
+
+// Adds a task to the stack high-water report
+void memStatsAddTask(TaskHandle_t task, const char* name);
+
+/**
+ * Takes a sample every MEM_STATS_SAMPLE_INTERVAL and prints a warning
+ * when the heap is low or fragmented. Returns true when a warning has
+ * just been raised.
+ */
+bool memStatsPoll();
+
+// Appends "heap".."sites" members from the latest sample
+void writeMemStats(FrameWriter& w);
+
+/**
+ * Charges to site the allocations the calling task makes while the
+ * scope is open, and the blocks and bytes left allocated when it ends
+ */
+class MemSiteScope {
+ public:
+  explicit MemSiteScope(MemSite site);
+  ~MemSiteScope();
+
+ private:
+  MemSite site_;
+  uint32_t blocks_;
+  uint32_t bytes_;
+  uint32_t allocations_;     // The task's counters when the scope opened
+  uint32_t allocatedBytes_;
+};
+
+// Counts one allocation of size bytes against the calling task
+void memStatsCountAllocation(size_t size);
+
+#else
+
+inline void memStatsAddTask(TaskHandle_t, const char*) {}
+inline bool memStatsPoll() { return false; }
+inline void writeMemStats(FrameWriter&) {}
+
+class MemSiteScope {
+ public:
+  explicit MemSiteScope(MemSite) {}
+};
+
+inline void memStatsCountAllocation(size_t) {}
+
+#endif // MEM_STATS_ENABLED
+
+// ArduinoJson allocator that counts its allocations; pass it to the
+// JsonDocuments built inside a MemSiteScope
+class MemStatsJsonAllocator : public ArduinoJson::Allocator {
+ public:
+  void* allocate(size_t size) override {
+    memStatsCountAllocation(size);
+    return malloc(size);
+  }
+
+  void deallocate(void* pointer) override {
+    free(pointer);
+  }
+
+  // A grown pool counts as a new block
+  void* reallocate(void* pointer, size_t size) override {
+    memStatsCountAllocation(size);
+    return realloc(pointer, size);
+  }
+};
+
+inline ArduinoJson::Allocator* memStatsJsonAllocator() {
+  static MemStatsJsonAllocator allocator;
+  return &allocator;
+}
+
+#endif // MEM_STATS_H
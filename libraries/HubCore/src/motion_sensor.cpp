@@ -0,0 +1,44 @@
+/*
+ * Interrupt-driven PIR input implementation
+ */
+#include "motion_sensor.h"
+#include <rom/gpio.h>
+
+static_assert((MOTION_EDGE_QUEUE_SIZE & (MOTION_EDGE_QUEUE_SIZE - 1)) == 0,
+              "MOTION_EDGE_QUEUE_SIZE must be a power of two");
+
+MotionSensor::MotionSensor(uint8_t pin)
+  : pin_(pin), head_(0), tail_(0), overflows_(0) {}
+
+void MotionSensor::begin() {
+  pinMode(pin_, INPUT);
+  if (digitalRead(pin_) == HIGH) push(true, millis());
+  attachInterruptArg(digitalPinToInterrupt(pin_), isr, this, CHANGE);
+}
+
+bool MotionSensor::nextEdge(MotionEdge& out) {
+  uint32_t tail = tail_.load(std::memory_order_relaxed);
+  if (tail == head_.load(std::memory_order_acquire)) return false;
+
+  out = edges_[tail & (MOTION_EDGE_QUEUE_SIZE - 1)];
+  tail_.store(tail + 1, std::memory_order_release);
+  return true;
+}
+
+void IRAM_ATTR MotionSensor::isr(void* arg) {
+  MotionSensor* self = static_cast<MotionSensor*>(arg);
+  // ROM register read; digitalRead() is not guaranteed to be in IRAM
+  uint32_t levels = self->pin_ < 32 ? gpio_input_get() : gpio_input_get_high();
+  self->push((levels >> (self->pin_ & 31)) & 1, millis());
+}
+
+void IRAM_ATTR MotionSensor::push(bool level, uint32_t timestamp) {
+  uint32_t head = head_.load(std::memory_order_relaxed);
+  if (head - tail_.load(std::memory_order_acquire) >= MOTION_EDGE_QUEUE_SIZE) {
+    overflows_.fetch_add(1, std::memory_order_relaxed);
+    return;
+  }
+
+  edges_[head & (MOTION_EDGE_QUEUE_SIZE - 1)] = { level, timestamp };
+  head_.store(head + 1, std::memory_order_release);
+}
@@ -0,0 +1,49 @@
+/*
+ * Interrupt-driven PIR input for the Smart Home Hub firmware
+ *
+ * A GPIO interrupt timestamps every level change of the PIR output and
+ * pushes it into a single-producer/single-consumer ring, so edges are
+ * never missed between polls and consumers see the time the edge
+ * actually happened. The ring is lock-free: the ISR only advances head_,
+ * the consuming task only advances tail_.
+ */
+#ifndef MOTION_SENSOR_H
+#define MOTION_SENSOR_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define MOTION_EDGE_QUEUE_SIZE 16  // Power of two
+
+struct MotionEdge {
+  bool level;          // PIR output after the edge
+  uint32_t timestamp;  // millis() when the interrupt fired
+};
+
+class MotionSensor {
+ public:
+  explicit MotionSensor(uint8_t pin);
+
+  // Configures the pin and attaches the interrupt. A PIR that is already
+  // high is reported as a rising edge.
+  void begin();
+
+  // Pops the oldest edge; returns false when there is none. Call from a
+  // single task only.
+  bool nextEdge(MotionEdge& out);
+
+  // Edges lost because the consumer fell behind
+  uint32_t overflowCount() const { return overflows_.load(std::memory_order_relaxed); }
+
+ private:
+  static void IRAM_ATTR isr(void* arg);
+  void IRAM_ATTR push(bool level, uint32_t timestamp);
+
+  uint8_t pin_;
+  MotionEdge edges_[MOTION_EDGE_QUEUE_SIZE];
+  std::atomic<uint32_t> head_;  // Written by the ISR
+  std::atomic<uint32_t> tail_;  // Written by the consumer
+  std::atomic<uint32_t> overflows_;
+};
+
+#endif // MOTION_SENSOR_H
@@ -0,0 +1,169 @@
+/*
+ * Generated by tools/build_portal.py from portal_page.cpp - do not edit.
+ */
+#ifndef PORTAL_GZ_H
+#define PORTAL_GZ_H
+
+#include <Arduino.h>
+
+#define PORTAL_HTML_ETAG "\"85a2234f9db42195\""
+
+const size_t portal_html_gz_len = 2454;
+const uint8_t portal_html_gz[] PROGMEM = {
+  0x1f, 0x8b, 0x08, 0x00, 0x00, 0x00, 0x00, 0x00, 0x02, 0x03, 0xd5, 0x59, 0x4d, 0x6f, 0xe3, 0xc6,
+  0x19, 0xbe, 0xfb, 0x57, 0x4c, 0xb9, 0x4d, 0x24, 0xb5, 0x26, 0x25, 0xea, 0xc3, 0x1f, 0xb2, 0xe5,
+  0x76, 0xb3, 0xbb, 0x46, 0x17, 0xd9, 0x24, 0x5b, 0xd8, 0x41, 0x91, 0xdb, 0x8e, 0xc8, 0x91, 0x38,
+  0x31, 0x45, 0xb2, 0xe4, 0x48, 0xb2, 0xd7, 0xf0, 0xa9, 0xe8, 0x2d, 0x05, 0x5a, 0xa0, 0x40, 0x0e,
+  0x6d, 0x51, 0x14, 0x45, 0x0f, 0x01, 0x9a, 0x5b, 0x4f, 0xbb, 0x87, 0x1e, 0xb6, 0x7f, 0xc4, 0xf9,
+  0x05, 0xfd, 0x09, 0x7d, 0xde, 0x99, 0xa1, 0x44, 0xca, 0xf6, 0x76, 0x13, 0xe7, 0x12, 0xc8, 0xe2,
+  0xc7, 0xcc, 0x3b, 0xef, 0xf7, 0x3c, 0xef, 0x3b, 0xf2, 0xe1, 0x8f, 0x1e, 0x7f, 0xf2, 0xe8, 0xf4,
+  0xb3, 0xe7, 0x4f, 0x58, 0xa4, 0x66, 0xf1, 0xd1, 0xd6, 0x21, 0xdd, 0x58, 0xcc, 0x93, 0xe9, 0xc8,
+  0x59, 0x48, 0x87, 0x06, 0x04, 0x0f, 0x71, 0x9b, 0x09, 0xc5, 0x59, 0x10, 0xf1, 0xbc, 0x10, 0x6a,
+  0xe4, 0x7c, 0x7a, 0x7a, 0xec, 0xee, 0x39, 0xac, 0x5d, 0x4e, 0x24, 0x7c, 0x26, 0x68, 0x81, 0x58,
+  0x66, 0x69, 0xae, 0x1c, 0x16, 0xa4, 0x89, 0x12, 0x09, 0x08, 0x97, 0x32, 0x54, 0xd1, 0x28, 0x14,
+  0x0b, 0x19, 0x08, 0x57, 0xbf, 0x6c, 0x33, 0x99, 0x48, 0x25, 0x79, 0xec, 0x16, 0x01, 0x8f, 0xc5,
+  0xc8, 0x37, 0x6c, 0x94, 0x54, 0xb1, 0x38, 0xfa, 0xf0, 0xfa, 0xd5, 0xbf, 0x15, 0x4b, 0xae, 0x5f,
+  0xff, 0x41, 0xb2, 0x5f, 0xc9, 0x63, 0x79, 0xd8, 0x36, 0xe3, 0x5b, 0x87, 0x85, 0xba, 0xa0, 0xfb,
+  0x30, 0x4f, 0x53, 0xc5, 0x2e, 0xb7, 0x5c, 0x37, 0xcb, 0xe5, 0x8c, 0xe7, 0x17, 0x43, 0xf6, 0xa0,
+  0xff, 0xe8, 0xe1, 0xf1, 0xa0, 0x73, 0x80, 0xb1, 0xf1, 0x14, 0xaf, 0x93, 0x90, 0x3e, 0xf4, 0xaa,
+  0xc4, 0xb9, 0xc2, 0x80, 0x2f, 0xe8, 0x43, 0x03, 0x01, 0xcf, 0x43, 0x4b, 0x34, 0x99, 0xe8, 0x05,
+  0x69, 0x1e, 0x8a, 0x1c, 0xef, 0x61, 0xa8, 0x57, 0x88, 0x3c, 0x4f, 0xe9, 0x75, 0xd2, 0xef, 0xf7,
+  0x7a, 0x3b, 0x34, 0x92, 0xf3, 0x50, 0xce, 0x8b, 0x21, 0xf3, 0xbb, 0xd9, 0xf9, 0xc1, 0xd6, 0xd5,
+  0xd6, 0xcf, 0x67, 0x22, 0x94, 0x9c, 0x35, 0xb3, 0x5c, 0x4c, 0x44, 0x5e, 0xb8, 0x41, 0x1a, 0xa7,
+  0x39, 0x4c, 0x89, 0xc4, 0x4c, 0x0c, 0x59, 0xc8, 0xf3, 0xb3, 0x16, 0xd4, 0x5b, 0xab, 0xa9, 0xa5,
+  0xad, 0x35, 0xb0, 0x2a, 0x4d, 0x06, 0xf4, 0xa9, 0xab, 0xd4, 0xe5, 0xf4, 0xa9, 0x69, 0xd5, 0xef,
+  0xf7, 0x49, 0xe6, 0xd5, 0xd6, 0x4f, 0xc0, 0x6b, 0x9c, 0x9e, 0xbb, 0x85, 0x7c, 0x29, 0x13, 0x10,
+  0x1b, 0x0a, 0x10, 0x6a, 0x9d, 0xc6, 0x69, 0x78, 0x01, 0x02, 0xb8, 0x63, 0x2a, 0x93, 0x21, 0x83,
+  0x2b, 0x26, 0xf0, 0xbf, 0x3b, 0xe1, 0x33, 0x19, 0xc3, 0x41, 0xce, 0x89, 0x98, 0xa6, 0x82, 0x7d,
+  0xfa, 0xd4, 0xd9, 0x66, 0x05, 0x4f, 0x0a, 0xb7, 0x10, 0xb9, 0x84, 0xf9, 0x63, 0x1e, 0x9c, 0x4d,
+  0xf3, 0x74, 0x9e, 0x84, 0x43, 0xb6, 0xe0, 0x79, 0x93, 0x94, 0x6d, 0x1d, 0x6c, 0x69, 0x8b, 0xca,
+  0x11, 0xd2, 0x17, 0x63, 0x19, 0x0f, 0x43, 0x2d, 0xb8, 0xdb, 0x31, 0x6e, 0xf0, 0x28, 0xc2, 0x5c,
+  0x26, 0x22, 0xd7, 0x82, 0xcf, 0x4d, 0x6c, 0x87, 0x6c, 0xd0, 0xd1, 0x04, 0xa5, 0x2a, 0x7c, 0xae,
+  0x52, 0x22, 0x8f, 0x7c, 0x90, 0x11, 0x2f, 0x97, 0xc7, 0x72, 0x8a, 0x89, 0x00, 0xd9, 0x21, 0xf2,
+  0x92, 0x10, 0x86, 0x28, 0x95, 0xce, 0xaa, 0xec, 0xe1, 0x16, 0xb2, 0xf9, 0x86, 0x8a, 0xd6, 0x5f,
+  0x37, 0x75, 0xb2, 0x2e, 0x29, 0xe3, 0x65, 0xa8, 0xcd, 0x5b, 0xeb, 0xc0, 0x38, 0x2f, 0xe2, 0x61,
+  0xba, 0x84, 0x7f, 0x58, 0x3f, 0x3b, 0x67, 0x7b, 0xf8, 0xe6, 0xd3, 0x31, 0x6f, 0x76, 0xb6, 0xf5,
+  0xc7, 0xeb, 0xec, 0xb5, 0xb4, 0xe8, 0xb1, 0x4a, 0x6e, 0x95, 0x6c, 0x13, 0x6e, 0xed, 0xa1, 0x65,
+  0x24, 0x95, 0x28, 0x05, 0x0f, 0x59, 0x92, 0x26, 0xa2, 0xa2, 0x95, 0x49, 0x18, 0xeb, 0x16, 0xbf,
+  0xd3, 0x79, 0xcf, 0x46, 0x05, 0x21, 0x44, 0xa2, 0xf8, 0x3b, 0xb7, 0xe8, 0xbc, 0x47, 0x63, 0xc1,
+  0x3c, 0x2f, 0x88, 0x7b, 0x96, 0xca, 0x9a, 0x8b, 0x54, 0x9a, 0x11, 0x1f, 0xeb, 0x1f, 0x28, 0x39,
+  0x8c, 0xd2, 0x85, 0x76, 0x7f, 0x55, 0xd5, 0x07, 0xfd, 0x1e, 0xef, 0xf4, 0x77, 0x89, 0xe6, 0x41,
+  0xa1, 0xb8, 0x9a, 0x17, 0xab, 0xc4, 0x58, 0x39, 0xd9, 0x30, 0xd1, 0xca, 0x2c, 0x85, 0x9c, 0x46,
+  0x8a, 0xf2, 0x29, 0x0e, 0x35, 0xdf, 0x44, 0xa8, 0x65, 0x9a, 0x9f, 0x61, 0x51, 0x28, 0x8b, 0x2c,
+  0xe6, 0x48, 0x9f, 0x49, 0x2c, 0x40, 0xfe, 0xf9, 0xbc, 0x50, 0x72, 0x72, 0xe1, 0xda, 0x9d, 0x3d,
+  0x64, 0x45, 0xc6, 0xb1, 0xa5, 0xc7, 0xa0, 0x17, 0x22, 0x39, 0xd8, 0xd2, 0x71, 0x75, 0xe1, 0x90,
+  0x59, 0xb1, 0x8e, 0xee, 0x86, 0x33, 0x56, 0x59, 0x6b, 0xf5, 0x40, 0x04, 0x8a, 0x34, 0x96, 0x61,
+  0x99, 0x7d, 0x7a, 0xba, 0x75, 0x8b, 0x0b, 0xd6, 0x8a, 0xdd, 0x6a, 0x74, 0x3d, 0x8c, 0x03, 0x13,
+  0xc6, 0xa5, 0x9c, 0x48, 0xb7, 0x50, 0x79, 0x0a, 0xf9, 0xc3, 0xb1, 0x98, 0xa4, 0xb9, 0xd8, 0xb6,
+  0xa3, 0xd3, 0x34, 0x0d, 0x37, 0xc7, 0x96, 0x82, 0x9f, 0x95, 0x63, 0x60, 0xbf, 0x32, 0xb3, 0xd1,
+  0x38, 0x58, 0xbb, 0x42, 0x26, 0x31, 0x52, 0xde, 0x1d, 0xc7, 0x69, 0x70, 0xb6, 0x8a, 0xad, 0x49,
+  0xbf, 0xc8, 0x7a, 0xd2, 0x26, 0xe3, 0x4a, 0x3b, 0x1b, 0x6f, 0xbb, 0x5d, 0x6a, 0x33, 0xb9, 0xc8,
+  0x04, 0x57, 0x94, 0x38, 0xf6, 0xf1, 0x2e, 0xbd, 0x6b, 0xe6, 0xba, 0xc8, 0xc2, 0x29, 0x38, 0xce,
+  0xf3, 0xb8, 0xd9, 0x08, 0xb9, 0xe2, 0x43, 0x3d, 0xd0, 0x2e, 0x16, 0xd3, 0x9f, 0x9e, 0xcf, 0xe2,
+  0xed, 0x43, 0x3c, 0xb0, 0x89, 0x8c, 0xe3, 0x91, 0xf3, 0x5e, 0xb7, 0x67, 0xb0, 0xd1, 0x61, 0x04,
+  0xcd, 0x1f, 0xa4, 0xe7, 0x23, 0xa7, 0x83, 0xf4, 0xef, 0xf6, 0xf1, 0xe7, 0x30, 0x50, 0x27, 0xc5,
+  0xc8, 0x89, 0x94, 0xca, 0x86, 0xed, 0xf6, 0x72, 0xb9, 0xf4, 0x96, 0x3d, 0x2f, 0xcd, 0xa7, 0xed,
+  0x6e, 0xa7, 0xd3, 0x21, 0x7e, 0xce, 0xd1, 0x61, 0xc6, 0x55, 0xc4, 0xc2, 0x91, 0xf3, 0x51, 0xd7,
+  0xf3, 0xd9, 0xbe, 0xb7, 0xf3, 0xac, 0xe7, 0x0d, 0x98, 0xef, 0x3f, 0xf4, 0x7b, 0xde, 0x7e, 0x9f,
+  0x99, 0x2b, 0x58, 0xfa, 0x7e, 0x97, 0xed, 0x04, 0x3d, 0x6f, 0x07, 0x2f, 0x3b, 0xde, 0x3e, 0xf3,
+  0xbd, 0x3e, 0xa8, 0xfb, 0x0c, 0x23, 0x31, 0x9e, 0x5d, 0x7c, 0x1f, 0xf9, 0x34, 0x30, 0x00, 0x1b,
+  0x7f, 0xe0, 0xed, 0x31, 0xcd, 0xa7, 0x4b, 0xb7, 0x93, 0x3e, 0x96, 0xd1, 0xb8, 0x15, 0xf1, 0xd2,
+  0x69, 0x57, 0xe4, 0xea, 0x05, 0x5d, 0xc3, 0x86, 0xd8, 0x3e, 0xdc, 0xf7, 0xf6, 0x89, 0x0c, 0x17,
+  0x2b, 0xd7, 0xef, 0x04, 0x5d, 0x30, 0xc3, 0xae, 0x06, 0x5b, 0x1f, 0xe2, 0x07, 0xac, 0xbb, 0x16,
+  0xfb, 0xd0, 0xf7, 0xbd, 0xfd, 0x1e, 0x33, 0x57, 0xac, 0xe8, 0x60, 0xc5, 0x5e, 0xe0, 0xe2, 0xd9,
+  0x1d, 0x78, 0xbb, 0xe0, 0xd8, 0x75, 0x77, 0xa1, 0x70, 0x6f, 0x53, 0xee, 0x9e, 0x51, 0x74, 0xe7,
+  0x19, 0x49, 0xd8, 0x8f, 0x61, 0xa8, 0xdb, 0xf3, 0xfa, 0x7c, 0xe0, 0xed, 0xef, 0x31, 0x7d, 0x21,
+  0x5e, 0x58, 0x8a, 0x07, 0xbd, 0x90, 0xfc, 0x75, 0xd4, 0xa8, 0xa4, 0x5e, 0x35, 0xc9, 0xee, 0x11,
+  0xc0, 0xe3, 0xe3, 0xfd, 0xbd, 0xce, 0xf7, 0x11, 0xc0, 0x1f, 0xac, 0x23, 0x37, 0x76, 0xe6, 0x77,
+  0x76, 0xa4, 0x2e, 0xe9, 0xdf, 0x83, 0x23, 0xef, 0x61, 0xd0, 0x03, 0x8b, 0x62, 0x85, 0x2d, 0x9a,
+  0x6b, 0xd0, 0xd0, 0xa8, 0x41, 0xd0, 0x36, 0x89, 0xd3, 0xa5, 0x7b, 0x51, 0x56, 0xce, 0x9b, 0xd8,
+  0x6f, 0x31, 0xd4, 0x8c, 0xdc, 0x05, 0xa0, 0x90, 0x04, 0xc0, 0x49, 0x44, 0x80, 0x26, 0x20, 0xcd,
+  0x67, 0xeb, 0x12, 0xa0, 0x97, 0xad, 0x8a, 0x6c, 0xc6, 0x8b, 0xc2, 0x25, 0x5f, 0x66, 0xa0, 0xc8,
+  0xd2, 0x02, 0x6d, 0x59, 0x8a, 0xda, 0x9c, 0x8b, 0x98, 0x2b, 0xb9, 0x10, 0x9b, 0x34, 0x32, 0xc9,
+  0xe6, 0xd4, 0xd4, 0xd4, 0x6a, 0xda, 0x1a, 0xe2, 0xc1, 0x95, 0xf5, 0xe9, 0xe2, 0x97, 0x97, 0x75,
+  0x6d, 0xbc, 0x53, 0xd3, 0xdb, 0x2a, 0xe0, 0x8d, 0x32, 0x09, 0x35, 0x54, 0x3a, 0x9d, 0xc6, 0xc2,
+  0x25, 0x6d, 0x6a, 0xba, 0xf2, 0x31, 0xd8, 0xce, 0xa9, 0x0c, 0xe7, 0xc6, 0x95, 0x46, 0xae, 0xb6,
+  0x73, 0x40, 0xfa, 0xa9, 0x1c, 0x1d, 0x0f, 0x39, 0x61, 0xc8, 0xf4, 0x23, 0x4c, 0x13, 0x9f, 0x35,
+  0x5d, 0xcc, 0xb5, 0xea, 0x1d, 0x90, 0x29, 0xdf, 0xf5, 0x62, 0x7e, 0xa3, 0x10, 0xad, 0xac, 0xed,
+  0xdc, 0xd0, 0x8a, 0x92, 0xed, 0xf2, 0x6d, 0x35, 0x81, 0x32, 0x71, 0xa3, 0xad, 0x02, 0x8b, 0x55,
+  0x91, 0xae, 0xb5, 0x5d, 0xeb, 0x5e, 0x03, 0x24, 0xba, 0x29, 0xdd, 0xa4, 0xd0, 0x83, 0x7a, 0x1e,
+  0x09, 0x66, 0x7a, 0xe3, 0xc3, 0xb6, 0xed, 0xd5, 0xa9, 0x1f, 0xc4, 0x2d, 0x94, 0x0b, 0x16, 0xc4,
+  0xd0, 0x6d, 0xe4, 0xac, 0xba, 0x35, 0xdd, 0xd1, 0xfb, 0xb7, 0xf4, 0xd9, 0x18, 0xac, 0xaf, 0x40,
+  0x9f, 0xe5, 0xd8, 0x21, 0x89, 0xb4, 0x37, 0x7a, 0x3a, 0x47, 0xff, 0xf9, 0x3d, 0xce, 0x06, 0xec,
+  0xd7, 0xf3, 0x37, 0x5f, 0x29, 0x36, 0xbb, 0x7e, 0xf5, 0xb7, 0x64, 0xea, 0x79, 0xde, 0x61, 0x1b,
+  0x64, 0x24, 0x78, 0x8e, 0xca, 0x9e, 0x94, 0x2c, 0xd0, 0xa3, 0x38, 0x2c, 0x4d, 0x82, 0x58, 0x06,
+  0x67, 0x60, 0x10, 0xf0, 0xe4, 0x63, 0x9b, 0xfe, 0xcd, 0x96, 0x73, 0xf4, 0xdf, 0xbf, 0xfe, 0xf1,
+  0x77, 0xec, 0x97, 0x9a, 0x4f, 0x0c, 0x3e, 0x50, 0xc1, 0xac, 0xae, 0xc8, 0x2c, 0x77, 0x0b, 0x76,
+  0x9f, 0x15, 0x50, 0xce, 0x54, 0xb3, 0xdb, 0x61, 0xda, 0xfe, 0x91, 0x53, 0x96, 0x69, 0x1d, 0x3b,
+  0x6d, 0x68, 0xcf, 0xa8, 0x2e, 0x62, 0xd0, 0x0a, 0x94, 0xe2, 0x42, 0x86, 0xc4, 0x2b, 0xea, 0xd5,
+  0x6d, 0x5d, 0xe7, 0x38, 0xad, 0x32, 0x69, 0xae, 0x2e, 0x32, 0x61, 0x66, 0xa0, 0x42, 0xe8, 0x68,
+  0x46, 0xeb, 0x37, 0xc8, 0x09, 0x44, 0x84, 0xa6, 0x49, 0xe4, 0x23, 0xe7, 0xe3, 0xe8, 0xfa, 0xd5,
+  0xd7, 0x19, 0x79, 0xe3, 0x6b, 0xc5, 0xce, 0xf0, 0xf2, 0xd5, 0x5c, 0x3b, 0xd5, 0xb9, 0xe1, 0x91,
+  0x4a, 0xbe, 0x54, 0x3c, 0x63, 0x46, 0x9f, 0x5b, 0xe6, 0x4d, 0x15, 0xc9, 0xa2, 0x45, 0x6b, 0x29,
+  0xa3, 0x6e, 0x41, 0xab, 0x0a, 0x14, 0x01, 0x81, 0x06, 0x81, 0xbb, 0x0b, 0x08, 0xf6, 0x7d, 0xb6,
+  0xab, 0x2f, 0x45, 0x9f, 0x01, 0x8c, 0x7d, 0x7d, 0x71, 0xcd, 0xc5, 0xed, 0xbb, 0x34, 0xe7, 0xee,
+  0xbe, 0x9c, 0x75, 0x50, 0x02, 0x02, 0xb7, 0x4b, 0xd8, 0xe4, 0x0e, 0x70, 0xef, 0xe2, 0x3a, 0x28,
+  0xf4, 0x9d, 0x0d, 0xe8, 0x0b, 0xc4, 0x07, 0x4f, 0xa6, 0xe7, 0xcc, 0x08, 0x16, 0xb9, 0x7b, 0xbc,
+  0xc7, 0x08, 0xf4, 0xb1, 0xe5, 0xd9, 0x0e, 0x33, 0xcf, 0x40, 0x46, 0x77, 0x67, 0x0d, 0x70, 0x5b,
+  0x95, 0xf8, 0xbd, 0x43, 0x36, 0xd8, 0x00, 0xda, 0x44, 0xf8, 0x92, 0x55, 0x12, 0xf2, 0x26, 0xa3,
+  0xfa, 0xad, 0x08, 0x72, 0x99, 0xa9, 0xa3, 0xad, 0x58, 0x28, 0x56, 0x86, 0xf6, 0xe4, 0xe4, 0xe9,
+  0x63, 0x36, 0xd2, 0xcd, 0xda, 0x64, 0x9e, 0x04, 0x84, 0x0d, 0xac, 0x9e, 0x70, 0xd4, 0xd1, 0xa6,
+  0xc1, 0x7c, 0x86, 0xa6, 0xce, 0x9b, 0x0a, 0xf5, 0x24, 0x16, 0xf4, 0xf8, 0xc1, 0xc5, 0xd3, 0xb0,
+  0xd9, 0x30, 0xb9, 0xdd, 0x68, 0x79, 0x12, 0x4a, 0xe5, 0xa7, 0xd8, 0x9b, 0xc4, 0xeb, 0xd6, 0x4c,
+  0x27, 0x01, 0x42, 0x05, 0x51, 0xb3, 0xd1, 0x26, 0xfe, 0x8d, 0x16, 0x40, 0x20, 0x12, 0x49, 0x33,
+  0x17, 0x05, 0x1b, 0x1d, 0x01, 0x3a, 0x0b, 0xef, 0xf3, 0x22, 0x4d, 0x9a, 0xad, 0x72, 0x82, 0xea,
+  0x12, 0xcd, 0x5c, 0x6e, 0xb5, 0xdb, 0xec, 0x58, 0xe6, 0x85, 0xd2, 0x8a, 0x21, 0x67, 0x01, 0x07,
+  0x2c, 0x9f, 0x27, 0x89, 0xc6, 0x13, 0x5e, 0x9c, 0x31, 0x3e, 0xc5, 0x16, 0x65, 0x45, 0x84, 0x13,
+  0x74, 0x7c, 0xb1, 0x25, 0x27, 0x4c, 0x2f, 0xf6, 0x88, 0x9c, 0x88, 0xd8, 0xfb, 0xef, 0x33, 0x3d,
+  0x50, 0x6e, 0x0b, 0x2f, 0x16, 0xc9, 0x14, 0x99, 0x30, 0x1a, 0x8d, 0x58, 0x87, 0x0c, 0xc4, 0xd1,
+  0xfc, 0x54, 0xce, 0x44, 0x3a, 0x57, 0xcd, 0xaa, 0xf1, 0xdb, 0x14, 0xb7, 0x0e, 0xb0, 0x22, 0x17,
+  0x6a, 0x9e, 0x27, 0x84, 0x19, 0x70, 0x3f, 0x14, 0x29, 0x19, 0x3d, 0x89, 0x61, 0xef, 0x9d, 0xde,
+  0x29, 0xa9, 0xa8, 0x84, 0xad, 0x57, 0x18, 0x5f, 0xfd, 0xe2, 0xf4, 0xa3, 0x67, 0xd6, 0xef, 0x75,
+  0xd5, 0xb0, 0x31, 0x9f, 0x70, 0xb8, 0x09, 0x03, 0xc6, 0x7a, 0x8a, 0x56, 0x2c, 0x16, 0x82, 0x44,
+  0x35, 0x56, 0x75, 0x1d, 0xeb, 0xc8, 0x4e, 0x50, 0x79, 0x39, 0x76, 0x27, 0x3b, 0x62, 0x40, 0xe6,
+  0xd6, 0x06, 0xa1, 0x69, 0x86, 0x41, 0x2a, 0xe2, 0x42, 0xb0, 0x4d, 0xfa, 0xdd, 0x1b, 0xf4, 0xd4,
+  0x79, 0x81, 0x1a, 0xfe, 0xa6, 0xb4, 0x28, 0x18, 0x47, 0xdf, 0x30, 0x4f, 0x54, 0x8e, 0x13, 0x8c,
+  0x00, 0xd0, 0x8f, 0xe7, 0x32, 0x0e, 0x19, 0x82, 0xc3, 0xf2, 0x74, 0xc9, 0x96, 0x52, 0x45, 0x70,
+  0x18, 0x5b, 0x99, 0x63, 0x7d, 0x43, 0x73, 0x15, 0xa7, 0x04, 0x39, 0xfa, 0x73, 0x61, 0xfd, 0x82,
+  0x6e, 0x43, 0x2e, 0xc8, 0x1d, 0x20, 0xf2, 0x74, 0x7a, 0x7f, 0xcc, 0x67, 0x82, 0xe4, 0x5b, 0xfb,
+  0x1b, 0x66, 0xca, 0x66, 0x3b, 0x26, 0x90, 0x7f, 0xf0, 0x82, 0xc9, 0x56, 0x1b, 0x16, 0x6d, 0x04,
+  0x21, 0x92, 0x3e, 0x50, 0xea, 0x70, 0x18, 0x26, 0x77, 0xc9, 0xc4, 0x81, 0x2b, 0xd1, 0x31, 0x00,
+  0x99, 0x47, 0x05, 0xe4, 0x91, 0x39, 0xa3, 0x60, 0x49, 0xc9, 0xaa, 0xe4, 0x54, 0xe0, 0x2c, 0xc6,
+  0xe3, 0x77, 0xe0, 0x65, 0x08, 0x6b, 0x36, 0x68, 0x5f, 0x1a, 0xfd, 0x79, 0x96, 0x89, 0x24, 0x6c,
+  0x92, 0xc0, 0x6d, 0xcb, 0xb3, 0x9e, 0x03, 0x86, 0xe0, 0x51, 0x04, 0x87, 0x36, 0xb1, 0x80, 0xca,
+  0x11, 0xbe, 0xef, 0xb8, 0xcf, 0x6c, 0xee, 0xbc, 0x38, 0x24, 0x65, 0x4a, 0x94, 0x28, 0xcb, 0xcc,
+  0xe9, 0x9b, 0x7f, 0xce, 0x10, 0xa3, 0xeb, 0x57, 0xff, 0xb8, 0x60, 0x3f, 0xbe, 0xbc, 0x2d, 0xed,
+  0xaf, 0xec, 0xa6, 0x04, 0xfc, 0x60, 0xfd, 0xd1, 0x0b, 0x92, 0x4d, 0xbf, 0x1b, 0xd0, 0xe6, 0x34,
+  0xee, 0xbe, 0xfc, 0x96, 0x9a, 0x34, 0x6a, 0x9a, 0xe8, 0x02, 0xeb, 0x1c, 0x7d, 0x18, 0xbd, 0xf9,
+  0x17, 0xf6, 0x1e, 0x54, 0x79, 0xfd, 0x9b, 0x1a, 0x18, 0x58, 0xb9, 0x0d, 0x63, 0xf3, 0x55, 0x05,
+  0x77, 0x6a, 0x51, 0xd6, 0x11, 0xd6, 0x7b, 0xb3, 0x86, 0x54, 0x26, 0x5a, 0x77, 0xeb, 0x57, 0x2d,
+  0x59, 0x1b, 0xc0, 0xf4, 0x82, 0x58, 0x0c, 0xe1, 0x15, 0x9a, 0xbb, 0x7a, 0xf1, 0x16, 0x2e, 0xd5,
+  0x2a, 0x09, 0x26, 0xba, 0x4c, 0x7a, 0xb6, 0x4a, 0x92, 0xbd, 0xfa, 0x1c, 0xdb, 0xa8, 0x29, 0xbf,
+  0xc2, 0x65, 0x73, 0x06, 0x46, 0x2e, 0x95, 0x45, 0xef, 0x6d, 0x10, 0x51, 0xd2, 0x40, 0xc8, 0x82,
+  0xc7, 0x73, 0x51, 0xe6, 0xa1, 0x01, 0x3f, 0xa4, 0xe7, 0x92, 0x1d, 0x43, 0x87, 0xc7, 0x78, 0x6d,
+  0xb6, 0x2c, 0x54, 0xd8, 0xe4, 0x6a, 0x68, 0x0b, 0xb7, 0x6b, 0x48, 0xbe, 0x49, 0xb2, 0x62, 0xbf,
+  0xbd, 0xd2, 0xe6, 0xdb, 0xa7, 0x19, 0xca, 0xcc, 0x17, 0xcc, 0x60, 0xfa, 0x59, 0xa5, 0xfb, 0x51,
+  0xd7, 0xaf, 0xff, 0x24, 0xc9, 0x99, 0x15, 0xf9, 0x57, 0x00, 0xfa, 0x17, 0x6b, 0xa0, 0xb7, 0x3e,
+  0x81, 0x74, 0xf4, 0xd1, 0x02, 0x70, 0x01, 0x10, 0x69, 0x3c, 0xff, 0xe4, 0xe4, 0xb4, 0xb1, 0xad,
+  0x7f, 0x7a, 0x1b, 0x6a, 0x3b, 0x75, 0xfa, 0xbd, 0x6b, 0x2d, 0x58, 0x83, 0xfb, 0x3c, 0x08, 0x44,
+  0x51, 0xb4, 0x74, 0x53, 0x1b, 0xc7, 0x27, 0x5a, 0x75, 0xf2, 0xd1, 0x15, 0xd3, 0x68, 0x77, 0x79,
+  0xaf, 0xdd, 0x64, 0x73, 0xf8, 0x9b, 0xbf, 0x7c, 0x51, 0x2d, 0xb0, 0x66, 0x5f, 0x29, 0x36, 0x36,
+  0x6d, 0xd7, 0x6a, 0xfb, 0xdc, 0x7b, 0x03, 0xdd, 0x29, 0xfc, 0xd9, 0xf5, 0xeb, 0x2f, 0x65, 0xd5,
+  0xed, 0xd5, 0x4d, 0x4b, 0x92, 0x81, 0xd5, 0xa7, 0x00, 0xe4, 0x68, 0x3e, 0x2e, 0x33, 0xb0, 0x00,
+  0x22, 0x6b, 0x90, 0x5e, 0xf7, 0xe8, 0x07, 0xd4, 0x3e, 0xa0, 0x00, 0x50, 0x21, 0xe1, 0x0b, 0x38,
+  0xf9, 0xe1, 0x73, 0x36, 0x4b, 0x43, 0xc1, 0xa8, 0x63, 0x22, 0x16, 0x19, 0x4e, 0x7f, 0x2c, 0x4e,
+  0x0b, 0x4c, 0xd1, 0x4a, 0x0b, 0x18, 0xdb, 0xf4, 0x43, 0x5d, 0x10, 0x31, 0x1e, 0x17, 0x29, 0x9b,
+  0x09, 0x9c, 0x01, 0xf4, 0xac, 0x95, 0x43, 0x49, 0x4f, 0x54, 0x22, 0x5c, 0x6f, 0x82, 0x6a, 0x24,
+  0xe0, 0x84, 0x55, 0xc1, 0xb7, 0x36, 0x7f, 0x97, 0x30, 0x63, 0xa9, 0xd0, 0x85, 0xba, 0xdc, 0x94,
+  0x28, 0xe8, 0x8d, 0x8d, 0x9a, 0xbd, 0x16, 0xbb, 0xaa, 0xd8, 0x36, 0x0b, 0xde, 0xc2, 0x47, 0x84,
+  0x8d, 0xd6, 0x3d, 0x03, 0x55, 0x62, 0xee, 0x37, 0x7f, 0xfe, 0x2d, 0x36, 0xc8, 0x9b, 0xbf, 0xff,
+  0xff, 0xfd, 0x51, 0x09, 0xdf, 0x0f, 0x3e, 0x4d, 0xef, 0x65, 0x7d, 0x1d, 0xf9, 0x37, 0x1a, 0x79,
+  0x74, 0xbc, 0x6b, 0x18, 0x35, 0xa7, 0x8a, 0x11, 0xc3, 0xa0, 0x97, 0xe5, 0x62, 0x21, 0xd3, 0x79,
+  0x61, 0x55, 0x3d, 0x91, 0xe3, 0x18, 0xe9, 0x80, 0x56, 0x88, 0x68, 0x3c, 0x3a, 0x79, 0x80, 0xb0,
+  0xfa, 0x42, 0xf1, 0x5e, 0x81, 0x20, 0xfb, 0x19, 0x6b, 0x50, 0xf9, 0x6f, 0xb0, 0x61, 0x65, 0x94,
+  0x14, 0x59, 0xca, 0x24, 0xd4, 0x6d, 0x47, 0x9c, 0x72, 0xc2, 0xeb, 0x6a, 0x13, 0x78, 0x40, 0xe7,
+  0x44, 0xdb, 0x39, 0xa3, 0xc3, 0x36, 0x27, 0xc4, 0xb6, 0xfe, 0xa7, 0xcf, 0xff, 0x00, 0x96, 0x71,
+  0xb2, 0x9a, 0x04, 0x1a, 0x00, 0x00,
+};
+
+#endif // PORTAL_GZ_H
@@ -0,0 +1,289 @@
+/*
+ * Captive portal page: network list, password form and status polling
+ *
+ * tools/build_portal.py compresses it into portal_gz.h, which is what
+ * most clients get; run it after editing the page.
+ */
+#include "portal_page.h"
+
+const char portal_html[] PROGMEM = R"=====(
+<!DOCTYPE html>
+<html lang="vi">
+<head>
+  <meta charset="UTF-8" />
+  <meta name="viewport" content="width=device-width, initial-scale=1" />
+  <title>Kết nối WiFi</title>
+  <style>
+    :root {
+      --primary: #4CAF50;
+      --bg: #fdfdfd;
+      --text: #1e1e1e;
+      --card-bg: #fff;
+      --border: #ddd;
+      --error: #f44336;
+      --radius: 12px;
+    }
+
+    @media (prefers-color-scheme: dark) {
+      :root {
+        --bg: #1e1e1e;
+        --text: #f5f5f5;
+        --card-bg: #2a2a2a;
+        --border: #444;
+      }
+    }
+
+    * {
+      box-sizing: border-box;
+    }
+
+    body {
+      margin: 0;
+      font-family: "Segoe UI", sans-serif;
+      background: var(--bg);
+      color: var(--text);
+      padding: 20px;
+    }
+
+    .container {
+      max-width: 500px;
+      margin: auto;
+    }
+
+    h1 {
+      text-align: center;
+      margin-bottom: 20px;
+    }
+
+    .card {
+      background: var(--card-bg);
+      padding: 20px;
+      border-radius: var(--radius);
+      box-shadow: 0 4px 8px rgba(0,0,0,0.08);
+    }
+
+    .btn {
+      background: var(--primary);
+      color: white;
+      border: none;
+      padding: 12px;
+      width: 100%;
+      font-size: 16px;
+      border-radius: 8px;
+      cursor: pointer;
+      margin-top: 10px;
+    }
+
+    .btn:hover {
+      background: #43a047;
+    }
+
+    #status {
+      margin-bottom: 10px;
+      font-weight: bold;
+    }
+
+    .network {
+      display: flex;
+      justify-content: space-between;
+      align-items: center;
+      padding: 12px;
+      border-bottom: 1px solid var(--border);
+      cursor: pointer;
+    }
+
+    .network:hover {
+      background: rgba(0,0,0,0.05);
+    }
+
+    .wifi-strong::before,
+    .wifi-good::before,
+    .wifi-weak::before {
+      content: '';
+      display: inline-block;
+      width: 20px;
+      height: 20px;
+      background-size: contain;
+      background-repeat: no-repeat;
+    }
+
+    .wifi-strong::before {
+      background-image: url('data:image/svg+xml,<svg fill="%234CAF50" viewBox="0 0 24 24" xmlns="http://www.w3.org/2000/svg"><path d="M2.1 9.6L3.5 11A13.94 13.94 0 0112 6c3.6 0 6.9 1.4 9.4 3.6l1.4-1.4C19.4 5.1 15.8 3.5 12 3.5S4.6 5.1 2.1 9.6z"/><path d="M5.1 12.6l1.4 1.4A9.91 9.91 0 0112 10c2.5 0 4.8 1 6.5 2.6l1.4-1.4A11.93 11.93 0 0012 8c-3 0-5.7 1.2-7.9 3.6z"/><path d="M8.1 15.6L12 19l3.9-3.4a5.98 5.98 0 00-7.8 0z"/></svg>');
+    }
+
+    .wifi-good::before {
+      background-image: url('data:image/svg+xml,<svg fill="%23FF9800" viewBox="0 0 24 24" xmlns="http://www.w3.org/2000/svg"><path d="M5.1 12.6l1.4 1.4A9.91 9.91 0 0112 10c2.5 0 4.8 1 6.5 2.6l1.4-1.4A11.93 11.93 0 0012 8c-3 0-5.7 1.2-7.9 3.6z"/><path d="M8.1 15.6L12 19l3.9-3.4a5.98 5.98 0 00-7.8 0z"/></svg>');
+    }
+
+    .wifi-weak::before {
+      background-image: url('data:image/svg+xml,<svg fill="%23F44336" viewBox="0 0 24 24" xmlns="http://www.w3.org/2000/svg"><path d="M8.1 15.6L12 19l3.9-3.4a5.98 5.98 0 00-7.8 0z"/></svg>');
+    }
+
+    #networks {
+      max-height: 200px;
+      overflow-y: auto;
+      margin-top: 10px;
+      border-top: 1px solid var(--border);
+    }
+
+    #connect-form {
+      margin-top: 20px;
+    }
+
+    .pass-group {
+      position: relative;
+    }
+
+    .pass-group input {
+      width: 100%;
+      padding: 10px 40px 10px 10px;
+      border: 1px solid var(--border);
+      border-radius: 8px;
+      font-size: 16px;
+    }
+
+    .toggle-pass {
+      position: absolute;
+      right: 10px;
+      top: 50%;
+      transform: translateY(-50%);
+      background: none;
+      border: none;
+      cursor: pointer;
+      padding: 0;
+    }
+
+    .toggle-pass svg {
+      width: 20px;
+      height: 20px;
+      fill: var(--text);
+    }
+
+    .status {
+      color: var(--primary);
+    }
+
+    .error {
+      color: var(--error);
+    }
+  </style>
+</head>
+<body>
+  <div class="container">
+    <h1>Kết nối WiFi</h1>
+    <div class="card">
+      <div id="status">Đang quét mạng...</div>
+      <button class="btn" onclick="scanNetworks()">🔍 Quét lại</button>
+      <div id="networks"></div>
+
+      <div id="connect-form" style="display:none;">
+        <h3 id="selected-ssid"></h3>
+        <div class="pass-group">
+          <input type="password" id="password" placeholder="Nhập mật khẩu WiFi">
+          <button class="toggle-pass" onclick="togglePassword(this)">
+            <svg viewBox="0 0 24 24"><path d="M12 5c-7 0-11 7-11 7s4 7 11 7 11-7 11-7-4-7-11-7zm0 12c-2.8 0-5-2.2-5-5s2.2-5 5-5 5 2.2 5 5-2.2 5-5 5zm0-8a3 3 0 100 6 3 3 0 000-6z"/></svg>
+          </button>
+        </div>
+        <button class="btn" onclick="connect()">🔗 Kết nối</button>
+      </div>
+    </div>
+  </div>
+
+  <script>
+    let selectedSSID = '';
+
+    function scanNetworks() {
+      document.getElementById('status').innerText = 'Đang quét mạng...';
+      fetch('/scan')
+        .then(res => res.json())
+        .then(data => {
+          // First scan still running: ask again shortly
+          if (data.scanning && data.networks.length === 0) {
+            setTimeout(scanNetworks, 1000);
+            return;
+          }
+          const networksEl = document.getElementById('networks');
+          networksEl.innerHTML = '';
+          data.networks.forEach(net => {
+            let level = 'wifi-weak';
+            if (net.rssi > -50) level = 'wifi-strong';
+            else if (net.rssi > -70) level = 'wifi-good';
+            // SSIDs are untrusted: build the row without innerHTML
+            const row = document.createElement('div');
+            row.className = 'network';
+            row.onclick = () => selectNetwork(net.ssid);
+            const name = document.createElement('span');
+            name.textContent = net.ssid;
+            const signal = document.createElement('span');
+            signal.className = level;
+            row.append(name, signal);
+            networksEl.appendChild(row);
+          });
+          document.getElementById('status').innerHTML = `<span class="status">Tìm thấy ${data.networks.length} mạng</span>`;
+        })
+        .catch(() => {
+          document.getElementById('status').innerHTML = '<span class="error">Không thể quét mạng</span>';
+        });
+    }
+
+    function selectNetwork(ssid) {
+      selectedSSID = ssid;
+      document.getElementById('selected-ssid').innerText = `SSID: ${ssid}`;
+      document.getElementById('connect-form').style.display = 'block';
+    }
+
+    function connect() {
+      const password = document.getElementById('password').value;
+      const data = new FormData();
+      data.append('ssid', selectedSSID);
+      data.append('password', password);
+
+      document.getElementById('status').innerHTML = `🔌 Đang kết nối tới ${selectedSSID}...`;
+
+      fetch('/connect', {
+        method: 'POST',
+        body: data
+      })
+        .then(res => res.json())
+        .then(data => {
+          if (data.success) {
+            pollStatus();
+          } else {
+            document.getElementById('status').innerHTML = `<span class="error">❌ Kết nối thất bại</span>`;
+          }
+        })
+        .catch(() => {
+          document.getElementById('status').innerHTML = `<span class="error">❌ Lỗi kết nối</span>`;
+        });
+    }
+
+    // The hub connects in the background; once it leaves AP mode this
+    // page loses the network, which also means the connection worked
+    function pollStatus() {
+      fetch('/status')
+        .then(res => res.json())
+        .then(data => {
+          if (data.state === 'connecting') {
+            setTimeout(pollStatus, 1000);
+          } else if (data.state === 'connected') {
+            document.getElementById('status').innerHTML = `<span class="status">✅ Đã kết nối tới ${selectedSSID}</span>`;
+          } else {
+            document.getElementById('status').innerHTML = `<span class="error">❌ Kết nối thất bại</span>`;
+          }
+        })
+        .catch(() => {
+          document.getElementById('status').innerHTML = `<span class="status">✅ Đã kết nối tới ${selectedSSID}</span>`;
+        });
+    }
+
+    function togglePassword(btn) {
+      const input = btn.previousElementSibling;
+      input.type = input.type === 'password' ? 'text' : 'password';
+    }
+
+    window.onload = scanNetworks;
+  </script>
+</body>
+</html>
+
+)=====";
@@ -0,0 +1,11 @@
+/*
+ * The captive portal page, uncompressed for clients without gzip
+ */
+#ifndef PORTAL_PAGE_H
+#define PORTAL_PAGE_H
+
+#include <Arduino.h>
+
+extern const char portal_html[];
+
+#endif // PORTAL_PAGE_H
@@ -0,0 +1,98 @@
+/*
+ * Hardware-faded PWM transitions implementation
+ */
+#include "pwm_fader.h"
+
+static bool fadeServiceInstalled = false;
+
+PwmFader::PwmFader(uint8_t channel, uint8_t resolutionBits)
+  : mode_((ledc_mode_t)(channel / 8)), channel_((ledc_channel_t)(channel % 8)),
+    maxDuty_((1UL << resolutionBits) - 1),
+    from_(0), target_(0), duration_(0), curve_(FADE_LINEAR), segment_(0), segments_(0),
+    duty_(0), running_(false), pending_(false), pendingTarget_(0), pendingDuration_(0),
+    pendingCurve_(FADE_LINEAR), segmentDone_(false) {}
+
+bool PwmFader::begin() {
+  if (!fadeServiceInstalled) {
+    esp_err_t err = ledc_fade_func_install(0);
+    if (err != ESP_OK && err != ESP_ERR_INVALID_STATE) return false;
+    fadeServiceInstalled = true;
+  }
+
+  ledc_cbs_t callbacks = { .fade_cb = onFadeEnd };
+  if (ledc_cb_register(mode_, channel_, &callbacks, this) != ESP_OK) return false;
+
+  duty_ = target_ = ledc_get_duty(mode_, channel_);
+  return true;
+}
+
+void PwmFader::fadeTo(uint32_t target, uint32_t durationMs, FadeCurve curve) {
+  pendingTarget_ = min(target, maxDuty_);
+  pendingDuration_ = durationMs;
+  pendingCurve_ = curve;
+  pending_ = true;
+  update();
+}
+
+void PwmFader::update() {
+  if (running_) {
+    if (!segmentDone_.exchange(false)) return;
+    running_ = false;
+  }
+
+  if (pending_) {
+    pending_ = false;
+    from_ = duty_;
+    target_ = pendingTarget_;
+    duration_ = pendingDuration_;
+    curve_ = pendingCurve_;
+    segment_ = 0;
+    segments_ = (duration_ + FADE_SEGMENT_MS - 1) / FADE_SEGMENT_MS;
+    if (segments_ == 0) segments_ = 1;
+    if (from_ == target_) segments_ = 0;
+  }
+
+  if (segment_ < segments_) startSegment();
+}
+
+void PwmFader::startSegment() {
+  uint32_t duty = dutyAt(segment_ + 1);
+  uint32_t start = duration_ * segment_ / segments_;
+  uint32_t end = duration_ * (segment_ + 1) / segments_;
+  segment_++;
+
+  if (end == start || duty == duty_) {
+    ledc_set_duty(mode_, channel_, duty);
+    ledc_update_duty(mode_, channel_);
+  } else {
+    segmentDone_ = false;
+    ledc_set_fade_with_time(mode_, channel_, duty, end - start);
+    ledc_fade_start(mode_, channel_, LEDC_FADE_NO_WAIT);
+    running_ = true;
+  }
+  duty_ = duty;
+}
+
+uint32_t PwmFader::dutyAt(uint16_t segment) const {
+  if (segment >= segments_) return target_;
+
+  float p = (float)segment / segments_;
+  switch (curve_) {
+    case FADE_EASE_IN:
+      p = p * p;
+      break;
+    case FADE_EASE_IN_OUT:
+      p = p * p * (3.0f - 2.0f * p);
+      break;
+    default:
+      break;
+  }
+  return from_ + lroundf(((float)target_ - (float)from_) * p);
+}
+
+bool IRAM_ATTR PwmFader::onFadeEnd(const ledc_cb_param_t *param, void *arg) {
+  if (param->event == LEDC_FADE_END_EVT) {
+    static_cast<PwmFader *>(arg)->segmentDone_ = true;
+  }
+  return false;
+}
@@ -0,0 +1,78 @@
+/*
+ * Hardware-faded PWM transitions on an LEDC channel
+ *
+ * A transition (target duty, duration, curve) is split into segments of
+ * at most FADE_SEGMENT_MS. Each segment is a linear ramp run by the LEDC
+ * fade unit, so the CPU only steps in once per segment. Curves are
+ * approximated piecewise by these segments.
+ *
+ * The classic ESP32 cannot stop a hardware fade halfway through. A new
+ * target given during a transition therefore takes over at the next
+ * segment boundary, starting from the duty reached there, so it never
+ * waits more than FADE_SEGMENT_MS.
+ *
+ * update() must be called regularly from the task that owns the channel.
+ */
+#ifndef PWM_FADER_H
+#define PWM_FADER_H
+
+#include <Arduino.h>
+#include <atomic>
+#include <driver/ledc.h>
+
+#define FADE_SEGMENT_MS 100  // Longest hardware segment, bounds retarget latency
+
+enum FadeCurve {
+  FADE_LINEAR,
+  FADE_EASE_IN,      // Slow start; perceived as even on LEDs
+  FADE_EASE_IN_OUT   // Smoothstep
+};
+
+class PwmFader {
+ public:
+  // channel is an Arduino LEDC channel already set up with ledcSetup()
+  // and ledcAttachPin()
+  PwmFader(uint8_t channel, uint8_t resolutionBits);
+
+  // Installs the fade service and the end-of-fade interrupt
+  bool begin();
+
+  // Starts, or retargets, a transition. A duration of 0 jumps straight
+  // to the target (once any running segment has ended).
+  void fadeTo(uint32_t target, uint32_t durationMs, FadeCurve curve = FADE_LINEAR);
+
+  // Starts the next segment once the previous one has ended
+  void update();
+
+  uint32_t target() const { return pending_ ? pendingTarget_ : target_; }
+  bool busy() const { return running_ || pending_ || segment_ < segments_; }
+
+ private:
+  static bool IRAM_ATTR onFadeEnd(const ledc_cb_param_t *param, void *arg);
+  void startSegment();
+  uint32_t dutyAt(uint16_t segment) const;
+
+  ledc_mode_t mode_;
+  ledc_channel_t channel_;
+  uint32_t maxDuty_;
+
+  // Transition being run
+  uint32_t from_;
+  uint32_t target_;
+  uint32_t duration_;
+  FadeCurve curve_;
+  uint16_t segment_;   // Next segment to start
+  uint16_t segments_;
+  uint32_t duty_;      // Duty at the end of the last started segment
+  bool running_;       // A hardware segment is in flight
+
+  // Target waiting for the running segment to end
+  bool pending_;
+  uint32_t pendingTarget_;
+  uint32_t pendingDuration_;
+  FadeCurve pendingCurve_;
+
+  std::atomic<bool> segmentDone_;
+};
+
+#endif // PWM_FADER_H
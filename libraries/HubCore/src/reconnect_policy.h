@@ -0,0 +1,157 @@
+/*
+ * Reconnect policy for the API WebSocket client
+ *
+ * The WebSockets library retries a lost connection every
+ * setReconnectInterval() ms, counted from the same moment on every hub.
+ * When the server restarts, the whole fleet reconnects in lock-step.
+ * This policy takes the timing over: after the n-th failure in a row
+ * the next attempt waits a random time in [0, min(cap, base * 2^(n-1))]
+ * ("full jitter"). The streak only resets once a connection has stayed
+ * up for Config::reconnectStable ms, so a server that accepts and
+ * immediately drops does not bring the herd back.
+ *
+ *   ReconnectPolicy<HubConfig> apiLink(apiClient);
+ *
+ *   apiClient.beginSSL(...);  apiLink.begin();  // first attempt is immediate
+ *   apiLink.loop();                             // instead of apiClient.loop()
+ *   // and from the event handler:
+ *   apiLink.connected();                        // on WStype_CONNECTED
+ *   apiLink.disconnected();                     // on WStype_DISCONNECTED
+ *
+ * The library's own interval is held at its maximum so it never
+ * connects by itself; it is lowered to 0 for exactly the loop() pass
+ * that should make an attempt. Client is WebSocketsClient or a class
+ * that hides its loop(), such as SecureWebSocketsClient.
+ */
+#ifndef RECONNECT_POLICY_H
+#define RECONNECT_POLICY_H
+
+#include <Arduino.h>
+#include <WebSocketsClient.h>
+#include "hub_config.h"
+#include "telemetry_frame.h"
+
+struct ReconnectStats {
+  uint32_t attempts;       // Connects started
+  uint32_t failures;       // Attempts that failed or timed out
+  uint32_t connects;       // Attempts that succeeded
+  uint32_t connectTime;    // Link lost (or begin()) to connected, last time (ms)
+  uint32_t maxConnectTime;
+};
+
+template <class Config, class Client = WebSocketsClient>
+class ReconnectPolicy {
+ public:
+  explicit ReconnectPolicy(Client& client)
+    : client_(client), state_(WAITING), streak_(0), nextAttempt_(0),
+      since_(0), outageStart_(0), delay_(0) {
+    memset(&stats_, 0, sizeof(stats_));
+  }
+
+  // Call after begin()/beginSSL() on the client: connect right away
+  void begin() {
+    client_.setReconnectInterval(HOLD_INTERVAL);
+    state_ = WAITING;
+    streak_ = 0;
+    delay_ = 0;
+    nextAttempt_ = outageStart_ = millis();
+  }
+
+  // Services the client, starting an attempt when one is due
+  void loop() {
+    uint32_t now = millis();
+    if (state_ == WAITING) {
+      if ((int32_t)(now - nextAttempt_) < 0) return;
+
+      stats_.attempts++;
+      state_ = ATTEMPTING;
+      // WebSocketsClient connects inside this pass; SecureWebSocketsClient
+      // starts a wss:// connect here and carries it on in the next ones
+      client_.setReconnectInterval(0);
+      client_.loop();
+      client_.setReconnectInterval(HOLD_INTERVAL);
+      // connected()/disconnected() may already have run
+      if (state_ == ATTEMPTING) since_ = millis();
+      return;
+    }
+
+    client_.loop();
+
+    // A refused connect raises no event, and a stalled handshake never ends
+    if (state_ == ATTEMPTING && millis() - since_ >= Config::reconnectTimeout) {
+      fail();
+      client_.disconnect();
+    }
+  }
+
+  void connected() {
+    if (state_ != ATTEMPTING) return;
+    uint32_t now = millis();
+    stats_.connects++;
+    stats_.connectTime = now - outageStart_;
+    stats_.maxConnectTime = max(stats_.maxConnectTime, stats_.connectTime);
+    state_ = CONNECTED;
+    since_ = now;
+  }
+
+  void disconnected() {
+    if (state_ == ATTEMPTING) {
+      fail();
+    } else if (state_ == CONNECTED) {
+      uint32_t now = millis();
+      if (now - since_ >= Config::reconnectStable) streak_ = 0;
+      outageStart_ = now;
+      schedule(now);
+    }
+  }
+
+  bool isConnected() const { return state_ == CONNECTED; }
+  const ReconnectStats& stats() const { return stats_; }
+  // Wait before the pending attempt (ms)
+  uint32_t delay() const { return delay_; }
+
+  // Appends "<name>":{"attempts":..,"failures":..,"connects":..,"connectMs":..,"maxConnectMs":..,"delayMs":..}
+  void writeStats(FrameWriter& w, const char* name) const {
+    w.key(name).raw("{");
+    w.key("attempts").integer(stats_.attempts);
+    w.key("failures").integer(stats_.failures);
+    w.key("connects").integer(stats_.connects);
+    w.key("connectMs").integer(stats_.connectTime);
+    w.key("maxConnectMs").integer(stats_.maxConnectTime);
+    w.key("delayMs").integer(state_ == WAITING ? delay_ : 0);
+    w.raw("}");
+  }
+
+ private:
+  enum State : uint8_t { WAITING, ATTEMPTING, CONNECTED };
+
+  // Longest interval the library accepts; it never reconnects by itself
+  static constexpr unsigned long HOLD_INTERVAL = 0xFFFFFFFFUL;
+
+  void fail() {
+    stats_.failures++;
+    schedule(millis());
+  }
+
+  void schedule(uint32_t now) {
+    if (streak_ < 31) streak_++;
+    uint32_t window = Config::reconnectCap;
+    if (streak_ <= 16 && ((uint32_t)Config::reconnectBase << (streak_ - 1)) < window) {
+      window = (uint32_t)Config::reconnectBase << (streak_ - 1);
+    }
+    delay_ = random(window + 1);
+    nextAttempt_ = now + delay_;
+    state_ = WAITING;
+  }
+
+  Client& client_;
+  State state_;
+  uint8_t streak_;         // Failures since the last stable connection
+  uint32_t nextAttempt_;
+  uint32_t since_;         // Attempt started, or connection opened
+  uint32_t outageStart_;
+  uint32_t delay_;
+  ReconnectStats stats_;
+};
+
+#endif // RECONNECT_POLICY_H
@@ -0,0 +1,42 @@
+/*
+ * Report-by-exception filter implementation
+ */
+#include "report_filter.h"
+
+ReportFilter::ReportFilter(float tempDeadband, float humDeadband,
+                           uint32_t heartbeatMs, uint32_t minIntervalMs)
+  : tempDeadband_(tempDeadband),
+    humDeadband_(humDeadband),
+    heartbeat_(heartbeatMs),
+    minInterval_(minIntervalMs),
+    reportedAt_(0),
+    haveReported_(false) {}
+
+// A reading appearing or going away counts as a change
+static bool outsideDeadband(float reported, float current, float deadband) {
+  if (isnan(reported) || isnan(current)) return isnan(reported) != isnan(current);
+  return fabsf(current - reported) >= deadband;
+}
+
+bool ReportFilter::changed(const TelemetrySample& sample) const {
+  return sample.motion != reported_.motion ||
+         sample.led1 != reported_.led1 ||
+         sample.led2 != reported_.led2 ||
+         sample.led3 != reported_.led3 ||
+         outsideDeadband(reported_.temperature, sample.temperature, tempDeadband_) ||
+         outsideDeadband(reported_.humidity, sample.humidity, humDeadband_);
+}
+
+bool ReportFilter::shouldReport(const TelemetrySample& sample, uint32_t now) const {
+  if (!haveReported_) return true;
+
+  uint32_t elapsed = now - reportedAt_;
+  if (elapsed >= heartbeat_) return true;
+  return elapsed >= minInterval_ && changed(sample);
+}
+
+void ReportFilter::markReported(const TelemetrySample& sample, uint32_t now) {
+  reported_ = sample;
+  reportedAt_ = now;
+  haveReported_ = true;
+}
@@ -0,0 +1,40 @@
+/*
+ * Report-by-exception filter for telemetry
+ *
+ * Decides whether a sample is worth publishing: motion and LED edges are
+ * reported straight away, temperature and humidity only once they move
+ * past their deadband, and a heartbeat guarantees a frame at least every
+ * heartbeat period even when nothing changes.
+ */
+#ifndef REPORT_FILTER_H
+#define REPORT_FILTER_H
+
+#include <Arduino.h>
+#include "telemetry_frame.h"
+
+class ReportFilter {
+ public:
+  // minIntervalMs rate-limits bursts of changes; they are coalesced into
+  // the next report
+  ReportFilter(float tempDeadband, float humDeadband,
+               uint32_t heartbeatMs, uint32_t minIntervalMs);
+
+  bool shouldReport(const TelemetrySample& sample, uint32_t now) const;
+  void markReported(const TelemetrySample& sample, uint32_t now);
+
+  // Forces the next shouldReport() to return true
+  void reset() { haveReported_ = false; }
+
+ private:
+  bool changed(const TelemetrySample& sample) const;
+
+  float tempDeadband_;
+  float humDeadband_;
+  uint32_t heartbeat_;
+  uint32_t minInterval_;
+  TelemetrySample reported_;
+  uint32_t reportedAt_;
+  bool haveReported_;
+};
+
+#endif // REPORT_FILTER_H
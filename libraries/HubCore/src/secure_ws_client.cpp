@@ -0,0 +1,362 @@
+/*
+ * wss:// client with TLS session resumption and certificate pinning
+ */
+#include "secure_ws_client.h"
+#include <WiFi.h>
+#include <esp_attr.h>
+#include <esp_rom_crc.h>
+#include <lwip/sockets.h>
+#include <mbedtls/base64.h>
+#include <mbedtls/platform_util.h>
+#include <mbedtls/sha256.h>
+
+#define TLS_SESSION_MAGIC 0x544c5331  // "TLS1"
+#define TLS_PERSONALIZATION "hub-tls"
+
+// ===== SESSION CACHE =====
+// One slot in RTC slow memory. It survives deep sleep and software
+// resets; after a power cycle it holds garbage, which the CRC rejects.
+struct TlsSessionSlot {
+  uint32_t magic;
+  uint32_t key;       // See sessionKey()
+  uint32_t crc;       // CRC of data
+  uint16_t length;
+  uint8_t data[TLS_SESSION_MAX];
+};
+
+static RTC_NOINIT_ATTR TlsSessionSlot sessionSlot;
+
+// Sessions are only resumed with the server and trust settings that
+// checked them; new firmware with another pin starts over
+static uint32_t sessionKey(const char* host, uint16_t port, const char* rootCA, const char* keyPin) {
+  uint32_t key = esp_rom_crc32_le(0, (const uint8_t*)host, strlen(host));
+  key = esp_rom_crc32_le(key, (const uint8_t*)&port, sizeof(port));
+  if (rootCA) key = esp_rom_crc32_le(key, (const uint8_t*)rootCA, strlen(rootCA));
+  if (keyPin) key = esp_rom_crc32_le(key, (const uint8_t*)keyPin, strlen(keyPin));
+  return key;
+}
+
+void tlsSessionClear() {
+  sessionSlot.magic = 0;
+}
+
+/**
+ * Offers the cached session for key to ssl. The master secret is copied
+ * to master so the caller can tell afterwards whether the server
+ * resumed it.
+ */
+static bool restoreSession(uint32_t key, mbedtls_ssl_context* ssl, unsigned char* master) {
+  const TlsSessionSlot& slot = sessionSlot;
+  if (slot.magic != TLS_SESSION_MAGIC || slot.key != key || slot.length > TLS_SESSION_MAX ||
+      esp_rom_crc32_le(0, slot.data, slot.length) != slot.crc) {
+    return false;
+  }
+
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  bool offered = mbedtls_ssl_session_load(&session, slot.data, slot.length) == 0 &&
+                 mbedtls_ssl_set_session(ssl, &session) == 0;
+  if (offered) memcpy(master, session.master, sizeof(session.master));
+  mbedtls_ssl_session_free(&session);
+  // A session from another firmware build does not load; start over
+  if (!offered) tlsSessionClear();
+  return offered;
+}
+
+static void saveSession(uint32_t key, const mbedtls_ssl_context* ssl) {
+  mbedtls_ssl_session session;
+  mbedtls_ssl_session_init(&session);
+  size_t length = 0;
+  tlsSessionClear();
+  if (mbedtls_ssl_get_session(ssl, &session) == 0 &&
+      mbedtls_ssl_session_save(&session, sessionSlot.data, TLS_SESSION_MAX, &length) == 0) {
+    sessionSlot.key = key;
+    sessionSlot.length = length;
+    sessionSlot.crc = esp_rom_crc32_le(0, sessionSlot.data, length);
+    sessionSlot.magic = TLS_SESSION_MAGIC;
+  } else {
+    Serial.println("TLS session too large to cache");
+  }
+  mbedtls_ssl_session_free(&session);
+}
+
+// ===== CERTIFICATE PINNING =====
+// True if crt has the pinned public key
+static bool matchesPin(const mbedtls_x509_crt* crt, const char* pin) {
+  // Written back to front; big enough for an RSA-4096 key
+  static unsigned char der[800];
+  unsigned char hash[32];
+  unsigned char encoded[48];
+  size_t encodedLength = 0;
+
+  int length = mbedtls_pk_write_pubkey_der((mbedtls_pk_context*)&crt->pk, der, sizeof(der));
+  if (length <= 0 ||
+      mbedtls_sha256_ret(der + sizeof(der) - length, length, hash, 0) != 0 ||
+      mbedtls_base64_encode(encoded, sizeof(encoded), &encodedLength, hash, sizeof(hash)) != 0) {
+    return false;
+  }
+  return encodedLength == strlen(pin) && memcmp(encoded, pin, encodedLength) == 0;
+}
+
+// mbedTLS calls this for each certificate of the chain it built and
+// verified against the root CA, root first. Extra certificates the
+// server sends are never part of it.
+int ResumableTlsClient::verifyCertificate(void* arg, mbedtls_x509_crt* crt, int depth, uint32_t* flags) {
+  ResumableTlsClient* client = static_cast<ResumableTlsClient*>(arg);
+  if (client->keyPin_ && matchesPin(crt, client->keyPin_)) client->pinMatched_ = true;
+  return 0;
+}
+
+// ===== RESUMABLE TLS CLIENT =====
+ResumableTlsClient::ResumableTlsClient(const char* rootCA, const char* keyPin, TlsStats& stats)
+  : rootCA_(rootCA), keyPin_(keyPin), pinMatched_(false), offered_(false), sessionKey_(0),
+    state_(TCP_CONNECT), started_(0), timeout_(0), stats_(stats) {}
+
+bool ResumableTlsClient::start(const char* host, uint16_t port, uint32_t timeout) {
+  started_ = millis();
+  timeout_ = timeout;
+  state_ = TCP_CONNECT;
+  sessionKey_ = sessionKey(host, port, rootCA_, keyPin_);
+  // Contexts are set up the way start_ssl_client() does it, so that
+  // WiFiClientSecure's read, write and stop() work on them unchanged
+  mbedtls_entropy_init(&sslclient->entropy_ctx);
+
+  if (!openSocket(host, port) || !setup(host)) {
+    fail();
+    return false;
+  }
+  return true;
+}
+
+TlsProgress ResumableTlsClient::poll(uint32_t budget) {
+  uint32_t passStarted = millis();
+  mbedtls_ssl_context* ssl = &sslclient->ssl_ctx;
+
+  while (state_ != DONE) {
+    if (millis() - started_ >= timeout_) {
+      Serial.println(state_ == TCP_CONNECT ? "TLS connect timed out" : "TLS handshake timed out");
+      return fail();
+    }
+    uint32_t spent = millis() - passStarted;
+    if (spent >= budget) return TlsProgress::Pending;
+
+    if (state_ == TCP_CONNECT) {
+      if (!waitSocket(true, budget - spent)) return TlsProgress::Pending;
+      int error = 0;
+      socklen_t length = sizeof(error);
+      if (getsockopt(sslclient->socket, SOL_SOCKET, SO_ERROR, &error, &length) < 0 || error != 0) {
+        return fail();
+      }
+      state_ = HANDSHAKE;
+      continue;
+    }
+
+    // One handshake message at a time, so the pass can end between them
+    int ret = mbedtls_ssl_handshake_step(ssl);
+    if (ret == MBEDTLS_ERR_SSL_WANT_READ || ret == MBEDTLS_ERR_SSL_WANT_WRITE) {
+      if (!waitSocket(ret == MBEDTLS_ERR_SSL_WANT_WRITE, budget - spent)) {
+        return TlsProgress::Pending;
+      }
+    } else if (ret != 0) {
+      Serial.printf("TLS handshake failed: -0x%04x\n", -ret);
+      return fail();
+    } else if (ssl->state == MBEDTLS_SSL_HANDSHAKE_OVER) {
+      if (!finish()) return fail();
+      state_ = DONE;
+    }
+  }
+  return TlsProgress::Connected;
+}
+
+TlsProgress ResumableTlsClient::fail() {
+  // Never let a bad cached session block the next attempt too
+  if (offered_ && state_ == HANDSHAKE) tlsSessionClear();
+  mbedtls_platform_zeroize(master_, sizeof(master_));
+  stats_.failed++;
+  stop();
+  return TlsProgress::Failed;
+}
+
+// Waits up to ms for the socket to take data (write) or to have some
+bool ResumableTlsClient::waitSocket(bool write, uint32_t ms) {
+  int fd = sslclient->socket;
+  fd_set fds;
+  FD_ZERO(&fds);
+  FD_SET(fd, &fds);
+  struct timeval tv;
+  tv.tv_sec = ms / 1000;
+  tv.tv_usec = (ms % 1000) * 1000;
+  return select(fd + 1, write ? NULL : &fds, write ? &fds : NULL, NULL, &tv) > 0;
+}
+
+bool ResumableTlsClient::openSocket(const char* host, uint16_t port) {
+  IPAddress ip;
+  if (!WiFi.hostByName(host, ip)) return false;
+
+  int fd = lwip_socket(AF_INET, SOCK_STREAM, IPPROTO_TCP);
+  if (fd < 0) return false;
+
+  struct sockaddr_in addr;
+  memset(&addr, 0, sizeof(addr));
+  addr.sin_family = AF_INET;
+  addr.sin_addr.s_addr = (uint32_t)ip;
+  addr.sin_port = htons(port);
+
+  // Non-blocking from here on, as poll() and WiFiClientSecure expect
+  fcntl(fd, F_SETFL, fcntl(fd, F_GETFL, 0) | O_NONBLOCK);
+  if (lwip_connect(fd, (struct sockaddr*)&addr, sizeof(addr)) < 0 && errno != EINPROGRESS) {
+    close(fd);
+    return false;
+  }
+  sslclient->socket = fd;
+  return true;
+}
+
+bool ResumableTlsClient::setup(const char* host) {
+  mbedtls_ssl_context* ssl = &sslclient->ssl_ctx;
+  mbedtls_ssl_config* conf = &sslclient->ssl_conf;
+
+  if (mbedtls_ctr_drbg_seed(&sslclient->drbg_ctx, mbedtls_entropy_func, &sslclient->entropy_ctx,
+                            (const unsigned char*)TLS_PERSONALIZATION,
+                            strlen(TLS_PERSONALIZATION)) != 0 ||
+      mbedtls_ssl_config_defaults(conf, MBEDTLS_SSL_IS_CLIENT, MBEDTLS_SSL_TRANSPORT_STREAM,
+                                  MBEDTLS_SSL_PRESET_DEFAULT) != 0) {
+    return false;
+  }
+
+  if (rootCA_) {
+    mbedtls_x509_crt_init(&sslclient->ca_cert);
+    if (mbedtls_x509_crt_parse(&sslclient->ca_cert, (const unsigned char*)rootCA_,
+                               strlen(rootCA_) + 1) != 0) {
+      Serial.println("TLS root CA does not parse");
+      mbedtls_x509_crt_free(&sslclient->ca_cert);
+      return false;
+    }
+    mbedtls_ssl_conf_ca_chain(conf, &sslclient->ca_cert, NULL);
+    mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_REQUIRED);
+    mbedtls_ssl_conf_verify(conf, verifyCertificate, this);
+  } else {
+    // Only the pin, if any, is checked in finish(), on the leaf
+    mbedtls_ssl_conf_authmode(conf, MBEDTLS_SSL_VERIFY_NONE);
+  }
+  pinMatched_ = false;
+  mbedtls_ssl_conf_rng(conf, mbedtls_ctr_drbg_random, &sslclient->drbg_ctx);
+
+  if (mbedtls_ssl_setup(ssl, conf) != 0 || mbedtls_ssl_set_hostname(ssl, host) != 0) {
+    return false;
+  }
+  mbedtls_ssl_set_bio(ssl, &sslclient->socket, mbedtls_net_send, mbedtls_net_recv, NULL);
+
+  offered_ = restoreSession(sessionKey_, ssl, master_);
+  return true;
+}
+
+// The handshake is over: checks the pin and caches the session
+bool ResumableTlsClient::finish() {
+  mbedtls_ssl_context* ssl = &sslclient->ssl_ctx;
+
+  // Only a resumed session keeps its master secret
+  bool resumed = offered_ && memcmp(ssl->session->master, master_, sizeof(master_)) == 0;
+  mbedtls_platform_zeroize(master_, sizeof(master_));
+
+  // With a root CA the pin may be on any certificate of the verified
+  // chain. Without one nothing ties the other certificates to the
+  // server, so only the leaf counts: the handshake proved the server
+  // holds its private key.
+  if (!resumed && keyPin_) {
+    const mbedtls_x509_crt* leaf = mbedtls_ssl_get_peer_cert(ssl);
+    bool pinned = rootCA_ ? pinMatched_ : leaf && matchesPin(leaf, keyPin_);
+    if (!pinned) {
+      Serial.println("TLS server key does not match the pin");
+      return false;
+    }
+  }
+
+  saveSession(sessionKey_, ssl);
+  uint32_t elapsed = millis() - started_;
+  if (resumed) {
+    stats_.resumed++;
+    stats_.resumedTime = elapsed;
+  } else {
+    stats_.full++;
+    stats_.fullTime = elapsed;
+  }
+  _connected = true;
+  return true;
+}
+
+// ===== SECURE WEBSOCKET CLIENT =====
+SecureWebSocketsClient::SecureWebSocketsClient()
+  : rootCA_(nullptr), keyPin_(nullptr), pending_(nullptr) {
+  memset(&stats_, 0, sizeof(stats_));
+}
+
+void SecureWebSocketsClient::setTrust(const char* rootCA, const char* keyPin) {
+  rootCA_ = rootCA;
+  keyPin_ = keyPin;
+  if (!rootCA_ && !keyPin_) Serial.println("Warning: API server certificate is not checked");
+}
+
+void SecureWebSocketsClient::loop() {
+  if (pending_) {
+    TlsProgress progress = pending_->poll(TLS_CONNECT_SLICE);
+    if (progress == TlsProgress::Pending) return;
+
+    ResumableTlsClient* tls = pending_;
+    pending_ = NULL;
+    if (progress == TlsProgress::Connected) {
+      _client.ssl = tls;
+      _client.tcp = tls;
+      connectedCb();
+      _lastConnectionFail = 0;
+    } else {
+      delete tls;
+      connectFailedCb();
+      _lastConnectionFail = millis();
+    }
+    return;
+  }
+
+  if (_port == 0 || !_client.isSSL || clientIsConnected(&_client) ||
+      millis() - _lastConnectionFail < _reconnectInterval) {
+    WebSocketsClient::loop();
+    return;
+  }
+
+  // The wss:// connect step of WebSocketsClient::loop(), with a client
+  // that resumes the cached session; the next passes carry it on
+  if (_client.ssl) {
+    delete _client.ssl;
+    _client.ssl = NULL;
+    _client.tcp = NULL;
+  }
+  ResumableTlsClient* tls = new ResumableTlsClient(rootCA_, keyPin_, stats_);
+  if (tls->start(_host.c_str(), _port, WEBSOCKETS_TCP_TIMEOUT)) {
+    pending_ = tls;
+  } else {
+    delete tls;
+    connectFailedCb();
+    _lastConnectionFail = millis();
+  }
+}
+
+void SecureWebSocketsClient::disconnect() {
+  if (pending_) {
+    stats_.failed++;
+    delete pending_;
+    pending_ = NULL;
+    _lastConnectionFail = millis();
+  }
+  WebSocketsClient::disconnect();
+}
+
+void SecureWebSocketsClient::writeTlsStats(FrameWriter& w) const {
+  w.key("tls").raw("{");
+  w.key("full").integer(stats_.full);
+  w.key("resumed").integer(stats_.resumed);
+  w.key("failed").integer(stats_.failed);
+  w.key("fullMs").integer(stats_.fullTime);
+  w.key("resumedMs").integer(stats_.resumedTime);
+  w.key("verify").string(rootCA_ ? (keyPin_ ? "ca+pin" : "ca") : (keyPin_ ? "pin" : "none"));
+  w.raw("}");
+}
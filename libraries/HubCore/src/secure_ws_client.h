@@ -0,0 +1,132 @@
+/*
+ * wss:// client with TLS session resumption and certificate pinning
+ *
+ * WebSocketsClient opens every wss:// connection with a fresh
+ * WiFiClientSecure: a full TLS handshake each time (hundreds of ms of
+ * CPU plus two extra round trips), and no check of the server
+ * certificate unless a CA is configured. SecureWebSocketsClient replaces
+ * that connect step:
+ *
+ *  - The last TLS session (session ID or ticket) is kept in RTC memory,
+ *    so reconnects, software resets and deep sleep resume it with an
+ *    abbreviated handshake. A power cycle, another host or other trust
+ *    settings start over with a full one.
+ *  - On a full handshake the server is checked against a root CA (PEM)
+ *    and/or a public key pin: the base64 SHA-256 of a
+ *    SubjectPublicKeyInfo, as printed by tools/tls_standin.py pin. With
+ *    a root CA the pin may be the key of any certificate in the chain
+ *    mbedTLS verified (an intermediate outlives server renewals).
+ *    Without one it must be the server certificate's own key. A resumed
+ *    session was checked when it was first established, and only
+ *    checked sessions are cached.
+ *  - The connect does not block the loop: each loop() pass moves it on
+ *    for at most TLS_CONNECT_SLICE ms, between handshake messages.
+ *
+ *   SecureWebSocketsClient apiClient;
+ *   apiClient.setTrust(rootCA, keyPin);
+ *   apiClient.beginSSL(host, 443, path);
+ *   apiClient.loop();   // or ReconnectPolicy<Config, SecureWebSocketsClient>
+ *
+ * ws:// connections go through WebSocketsClient unchanged. Built on the
+ * mbedTLS 2.x context inside WiFiClientSecure (Arduino-ESP32 2.x).
+ */
+#ifndef SECURE_WS_CLIENT_H
+#define SECURE_WS_CLIENT_H
+
+#include <Arduino.h>
+#include <WiFiClientSecure.h>
+#include <WebSocketsClient.h>
+#include "telemetry_frame.h"
+
+// Room for a serialized session, including the server certificate
+#define TLS_SESSION_MAX 2560
+// Longest a loop() pass spends on a pending wss:// connect (ms). One
+// handshake step, such as the key exchange, is not cut short.
+#define TLS_CONNECT_SLICE 20
+
+struct TlsStats {
+  uint32_t full;          // Full handshakes
+  uint32_t resumed;       // Abbreviated handshakes from the cached session
+  uint32_t failed;        // Connect, handshake, CA or pin failures
+  uint32_t fullTime;      // Last full handshake, TCP connect included (ms)
+  uint32_t resumedTime;   // Last resumed handshake, TCP connect included (ms)
+};
+
+enum class TlsProgress : uint8_t { Pending, Connected, Failed };
+
+/**
+ * WiFiClientSecure whose handshake offers the cached session. The
+ * connect is started once and then polled, so it never holds the
+ * caller for longer than it asks. Once connected it is an ordinary
+ * WiFiClientSecure, so WebSocketsClient reads, writes and deletes it as
+ * its own.
+ */
+class ResumableTlsClient : public WiFiClientSecure {
+ public:
+  ResumableTlsClient(const char* rootCA, const char* keyPin, TlsStats& stats);
+
+  // Resolves host and starts a connect that has timeout ms to finish;
+  // false if it failed already
+  bool start(const char* host, uint16_t port, uint32_t timeout);
+
+  // Moves the connect on for at most budget ms, waiting on the socket
+  // no longer than that. Pending until it connects or fails.
+  TlsProgress poll(uint32_t budget);
+
+ private:
+  enum State : uint8_t { TCP_CONNECT, HANDSHAKE, DONE };
+
+  bool openSocket(const char* host, uint16_t port);
+  bool setup(const char* host);
+  bool finish();
+  TlsProgress fail();
+  bool waitSocket(bool write, uint32_t ms);
+  static int verifyCertificate(void* client, mbedtls_x509_crt* crt, int depth, uint32_t* flags);
+
+  const char* rootCA_;
+  const char* keyPin_;
+  bool pinMatched_;        // The pin was found in the verified chain
+  bool offered_;           // The cached session was offered
+  unsigned char master_[48];  // Its master secret
+  uint32_t sessionKey_;
+  State state_;
+  uint32_t started_;
+  uint32_t timeout_;
+  TlsStats& stats_;
+};
+
+class SecureWebSocketsClient : public WebSocketsClient {
+ public:
+  SecureWebSocketsClient();
+
+  /**
+   * rootCA is a PEM certificate, keyPin a base64 SHA-256 public key
+   * pin; either may be null. A pin without rootCA must be the server
+   * certificate's key. With both null the server is not checked.
+   * The strings must outlive the client.
+   */
+  void setTrust(const char* rootCA, const char* keyPin);
+
+  // Hides WebSocketsClient::loop() to make wss:// connects resumable
+  // and spread them over passes
+  void loop();
+
+  // Hides WebSocketsClient::disconnect(); also gives up a pending connect
+  void disconnect();
+
+  const TlsStats& tlsStats() const { return stats_; }
+
+  // Appends "tls":{"full":..,"resumed":..,"failed":..,"fullMs":..,"resumedMs":..,"verify":".."}
+  void writeTlsStats(FrameWriter& w) const;
+
+ private:
+  const char* rootCA_;
+  const char* keyPin_;
+  ResumableTlsClient* pending_;  // wss:// connect in progress
+  TlsStats stats_;
+};
+
+// Drops the cached session so the next connect is a full handshake
+void tlsSessionClear();
+
+#endif // SECURE_WS_CLIENT_H
@@ -0,0 +1,110 @@
+/*
+ * Batched telemetry uplink implementation
+ */
+#include "telemetry_batch.h"
+#include "telemetry_store.h"
+#include <time.h>
+
+TelemetryBatch::TelemetryBatch()
+  : currentOpen_(false), havePrevious_(false), count_(0), window_(0), batchSize_(1) {}
+
+void TelemetryBatch::configure(uint32_t windowMs, uint8_t batchSize) {
+  window_ = windowMs;
+  batchSize_ = constrain(batchSize, 1, BATCH_MAX_ENTRIES);
+  currentOpen_ = false;
+  count_ = 0;
+}
+
+void TelemetryBatch::open(uint32_t now) {
+  memset(&current_, 0, sizeof(current_));
+  current_.start = now;
+  current_.tempMin = current_.humMin = INFINITY;
+  current_.tempMax = current_.humMax = -INFINITY;
+  currentOpen_ = true;
+}
+
+void TelemetryBatch::add(const TelemetrySample& sample, uint32_t now) {
+  if (currentOpen_ && now - current_.start >= window_) {
+    // Batch full and not yet collected: the oldest window gives way
+    if (count_ == BATCH_MAX_ENTRIES) {
+      memmove(entries_, entries_ + 1, sizeof(BatchEntry) * (BATCH_MAX_ENTRIES - 1));
+      count_--;
+    }
+    entries_[count_++] = current_;
+    currentOpen_ = false;
+  }
+  if (!currentOpen_) open(now);
+
+  BatchEntry& e = current_;
+  e.samples++;
+  if (!isnan(sample.temperature)) {
+    e.tempSamples++;
+    e.tempSum += sample.temperature;
+    e.tempMin = min(e.tempMin, sample.temperature);
+    e.tempMax = max(e.tempMax, sample.temperature);
+  }
+  if (!isnan(sample.humidity)) {
+    e.humSamples++;
+    e.humSum += sample.humidity;
+    e.humMin = min(e.humMin, sample.humidity);
+    e.humMax = max(e.humMax, sample.humidity);
+  }
+  if (sample.motion) e.motionSamples++;
+  if (havePrevious_) {
+    if (sample.led1 != previous_.led1) e.ledChanges++;
+    if (sample.led2 != previous_.led2) e.ledChanges++;
+    if (sample.led3 != previous_.led3) e.ledChanges++;
+  }
+  e.last = sample;
+
+  previous_ = sample;
+  havePrevious_ = true;
+}
+
+TelemetrySample batchEntryMean(const BatchEntry& entry) {
+  TelemetrySample sample = entry.last;
+  sample.temperature = entry.tempSamples ? entry.tempSum / entry.tempSamples : NAN;
+  sample.humidity = entry.humSamples ? entry.humSum / entry.humSamples : NAN;
+  sample.motion = entry.motionSamples > 0;
+  return sample;
+}
+
+// min/max stay at +-INFINITY without valid readings, which number() writes as null
+static void writeEntry(FrameWriter& w, const BatchEntry& e, uint32_t nowMs) {
+  w.raw("{");
+  if (wallClockValid()) {
+    w.key("t").integer((uint32_t)time(nullptr) - (nowMs - e.start) / 1000);
+  } else {
+    w.key("age").integer(nowMs - e.start);
+  }
+  w.key("n").integer(e.samples);
+  w.key("tMin").number(e.tempMin);
+  w.key("tMax").number(e.tempMax);
+  w.key("tMean").number(e.tempSamples ? e.tempSum / e.tempSamples : NAN);
+  w.key("hMin").number(e.humMin);
+  w.key("hMax").number(e.humMax);
+  w.key("hMean").number(e.humSamples ? e.humSum / e.humSamples : NAN);
+  w.key("motion").integer(e.samples ? (e.motionSamples * 100L + e.samples / 2) / e.samples : 0);
+  w.key("ledChanges").integer(e.ledChanges);
+  w.key("led1").integer(e.last.led1);
+  w.key("led2").boolean(e.last.led2);
+  w.key("led3").boolean(e.last.led3);
+  w.raw("}");
+}
+
+size_t writeBatchFrame(char* buffer, size_t capacity, const TelemetryBatch& batch,
+                       const char* deviceId) {
+  uint32_t nowMs = millis();
+
+  FrameWriter w(buffer, capacity);
+  w.raw("{\"action\":\"batch\",\"payload\":{");
+  w.key("deviceId").string(deviceId);
+  w.key("window").integer(batch.window());
+  w.key("entries").raw("[");
+  for (size_t i = 0; i < batch.size(); i++) {
+    if (i) w.raw(",");
+    writeEntry(w, batch.at(i), nowMs);
+  }
+  w.raw("]}}");
+  return w.finish();
+}
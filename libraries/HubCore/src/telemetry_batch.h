@@ -0,0 +1,78 @@
+/*
+ * Batched telemetry uplink
+ *
+ * Folds samples into one summary per aggregation window (min/max/mean
+ * temperature and humidity, motion duty cycle, LED changes) and ships a
+ * batch of windows in a single frame:
+ *
+ *   {"action":"batch","payload":{"deviceId":"..","window":ms,"entries":[
+ *     {"t"|"age":..,"n":..,"tMin":..,"tMax":..,"tMean":..,
+ *      "hMin":..,"hMax":..,"hMean":..,"motion":%,"ledChanges":..,
+ *      "led1":..,"led2":..,"led3":..}, ...]}}
+ *
+ * "t" is the window start in Unix seconds once the clock is set, "age"
+ * the time since the window started in ms before that.
+ */
+#ifndef TELEMETRY_BATCH_H
+#define TELEMETRY_BATCH_H
+
+#include <Arduino.h>
+#include "telemetry_frame.h"
+
+#define BATCH_MAX_ENTRIES 6         // Windows per frame, upper bound for batchSize
+#define BATCH_FRAME_SIZE 1024       // Fits BATCH_MAX_ENTRIES windows
+#define BATCH_WINDOW_MIN 10000      // Shortest window the server may set (ms)
+#define BATCH_WINDOW_MAX 3600000    // Longest window the server may set (ms)
+
+// Summary of all samples taken in one window
+struct BatchEntry {
+  uint32_t start;          // millis() of the first sample
+  uint16_t samples;
+  uint16_t tempSamples;    // Samples with a valid temperature
+  uint16_t humSamples;     // Samples with a valid humidity
+  uint16_t motionSamples;  // Samples with motion detected
+  uint16_t ledChanges;     // LED edges seen during the window
+  float tempMin, tempMax, tempSum;
+  float humMin, humMax, humSum;
+  TelemetrySample last;    // LED state at the end of the window
+};
+
+class TelemetryBatch {
+ public:
+  TelemetryBatch();
+
+  // A window of 0 turns batching off. Drops anything collected so far.
+  void configure(uint32_t windowMs, uint8_t batchSize);
+  bool enabled() const { return window_ > 0; }
+  uint32_t window() const { return window_; }
+  uint8_t batchSize() const { return batchSize_; }
+
+  // Adds a sample, closing the open window first if it has elapsed
+  void add(const TelemetrySample& sample, uint32_t now);
+
+  // True once batchSize windows are closed
+  bool ready() const { return count_ >= batchSize_; }
+  size_t size() const { return count_; }
+  const BatchEntry& at(size_t index) const { return entries_[index]; }
+  void clear() { count_ = 0; }
+
+ private:
+  void open(uint32_t now);
+
+  BatchEntry entries_[BATCH_MAX_ENTRIES];
+  BatchEntry current_;
+  bool currentOpen_;
+  TelemetrySample previous_;
+  bool havePrevious_;
+  size_t count_;
+  uint32_t window_;
+  uint8_t batchSize_;
+};
+
+// Mean of a window as a plain sample, for paths that take single samples
+TelemetrySample batchEntryMean(const BatchEntry& entry);
+
+size_t writeBatchFrame(char* buffer, size_t capacity, const TelemetryBatch& batch,
+                       const char* deviceId);
+
+#endif // TELEMETRY_BATCH_H
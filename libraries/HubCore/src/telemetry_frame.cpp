@@ -0,0 +1,143 @@
+/*
+ * Fixed-layout telemetry frame implementation
+ */
+#include "telemetry_frame.h"
+
+FrameWriter::FrameWriter(char* buffer, size_t capacity)
+  : buffer_(buffer),
+    capacity_(capacity),
+    length_(0),
+    overflow_(false),
+    needComma_(false) {}
+
+void FrameWriter::put(char c) {
+  // Keep one byte for the terminating NUL
+  if (length_ + 1 >= capacity_) {
+    overflow_ = true;
+    return;
+  }
+  buffer_[length_++] = c;
+}
+
+FrameWriter& FrameWriter::raw(const char* text) {
+  while (*text) put(*text++);
+  // Any opening bracket starts a fresh member list
+  char last = length_ > 0 ? buffer_[length_ - 1] : 0;
+  needComma_ = !(last == '{' || last == '[' || last == ':' || last == ',');
+  return *this;
+}
+
+FrameWriter& FrameWriter::string(const char* text) {
+  static const char hex[] = "0123456789abcdef";
+  put('"');
+  for (; *text; text++) {
+    unsigned char c = *text;
+    if (c == '"' || c == '\\') {
+      put('\\');
+      put(c);
+    } else if (c < 0x20) {
+      put('\\');
+      put('u');
+      put('0');
+      put('0');
+      put(hex[c >> 4]);
+      put(hex[c & 0x0F]);
+    } else {
+      put(c);
+    }
+  }
+  put('"');
+  needComma_ = true;
+  return *this;
+}
+
+FrameWriter& FrameWriter::integer(long value) {
+  char digits[12];
+  int n = 0;
+  unsigned long v = value < 0 ? -(unsigned long)value : value;
+  do {
+    digits[n++] = '0' + v % 10;
+    v /= 10;
+  } while (v);
+  if (value < 0) put('-');
+  while (n) put(digits[--n]);
+  needComma_ = true;
+  return *this;
+}
+
+FrameWriter& FrameWriter::number(float value) {
+  if (isnan(value) || isinf(value)) return raw("null");
+
+  // Fixed point with two decimals, trailing zeros dropped
+  long scaled = lroundf(value * 100.0f);
+  if (scaled < 0) {
+    put('-');
+    scaled = -scaled;
+  }
+  integer(scaled / 100);
+  int frac = scaled % 100;
+  if (frac) {
+    put('.');
+    put('0' + frac / 10);
+    if (frac % 10) put('0' + frac % 10);
+  }
+  return *this;
+}
+
+FrameWriter& FrameWriter::boolean(bool value) {
+  return raw(value ? "true" : "false");
+}
+
+FrameWriter& FrameWriter::key(const char* name) {
+  if (needComma_) put(',');
+  string(name);
+  put(':');
+  needComma_ = false;
+  return *this;
+}
+
+size_t FrameWriter::finish() {
+  if (overflow_) return 0;
+  buffer_[length_] = '\0';
+  return length_;
+}
+
+void writeSampleFields(FrameWriter& w, const TelemetrySample& sample) {
+  w.key("led1").integer(sample.led1);
+  w.key("led2").boolean(sample.led2);
+  w.key("led3").boolean(sample.led3);
+  w.key("motion").boolean(sample.motion);
+  w.key("temp").number(sample.temperature);
+  w.key("hum").number(sample.humidity);
+}
+
+size_t writeUpdateEnvFrame(char* buffer, size_t capacity,
+                           const TelemetrySample& sample, const char* deviceId,
+                           uint32_t ack) {
+  FrameWriter w(buffer, capacity);
+  w.raw("{\"action\":\"updateenv\",\"payload\":{");
+  writeSampleFields(w, sample);
+  w.key("deviceId").string(deviceId);
+  if (ack) w.key("ack").integer(ack);
+  w.raw("}}");
+  return w.finish();
+}
+
+size_t writeStatusFrame(char* buffer, size_t capacity, const TelemetrySample& sample) {
+  FrameWriter w(buffer, capacity);
+  w.raw("{");
+  writeSampleFields(w, sample);
+  w.raw("}");
+  return w.finish();
+}
+
+size_t writeMotionEventFrame(char* buffer, size_t capacity, bool detected,
+                             uint32_t ageMs, const char* deviceId) {
+  FrameWriter w(buffer, capacity);
+  w.raw(detected ? "{\"action\":\"motion_detected\",\"payload\":{"
+                 : "{\"action\":\"motion_stopped\",\"payload\":{");
+  w.key("deviceId").string(deviceId);
+  w.key("age").integer(ageMs);
+  w.raw("}}");
+  return w.finish();
+}
@@ -0,0 +1,67 @@
+/*
+ * Fixed-layout telemetry frames for the Smart Home Hub firmware
+ *
+ * Writes the JSON frames sent to the API server and to local WebSocket
+ * clients straight into a caller-owned buffer, without JsonDocument or
+ * String and without touching the heap.
+ */
+#ifndef TELEMETRY_FRAME_H
+#define TELEMETRY_FRAME_H
+
+#include <Arduino.h>
+
+#define TELEMETRY_FRAME_SIZE 192  // Large enough for any frame below
+
+// Values reported in every telemetry frame
+struct TelemetrySample {
+  float temperature;
+  float humidity;
+  bool motion;
+  int led1;
+  bool led2;
+  bool led3;
+};
+
+// Bounded append-only writer over a char buffer
+class FrameWriter {
+ public:
+  FrameWriter(char* buffer, size_t capacity);
+
+  FrameWriter& raw(const char* text);
+  FrameWriter& string(const char* text);  // Quoted, with JSON escaping
+  FrameWriter& integer(long value);
+  FrameWriter& number(float value);       // Up to 2 decimals, null for NaN
+  FrameWriter& boolean(bool value);
+  FrameWriter& key(const char* name);     // "name": with a leading comma if needed
+
+  // Length written, or 0 if the buffer was too small
+  size_t finish();
+
+ private:
+  void put(char c);
+
+  char* buffer_;
+  size_t capacity_;
+  size_t length_;
+  bool overflow_;
+  bool needComma_;
+};
+
+// Appends the "led1".."hum" members shared by all telemetry frames
+void writeSampleFields(FrameWriter& w, const TelemetrySample& sample);
+
+// {"action":"updateenv","payload":{...,"deviceId":"..."[,"ack":seq]}}
+// ack acknowledges server commands up to seq; 0 leaves it out
+size_t writeUpdateEnvFrame(char* buffer, size_t capacity,
+                           const TelemetrySample& sample, const char* deviceId,
+                           uint32_t ack = 0);
+
+// {"led1":..,"led2":..,"led3":..,"motion":..,"temp":..,"hum":..}
+size_t writeStatusFrame(char* buffer, size_t capacity, const TelemetrySample& sample);
+
+// {"action":"motion_detected"|"motion_stopped","payload":{"deviceId":"..","age":ms}}
+// where age is the time since the edge was seen
+size_t writeMotionEventFrame(char* buffer, size_t capacity, bool detected,
+                             uint32_t ageMs, const char* deviceId);
+
+#endif // TELEMETRY_FRAME_H
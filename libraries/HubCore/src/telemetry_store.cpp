@@ -0,0 +1,143 @@
+/*
+ * Store-and-forward telemetry buffer implementation
+ */
+#include "telemetry_store.h"
+#include <time.h>
+
+#define STORE_FILE_MAGIC 0x54534231  // "TSB1"
+#define MIN_VALID_EPOCH 1600000000UL
+
+struct StoreFileHeader {
+  uint32_t magic;
+  uint32_t count;
+  uint32_t dropped;
+};
+
+bool wallClockValid() {
+  return time(nullptr) > (time_t)MIN_VALID_EPOCH;
+}
+
+TelemetryStore::TelemetryStore()
+  : head_(0), count_(0), dropped_(0), dirty_(false) {}
+
+void TelemetryStore::push(const TelemetrySample& sample) {
+  StoredSample entry;
+  if (wallClockValid()) {
+    entry.time = (uint32_t)time(nullptr);
+    entry.flags = STORED_SAMPLE_EPOCH;
+  } else {
+    entry.time = millis();
+    entry.flags = 0;
+  }
+  entry.sample = quantizeSample(sample);
+
+  if (count_ == TELEMETRY_STORE_CAPACITY) {
+    // Full: overwrite the oldest sample
+    head_ = (head_ + 1) % TELEMETRY_STORE_CAPACITY;
+    count_--;
+    dropped_++;
+  }
+  entries_[(head_ + count_) % TELEMETRY_STORE_CAPACITY] = entry;
+  count_++;
+  dirty_ = true;
+}
+
+const StoredSample& TelemetryStore::at(size_t index) const {
+  return entries_[(head_ + index) % TELEMETRY_STORE_CAPACITY];
+}
+
+void TelemetryStore::pop(size_t count) {
+  if (count > count_) count = count_;
+  head_ = (head_ + count) % TELEMETRY_STORE_CAPACITY;
+  count_ -= count;
+  dirty_ = true;
+}
+
+void TelemetryStore::anchorClock() {
+  if (!wallClockValid()) return;
+
+  uint32_t nowEpoch = (uint32_t)time(nullptr);
+  uint32_t nowMs = millis();
+  for (size_t i = 0; i < count_; i++) {
+    StoredSample& entry = entries_[(head_ + i) % TELEMETRY_STORE_CAPACITY];
+    if (entry.flags & STORED_SAMPLE_EPOCH) continue;
+    entry.time = nowEpoch - (nowMs - entry.time) / 1000;
+    entry.flags |= STORED_SAMPLE_EPOCH;
+  }
+}
+
+bool TelemetryStore::save(fs::FS& fs, const char* path) {
+  dirty_ = false;
+  if (count_ == 0) {
+    if (fs.exists(path)) fs.remove(path);
+    return true;
+  }
+
+  File file = fs.open(path, FILE_WRITE);
+  if (!file) return false;
+
+  StoreFileHeader header = { STORE_FILE_MAGIC, (uint32_t)count_, dropped_ };
+  bool ok = file.write((const uint8_t*)&header, sizeof(header)) == sizeof(header);
+  for (size_t i = 0; ok && i < count_; i++) {
+    ok = file.write((const uint8_t*)&at(i), sizeof(StoredSample)) == sizeof(StoredSample);
+  }
+  file.close();
+  return ok;
+}
+
+bool TelemetryStore::load(fs::FS& fs, const char* path) {
+  if (!fs.exists(path)) return false;
+
+  File file = fs.open(path, FILE_READ);
+  if (!file) return false;
+
+  StoreFileHeader header;
+  if (file.read((uint8_t*)&header, sizeof(header)) != sizeof(header) ||
+      header.magic != STORE_FILE_MAGIC) {
+    file.close();
+    return false;
+  }
+
+  head_ = 0;
+  count_ = 0;
+  dropped_ = header.dropped;
+  StoredSample entry;
+  for (uint32_t i = 0; i < header.count; i++) {
+    if (file.read((uint8_t*)&entry, sizeof(entry)) != sizeof(entry)) break;
+    if (!(entry.flags & STORED_SAMPLE_EPOCH)) {
+      dropped_++;
+      continue;
+    }
+    if (count_ == TELEMETRY_STORE_CAPACITY) pop(1);
+    entries_[(head_ + count_) % TELEMETRY_STORE_CAPACITY] = entry;
+    count_++;
+  }
+  file.close();
+  dirty_ = false;
+  return true;
+}
+
+size_t writeBackfillFrame(char* buffer, size_t capacity, const TelemetryStore& store,
+                          size_t count, const char* deviceId) {
+  if (count > store.size()) count = store.size();
+  uint32_t nowMs = millis();
+
+  FrameWriter w(buffer, capacity);
+  w.raw("{\"action\":\"backfill\",\"payload\":{");
+  w.key("deviceId").string(deviceId);
+  w.key("samples").raw("[");
+  for (size_t i = 0; i < count; i++) {
+    const StoredSample& entry = store.at(i);
+    if (i) w.raw(",");
+    w.raw("{");
+    if (entry.flags & STORED_SAMPLE_EPOCH) {
+      w.key("t").integer(entry.time);
+    } else {
+      w.key("age").integer(nowMs - entry.time);
+    }
+    writeSampleFields(w, expandSample(entry.sample));
+    w.raw("}");
+  }
+  w.raw("]}}");
+  return w.finish();
+}
@@ -0,0 +1,67 @@
+/*
+ * Store-and-forward buffer for telemetry samples
+ *
+ * Samples taken while the API link is down are kept in a fixed-size ring
+ * in RAM (oldest dropped first) and can be persisted to SPIFFS. Once the
+ * link is back they are drained in batched "backfill" frames.
+ */
+#ifndef TELEMETRY_STORE_H
+#define TELEMETRY_STORE_H
+
+#include <Arduino.h>
+#include <FS.h>
+#include "telemetry_frame.h"
+#include "binary_telemetry.h"
+
+#define TELEMETRY_STORE_CAPACITY 360  // Samples kept while the API link is down
+#define BACKFILL_BATCH 8              // Samples per backfill frame
+#define BACKFILL_FRAME_SIZE 1024      // Fits BACKFILL_BATCH samples
+
+#define STORED_SAMPLE_EPOCH 0x01      // time is Unix seconds, else millis()
+
+struct StoredSample {
+  uint32_t time;
+  uint8_t flags;
+  QuantizedSample sample;
+};
+
+class TelemetryStore {
+ public:
+  TelemetryStore();
+
+  // Records a sample stamped with wall-clock time if known, else millis()
+  void push(const TelemetrySample& sample);
+
+  size_t size() const { return count_; }
+  uint32_t dropped() const { return dropped_; }
+  bool dirty() const { return dirty_; }
+
+  // 0 is the oldest sample
+  const StoredSample& at(size_t index) const;
+  void pop(size_t count);
+
+  // Converts millis() stamps to Unix time once the system clock is set
+  void anchorClock();
+
+  // Persistence; samples from an earlier boot without wall-clock time
+  // cannot be placed and are dropped on load
+  bool save(fs::FS& fs, const char* path);
+  bool load(fs::FS& fs, const char* path);
+
+ private:
+  StoredSample entries_[TELEMETRY_STORE_CAPACITY];
+  size_t head_;   // Index of the oldest sample
+  size_t count_;
+  uint32_t dropped_;
+  bool dirty_;
+};
+
+// True once SNTP (or anything else) has set the system clock
+bool wallClockValid();
+
+// {"action":"backfill","payload":{"deviceId":"..","samples":[{"t"|"age":..,...}]}}
+// for the oldest count samples in the store
+size_t writeBackfillFrame(char* buffer, size_t capacity, const TelemetryStore& store,
+                          size_t count, const char* deviceId);
+
+#endif // TELEMETRY_STORE_H
@@ -0,0 +1,19 @@
+/*
+ * Root certificates for the API server
+ *
+ * The public API endpoint is served with Let's Encrypt certificates,
+ * which chain to ISRG Root X1 (RSA) or ISRG Root X2 (ECDSA, also
+ * cross-signed by X1). Both roots are long-lived: X1 is valid until
+ * 2035, X2 until 2040. HubDefaults::apiRootCA() returns them, so a
+ * sketch checks the server unless it explicitly opts out with nullptr.
+ *
+ * A server behind another CA needs its own root; print the chain with
+ *   python3 tools/tls_standin.py pin <host>
+ */
+#ifndef TRUST_ANCHORS_H
+#define TRUST_ANCHORS_H
+
+// ISRG Root X1 and ISRG Root X2, in one PEM bundle as mbedTLS parses it
+extern const char ISRG_ROOTS_PEM[];
+
+#endif // TRUST_ANCHORS_H
@@ -0,0 +1,76 @@
+/*
+ * Server-to-device command pipeline implementation
+ */
+#include "uplink_commands.h"
+
+UplinkCommandPipeline::UplinkCommandPipeline()
+  : lastAccepted_(0), lastTicket_(0), duplicates_(0), coalesced_(0) {
+  memset(targets_, 0, sizeof(targets_));
+  for (size_t i = 0; i < UPLINK_MAX_TARGETS; i++) applied_[i].store(0);
+}
+
+void UplinkCommandPipeline::reset() {
+  lastAccepted_ = 0;
+  for (uint8_t i = 0; i < UPLINK_MAX_TARGETS; i++) {
+    Target &t = targets_[i];
+    t.seq = 0;
+    // Still on its way from the last connection: holds back every ack
+    // until it is applied
+    t.firstSeq = inFlight(i) ? 1 : 0;
+  }
+}
+
+bool UplinkCommandPipeline::accept(uint32_t seq) {
+  if (seq == 0) return true;
+  if (seq <= lastAccepted_) {
+    duplicates_++;
+    return false;
+  }
+  lastAccepted_ = seq;
+  return true;
+}
+
+void UplinkCommandPipeline::set(uint8_t target, int value, uint32_t seq) {
+  if (target >= UPLINK_MAX_TARGETS) return;
+  Target &t = targets_[target];
+  if (t.held) coalesced_++;
+  if (!t.held && !inFlight(target)) t.firstSeq = 0;
+  if (!t.firstSeq) t.firstSeq = seq;
+  t.value = value;
+  t.seq = seq;
+  t.held = true;
+}
+
+void UplinkCommandPipeline::flush(uint32_t now, UplinkSubmit submit) {
+  for (uint8_t i = 0; i < UPLINK_MAX_TARGETS; i++) {
+    Target &t = targets_[i];
+    if (!t.held) continue;
+    if (t.written && now - t.lastWrite < UPLINK_COALESCE_INTERVAL) continue;
+
+    t.ticket = ++lastTicket_;
+    submit(i, t.value, t.ticket);
+    t.held = false;
+    t.written = true;
+    t.lastWrite = now;
+  }
+}
+
+void UplinkCommandPipeline::applied(uint8_t target, uint32_t ticket) {
+  if (target < UPLINK_MAX_TARGETS && ticket) applied_[target].store(ticket);
+}
+
+bool UplinkCommandPipeline::inFlight(uint8_t target) const {
+  const Target &t = targets_[target];
+  return t.ticket && (int32_t)(applied_[target].load() - t.ticket) < 0;
+}
+
+uint32_t UplinkCommandPipeline::ackable() const {
+  uint32_t ack = lastAccepted_;
+  for (uint8_t i = 0; i < UPLINK_MAX_TARGETS; i++) {
+    const Target &t = targets_[i];
+    // Held back by coalescing, or submitted but not yet applied by the
+    // actuators
+    if (t.firstSeq && t.firstSeq - 1 < ack && (t.held || inFlight(i))) ack = t.firstSeq - 1;
+  }
+  return ack;
+}
@@ -0,0 +1,87 @@
+/*
+ * Server-to-device command pipeline for the API uplink
+ *
+ * device_control commands carry a sequence number. Anything at or below
+ * the last accepted number is a retransmit or arrived out of order and
+ * is not applied again. Set-points are absolute, so applying one twice
+ * would be harmless, but an old one must never override a newer one.
+ *
+ * Set-points are rate limited per target. The first one goes to the
+ * actuators at once; any that follow within UPLINK_COALESCE_INTERVAL
+ * only update a held value, and the latest one is applied when the
+ * interval ends. A slider drag turns into a few LED writes instead of
+ * one per message.
+ *
+ * The acknowledged sequence number is cumulative: every command up to
+ * it has been applied, or superseded by a newer set-point. Every submit
+ * gets a ticket, and the actuator task reports back the last ticket it
+ * applied per target. Tickets keep counting across connections, so a
+ * set-point from an earlier connection that is applied late is never
+ * taken for one of the current connection.
+ */
+#ifndef UPLINK_COMMANDS_H
+#define UPLINK_COMMANDS_H
+
+#include <Arduino.h>
+#include <atomic>
+
+#define UPLINK_MAX_TARGETS 4
+#define UPLINK_COALESCE_INTERVAL 100  // Shortest gap between writes to one target (ms)
+
+// Hands a set-point to the actuators, which pass ticket to applied()
+// once it is in effect. A later submit for the same target may stand in
+// for an earlier one, as long as it reports the later ticket.
+typedef void (*UplinkSubmit)(uint8_t target, int value, uint32_t ticket);
+
+class UplinkCommandPipeline {
+ public:
+  UplinkCommandPipeline();
+
+  // New API connection: sequence numbers start over. Held set-points
+  // are kept but no longer tied to a sequence number.
+  void reset();
+
+  // False for a retransmitted or out-of-order command. seq 0 is always
+  // accepted and never acknowledged.
+  bool accept(uint32_t seq);
+
+  // Queues a set-point from an accepted command
+  void set(uint8_t target, int value, uint32_t seq);
+
+  // Submits the set-points that are due
+  void flush(uint32_t now, UplinkSubmit submit);
+
+  // Called by the actuator task, in submit order per target
+  void applied(uint8_t target, uint32_t ticket);
+
+  // Highest sequence number that can be acknowledged: one below the
+  // lowest that is held back, or submitted and not applied yet, for any
+  // target
+  uint32_t ackable() const;
+
+  uint32_t duplicates() const { return duplicates_; }
+  uint32_t coalesced() const { return coalesced_; }
+
+ private:
+  struct Target {
+    int value;
+    uint32_t seq;
+    uint32_t lastWrite;  // millis() of the last submit
+    uint32_t ticket;     // Of the last submit
+    uint32_t firstSeq;   // Lowest seq set since the target was last idle
+    bool held;
+    bool written;        // lastWrite is valid
+  };
+
+  // Submitted and not applied yet
+  bool inFlight(uint8_t target) const;
+
+  Target targets_[UPLINK_MAX_TARGETS];
+  std::atomic<uint32_t> applied_[UPLINK_MAX_TARGETS];
+  uint32_t lastAccepted_;
+  uint32_t lastTicket_;
+  uint32_t duplicates_;
+  uint32_t coalesced_;
+};
+
+#endif // UPLINK_COMMANDS_H
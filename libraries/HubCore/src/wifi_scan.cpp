@@ -0,0 +1,111 @@
+/*
+ * Shared WiFi scan service implementation
+ */
+#include "wifi_scan.h"
+#include <WiFi.h>
+
+WifiScanService::WifiScanService()
+  : count_(0), scannedAt_(0), startedAt_(0),
+    scanning_(false), requested_(false), forced_(false), lock_(nullptr) {}
+
+void WifiScanService::begin() {
+  if (lock_ == nullptr) lock_ = xSemaphoreCreateMutex();
+}
+
+void WifiScanService::request(bool force) {
+  if (force) forced_ = true;
+  requested_ = true;
+}
+
+bool WifiScanService::poll() {
+  if (scanning_) {
+    int found = WiFi.scanComplete();
+    if (found == WIFI_SCAN_RUNNING) return false;
+
+    scanning_ = false;
+    if (found < 0) return false;  // Scan failed; the next request retries
+    store(found);
+    WiFi.scanDelete();
+    return true;
+  }
+
+  if (!requested_) return false;
+  requested_ = false;
+
+  uint32_t now = millis();
+  bool force = forced_.exchange(false);
+  uint32_t maxAge = force ? WIFI_SCAN_MIN_INTERVAL : WIFI_SCAN_TTL;
+  if (scannedAt_ != 0 && now - scannedAt_ < maxAge) return false;
+  if (startedAt_ != 0 && now - startedAt_ < WIFI_SCAN_MIN_INTERVAL) return false;
+
+  if (WiFi.scanNetworks(true) == WIFI_SCAN_FAILED) return false;
+  startedAt_ = now;
+  scanning_ = true;
+  return false;
+}
+
+void WifiScanService::store(int found) {
+  ScannedNetwork fresh[WIFI_SCAN_MAX_NETWORKS];
+  size_t count = 0;
+
+  for (int i = 0; i < found; i++) {
+    String ssid = WiFi.SSID(i);
+    if (ssid.length() == 0) continue;  // Hidden network
+    int8_t rssi = WiFi.RSSI(i);
+
+    // One entry per SSID, keeping the strongest access point
+    size_t j = 0;
+    while (j < count && strcmp(fresh[j].ssid, ssid.c_str()) != 0) j++;
+    if (j < count) {
+      if (rssi <= fresh[j].rssi) continue;
+      // Take it out and re-insert below at its new rank
+      memmove(&fresh[j], &fresh[j + 1], (count - j - 1) * sizeof(ScannedNetwork));
+      count--;
+    }
+
+    // Insert sorted by RSSI, strongest first; the weakest falls off when full
+    size_t pos = 0;
+    while (pos < count && fresh[pos].rssi >= rssi) pos++;
+    if (pos >= WIFI_SCAN_MAX_NETWORKS) continue;
+    if (count == WIFI_SCAN_MAX_NETWORKS) count--;
+    memmove(&fresh[pos + 1], &fresh[pos], (count - pos) * sizeof(ScannedNetwork));
+    strlcpy(fresh[pos].ssid, ssid.c_str(), sizeof(fresh[pos].ssid));
+    fresh[pos].rssi = rssi;
+    fresh[pos].secure = WiFi.encryptionType(i) != WIFI_AUTH_OPEN;
+    count++;
+  }
+
+  xSemaphoreTake(lock_, portMAX_DELAY);
+  memcpy(networks_, fresh, count * sizeof(ScannedNetwork));
+  count_ = count;
+  scannedAt_ = millis();
+  xSemaphoreGive(lock_);
+}
+
+size_t WifiScanService::writeJson(char* buffer, size_t capacity,
+                                  const char* prefix, const char* suffix) {
+  xSemaphoreTake(lock_, portMAX_DELAY);
+  size_t len = 0;
+  for (size_t limit = count_ + 1; limit-- > 0;) {
+    FrameWriter w(buffer, capacity);
+    w.raw(prefix);
+    w.key("networks").raw("[");
+    for (size_t i = 0; i < limit; i++) {
+      if (i) w.raw(",");
+      w.raw("{");
+      w.key("ssid").string(networks_[i].ssid);
+      w.key("rssi").integer(networks_[i].rssi);
+      w.key("secure").boolean(networks_[i].secure);
+      w.raw("}");
+    }
+    w.raw("]");
+    // A pending request counts: the scan starts on the next poll()
+    w.key("scanning").boolean(scanning_ || requested_);
+    w.key("age").integer(scannedAt_ ? (long)(millis() - scannedAt_) : -1);
+    w.raw(suffix);
+    len = w.finish();
+    if (len) break;
+  }
+  xSemaphoreGive(lock_);
+  return len;
+}
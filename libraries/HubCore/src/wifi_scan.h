@@ -0,0 +1,61 @@
+/*
+ * Shared WiFi scan service
+ *
+ * Holds one scan result, deduplicated by SSID and sorted by signal
+ * strength, and serves it to every consumer (HTTP /scan, WebSocket
+ * clients). Stale results trigger a background rescan; readers always
+ * get the cached set immediately and never restart a running scan.
+ *
+ * All WiFi calls happen in poll(), so they stay on the network task.
+ * Readers may run on other tasks (e.g. the async web server).
+ */
+#ifndef WIFI_SCAN_H
+#define WIFI_SCAN_H
+
+#include <Arduino.h>
+#include <atomic>
+#include "telemetry_frame.h"
+
+#define WIFI_SCAN_MAX_NETWORKS 16
+#define WIFI_SCAN_TTL 30000         // Results older than this are refreshed on request (ms)
+#define WIFI_SCAN_MIN_INTERVAL 5000 // Shortest gap between forced rescans (ms)
+#define WIFI_SCAN_JSON_SIZE 1024    // Fits WIFI_SCAN_MAX_NETWORKS typical entries
+
+struct ScannedNetwork {
+  char ssid[33];
+  int8_t rssi;
+  bool secure;
+};
+
+class WifiScanService {
+ public:
+  WifiScanService();
+  void begin();
+
+  // Asks for a rescan if the result is older than WIFI_SCAN_TTL, or
+  // WIFI_SCAN_MIN_INTERVAL when forced. Safe from any task.
+  void request(bool force = false);
+
+  // Starts requested scans and collects finished ones. Returns true when
+  // a new result has just been stored.
+  bool poll();
+
+  // Writes prefix, then "networks":[..],"scanning":..,"age":ms, then
+  // suffix. Networks that do not fit are dropped from the weakest end.
+  // Returns the length, or 0 if not even an empty list fits.
+  size_t writeJson(char* buffer, size_t capacity, const char* prefix, const char* suffix);
+
+ private:
+  void store(int found);
+
+  ScannedNetwork networks_[WIFI_SCAN_MAX_NETWORKS];
+  size_t count_;
+  uint32_t scannedAt_;   // millis() of the last result, 0 if none
+  uint32_t startedAt_;   // millis() of the last scan start
+  std::atomic<bool> scanning_;
+  std::atomic<bool> requested_;
+  std::atomic<bool> forced_;
+  SemaphoreHandle_t lock_;
+};
+
+#endif // WIFI_SCAN_H
@@ -0,0 +1,87 @@
+#!/usr/bin/env python3
+"""Builds the gzipped captive portal page served by the firmware.
+
+The portal HTML stays where it is edited, in the portal_html raw string
+in HubCore's portal_page.cpp. This script minifies it, gzips it and
+writes portal_gz.h next to it with the compressed bytes and a strong
+ETag.
+
+Run it from the repository root after changing the portal page:
+
+    python3 tools/build_portal.py
+
+Output is deterministic, so an unchanged page gives an unchanged header.
+"""
+
+import gzip
+import hashlib
+import os
+import re
+import sys
+
+# Source file holding portal_html -> generated header
+PAGES = [
+    ("libraries/HubCore/src/portal_page.cpp", "libraries/HubCore/src/portal_gz.h"),
+]
+
+PORTAL_RE = re.compile(r'portal_html\[\]\s+PROGMEM\s*=\s*R"=====\((.*?)\)====="', re.S)
+
+
+def minify(html):
+    """Drops comments, indentation and blank lines.
+
+    Line breaks are kept so inline scripts that rely on automatic
+    semicolon insertion keep working.
+    """
+    html = re.sub(r"<!--.*?-->", "", html, flags=re.S)
+    lines = (line.strip() for line in html.splitlines())
+    return "\n".join(line for line in lines if line)
+
+
+def render_header(source, data, etag):
+    rows = []
+    for i in range(0, len(data), 16):
+        rows.append("  " + ", ".join("0x%02x" % b for b in data[i:i + 16]) + ",")
+    return (
+        "/*\n"
+        " * Generated by tools/build_portal.py from %s - do not edit.\n"
+        " */\n"
+        "#ifndef PORTAL_GZ_H\n"
+        "#define PORTAL_GZ_H\n"
+        "\n"
+        "#include <Arduino.h>\n"
+        "\n"
+        "#define PORTAL_HTML_ETAG \"\\\"%s\\\"\"\n"
+        "\n"
+        "const size_t portal_html_gz_len = %d;\n"
+        "const uint8_t portal_html_gz[] PROGMEM = {\n"
+        "%s\n"
+        "};\n"
+        "\n"
+        "#endif // PORTAL_GZ_H\n"
+    ) % (os.path.basename(source), etag, len(data), "\n".join(rows))
+
+
+def build(root, source, output):
+    with open(os.path.join(root, source), encoding="utf-8") as f:
+        match = PORTAL_RE.search(f.read())
+    if not match:
+        sys.exit("%s: portal_html not found" % source)
+
+    html = minify(match.group(1)).encode("utf-8")
+    data = gzip.compress(html, compresslevel=9, mtime=0)
+    etag = hashlib.sha256(data).hexdigest()[:16]
+
+    with open(os.path.join(root, output), "w", encoding="utf-8", newline="\n") as f:
+        f.write(render_header(source, data, etag))
+    print("%s: %d -> %d bytes gzipped, ETag %s" % (output, len(match.group(1)), len(data), etag))
+
+
+def main():
+    root = os.path.dirname(os.path.dirname(os.path.abspath(__file__)))
+    for source, output in PAGES:
+        build(root, source, output)
+
+
+if __name__ == "__main__":
+    main()
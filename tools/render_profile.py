@@ -0,0 +1,128 @@
+#!/usr/bin/env python3
+"""Renders the latency histograms exported by the esp32 firmware.
+
+The firmware exports the same profile object in two ways:
+
+  - over Serial, as one "[prof] {...}" line per region with every
+    loop report
+  - to a local WebSocket client that sends {"op":"profile"}, as
+    {"action":"profile","payload":{...}}
+
+Feed either one in, as a saved serial log, a saved frame or stdin:
+
+    python3 tools/render_profile.py serial.log
+    websocat ws://<hub>:81 <<< '{"op":"profile"}' | python3 tools/render_profile.py
+
+If a region appears more than once, the last copy is used. The
+histograms count from boot, so the last copy already includes the
+earlier ones.
+"""
+
+import argparse
+import json
+import sys
+
+PROF_PREFIX = "[prof] "
+BAR_WIDTH = 50
+
+
+def bucket_bounds(index, sub_bits, min_shift):
+    """Smallest and largest cycle count that land in a bucket."""
+    if index == 0:
+        return 0, (1 << min_shift) - 1
+    msb = min_shift + ((index - 1) >> sub_bits)
+    sub = (index - 1) & ((1 << sub_bits) - 1)
+    width = 1 << (msb - sub_bits)
+    low = (1 << msb) + sub * width
+    return low, low + width - 1
+
+
+def extract_profiles(lines):
+    """Yields every profile object found in the input."""
+    for line in lines:
+        line = line.strip()
+        if PROF_PREFIX in line:
+            line = line[line.index(PROF_PREFIX) + len(PROF_PREFIX):]
+        if not line.startswith("{"):
+            continue
+        try:
+            obj = json.loads(line)
+        except ValueError:
+            continue
+        if obj.get("action") == "profile":
+            obj = obj.get("payload", {})
+        if "regions" in obj:
+            yield obj
+
+
+def percentile(region, buckets, percent):
+    rank = max(1, -(-region["count"] * percent // 100))
+    seen = 0
+    for _, high, count in buckets:
+        seen += count
+        if seen >= rank:
+            return min(high, region["max"])
+    return region["max"]
+
+
+def render(profile, region, out):
+    mhz = profile["mhz"]
+    sub_bits = profile["subBits"]
+    min_shift = profile["minShift"]
+    counts = region.get("b", [])
+    lo = region.get("lo", 0)
+
+    # (index, largest cycle count, count) for every exported bucket
+    buckets = [(lo + offset, bucket_bounds(lo + offset, sub_bits, min_shift)[1], count)
+               for offset, count in enumerate(counts)]
+
+    us = lambda cycles: cycles / mhz
+    out.write("%s  count=%d  p50=%.1fus  p90=%.1fus  p99=%.1fus  max=%.1fus\n" % (
+        region["name"], region["count"],
+        us(percentile(region, buckets, 50)),
+        us(percentile(region, buckets, 90)),
+        us(percentile(region, buckets, 99)),
+        us(region["max"])))
+    if not buckets:
+        out.write("  (no buckets in this export)\n\n")
+        return
+
+    peak = max(count for _, _, count in buckets) or 1
+    for index, high, count in buckets:
+        low, _ = bucket_bounds(index, sub_bits, min_shift)
+        bar = "#" * int(round(count * BAR_WIDTH / peak))
+        out.write("  %10.1f - %10.1f us %9d %s\n" % (us(low), us(high + 1), count, bar))
+    out.write("\n")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("files", nargs="*", help="serial logs or saved frames (default: stdin)")
+    parser.add_argument("-r", "--region", action="append",
+                        help="only show this region (repeatable)")
+    args = parser.parse_args()
+
+    lines = []
+    if args.files:
+        for path in args.files:
+            with open(path, encoding="utf-8", errors="replace") as f:
+                lines.extend(f)
+    else:
+        lines = sys.stdin
+
+    regions = {}
+    for profile in extract_profiles(lines):
+        for region in profile["regions"]:
+            regions[region["name"]] = (profile, region)
+
+    if not regions:
+        sys.exit("no profile data found")
+
+    for name, (profile, region) in regions.items():
+        if args.region and name not in args.region:
+            continue
+        render(profile, region, sys.stdout)
+
+
+if __name__ == "__main__":
+    main()
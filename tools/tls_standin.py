@@ -0,0 +1,224 @@
+#!/usr/bin/env python3
+"""Local TLS stand-in for the API server, and pin printer.
+
+serve: runs a wss:// server with a throwaway CA, so the firmware's TLS
+session resumption and certificate checks can be tried on the bench.
+
+    python3 tools/tls_standin.py serve --name 192.168.1.20
+
+It prints the endpoint(), apiRootCA() and apiKeyPin() to paste into the
+HubConfig in esp32/esp32.ino, then logs every connection: whether the TLS session
+was resumed, the protocol and cipher, and the WebSocket
+frames received. --drop-after closes each connection after that many
+seconds, so the hub keeps reconnecting and resuming.
+
+pin: prints the public key pin of every certificate a server sends,
+for API_KEY_PIN, and the issuer to look up for API_ROOT_CA. The hub
+accepts a pin on any certificate of the chain only together with
+API_ROOT_CA, which makes that chain verifiable; with API_KEY_PIN alone
+it must be the server certificate's own key ([0]).
+
+    python3 tools/tls_standin.py pin websocket-server-ts-production.up.railway.app
+
+Needs the openssl command line tool.
+"""
+
+import argparse
+import asyncio
+import base64
+import hashlib
+import os
+import re
+import ssl
+import subprocess
+import sys
+import time
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+
+def openssl(*args, data=None):
+    return subprocess.run(["openssl", *args], input=data, capture_output=True, check=True).stdout
+
+
+def key_pin(cert_pem):
+    """base64 SHA-256 of the certificate's SubjectPublicKeyInfo."""
+    public_key = openssl("x509", "-pubkey", "-noout", data=cert_pem)
+    der = openssl("pkey", "-pubin", "-outform", "der", data=public_key)
+    return base64.b64encode(hashlib.sha256(der).digest()).decode()
+
+
+def c_string(pem):
+    lines = pem.decode().strip().splitlines()
+    return "\n".join(f'  "{line}\\n"' for line in lines)
+
+
+def make_certificates(directory, name):
+    """Creates a CA and a server certificate for name, once per directory."""
+    ca_key = os.path.join(directory, "ca.key")
+    ca_pem = os.path.join(directory, "ca.pem")
+    server_key = os.path.join(directory, "server.key")
+    server_pem = os.path.join(directory, "server.pem")
+    if os.path.exists(server_pem):
+        return ca_pem, server_pem, server_key
+
+    os.makedirs(directory, exist_ok=True)
+    ec = ["-newkey", "ec", "-pkeyopt", "ec_paramgen_curve:prime256v1", "-nodes"]
+    openssl("req", "-x509", *ec, "-keyout", ca_key, "-out", ca_pem, "-days", "3650",
+            "-subj", "/CN=Hub TLS stand-in CA")
+    csr = openssl("req", *ec, "-keyout", server_key, "-subj", f"/CN={name}")
+    # mbedTLS 2.x compares the host name with DNS names only, so an
+    # address goes in as both
+    names = f"IP:{name},DNS:{name}" if re.fullmatch(r"[\d.]+", name) else f"DNS:{name}"
+    extensions = os.path.join(directory, "server.ext")
+    with open(extensions, "w") as f:
+        f.write(f"subjectAltName={names}\n")
+    openssl("x509", "-req", "-CA", ca_pem, "-CAkey", ca_key, "-CAcreateserial",
+            "-out", server_pem, "-days", "825", "-extfile", extensions, data=csr)
+    return ca_pem, server_pem, server_key
+
+
+async def read_frame(reader):
+    """Returns (opcode, payload) of one client frame."""
+    head = await reader.readexactly(2)
+    opcode = head[0] & 0x0F
+    length = head[1] & 0x7F
+    if length == 126:
+        length = int.from_bytes(await reader.readexactly(2), "big")
+    elif length == 127:
+        length = int.from_bytes(await reader.readexactly(8), "big")
+    mask = await reader.readexactly(4) if head[1] & 0x80 else b"\0\0\0\0"
+    data = await reader.readexactly(length)
+    return opcode, bytes(b ^ mask[i % 4] for i, b in enumerate(data))
+
+
+def frame(opcode, payload):
+    length = len(payload)
+    if length < 126:
+        head = bytes([0x80 | opcode, length])
+    else:
+        head = bytes([0x80 | opcode, 126]) + length.to_bytes(2, "big")
+    return head + payload
+
+
+async def serve_client(reader, writer, args, counters):
+    accepted = time.monotonic()
+    sslobj = writer.get_extra_info("ssl_object")
+    peer = writer.get_extra_info("peername")[0]
+    resumed = sslobj.session_reused
+    counters["resumed" if resumed else "full"] += 1
+    print(f"{peer} {sslobj.version()} {sslobj.cipher()[0]} "
+          f"{'resumed' if resumed else 'full handshake'} "
+          f"(full {counters['full']}, resumed {counters['resumed']})")
+
+    try:
+        request = await reader.readuntil(b"\r\n\r\n")
+        match = re.search(rb"Sec-WebSocket-Key:\s*(\S+)", request, re.I)
+        if not match:
+            return
+        accept = base64.b64encode(hashlib.sha1(match.group(1) + WS_GUID.encode()).digest())
+        writer.write(b"HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                     b"Connection: Upgrade\r\nSec-WebSocket-Accept: " + accept + b"\r\n\r\n")
+        await writer.drain()
+
+        while True:
+            timeout = None
+            if args.drop_after:
+                timeout = max(0.0, accepted + args.drop_after - time.monotonic())
+            opcode, payload = await asyncio.wait_for(read_frame(reader), timeout)
+            if opcode == 0x1:
+                print(f"{peer} text {payload[:120].decode(errors='replace')}")
+            elif opcode == 0x2:
+                print(f"{peer} binary {len(payload)} bytes")
+            elif opcode == 0x9:
+                writer.write(frame(0xA, payload))
+            elif opcode == 0x8:
+                break
+    except (asyncio.IncompleteReadError, asyncio.TimeoutError, ConnectionError):
+        pass
+    finally:
+        writer.close()
+        print(f"{peer} closed")
+
+
+def serve(args):
+    ca_pem, server_pem, server_key = make_certificates(args.dir, args.name)
+    with open(ca_pem, "rb") as f:
+        ca = f.read()
+    with open(server_pem, "rb") as f:
+        server_cert = f.read()
+
+    # Send the CA along with the server certificate, as real servers send
+    # their intermediates
+    chain_pem = os.path.join(args.dir, "chain.pem")
+    with open(chain_pem, "wb") as f:
+        f.write(server_cert + ca)
+    context = ssl.SSLContext(ssl.PROTOCOL_TLS_SERVER)
+    context.load_cert_chain(chain_pem, server_key)
+    if args.no_tickets:
+        # Session ID resumption only
+        context.options |= ssl.OP_NO_TICKET
+    counters = {"full": 0, "resumed": 0}
+
+    async def run():
+        server = await asyncio.start_server(
+            lambda r, w: serve_client(r, w, args, counters), args.listen, args.port, ssl=context)
+        # --port 0 takes any free port
+        port = server.sockets[0].getsockname()[1]
+        print(f'static const char* endpoint() {{ return "wss://{args.name}:{port}/"; }}')
+        print("static const char* apiRootCA() { return")
+        print(c_string(ca) + "; }")
+        print(f'static const char* apiKeyPin() {{ return "{key_pin(server_cert)}"; }}  // server key')
+        print(f"// or, together with apiRootCA() only, the CA key: {key_pin(ca)}")
+        print()
+        print(f"listening on {args.listen}:{port}", flush=True)
+        async with server:
+            await server.serve_forever()
+
+    try:
+        asyncio.run(run())
+    except KeyboardInterrupt:
+        pass
+
+
+def pin(args):
+    host, _, port = args.host.partition(":")
+    chain = openssl("s_client", "-connect", f"{host}:{port or 443}", "-servername", host,
+                    "-showcerts", data=b"")
+    certs = re.findall(rb"-----BEGIN CERTIFICATE-----.+?-----END CERTIFICATE-----\n", chain, re.S)
+    if not certs:
+        sys.exit(f"no certificates from {args.host}")
+    for index, cert in enumerate(certs):
+        subject = openssl("x509", "-noout", "-subject", "-issuer", data=cert).decode().strip()
+        print(f"[{index}] {key_pin(cert)}")
+        for line in subject.splitlines():
+            print(f"    {line}")
+    print("\nWith API_ROOT_CA (the root named as the last issuer), pin a key that")
+    print("outlives certificate renewals, usually an intermediate. Without it,")
+    print("only [0], the server's own key, is accepted; it changes if the server")
+    print("gets a new key pair on renewal.")
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    commands = parser.add_subparsers(dest="command", required=True)
+
+    serve_parser = commands.add_parser("serve", help="run a local wss:// stand-in")
+    serve_parser.add_argument("--name", required=True, help="IP address or host name the hub connects to")
+    serve_parser.add_argument("--port", type=int, default=8443)
+    serve_parser.add_argument("--listen", default="0.0.0.0")
+    serve_parser.add_argument("--dir", default="tls-standin", help="where the certificates are kept")
+    serve_parser.add_argument("--drop-after", type=float, default=0, help="close connections after (s)")
+    serve_parser.add_argument("--no-tickets", action="store_true", help="disable session tickets")
+    serve_parser.set_defaults(func=serve)
+
+    pin_parser = commands.add_parser("pin", help="print the key pins of a server")
+    pin_parser.add_argument("host", help="host[:port]")
+    pin_parser.set_defaults(func=pin)
+
+    args = parser.parse_args()
+    args.func(args)
+
+
+if __name__ == "__main__":
+    main()
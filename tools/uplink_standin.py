@@ -0,0 +1,313 @@
+#!/usr/bin/env python3
+"""Local stand-in for the API server's telemetry uplink.
+
+Runs a plain ws:// server that speaks the hub's side of the protocol:
+it answers the hello handshake, accepting the binary telemetry format
+unless --json is given, and decodes every frame the hub sends. Binary
+frames are decoded the way BinaryTelemetryDecoder in
+libraries/HubCore/src/binary_telemetry.h does it, including the
+sequence check on delta frames, so a hub whose encoder and decoder get
+out of step shows up here as rejected frames.
+
+    python3 tools/uplink_standin.py
+    python3 tools/uplink_standin.py --port 8080 --drop-after 30
+
+Point HubConfig::endpoint() in esp32/esp32.ino at ws://<this machine>:<port>/.
+--drop-after closes each connection after that many seconds, so the
+key frame after every reconnect can be watched. For wss:// use
+tools/tls_standin.py, which only logs frames.
+
+    python3 tools/uplink_standin.py --check-vectors binary_telemetry.vectors
+
+decodes the frames host/test/test_binary_telemetry.cpp wrote with
+--vectors and exits non-zero where this decoder and the firmware's
+disagree; the host build runs it as a test.
+"""
+
+import argparse
+import asyncio
+import base64
+import hashlib
+import json
+import re
+import struct
+import time
+
+WS_GUID = "258EAFA5-E914-47DA-95CA-C5AB0DC85B11"
+
+# binary_telemetry.h
+BINARY_TELEMETRY_VERSION = 1
+BINARY_FRAME_KEY = 0x01
+BINARY_FRAME_DELTA = 0x02
+BINARY_TEMP_INVALID = -0x8000
+BINARY_HUM_INVALID = 0xFFFF
+BINARY_STATE_MOTION = 0x01
+BINARY_STATE_LED2 = 0x02
+BINARY_STATE_LED3 = 0x04
+BINARY_CHANGED_TEMP = 0x01
+BINARY_CHANGED_HUM = 0x02
+BINARY_CHANGED_STATE = 0x04
+BINARY_CHANGED_LED1 = 0x08
+HEADER_SIZE = 4
+KEY_BODY_SIZE = 6
+
+
+class DecodeError(Exception):
+    pass
+
+
+class BinaryDecoder:
+    """Mirror of BinaryTelemetryDecoder; one per connection."""
+
+    def __init__(self):
+        self.previous = None   # (temperature, humidity, state, led1), quantized
+        self.sequence = 0
+
+    def decode(self, frame):
+        if len(frame) < HEADER_SIZE or frame[0] != BINARY_TELEMETRY_VERSION:
+            raise DecodeError("bad header or version")
+        kind = frame[1]
+        seq = struct.unpack_from("<H", frame, 2)[0]
+        body = frame[HEADER_SIZE:]
+
+        if kind == BINARY_FRAME_KEY:
+            if len(body) != KEY_BODY_SIZE:
+                raise DecodeError(f"key frame body of {len(body)} bytes")
+            current = struct.unpack("<hHBB", body)
+        elif kind == BINARY_FRAME_DELTA:
+            # Deltas only make sense on top of the frame right before them
+            if self.previous is None:
+                raise DecodeError("delta without a key frame")
+            if seq != (self.sequence + 1) & 0xFFFF:
+                raise DecodeError(f"delta seq {seq} after {self.sequence}")
+            if not body:
+                raise DecodeError("empty delta")
+            mask, rest = body[0], list(body[1:])
+            temperature, humidity, state, led1 = self.previous
+
+            def take():
+                if not rest:
+                    raise DecodeError("delta body too short")
+                return rest.pop(0)
+
+            if mask & BINARY_CHANGED_TEMP:
+                temperature = to_int16(temperature + to_int8(take()))
+            if mask & BINARY_CHANGED_HUM:
+                humidity = (humidity + to_int8(take())) & 0xFFFF
+            if mask & BINARY_CHANGED_STATE:
+                state = take()
+            if mask & BINARY_CHANGED_LED1:
+                led1 = take()
+            if rest:
+                raise DecodeError("delta body too long")
+            current = (temperature, humidity, state, led1)
+        else:
+            raise DecodeError(f"frame type {kind}")
+
+        self.previous = current
+        self.sequence = seq
+        return kind, seq, expand(current)
+
+
+def to_int8(value):
+    return value - 256 if value > 127 else value
+
+
+def to_int16(value):
+    return (value + 0x8000) % 0x10000 - 0x8000
+
+
+def expand(quantized):
+    temperature, humidity, state, led1 = quantized
+    return {
+        "temperature": None if temperature == BINARY_TEMP_INVALID else temperature / 10,
+        "humidity": None if humidity == BINARY_HUM_INVALID else humidity / 10,
+        "motion": bool(state & BINARY_STATE_MOTION),
+        "led1": led1,
+        "led2": bool(state & BINARY_STATE_LED2),
+        "led3": bool(state & BINARY_STATE_LED3),
+    }
+
+
+async def read_frame(reader):
+    """Returns (opcode, payload) of one client frame."""
+    head = await reader.readexactly(2)
+    opcode = head[0] & 0x0F
+    length = head[1] & 0x7F
+    if length == 126:
+        length = int.from_bytes(await reader.readexactly(2), "big")
+    elif length == 127:
+        length = int.from_bytes(await reader.readexactly(8), "big")
+    mask = await reader.readexactly(4) if head[1] & 0x80 else b"\0\0\0\0"
+    data = await reader.readexactly(length)
+    return opcode, bytes(b ^ mask[i % 4] for i, b in enumerate(data))
+
+
+def frame(opcode, payload):
+    length = len(payload)
+    if length < 126:
+        head = bytes([0x80 | opcode, length])
+    else:
+        head = bytes([0x80 | opcode, 126]) + length.to_bytes(2, "big")
+    return head + payload
+
+
+def format_sample(sample):
+    def value(v, unit):
+        return "--" if v is None else f"{v:.1f}{unit}"
+    return (f"{value(sample['temperature'], 'C')} {value(sample['humidity'], '%')} "
+            f"motion={int(sample['motion'])} led1={sample['led1']} "
+            f"led2={int(sample['led2'])} led3={int(sample['led3'])}")
+
+
+class Connection:
+    def __init__(self, peer, args):
+        self.peer = peer
+        self.args = args
+        self.decoder = BinaryDecoder()
+        self.counts = {"key": 0, "delta": 0, "rejected": 0, "json": 0}
+        self.binary_bytes = 0
+
+    def log(self, text):
+        print(f"{time.strftime('%H:%M:%S')} {self.peer} {text}")
+
+    def on_text(self, payload, writer):
+        try:
+            message = json.loads(payload)
+        except ValueError:
+            self.log(f"text (not JSON) {payload[:120]!r}")
+            return
+        action = message.get("action")
+        body = message.get("payload") or {}
+
+        if action == "hello":
+            offered = body.get("binary", 0)
+            accepted = 0 if self.args.json else offered if offered == BINARY_TELEMETRY_VERSION else 0
+            self.log(f"hello from {body.get('deviceId')} offering binary {offered}, "
+                     f"answering {accepted or 'JSON'}")
+            reply = {"action": "hello", "payload": {"binary": accepted}}
+            writer.write(frame(0x1, json.dumps(reply, separators=(",", ":")).encode()))
+            # Frames from the previous connection do not carry over
+            self.decoder = BinaryDecoder()
+        elif action == "updateenv":
+            self.counts["json"] += 1
+            sample = {
+                "temperature": body.get("temp"),
+                "humidity": body.get("hum"),
+                "motion": body.get("motion", False),
+                "led1": body.get("led1", 0),
+                "led2": body.get("led2", False),
+                "led3": body.get("led3", False),
+            }
+            ack = f" ack={body['ack']}" if "ack" in body else ""
+            self.log(f"json  {len(payload):3d} B  {format_sample(sample)}{ack}")
+        else:
+            self.log(f"{action} {payload[:160].decode(errors='replace')}")
+
+    def on_binary(self, payload):
+        try:
+            kind, seq, sample = self.decoder.decode(payload)
+        except DecodeError as error:
+            self.counts["rejected"] += 1
+            self.log(f"REJECTED {payload.hex()}: {error}")
+            return
+        name = "key" if kind == BINARY_FRAME_KEY else "delta"
+        self.counts[name] += 1
+        self.binary_bytes += len(payload)
+        self.log(f"{name:5s} {len(payload):3d} B  seq {seq:5d}  {format_sample(sample)}")
+
+    def summary(self):
+        frames = self.counts["key"] + self.counts["delta"]
+        average = f", {self.binary_bytes / frames:.1f} B per binary frame" if frames else ""
+        return (f"closed: {self.counts['key']} key, {self.counts['delta']} delta, "
+                f"{self.counts['rejected']} rejected, {self.counts['json']} JSON{average}")
+
+
+def check_vectors(path):
+    """Returns the number of frames in path this decoder reads differently."""
+    decoder = BinaryDecoder()
+    frames = mismatches = 0
+    with open(path) as vectors:
+        for number, line in enumerate(vectors, 1):
+            line = line.rstrip("\n")
+            if not line or line.startswith("#"):
+                continue
+            if line == "reset":
+                decoder = BinaryDecoder()
+                continue
+            data, expected = line.split("\t", 1)
+            try:
+                result = format_sample(decoder.decode(bytes.fromhex(data))[2])
+            except DecodeError:
+                result = "rejected"
+            frames += 1
+            if result != expected:
+                mismatches += 1
+                print(f"{path}:{number}: {data}: {result}, BinaryTelemetryDecoder: {expected}")
+    print(f"{frames} frames, {mismatches} decoded differently")
+    return mismatches
+
+
+async def serve_client(reader, writer, args):
+    accepted = time.monotonic()
+    connection = Connection(writer.get_extra_info("peername")[0], args)
+    connection.log("connected")
+
+    try:
+        request = await reader.readuntil(b"\r\n\r\n")
+        match = re.search(rb"Sec-WebSocket-Key:\s*(\S+)", request, re.I)
+        if not match:
+            return
+        accept = base64.b64encode(hashlib.sha1(match.group(1) + WS_GUID.encode()).digest())
+        writer.write(b"HTTP/1.1 101 Switching Protocols\r\nUpgrade: websocket\r\n"
+                     b"Connection: Upgrade\r\nSec-WebSocket-Accept: " + accept + b"\r\n\r\n")
+        await writer.drain()
+
+        while True:
+            timeout = None
+            if args.drop_after:
+                timeout = max(0.0, accepted + args.drop_after - time.monotonic())
+            opcode, payload = await asyncio.wait_for(read_frame(reader), timeout)
+            if opcode == 0x1:
+                connection.on_text(payload, writer)
+            elif opcode == 0x2:
+                connection.on_binary(payload)
+            elif opcode == 0x9:
+                writer.write(frame(0xA, payload))
+            elif opcode == 0x8:
+                break
+            await writer.drain()
+    except (asyncio.IncompleteReadError, asyncio.TimeoutError, ConnectionError):
+        pass
+    finally:
+        writer.close()
+        connection.log(connection.summary())
+
+
+def main():
+    parser = argparse.ArgumentParser(description=__doc__.split("\n")[0])
+    parser.add_argument("--port", type=int, default=8080)
+    parser.add_argument("--listen", default="0.0.0.0")
+    parser.add_argument("--json", action="store_true", help="decline the binary format")
+    parser.add_argument("--drop-after", type=float, default=0, help="close connections after (s)")
+    parser.add_argument("--check-vectors", metavar="FILE",
+                        help="compare with frames decoded by the firmware, then exit")
+    args = parser.parse_args()
+    if args.check_vectors:
+        raise SystemExit(1 if check_vectors(args.check_vectors) else 0)
+
+    async def run():
+        server = await asyncio.start_server(
+            lambda r, w: serve_client(r, w, args), args.listen, args.port)
+        print(f"listening on ws://{args.listen}:{args.port}/")
+        async with server:
+            await server.serve_forever()
+
+    try:
+        asyncio.run(run())
+    except KeyboardInterrupt:
+        pass
+
+
+if __name__ == "__main__":
+    main()